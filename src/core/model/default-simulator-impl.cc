@@ -55,6 +55,7 @@ DefaultSimulatorImpl::GetTypeId (void)
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl ()
+  : m_eventsWithContextQueue (EVENTS_WITH_CONTEXT_SLOTS)
 {
   NS_LOG_FUNCTION (this);
   m_stop = false;
@@ -64,7 +65,7 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentContext = Simulator::NO_CONTEXT;
   m_unscheduledEvents = 0;
   m_eventCount = 0;
-  m_eventsWithContextEmpty = true;
+  m_eventsWithContextOverflow = false;
   m_mainThreadId = std::this_thread::get_id ();
 }
 
@@ -158,33 +159,56 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContextQueue.IsEmpty () && !m_eventsWithContextOverflow)
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
-  {
-    std::unique_lock lock {m_eventsWithContextMutex};
-    m_eventsWithContext.swap (eventsWithContext);
-    m_eventsWithContextEmpty = true;
-  }
-  while (!eventsWithContext.empty ())
+  EventWithContext event;
+  while (m_eventsWithContextQueue.Pop (event))
     {
-      EventWithContext event = eventsWithContext.front ();
-      eventsWithContext.pop_front ();
-      Scheduler::Event ev;
-      ev.impl = event.event;
-      ev.key.m_ts = m_currentTs + event.timestamp;
-      ev.key.m_context = event.context;
-      ev.key.m_uid = m_uid;
-      m_uid++;
-      m_unscheduledEvents++;
-      m_events->Insert (ev);
+      InsertEventWithContext (event);
+    }
+
+  if (m_eventsWithContextOverflow)
+    {
+      // swap queues. A thread may have seen the flag unset and pushed to
+      // the lock-free queue after the loop above, and then appended to the
+      // list: its events pushed before the swap are inserted first. The
+      // events pushed after the swap were scheduled after the ones in the
+      // list, and stay in the queue.
+      EventsWithContext eventsWithContext;
+      std::size_t end;
+      {
+        std::unique_lock lock {m_eventsWithContextMutex};
+        end = m_eventsWithContextQueue.GetPushPosition ();
+        m_eventsWithContext.swap (eventsWithContext);
+        m_eventsWithContextOverflow = false;
+      }
+      while (m_eventsWithContextQueue.Pop (event, end))
+        {
+          InsertEventWithContext (event);
+        }
+      for (const EventWithContext &listEvent : eventsWithContext)
+        {
+          InsertEventWithContext (listEvent);
+        }
     }
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext (const EventWithContext &event)
+{
+  Scheduler::Event ev;
+  ev.impl = event.event;
+  ev.key.m_ts = m_currentTs + event.timestamp;
+  ev.key.m_context = event.context;
+  ev.key.m_uid = m_uid;
+  m_uid++;
+  m_unscheduledEvents++;
+  m_events->Insert (ev);
+}
+
 void
 DefaultSimulatorImpl::Run (void)
 {
@@ -266,11 +290,12 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       // Current time added in ProcessEventsWithContext()
       ev.timestamp = delay.GetTimeStep ();
       ev.event = event;
-      {
-        std::unique_lock lock {m_eventsWithContextMutex};
-        m_eventsWithContext.push_back (ev);
-        m_eventsWithContextEmpty = false;
-      }
+      if (m_eventsWithContextOverflow || !m_eventsWithContextQueue.Push (ev))
+        {
+          std::unique_lock lock {m_eventsWithContextMutex};
+          m_eventsWithContext.push_back (ev);
+          m_eventsWithContextOverflow = true;
+        }
     }
 }
 
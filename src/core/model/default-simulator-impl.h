@@ -22,6 +22,8 @@
 #define DEFAULT_SIMULATOR_IMPL_H
 
 #include "simulator-impl.h"
+#include "mpsc-queue.h"
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
@@ -95,15 +97,31 @@ private:
     /** The event implementation. */
     EventImpl *event;
   };
+  /**
+   * Insert an event from a different context into the main event queue.
+   * \param [in] event The event.
+   */
+  void InsertEventWithContext (const struct EventWithContext &event);
+
+  /** Number of slots of the queue of events from a different context. */
+  static const std::size_t EVENTS_WITH_CONTEXT_SLOTS = 1024;
+  /** The lock-free queue of events from a different context. */
+  MpscQueue<struct EventWithContext> m_eventsWithContextQueue;
   /** Container type for the events from a different context. */
   typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
+  /**
+   * The events from a different context that did not fit in
+   * m_eventsWithContextQueue.
+   */
   EventsWithContext m_eventsWithContext;
   /**
-   * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * Flag \c true if m_eventsWithContext is not empty. While it is set,
+   * the other threads append to m_eventsWithContext rather than to
+   * m_eventsWithContextQueue. ProcessEventsWithContext inserts the events
+   * pushed to m_eventsWithContextQueue before the list is swapped, then the
+   * list, so that the events of each thread keep their order.
    */
-  bool m_eventsWithContextEmpty;
+  std::atomic<bool> m_eventsWithContextOverflow;
   /** Mutex to control access to the list of events with context. */
   std::mutex m_eventsWithContextMutex;
 
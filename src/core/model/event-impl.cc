@@ -21,6 +21,12 @@
 #include "event-impl.h"
 #include "log.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <vector>
+
 /**
  * \file
  * \ingroup events
@@ -31,6 +37,241 @@ namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
+namespace {
+
+/** Size step of the size classes of the event pool. */
+const std::size_t POOL_GRANULARITY = 16;
+/** Largest event allocated from the pool. */
+const std::size_t POOL_MAX_SIZE = 256;
+/** Number of size classes of the event pool. */
+const std::size_t POOL_CLASSES = POOL_MAX_SIZE / POOL_GRANULARITY;
+/** Maximum number of free blocks kept per size class and thread. */
+const uint32_t POOL_MAX_FREE = 4096;
+
+/** Whether the events are allocated from the pool. */
+std::atomic<bool> g_poolEnabled {false};
+/** Event memory in use, allocated minus freed bytes over all the threads. */
+std::atomic<int64_t> g_poolBytes {0};
+/** Peak of g_poolBytes. */
+std::atomic<int64_t> g_poolPeakBytes {0};
+
+/** A free block of the event pool. */
+struct PoolBlock
+{
+  PoolBlock *next;  /**< Next free block of the same size class. */
+};
+
+/**
+ * Free lists and counters of the event pool of a thread.
+ *
+ * The blocks are allocated one by one with the global operator new,
+ * rounded up to their size class, so that a block can be freed by any
+ * thread, with or without the pool.
+ */
+struct PoolCache
+{
+  PoolCache ();
+  ~PoolCache ();
+
+  PoolBlock *freeList[POOL_CLASSES];    /**< Free blocks of each size class. */
+  uint32_t freeCount[POOL_CLASSES];     /**< Length of each free list. */
+  // updated only by the owner thread, read by GetPoolStats
+  std::atomic<uint64_t> allocations;    /**< Events allocated by this thread. */
+  std::atomic<uint64_t> hits;           /**< Events taken from the free lists. */
+};
+
+/** Counters of the threads that have exited. */
+struct PoolRegistry
+{
+  std::mutex mutex;                     /**< Protects the fields below. */
+  std::vector<PoolCache *> caches;      /**< Caches of the running threads. */
+  EventImpl::PoolStats retired;         /**< Counters of the exited threads. */
+};
+
+/**
+ * Get the registry of the pool caches.
+ * \returns The registry, never destroyed.
+ */
+PoolRegistry &
+GetPoolRegistry (void)
+{
+  static PoolRegistry *registry = new PoolRegistry ();
+  return *registry;
+}
+
+/** Set once the cache of the thread has been destroyed, at thread exit. */
+thread_local bool t_poolCacheDestroyed = false;
+
+PoolCache::PoolCache ()
+  : allocations (0),
+    hits (0)
+{
+  std::fill (freeList, freeList + POOL_CLASSES, nullptr);
+  std::fill (freeCount, freeCount + POOL_CLASSES, 0);
+  PoolRegistry &registry = GetPoolRegistry ();
+  std::unique_lock lock {registry.mutex};
+  registry.caches.push_back (this);
+}
+
+PoolCache::~PoolCache ()
+{
+  for (std::size_t c = 0; c < POOL_CLASSES; c++)
+    {
+      while (freeList[c] != nullptr)
+        {
+          PoolBlock *block = freeList[c];
+          freeList[c] = block->next;
+          ::operator delete (block);
+        }
+    }
+  PoolRegistry &registry = GetPoolRegistry ();
+  std::unique_lock lock {registry.mutex};
+  registry.caches.erase (std::find (registry.caches.begin (), registry.caches.end (), this));
+  registry.retired.allocations += allocations;
+  registry.retired.hits += hits;
+  t_poolCacheDestroyed = true;
+}
+
+/**
+ * Get the pool cache of the current thread.
+ * \returns The cache, or 0 if the thread is exiting.
+ */
+PoolCache *
+GetPoolCache (void)
+{
+  if (t_poolCacheDestroyed)
+    {
+      return nullptr;
+    }
+  thread_local PoolCache cache;
+  return &cache;
+}
+
+/**
+ * Add to a counter updated only by the current thread.
+ * \param [in,out] counter The counter.
+ * \param [in] value The value to add.
+ * \returns The new value.
+ */
+template <typename T>
+T
+AddOwned (std::atomic<T> &counter, T value)
+{
+  T result = counter.load (std::memory_order_relaxed) + value;
+  counter.store (result, std::memory_order_relaxed);
+  return result;
+}
+
+/**
+ * Add to the event memory in use, and update its peak.
+ * \param [in] bytes The bytes allocated, negative if freed.
+ */
+void
+AddPoolBytes (int64_t bytes)
+{
+  int64_t inUse = g_poolBytes.fetch_add (bytes, std::memory_order_relaxed) + bytes;
+  int64_t peak = g_poolPeakBytes.load (std::memory_order_relaxed);
+  while (inUse > peak
+         && !g_poolPeakBytes.compare_exchange_weak (peak, inUse, std::memory_order_relaxed))
+    {
+    }
+}
+
+} // unnamed namespace
+
+void *
+EventImpl::operator new (std::size_t size)
+{
+  std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+  std::size_t allocSize = size <= POOL_MAX_SIZE ? (sizeClass + 1) * POOL_GRANULARITY : size;
+  if (g_poolEnabled.load (std::memory_order_relaxed))
+    {
+      PoolCache *cache = GetPoolCache ();
+      if (cache != nullptr)
+        {
+          AddOwned<uint64_t> (cache->allocations, 1);
+          AddPoolBytes (size);
+          if (size <= POOL_MAX_SIZE && cache->freeList[sizeClass] != nullptr)
+            {
+              PoolBlock *block = cache->freeList[sizeClass];
+              cache->freeList[sizeClass] = block->next;
+              cache->freeCount[sizeClass]--;
+              AddOwned<uint64_t> (cache->hits, 1);
+              return block;
+            }
+        }
+    }
+  return ::operator new (allocSize);
+}
+
+void
+EventImpl::operator delete (void *ptr, std::size_t size)
+{
+  if (g_poolEnabled.load (std::memory_order_relaxed))
+    {
+      PoolCache *cache = GetPoolCache ();
+      if (cache != nullptr)
+        {
+          AddPoolBytes (-static_cast<int64_t> (size));
+          std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+          if (size <= POOL_MAX_SIZE && cache->freeCount[sizeClass] < POOL_MAX_FREE)
+            {
+              PoolBlock *block = static_cast<PoolBlock *> (ptr);
+              block->next = cache->freeList[sizeClass];
+              cache->freeList[sizeClass] = block;
+              cache->freeCount[sizeClass]++;
+              return;
+            }
+        }
+    }
+  ::operator delete (ptr);
+}
+
+void
+EventImpl::SetPoolEnabled (bool enabled)
+{
+  g_poolEnabled.store (enabled, std::memory_order_relaxed);
+}
+
+bool
+EventImpl::IsPoolEnabled (void)
+{
+  return g_poolEnabled.load (std::memory_order_relaxed);
+}
+
+EventImpl::PoolStats
+EventImpl::GetPoolStats (void)
+{
+  PoolRegistry &registry = GetPoolRegistry ();
+  std::unique_lock lock {registry.mutex};
+  PoolStats stats = registry.retired;
+  for (PoolCache *cache : registry.caches)
+    {
+      stats.allocations += cache->allocations.load (std::memory_order_relaxed);
+      stats.hits += cache->hits.load (std::memory_order_relaxed);
+    }
+  stats.bytes = g_poolBytes.load (std::memory_order_relaxed);
+  stats.peakBytes = g_poolPeakBytes.load (std::memory_order_relaxed);
+  return stats;
+}
+
+void
+EventImpl::ResetPoolStats (void)
+{
+  PoolRegistry &registry = GetPoolRegistry ();
+  std::unique_lock lock {registry.mutex};
+  registry.retired.allocations = 0;
+  registry.retired.hits = 0;
+  for (PoolCache *cache : registry.caches)
+    {
+      cache->allocations.store (0, std::memory_order_relaxed);
+      cache->hits.store (0, std::memory_order_relaxed);
+    }
+  // the events in use are still counted, so that the memory in use
+  // goes back to zero once they are freed
+  g_poolPeakBytes.store (g_poolBytes.load (std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 /**
@@ -40,6 +41,10 @@ namespace ns3 {
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * The events can be allocated from per-thread free lists, one per size
+ * class, rather than from the heap: see the
+ * \ref GlobalValueEventImplPool "EventImplPool" global value.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -66,6 +71,58 @@ public:
    */
   bool IsCancelled (void);
 
+  /**
+   * Allocate an event, from the free list of its size class if the
+   * pool is enabled.
+   * \param [in] size The size of the event.
+   * \returns The memory of the event.
+   */
+  static void * operator new (std::size_t size);
+  /**
+   * Free an event, keeping its memory in the free list of the current
+   * thread if the pool is enabled.
+   * \param [in] ptr The memory of the event.
+   * \param [in] size The size of the event.
+   */
+  static void operator delete (void *ptr, std::size_t size);
+
+  /** Counters of the event pool, updated while the pool is enabled. */
+  struct PoolStats
+  {
+    uint64_t allocations;  /**< Number of events allocated. */
+    uint64_t hits;         /**< Number of events taken from a free list. */
+    int64_t bytes;         /**< Event memory in use by all the threads, in bytes. */
+    int64_t peakBytes;     /**< Peak of the event memory in use by all the threads. */
+  };
+
+  /**
+   * Enable or disable the event pool.
+   *
+   * Called by the simulator with the value of the
+   * \ref GlobalValueEventImplPool "EventImplPool" global value when the
+   * simulator implementation is created. The events can be allocated and
+   * freed with different settings.
+   * \param [in] enabled Whether the events are allocated from the pool.
+   */
+  static void SetPoolEnabled (bool enabled);
+  /**
+   * \returns \c true if the events are allocated from the pool.
+   */
+  static bool IsPoolEnabled (void);
+  /**
+   * Get the counters of the event pool, summed over the threads. The
+   * memory in use is a single counter shared by the threads, so that an
+   * event freed by another thread than the one that allocated it is
+   * accounted for, and its peak is the peak of the sum.
+   * \returns The counters.
+   */
+  static PoolStats GetPoolStats (void);
+  /**
+   * Reset the event and hit counts, and the peak memory to the memory in
+   * use. Must not be called while other threads allocate events.
+   */
+  static void ResetPoolStats (void);
+
 protected:
   /**
    * Implementation for Invoke().
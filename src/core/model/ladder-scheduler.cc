@@ -0,0 +1,310 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "type-id.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+namespace {
+
+/**
+ * Add two time stamps, saturating at the largest one.
+ * \param [in] a The first time stamp.
+ * \param [in] b The second time stamp.
+ * \returns The sum.
+ */
+uint64_t
+SaturatingAdd (uint64_t a, uint64_t b)
+{
+  return (a > std::numeric_limits<uint64_t>::max () - b) ? std::numeric_limits<uint64_t>::max () : a + b;
+}
+
+} // unnamed namespace
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("BottomThreshold",
+                   "Maximum number of events moved at once to the sorted bottom "
+                   "of the ladder; larger buckets are split in a new rung",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (50),
+                   MakeUintegerAccessor (&LadderScheduler::m_bottomThreshold),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("MaxRungs",
+                   "Maximum number of rungs of the ladder",
+                   TypeId::ATTR_CONSTRUCT,
+                   UintegerValue (8),
+                   MakeUintegerAccessor (&LadderScheduler::m_maxRungs),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_topMin (std::numeric_limits<uint64_t>::max ()),
+    m_topMax (0),
+    m_topStart (0),
+    m_nRungs (0),
+    m_qSize (0),
+    m_bottomThreshold (50),
+    m_maxRungs (8)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+uint64_t
+LadderScheduler::GetRungCurrent (const Rung &rung)
+{
+  return rung.start + rung.current * rung.width;
+}
+
+uint32_t
+LadderScheduler::FindRung (uint64_t ts) const
+{
+  // the rungs cover consecutive spans, the earliest last
+  for (uint32_t i = 0; i < m_nRungs; i++)
+    {
+      if (ts >= GetRungCurrent (m_rungs[i]))
+        {
+          return i;
+        }
+    }
+  return m_nRungs;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (m_qSize == 0)
+    {
+      // start afresh: the event is the only one of the bottom
+      NS_ASSERT (m_top.empty () && m_bottom.empty ());
+      m_nRungs = 0;
+      m_topMin = std::numeric_limits<uint64_t>::max ();
+      m_topMax = 0;
+      m_topStart = SaturatingAdd (ts, 1);
+      m_bottom.push_back (ev);
+    }
+  else if (ts >= m_topStart)
+    {
+      m_top.push_back (ev);
+      m_topMin = std::min (m_topMin, ts);
+      m_topMax = std::max (m_topMax, ts);
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          rung.buckets[(ts - rung.start) / rung.width].push_back (ev);
+          rung.count++;
+        }
+      else
+        {
+          InsertBottom (ev);
+        }
+    }
+  m_qSize++;
+}
+
+void
+LadderScheduler::InsertBottom (const Event &ev)
+{
+  m_bottom.insert (std::upper_bound (m_bottom.begin (), m_bottom.end (), ev, std::greater<Event> ()), ev);
+}
+
+void
+LadderScheduler::SpawnRung (Bucket &events, uint64_t start, uint64_t span)
+{
+  NS_LOG_FUNCTION (this << events.size () << start << span);
+  NS_ASSERT (m_nRungs < m_maxRungs && span > 0);
+  if (m_nRungs == m_rungs.size ())
+    {
+      // the events may belong to a rung, do not move the rungs
+      NS_ASSERT (m_rungs.size () < m_rungs.capacity ());
+      m_rungs.emplace_back ();
+    }
+  Rung &rung = m_rungs[m_nRungs];
+  uint64_t nBuckets = std::max<uint64_t> (1, std::min<uint64_t> (events.size (), span));
+  rung.width = span / nBuckets + (span % nBuckets != 0);
+  rung.start = start;
+  rung.current = 0;
+  rung.count = events.size ();
+  rung.buckets.resize (span / rung.width + (span % rung.width != 0));
+  for (const Event &ev : events)
+    {
+      rung.buckets[(ev.key.m_ts - start) / rung.width].push_back (ev);
+    }
+  events.clear ();
+  m_nRungs++;
+  NS_LOG_DEBUG ("rung " << m_nRungs << ": " << rung.count << " events in "
+                        << rung.buckets.size () << " buckets of width " << rung.width);
+}
+
+void
+LadderScheduler::RefillBottom (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_bottom.empty () && m_qSize > 0);
+  if (m_rungs.capacity () < m_maxRungs)
+    {
+      m_rungs.reserve (m_maxRungs);
+    }
+  while (m_bottom.empty ())
+    {
+      if (m_nRungs == 0)
+        {
+          NS_ASSERT (!m_top.empty ());
+          uint64_t span = SaturatingAdd (m_topMax - m_topMin, 1);
+          SpawnRung (m_top, m_topMin, span);
+          m_topStart = SaturatingAdd (m_topMin, m_rungs[0].buckets.size () * m_rungs[0].width);
+          m_topMin = std::numeric_limits<uint64_t>::max ();
+          m_topMax = 0;
+        }
+      Rung &rung = m_rungs[m_nRungs - 1];
+      if (rung.count == 0)
+        {
+          m_nRungs--;
+          continue;
+        }
+      while (rung.buckets[rung.current].empty ())
+        {
+          rung.current++;
+        }
+      Bucket &bucket = rung.buckets[rung.current];
+      uint64_t bucketStart = GetRungCurrent (rung);
+      rung.current++;
+      rung.count -= bucket.size ();
+      if (bucket.size () > m_bottomThreshold && rung.width > 1 && m_nRungs < m_maxRungs)
+        {
+          SpawnRung (bucket, bucketStart, rung.width);
+        }
+      else
+        {
+          m_bottom.swap (bucket);
+          std::sort (m_bottom.begin (), m_bottom.end (), std::greater<Event> ());
+        }
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_qSize == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  return m_bottom.back ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event ev = m_bottom.back ();
+  m_bottom.pop_back ();
+  m_qSize--;
+  // keep the next event at the end of the bottom
+  if (m_bottom.empty () && m_qSize > 0)
+    {
+      RefillBottom ();
+    }
+  NS_LOG_DEBUG ("remove " << ev.impl << " at " << ev.key.m_ts);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  NS_ASSERT (!IsEmpty ());
+  uint64_t ts = ev.key.m_ts;
+  Bucket *events;
+  if (ts >= m_topStart)
+    {
+      events = &m_top;
+    }
+  else
+    {
+      uint32_t i = FindRung (ts);
+      if (i < m_nRungs)
+        {
+          Rung &rung = m_rungs[i];
+          events = &rung.buckets[(ts - rung.start) / rung.width];
+          rung.count--;
+        }
+      else
+        {
+          events = &m_bottom;
+        }
+    }
+  Bucket::iterator it = std::find (events->begin (), events->end (), ev);
+  NS_ASSERT (it != events->end ());
+  if (events == &m_bottom)
+    {
+      m_bottom.erase (it);
+    }
+  else
+    {
+      // the buckets and the top are not sorted
+      *it = events->back ();
+      events->pop_back ();
+    }
+  m_qSize--;
+  if (m_bottom.empty () && m_qSize > 0)
+    {
+      RefillBottom ();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler class declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler implements the ladder queue of
+ * ["Ladder Queue: An O(1) Priority Queue Structure for Large-Scale
+ * Discrete Event Simulation" by W. T. Tang, R. S. M. Goh and
+ * I. L.-J. Thng][Tang].
+ *
+ * [Tang]: https://doi.org/10.1145/1103323.1103324 "Tang"
+ *
+ * The events are kept in three tiers:
+ *   - Top: an unsorted vector of the events later than all the others,
+ *   - Ladder: up to MaxRungs rungs of buckets, each rung splitting one
+ *     bucket of the rung above in finer buckets,
+ *   - Bottom: a short vector of the earliest events, sorted in reverse
+ *     chronological order so that the next event is at its end.
+ *
+ * When the bottom is empty, the first non-empty bucket of the lowest rung
+ * is moved to it, or split in a new rung if it holds more than
+ * BottomThreshold events. When the ladder is empty, the top is moved to a
+ * new rung. The bucket width of a new rung is the span of its events
+ * divided by their number, which adapts the width to the event density:
+ * for instance, the events scheduled a few symbols ahead by the mmWave
+ * PHY and MAC end up in buckets about one symbol wide.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | ~Constant       | Append to top or bucket; sorted insertion in bottom
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | End of bottom
+ * Remove()     | Linear          | Search within top or bucket
+ * RemoveNext() | ~Constant       | End of bottom; moves events down the ladder
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | ~ 24 bytes per bucket            | `std::vector` buckets
+ * Per Event | 0                                | Events stored in `std::vector`
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  LadderScheduler ();
+  /** Destructor. */
+  virtual ~LadderScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /** Bucket type: an unsorted vector of Events. */
+  typedef std::vector<Scheduler::Event> Bucket;
+
+  /** A rung of the ladder. */
+  struct Rung
+  {
+    std::vector<Bucket> buckets;  /**< The buckets, in chronological order. */
+    uint64_t start;               /**< Time stamp of the first bucket. */
+    uint64_t width;               /**< Duration of a bucket. */
+    uint32_t current;             /**< First bucket not yet moved down. */
+    uint32_t count;               /**< Number of events in the buckets. */
+  };
+
+  /**
+   * Get the time stamp from which a rung accepts events.
+   * \param [in] rung The rung.
+   * \returns The time stamp of the first bucket not yet moved down.
+   */
+  static uint64_t GetRungCurrent (const Rung &rung);
+  /**
+   * Find the rung in which an event belongs.
+   * \param [in] ts The time stamp of the event.
+   * \returns The index of the rung, or the number of rungs if the event
+   *          belongs to the bottom.
+   */
+  uint32_t FindRung (uint64_t ts) const;
+  /**
+   * Add a rung below the others, and move events into it.
+   * \param [in,out] events The events, all in [start, start + span).
+   * \param [in] start The start of the span of the rung.
+   * \param [in] span The span of the rung, at least 1.
+   */
+  void SpawnRung (Bucket &events, uint64_t start, uint64_t span);
+  /** Move the earliest events to the bottom, which must be empty. */
+  void RefillBottom (void);
+  /**
+   * Insert an event in the bottom, keeping it sorted.
+   * \param [in] ev The event.
+   */
+  void InsertBottom (const Scheduler::Event &ev);
+
+  /** Events later than all the rungs. */
+  Bucket m_top;
+  /** Earliest time stamp in the top. */
+  uint64_t m_topMin;
+  /** Latest time stamp in the top. */
+  uint64_t m_topMax;
+  /** Events at or after this time stamp go to the top. */
+  uint64_t m_topStart;
+  /**
+   * The rungs, the earliest last. The rungs up to m_nRungs are in use,
+   * the others are kept to reuse their buckets.
+   */
+  std::vector<Rung> m_rungs;
+  /** Number of rungs in use. */
+  uint32_t m_nRungs;
+  /** Earliest events, sorted in reverse chronological order. */
+  Bucket m_bottom;
+  /** Number of events in queue. */
+  uint32_t m_qSize;
+  /** Buckets larger than this are split in a new rung. */
+  uint32_t m_bottomThreshold;
+  /** Maximum number of rungs. */
+  uint32_t m_maxRungs;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -0,0 +1,249 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include "assert.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::MpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Bounded lock-free queue with many producers and a single consumer
+ *
+ * The queue is a ring of pre-allocated slots, each tagged with a sequence
+ * number that tells whether the slot is free for the producer of a given
+ * position or holds an item for the consumer (D. Vyukov's bounded queue).
+ * A producer claims a position with a single compare-and-swap and never
+ * waits for the other producers; Push fails instead of blocking when the
+ * queue is full. The items pushed by one thread are popped in the order in
+ * which they were pushed.
+ *
+ * Push and GetPushPosition can be called by any thread, Pop and IsEmpty
+ * only by the consumer.
+ *
+ * \tparam T \explicit The item type, which must be default constructible
+ *         and copy assignable.
+ */
+template <typename T>
+class MpscQueue
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] capacity The minimum number of items the queue can hold,
+   *             rounded up to a power of two.
+   */
+  explicit MpscQueue (std::size_t capacity);
+
+  /**
+   * Append an item.
+   * \param [in] item The item.
+   * \returns \c false if the queue is full.
+   */
+  bool Push (const T &item);
+
+  /**
+   * Remove the oldest item.
+   * \param [out] item The item removed.
+   * \returns \c false if the queue is empty.
+   */
+  bool Pop (T &item);
+
+  /**
+   * Remove the oldest item, if its position is before \p end. All these
+   * positions have been claimed by a Push, thus if the producer has not
+   * stored the item yet, wait for it.
+   * \param [out] item The item removed.
+   * \param [in] end A position returned by GetPushPosition.
+   * \returns \c false if all the items before \p end have been removed.
+   */
+  bool Pop (T &item, std::size_t end);
+
+  /**
+   * Check if there is an item to pop.
+   * \returns \c true if Pop would fail.
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * Get the position that the next Push will claim. The items pushed
+   * before a call are at earlier positions; the items pushed by a thread
+   * after it has seen a value stored after the call are at this position
+   * or after it.
+   * \returns The position.
+   */
+  std::size_t GetPushPosition (void) const;
+
+  /**
+   * Get the number of slots.
+   * \returns The capacity of the queue.
+   */
+  std::size_t GetCapacity (void) const;
+
+private:
+  /** A slot of the ring. */
+  struct Slot
+  {
+    /**
+     * Position for which the slot can be pushed to, or position plus one
+     * once it holds the item to pop.
+     */
+    std::atomic<std::size_t> sequence;
+    /** The item. */
+    T item;
+  };
+
+  /** The slots. */
+  std::unique_ptr<Slot[]> m_slots;
+  /** Capacity minus one, to map a position to its slot. */
+  std::size_t m_mask;
+  /** Next position to push to, shared by the producers. */
+  alignas (64) std::atomic<std::size_t> m_head;
+  /** Next position to pop from, used by the consumer only. */
+  alignas (64) std::size_t m_tail;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+MpscQueue<T>::MpscQueue (std::size_t capacity)
+  : m_head (0),
+    m_tail (0)
+{
+  NS_ASSERT (capacity > 0);
+  std::size_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_slots.reset (new Slot[size]);
+  m_mask = size - 1;
+  for (std::size_t i = 0; i < size; i++)
+    {
+      m_slots[i].sequence.store (i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Push (const T &item)
+{
+  std::size_t pos = m_head.load (std::memory_order_relaxed);
+  Slot *slot;
+  while (true)
+    {
+      slot = &m_slots[pos & m_mask];
+      std::size_t sequence = slot->sequence.load (std::memory_order_acquire);
+      std::ptrdiff_t diff = static_cast<std::ptrdiff_t> (sequence) - static_cast<std::ptrdiff_t> (pos);
+      if (diff == 0)
+        {
+          // the slot is free for this position: claim it
+          if (m_head.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+            {
+              break;
+            }
+        }
+      else if (diff < 0)
+        {
+          // the consumer has not popped the item of the previous lap yet
+          return false;
+        }
+      else
+        {
+          // another producer claimed the position first
+          pos = m_head.load (std::memory_order_relaxed);
+        }
+    }
+  slot->item = item;
+  slot->sequence.store (pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &item)
+{
+  Slot &slot = m_slots[m_tail & m_mask];
+  if (slot.sequence.load (std::memory_order_acquire) != m_tail + 1)
+    {
+      return false;
+    }
+  item = slot.item;
+  // free the slot for the position of the next lap
+  slot.sequence.store (m_tail + m_mask + 1, std::memory_order_release);
+  m_tail++;
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::Pop (T &item, std::size_t end)
+{
+  if (static_cast<std::ptrdiff_t> (end - m_tail) <= 0)
+    {
+      return false;
+    }
+  while (!Pop (item))
+    {
+      // the producer is between the claim of the position and the store
+      std::this_thread::yield ();
+    }
+  return true;
+}
+
+template <typename T>
+bool
+MpscQueue<T>::IsEmpty (void) const
+{
+  return m_slots[m_tail & m_mask].sequence.load (std::memory_order_acquire) != m_tail + 1;
+}
+
+template <typename T>
+std::size_t
+MpscQueue<T>::GetPushPosition (void) const
+{
+  return m_head.load (std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t
+MpscQueue<T>::GetCapacity (void) const
+{
+  return m_mask + 1;
+}
+
+} // namespace ns3
+
+#endif /* MPSC_QUEUE_H */
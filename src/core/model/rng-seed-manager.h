@@ -105,6 +105,12 @@ public:
    */
   static uint64_t GetNextStreamIndex (void);
 
+  /**
+   * Resets the global stream index counter, so that the simulations run
+   * one after the other in the same program draw the same streams.
+   */
+  static void ResetNextStreamIndex (void);
+
 };
 
 /** Alias for compatibility. */
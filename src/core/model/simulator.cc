@@ -27,6 +27,7 @@
 
 #include "ptr.h"
 #include "string.h"
+#include "boolean.h"
 #include "object-factory.h"
 #include "global-value.h"
 #include "assert.h"
@@ -78,6 +79,20 @@ static GlobalValue g_schedTypeImpl = GlobalValue ("SchedulerType",
                                                   TypeIdValue (MapScheduler::GetTypeId ()),
                                                   MakeTypeIdChecker ());
 
+/**
+ * \ingroup simulator
+ * \anchor GlobalValueEventImplPool
+ * Whether the events are allocated from per-thread free lists.
+ *
+ * Read when the simulator implementation is created.
+ * \see EventImpl::GetPoolStats()
+ */
+static GlobalValue g_eventImplPool = GlobalValue ("EventImplPool",
+                                                  "Whether the events are allocated from per-thread free lists "
+                                                  "of recycled events rather than from the heap",
+                                                  BooleanValue (false),
+                                                  MakeBooleanChecker ());
+
 /**
  * \ingroup simulator
  * \brief Get the static SimulatorImpl instance.
@@ -118,6 +133,11 @@ static SimulatorImpl * GetImpl (void)
         factory.SetTypeId (s.Get ());
         (*pimpl)->SetScheduler (factory);
       }
+      {
+        BooleanValue pool;
+        g_eventImplPool.GetValue (pool);
+        EventImpl::SetPoolEnabled (pool.Get ());
+      }
 
 //
 // Note: we call LogSetTimePrinter _after_ creating the implementation
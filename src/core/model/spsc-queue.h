@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include "assert.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::SpscQueue declaration and template implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Bounded lock-free queue with a single producer and a single consumer
+ *
+ * The queue is a ring of pre-allocated items indexed by two counters: the
+ * producer owns the head and the consumer the tail. Each side keeps a copy
+ * of the counter of the other side and only reloads it when the ring looks
+ * full or empty, so that in the common case Push and Pop touch a single
+ * shared cache line. Push fails instead of blocking when the queue is full.
+ *
+ * Push can only be called by the producer, Pop and IsEmpty only by the
+ * consumer; GetSize can be called by both.
+ *
+ * \tparam T \explicit The item type, which must be default constructible
+ *         and copy assignable.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] capacity The minimum number of items the queue can hold,
+   *             rounded up to a power of two.
+   */
+  explicit SpscQueue (std::size_t capacity);
+
+  /**
+   * Append an item.
+   * \param [in] item The item.
+   * \returns \c false if the queue is full.
+   */
+  bool Push (const T &item);
+
+  /**
+   * Remove the oldest item.
+   * \param [out] item The item removed.
+   * \returns \c false if the queue is empty.
+   */
+  bool Pop (T &item);
+
+  /**
+   * Check if there is an item to pop.
+   * \returns \c true if Pop would fail.
+   */
+  bool IsEmpty (void) const;
+
+  /**
+   * Get the number of items in the queue, which may already be out of date
+   * when it is returned.
+   * \returns The number of items.
+   */
+  std::size_t GetSize (void) const;
+
+  /**
+   * Get the number of slots.
+   * \returns The capacity of the queue.
+   */
+  std::size_t GetCapacity (void) const;
+
+private:
+  /** The items. */
+  std::unique_ptr<T[]> m_items;
+  /** Capacity minus one, to map a position to its item. */
+  std::size_t m_mask;
+  /** Next position to push to, written by the producer. */
+  alignas (64) std::atomic<std::size_t> m_head;
+  /** Copy of the tail, used by the producer only. */
+  std::size_t m_tailCache;
+  /** Next position to pop from, written by the consumer. */
+  alignas (64) std::atomic<std::size_t> m_tail;
+  /** Copy of the head, used by the consumer only. */
+  std::size_t m_headCache;
+};
+
+} // namespace ns3
+
+
+/********************************************************************
+ *  Implementation of the templates declared above.
+ ********************************************************************/
+
+namespace ns3 {
+
+template <typename T>
+SpscQueue<T>::SpscQueue (std::size_t capacity)
+  : m_head (0),
+    m_tailCache (0),
+    m_tail (0),
+    m_headCache (0)
+{
+  NS_ASSERT (capacity > 0);
+  std::size_t size = 1;
+  while (size < capacity)
+    {
+      size <<= 1;
+    }
+  m_items.reset (new T[size]);
+  m_mask = size - 1;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::Push (const T &item)
+{
+  std::size_t head = m_head.load (std::memory_order_relaxed);
+  if (head - m_tailCache > m_mask)
+    {
+      m_tailCache = m_tail.load (std::memory_order_acquire);
+      if (head - m_tailCache > m_mask)
+        {
+          return false;
+        }
+    }
+  m_items[head & m_mask] = item;
+  m_head.store (head + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::Pop (T &item)
+{
+  std::size_t tail = m_tail.load (std::memory_order_relaxed);
+  if (tail == m_headCache)
+    {
+      m_headCache = m_head.load (std::memory_order_acquire);
+      if (tail == m_headCache)
+        {
+          return false;
+        }
+    }
+  item = m_items[tail & m_mask];
+  // free the item for the producer
+  m_tail.store (tail + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+bool
+SpscQueue<T>::IsEmpty (void) const
+{
+  return m_tail.load (std::memory_order_relaxed) == m_head.load (std::memory_order_acquire);
+}
+
+template <typename T>
+std::size_t
+SpscQueue<T>::GetSize (void) const
+{
+  std::size_t tail = m_tail.load (std::memory_order_acquire);
+  std::size_t head = m_head.load (std::memory_order_acquire);
+  // the tail read first can only be behind the head
+  return head - tail;
+}
+
+template <typename T>
+std::size_t
+SpscQueue<T>::GetCapacity (void) const
+{
+  return m_mask + 1;
+}
+
+} // namespace ns3
+
+#endif /* SPSC_QUEUE_H */
@@ -0,0 +1,386 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/event-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/make-event.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup event-impl-pool-tests
+ * EventImpl pool test suite and benchmark.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup event-impl-pool-tests EventImpl pool tests
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief Schedule chains of events of different sizes.
+ */
+class EventImplPoolChains
+{
+public:
+  /**
+   * Start the chains.
+   * \param [in] chains The number of chains.
+   * \param [in] length The number of events of each chain.
+   */
+  EventImplPoolChains (uint32_t chains, uint32_t length);
+
+  /** \returns The number of events run. */
+  uint64_t GetEvents (void) const;
+
+private:
+  /**
+   * Small event, scheduling the next one of the chain.
+   * \param [in] left The number of events left in the chain.
+   */
+  void Small (uint32_t left);
+  /**
+   * Large event, scheduling the next one of the chain.
+   * \param [in] left The number of events left in the chain.
+   * \param [in] a Unused payload.
+   * \param [in] b Unused payload.
+   * \param [in] c Unused payload.
+   */
+  void Large (uint32_t left, uint64_t a, uint64_t b, uint64_t c);
+
+  /** Number of events run. */
+  uint64_t m_events;
+};
+
+EventImplPoolChains::EventImplPoolChains (uint32_t chains, uint32_t length)
+  : m_events (0)
+{
+  for (uint32_t i = 0; i < chains; i++)
+    {
+      Simulator::Schedule (NanoSeconds (i), &EventImplPoolChains::Small, this, length);
+    }
+}
+
+uint64_t
+EventImplPoolChains::GetEvents (void) const
+{
+  return m_events;
+}
+
+void
+EventImplPoolChains::Small (uint32_t left)
+{
+  m_events++;
+  if (left > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &EventImplPoolChains::Large, this, left - 1, 1, 2, 3);
+    }
+}
+
+void
+EventImplPoolChains::Large (uint32_t left, uint64_t a, uint64_t b, uint64_t c)
+{
+  m_events++;
+  if (left > 0)
+    {
+      Simulator::Schedule (MicroSeconds (1), &EventImplPoolChains::Small, this, left - 1);
+    }
+}
+
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief Check the counters of the event pool.
+ */
+class EventImplPoolCountersTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EventImplPoolCountersTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventImplPoolCountersTestCase::EventImplPoolCountersTestCase ()
+  : TestCase ("Check the hit rate and the memory counters of the event pool")
+{}
+
+void
+EventImplPoolCountersTestCase::DoRun (void)
+{
+  Config::SetGlobal ("EventImplPool", BooleanValue (true));
+  // the global value is read when the simulator is created, which
+  // happens after the allocation of the first event
+  Simulator::Now ();
+  EventImpl::ResetPoolStats ();
+  int64_t bytes = EventImpl::GetPoolStats ().bytes;
+
+  EventImplPoolChains chains (100, 1000);
+  NS_TEST_ASSERT_MSG_EQ (EventImpl::IsPoolEnabled (), true, "The pool must be enabled by the global value");
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  EventImpl::PoolStats stats = EventImpl::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (chains.GetEvents (), 100 * 1001, "All the events must run");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (stats.allocations, chains.GetEvents (), "All the events must be counted");
+  // only the first events of each size must come from the heap
+  NS_TEST_ASSERT_MSG_GT (stats.hits, stats.allocations * 9 / 10, "The hit rate must be above 90%");
+  NS_TEST_ASSERT_MSG_EQ (stats.bytes, bytes, "All the events must be freed");
+  NS_TEST_ASSERT_MSG_GT (stats.peakBytes, bytes, "The peak memory must account for the events");
+
+  Config::SetGlobal ("EventImplPool", BooleanValue (false));
+  EventImpl::SetPoolEnabled (false);
+}
+
+
+/** Event function that does nothing. */
+void
+EventImplPoolNoop (void)
+{}
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief Check the memory counters with events allocated by several
+ * threads, and freed by another one.
+ */
+class EventImplPoolThreadsTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EventImplPoolThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventImplPoolThreadsTestCase::EventImplPoolThreadsTestCase ()
+  : TestCase ("Check the memory counters of the event pool with several threads")
+{}
+
+void
+EventImplPoolThreadsTestCase::DoRun (void)
+{
+  const uint32_t threads = 4;
+  const uint32_t events = 1000;
+  EventImpl::SetPoolEnabled (true);
+  EventImpl::ResetPoolStats ();
+  int64_t bytes = EventImpl::GetPoolStats ().bytes;
+
+  // each thread holds its events until all the threads have allocated theirs
+  std::vector<std::vector<EventImpl *> > allocated (threads);
+  std::atomic<uint32_t> ready {0};
+  std::vector<std::thread> workers;
+  for (uint32_t t = 0; t < threads; t++)
+    {
+      workers.emplace_back ([&allocated, &ready, t, events, threads] ()
+        {
+          for (uint32_t i = 0; i < events; i++)
+            {
+              allocated[t].push_back (MakeEvent (&EventImplPoolNoop));
+            }
+          ready++;
+          while (ready.load () < threads)
+            {
+              std::this_thread::yield ();
+            }
+        });
+    }
+  for (std::thread &worker : workers)
+    {
+      worker.join ();
+    }
+
+  EventImpl::PoolStats stats = EventImpl::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_GT (stats.bytes, bytes, "The memory in use must account for the events of all the threads");
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (stats.peakBytes, stats.bytes, "The peak memory must be the peak of the sum over the threads");
+
+  // free the events in this thread
+  for (std::vector<EventImpl *> &threadEvents : allocated)
+    {
+      for (EventImpl *event : threadEvents)
+        {
+          event->Unref ();
+        }
+    }
+  stats = EventImpl::GetPoolStats ();
+  NS_TEST_ASSERT_MSG_EQ (stats.bytes, bytes, "The events freed by another thread must be counted");
+
+  EventImpl::SetPoolEnabled (false);
+}
+
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief Check that the pool can be toggled while events are pending.
+ */
+class EventImplPoolToggleTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EventImplPoolToggleTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EventImplPoolToggleTestCase::EventImplPoolToggleTestCase ()
+  : TestCase ("Check that the event pool can be toggled while events are pending")
+{}
+
+void
+EventImplPoolToggleTestCase::DoRun (void)
+{
+  EventImplPoolChains chains (100, 1000);
+  for (uint32_t i = 1; i < 10; i++)
+    {
+      Simulator::Schedule (MicroSeconds (100 * i), &EventImpl::SetPoolEnabled, i % 2 == 1);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (chains.GetEvents (), 100 * 1001, "All the events must run");
+  EventImpl::SetPoolEnabled (false);
+}
+
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief Compare the time to schedule and run events with and without the
+ * event pool.
+ *
+ * The times are printed on the standard output.
+ */
+class EventImplPoolBenchmarkTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  EventImplPoolBenchmarkTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Schedule and run the events.
+   * \param [in] pool Whether the pool is enabled.
+   * \returns The time in seconds.
+   */
+  double Run (bool pool);
+};
+
+EventImplPoolBenchmarkTestCase::EventImplPoolBenchmarkTestCase ()
+  : TestCase ("Schedule and run events with and without the event pool")
+{}
+
+double
+EventImplPoolBenchmarkTestCase::Run (bool pool)
+{
+  Config::SetGlobal ("EventImplPool", BooleanValue (pool));
+  Simulator::Now ();
+  auto begin = std::chrono::steady_clock::now ();
+  EventImplPoolChains chains (1000, 2000);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - begin;
+  NS_TEST_EXPECT_MSG_EQ (chains.GetEvents (), 1000 * 2001, "All the events must run");
+  return elapsed.count () / chains.GetEvents ();
+}
+
+void
+EventImplPoolBenchmarkTestCase::DoRun (void)
+{
+  double heapTime = Run (false);
+  EventImpl::ResetPoolStats ();
+  double poolTime = Run (true);
+  EventImpl::PoolStats stats = EventImpl::GetPoolStats ();
+  Config::SetGlobal ("EventImplPool", BooleanValue (false));
+  EventImpl::SetPoolEnabled (false);
+
+  std::cout << std::fixed << std::setprecision (1)
+            << "heap " << heapTime * 1e9 << " ns/event"
+            << " pool " << poolTime * 1e9 << " ns/event"
+            << " hit rate " << 100.0 * stats.hits / stats.allocations << "%"
+            << " peak " << stats.peakBytes << " bytes" << std::endl;
+}
+
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief The EventImpl pool test suite.
+ */
+class EventImplPoolTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  EventImplPoolTestSuite ()
+    : TestSuite ("event-impl-pool")
+  {
+    AddTestCase (new EventImplPoolCountersTestCase (), TestCase::QUICK);
+    AddTestCase (new EventImplPoolThreadsTestCase (), TestCase::QUICK);
+    AddTestCase (new EventImplPoolToggleTestCase (), TestCase::QUICK);
+  }
+};
+
+/**
+ * \ingroup event-impl-pool-tests
+ *
+ * \brief The EventImpl pool benchmark.
+ */
+class EventImplPoolBenchmarkTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  EventImplPoolBenchmarkTestSuite ()
+    : TestSuite ("event-impl-pool-benchmark", PERFORMANCE)
+  {
+    AddTestCase (new EventImplPoolBenchmarkTestCase (), TestCase::QUICK);
+  }
+};
+
+/**
+ * \ingroup event-impl-pool-tests
+ * EventImplPoolTestSuite instance variable.
+ */
+static EventImplPoolTestSuite g_eventImplPoolTestSuite;
+/**
+ * \ingroup event-impl-pool-tests
+ * EventImplPoolBenchmarkTestSuite instance variable.
+ */
+static EventImplPoolBenchmarkTestSuite g_eventImplPoolBenchmarkTestSuite;
+
+}    // namespace tests
+
+}  // namespace ns3
@@ -0,0 +1,494 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/mpsc-queue.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mpsc-queue-tests
+ * MpscQueue test suite and contention benchmark.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup mpsc-queue-tests MpscQueue tests
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Check push, pop and wrap around with a single thread.
+ */
+class MpscQueueSingleThreadTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  MpscQueueSingleThreadTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MpscQueueSingleThreadTestCase::MpscQueueSingleThreadTestCase ()
+  : TestCase ("Check push, pop and wrap around with a single thread")
+{}
+
+void
+MpscQueueSingleThreadTestCase::DoRun (void)
+{
+  MpscQueue<uint32_t> queue (5);
+  NS_TEST_ASSERT_MSG_EQ (queue.GetCapacity (), 8, "The capacity must be rounded up to a power of two");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "The queue must start empty");
+
+  uint32_t item;
+  NS_TEST_ASSERT_MSG_EQ (queue.Pop (item), false, "Pop must fail on an empty queue");
+
+  uint32_t next = 0;
+  uint32_t expected = 0;
+  for (uint32_t lap = 0; lap < 3; lap++)
+    {
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.Push (next++), true, "Push must succeed until the queue is full");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.Push (next), false, "Push must fail on a full queue");
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.Pop (item), true, "Pop must succeed on a non-empty queue");
+          NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+        }
+      while (queue.Pop (item))
+        {
+          NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "The queue must be empty after popping all the items");
+    }
+  NS_TEST_ASSERT_MSG_EQ (expected, next, "All the items must be popped");
+
+  // only the items pushed before GetPushPosition are popped up to it
+  for (uint32_t i = 0; i < 3; i++)
+    {
+      queue.Push (next++);
+    }
+  std::size_t end = queue.GetPushPosition ();
+  for (uint32_t i = 0; i < 2; i++)
+    {
+      queue.Push (next++);
+    }
+  while (queue.Pop (item, end))
+    {
+      NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+    }
+  NS_TEST_ASSERT_MSG_EQ (expected, next - 2, "The items before the position must be popped");
+  while (queue.Pop (item))
+    {
+      NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+    }
+  NS_TEST_ASSERT_MSG_EQ (expected, next, "All the items must be popped");
+}
+
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Check that the items of each producer are popped once and in order.
+ */
+class MpscQueueProducersTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] producers The number of producer threads.
+   */
+  MpscQueueProducersTestCase (uint32_t producers);
+
+private:
+  virtual void DoRun (void);
+
+  /** Number of producer threads. */
+  uint32_t m_producers;
+};
+
+MpscQueueProducersTestCase::MpscQueueProducersTestCase (uint32_t producers)
+  : TestCase ("Check the order of the items with " + std::to_string (producers) + " producers"),
+    m_producers (producers)
+{}
+
+void
+MpscQueueProducersTestCase::DoRun (void)
+{
+  const uint32_t itemsPerProducer = 100000;
+  // small queue, to exercise the full queue case
+  MpscQueue<uint64_t> queue (64);
+
+  std::vector<std::thread> threads;
+  for (uint32_t p = 0; p < m_producers; p++)
+    {
+      threads.emplace_back ([&queue, p, itemsPerProducer] ()
+        {
+          for (uint32_t i = 0; i < itemsPerProducer; i++)
+            {
+              while (!queue.Push ((static_cast<uint64_t> (p) << 32) | i))
+                {
+                  std::this_thread::yield ();
+                }
+            }
+        });
+    }
+
+  std::vector<uint32_t> next (m_producers, 0);
+  uint64_t popped = 0;
+  bool ordered = true;
+  uint64_t item;
+  while (popped < static_cast<uint64_t> (m_producers) * itemsPerProducer)
+    {
+      if (!queue.Pop (item))
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      uint32_t p = item >> 32;
+      ordered = ordered && (p < m_producers) && ((item & 0xffffffff) == next[p]);
+      if (p < m_producers)
+        {
+          next[p]++;
+        }
+      popped++;
+    }
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (ordered, true, "The items of a producer must be popped in order");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "No item must be left");
+}
+
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Check the order of the events scheduled by other threads when they
+ * do not fit in the lock-free queue of DefaultSimulatorImpl.
+ *
+ * The threads overflow the queue many times, while the main thread drains
+ * it, so that some threads push to the queue while others append to the
+ * overflow list.
+ */
+class MpscQueueSimulatorTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] threads The number of scheduling threads.
+   */
+  MpscQueueSimulatorTestCase (uint32_t threads);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Event scheduled by the threads.
+   * \param [in] thread The index of the thread.
+   * \param [in] seq The sequence number of the event in the thread.
+   */
+  void Receive (uint32_t thread, uint32_t seq);
+
+  /** Stop the simulation once all the events have been received. */
+  void Poll (void);
+
+  /** Number of events scheduled by each thread. */
+  static const uint32_t EVENTS = 20000;
+
+  /** Number of scheduling threads. */
+  uint32_t m_threads;
+  /** Next sequence number expected from each thread. */
+  std::vector<uint32_t> m_next;
+  /** Time of the last event received from each thread. */
+  std::vector<Time> m_last;
+  /** Number of events received. */
+  uint32_t m_received;
+  /** Whether the events of each thread were received in order. */
+  bool m_ordered;
+};
+
+MpscQueueSimulatorTestCase::MpscQueueSimulatorTestCase (uint32_t threads)
+  : TestCase ("Check the order of the events scheduled with context by " + std::to_string (threads) + " threads"),
+    m_threads (threads)
+{}
+
+void
+MpscQueueSimulatorTestCase::Receive (uint32_t thread, uint32_t seq)
+{
+  // an event scheduled later by the same thread must not run earlier, nor
+  // at a later time step, since all of them have a null delay
+  m_ordered = m_ordered && (seq == m_next[thread]) && (Simulator::Now () >= m_last[thread]);
+  m_next[thread] = seq + 1;
+  m_last[thread] = Simulator::Now ();
+  m_received++;
+}
+
+void
+MpscQueueSimulatorTestCase::Poll (void)
+{
+  if (m_received == m_threads * EVENTS)
+    {
+      Simulator::Stop ();
+      return;
+    }
+  Simulator::Schedule (MicroSeconds (1), &MpscQueueSimulatorTestCase::Poll, this);
+}
+
+void
+MpscQueueSimulatorTestCase::DoRun (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+  m_next.assign (m_threads, 0);
+  m_last.assign (m_threads, Seconds (0));
+  m_received = 0;
+  m_ordered = true;
+
+  // the threads start once the simulator has been created
+  Simulator::Schedule (MicroSeconds (1), &MpscQueueSimulatorTestCase::Poll, this);
+  std::vector<std::thread> threads;
+  for (uint32_t t = 0; t < m_threads; t++)
+    {
+      threads.emplace_back ([this, t] ()
+        {
+          // more events than the slots of the queue, so that some of
+          // them go through the overflow list
+          for (uint32_t i = 0; i < EVENTS; i++)
+            {
+              Simulator::ScheduleWithContext (t, Seconds (0),
+                                              &MpscQueueSimulatorTestCase::Receive, this, t, i);
+            }
+        });
+    }
+  Simulator::Run ();
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_received, m_threads * EVENTS, "All the events must be received");
+  NS_TEST_ASSERT_MSG_EQ (m_ordered, true, "The events of a thread must be received in order");
+}
+
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief Compare the throughput of MpscQueue and of a list protected by a
+ * mutex, with several producers and a consumer draining concurrently.
+ *
+ * The times are printed on the standard output.
+ */
+class MpscQueueContentionTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param [in] producers The number of producer threads.
+   */
+  MpscQueueContentionTestCase (uint32_t producers);
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Push items from the producers and drain them with the consumer.
+   * \param [in] push Function pushing an item, returning \c false if full.
+   * \param [in] drain Function popping all the available items,
+   *             returning their number.
+   * \returns The time in seconds.
+   */
+  template <typename Push, typename Drain>
+  double Run (Push push, Drain drain);
+
+  /** Number of producer threads. */
+  uint32_t m_producers;
+  /** Number of items pushed by each producer. */
+  static const uint32_t ITEMS = 200000;
+};
+
+MpscQueueContentionTestCase::MpscQueueContentionTestCase (uint32_t producers)
+  : TestCase ("Contention benchmark with " + std::to_string (producers) + " producers"),
+    m_producers (producers)
+{}
+
+template <typename Push, typename Drain>
+double
+MpscQueueContentionTestCase::Run (Push push, Drain drain)
+{
+  std::atomic<bool> start {false};
+  std::vector<std::thread> threads;
+  for (uint32_t p = 0; p < m_producers; p++)
+    {
+      threads.emplace_back ([&push, &start] ()
+        {
+          while (!start)
+            {
+              std::this_thread::yield ();
+            }
+          for (uint32_t i = 0; i < ITEMS; i++)
+            {
+              while (!push (i))
+                {
+                  std::this_thread::yield ();
+                }
+            }
+        });
+    }
+
+  auto begin = std::chrono::steady_clock::now ();
+  start = true;
+  uint64_t popped = 0;
+  while (popped < static_cast<uint64_t> (m_producers) * ITEMS)
+    {
+      uint64_t n = drain ();
+      if (n == 0)
+        {
+          std::this_thread::yield ();
+        }
+      popped += n;
+    }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now () - begin;
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (popped, static_cast<uint64_t> (m_producers) * ITEMS, "All the items must be popped");
+  return elapsed.count ();
+}
+
+void
+MpscQueueContentionTestCase::DoRun (void)
+{
+  MpscQueue<uint32_t> queue (1024);
+  double queueTime = Run ([&queue] (uint32_t item)
+                          {
+                            return queue.Push (item);
+                          },
+                          [&queue] ()
+                          {
+                            uint64_t n = 0;
+                            uint32_t item;
+                            while (queue.Pop (item))
+                              {
+                                n++;
+                              }
+                            return n;
+                          });
+
+  // the scheme used before by DefaultSimulatorImpl
+  std::mutex mutex;
+  std::list<uint32_t> list;
+  double listTime = Run ([&mutex, &list] (uint32_t item)
+                         {
+                           std::unique_lock lock {mutex};
+                           list.push_back (item);
+                           return true;
+                         },
+                         [&mutex, &list] ()
+                         {
+                           std::list<uint32_t> items;
+                           {
+                             std::unique_lock lock {mutex};
+                             list.swap (items);
+                           }
+                           return static_cast<uint64_t> (items.size ());
+                         });
+
+  double items = static_cast<double> (m_producers) * ITEMS;
+  std::cout << std::fixed << std::setprecision (1)
+            << "producers " << m_producers
+            << " mpsc-queue " << queueTime * 1e9 / items << " ns/item"
+            << " mutex-list " << listTime * 1e9 / items << " ns/item" << std::endl;
+}
+
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief The MpscQueue test suite.
+ */
+class MpscQueueTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  MpscQueueTestSuite ()
+    : TestSuite ("mpsc-queue")
+  {
+    AddTestCase (new MpscQueueSingleThreadTestCase (), TestCase::QUICK);
+    AddTestCase (new MpscQueueProducersTestCase (1), TestCase::QUICK);
+    AddTestCase (new MpscQueueProducersTestCase (4), TestCase::QUICK);
+    AddTestCase (new MpscQueueSimulatorTestCase (4), TestCase::QUICK);
+    AddTestCase (new MpscQueueSimulatorTestCase (16), TestCase::QUICK);
+  }
+};
+
+/**
+ * \ingroup mpsc-queue-tests
+ *
+ * \brief The MpscQueue contention benchmark.
+ */
+class MpscQueueContentionTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  MpscQueueContentionTestSuite ()
+    : TestSuite ("mpsc-queue-contention", PERFORMANCE)
+  {
+    for (uint32_t producers : {1, 2, 4, 8})
+      {
+        AddTestCase (new MpscQueueContentionTestCase (producers), TestCase::QUICK);
+      }
+  }
+};
+
+/**
+ * \ingroup mpsc-queue-tests
+ * MpscQueueTestSuite instance variable.
+ */
+static MpscQueueTestSuite g_mpscQueueTestSuite;
+/**
+ * \ingroup mpsc-queue-tests
+ * MpscQueueContentionTestSuite instance variable.
+ */
+static MpscQueueContentionTestSuite g_mpscQueueContentionTestSuite;
+
+}    // namespace tests
+
+}  // namespace ns3
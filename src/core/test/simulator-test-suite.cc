@@ -24,6 +24,12 @@
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
 
 using namespace ns3;
 
@@ -531,6 +537,217 @@ SimulatorTemplateTestCase::DoRun (void)
 }
 
 
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the LadderScheduler returns the events in the same
+ * order as the MapScheduler.
+ *
+ * Bursts of events, many of them at the same time stamps, spread over a
+ * wide span or after all the others, are inserted, then Insert, Remove and
+ * RemoveNext are interleaved at random. With a small BottomThreshold, the
+ * bursts are split in nested rungs, and the events removed at random are
+ * in the top, in the rungs or in the bottom.
+ */
+class LadderSchedulerDifferentialTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor.
+   * \param bottomThreshold The BottomThreshold of the LadderScheduler.
+   * \param maxRungs The MaxRungs of the LadderScheduler.
+   * \param seed The seed of the random operations.
+   */
+  LadderSchedulerDifferentialTestCase (uint32_t bottomThreshold, uint32_t maxRungs, uint32_t seed);
+  virtual void DoRun (void);
+
+private:
+  /** Insert an event at a random time stamp in both schedulers. */
+  void Insert (void);
+  /** Remove the next event from both schedulers, and compare them. */
+  void RemoveNext (void);
+  /** Remove a random pending event from both schedulers. */
+  void Remove (void);
+  /**
+   * Forget a pending event.
+   * \param i The index of the event.
+   */
+  void Erase (std::size_t i);
+  /** Compare the state of both schedulers. */
+  void Check (void);
+
+  uint32_t m_bottomThreshold;  //!< BottomThreshold of the LadderScheduler.
+  uint32_t m_maxRungs;         //!< MaxRungs of the LadderScheduler.
+  uint32_t m_seed;             //!< Seed of the random operations.
+  Ptr<Scheduler> m_ladder;     //!< The scheduler under test.
+  Ptr<Scheduler> m_map;        //!< The reference scheduler.
+  std::vector<Scheduler::Event> m_pending;          //!< The events in the schedulers.
+  std::unordered_map<uint32_t, std::size_t> m_index; //!< Index of each pending event, by uid.
+  std::mt19937 m_rng;          //!< Random number generator.
+  std::vector<uint64_t> m_hot; //!< Time stamps shared by many events of a burst.
+  uint64_t m_now;              //!< Time stamp of the last event removed by RemoveNext.
+  uint64_t m_last;             //!< Latest time stamp inserted.
+  uint32_t m_uid;              //!< Uid of the next event.
+};
+
+LadderSchedulerDifferentialTestCase::LadderSchedulerDifferentialTestCase (uint32_t bottomThreshold,
+                                                                          uint32_t maxRungs,
+                                                                          uint32_t seed)
+  : TestCase ("Check that the LadderScheduler with BottomThreshold " + std::to_string (bottomThreshold) +
+              " and MaxRungs " + std::to_string (maxRungs) + " orders the events as the MapScheduler"),
+    m_bottomThreshold (bottomThreshold),
+    m_maxRungs (maxRungs),
+    m_seed (seed),
+    m_now (0),
+    m_last (0),
+    m_uid (0)
+{}
+
+void
+LadderSchedulerDifferentialTestCase::Insert (void)
+{
+  uint64_t ts = m_now;
+  switch (std::uniform_int_distribution<uint32_t> (0, 7) (m_rng))
+    {
+    case 0:
+      // at the current time stamp
+      break;
+    case 1:
+    case 2:
+    case 3:
+      ts += m_hot[std::uniform_int_distribution<std::size_t> (0, m_hot.size () - 1) (m_rng)];
+      break;
+    case 4:
+    case 5:
+      ts += std::uniform_int_distribution<uint64_t> (0, 1000) (m_rng);
+      break;
+    case 6:
+      ts += std::uniform_int_distribution<uint64_t> (0, 10000000) (m_rng);
+      break;
+    default:
+      // after all the other events, thus in the top
+      ts = m_last + std::uniform_int_distribution<uint64_t> (1, 1000) (m_rng);
+      break;
+    }
+  m_last = std::max (m_last, ts);
+  Scheduler::Event ev;
+  // the schedulers do not use the implementation of the events
+  ev.impl = nullptr;
+  ev.key.m_ts = ts;
+  ev.key.m_uid = m_uid++;
+  ev.key.m_context = 0;
+  m_ladder->Insert (ev);
+  m_map->Insert (ev);
+  m_index[ev.key.m_uid] = m_pending.size ();
+  m_pending.push_back (ev);
+}
+
+void
+LadderSchedulerDifferentialTestCase::RemoveNext (void)
+{
+  Scheduler::Event expected = m_map->RemoveNext ();
+  Scheduler::Event actual = m_ladder->RemoveNext ();
+  NS_TEST_EXPECT_MSG_EQ (actual.key.m_uid, expected.key.m_uid, "Wrong next event");
+  NS_TEST_EXPECT_MSG_EQ (actual.key.m_ts, expected.key.m_ts, "Wrong time stamp of the next event");
+  m_now = expected.key.m_ts;
+  Erase (m_index[expected.key.m_uid]);
+}
+
+void
+LadderSchedulerDifferentialTestCase::Remove (void)
+{
+  std::size_t i = std::uniform_int_distribution<std::size_t> (0, m_pending.size () - 1) (m_rng);
+  Scheduler::Event ev = m_pending[i];
+  m_ladder->Remove (ev);
+  m_map->Remove (ev);
+  Erase (i);
+}
+
+void
+LadderSchedulerDifferentialTestCase::Erase (std::size_t i)
+{
+  uint32_t uid = m_pending[i].key.m_uid;
+  m_pending[i] = m_pending.back ();
+  m_index[m_pending[i].key.m_uid] = i;
+  m_pending.pop_back ();
+  m_index.erase (uid);
+}
+
+void
+LadderSchedulerDifferentialTestCase::Check (void)
+{
+  NS_TEST_EXPECT_MSG_EQ (m_ladder->IsEmpty (), m_map->IsEmpty (), "Wrong emptiness");
+  if (!m_map->IsEmpty ())
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_ladder->PeekNext ().key.m_uid, m_map->PeekNext ().key.m_uid, "Wrong peeked event");
+    }
+}
+
+void
+LadderSchedulerDifferentialTestCase::DoRun (void)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (LadderScheduler::GetTypeId ());
+  factory.Set ("BottomThreshold", UintegerValue (m_bottomThreshold));
+  factory.Set ("MaxRungs", UintegerValue (m_maxRungs));
+  m_ladder = factory.Create<Scheduler> ();
+  m_map = CreateObject<MapScheduler> ();
+  m_rng.seed (m_seed);
+
+  for (uint32_t round = 0; round < 200; round++)
+    {
+      m_hot.clear ();
+      for (uint32_t i = 0; i < 3; i++)
+        {
+          m_hot.push_back (std::uniform_int_distribution<uint64_t> (0, 100000) (m_rng));
+        }
+      // a burst of events, moved to the rungs by the next RemoveNext
+      uint32_t burst = std::uniform_int_distribution<uint32_t> (1, 300) (m_rng);
+      for (uint32_t i = 0; i < burst; i++)
+        {
+          Insert ();
+        }
+      Check ();
+      for (uint32_t i = 0; i < 2 * burst; i++)
+        {
+          uint32_t op = std::uniform_int_distribution<uint32_t> (0, 9) (m_rng);
+          if (op < 3)
+            {
+              Insert ();
+            }
+          else if (m_pending.empty ())
+            {
+              continue;
+            }
+          else if (op < 7)
+            {
+              RemoveNext ();
+            }
+          else
+            {
+              Remove ();
+            }
+          Check ();
+        }
+      if (round % 10 == 9)
+        {
+          // empty the schedulers, to start afresh
+          while (!m_pending.empty ())
+            {
+              RemoveNext ();
+              Check ();
+            }
+        }
+    }
+  while (!m_pending.empty ())
+    {
+      RemoveNext ();
+      Check ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_ladder->IsEmpty (), true, "The LadderScheduler is not empty");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -554,6 +771,12 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (PriorityQueueScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerDifferentialTestCase (1, 8, 1), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerDifferentialTestCase (2, 8, 2), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerDifferentialTestCase (4, 2, 3), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerDifferentialTestCase (50, 8, 4), TestCase::QUICK);
   }
 };
 
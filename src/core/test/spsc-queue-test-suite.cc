@@ -0,0 +1,179 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/spsc-queue.h"
+
+#include <thread>
+
+/**
+ * \file
+ * \ingroup spsc-queue-tests
+ * SpscQueue test suite.
+ */
+
+/**
+ * \ingroup core-tests
+ * \defgroup spsc-queue-tests SpscQueue tests
+ */
+
+namespace ns3 {
+
+namespace tests {
+
+
+/**
+ * \ingroup spsc-queue-tests
+ *
+ * \brief Check push, pop, size and wrap around with a single thread.
+ */
+class SpscQueueSingleThreadTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  SpscQueueSingleThreadTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SpscQueueSingleThreadTestCase::SpscQueueSingleThreadTestCase ()
+  : TestCase ("Check push, pop, size and wrap around with a single thread")
+{}
+
+void
+SpscQueueSingleThreadTestCase::DoRun (void)
+{
+  SpscQueue<uint32_t> queue (5);
+  NS_TEST_ASSERT_MSG_EQ (queue.GetCapacity (), 8, "The capacity must be rounded up to a power of two");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "The queue must start empty");
+
+  uint32_t item;
+  NS_TEST_ASSERT_MSG_EQ (queue.Pop (item), false, "Pop must fail on an empty queue");
+
+  uint32_t next = 0;
+  uint32_t expected = 0;
+  for (uint32_t lap = 0; lap < 3; lap++)
+    {
+      for (uint32_t i = 0; i < 8; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.Push (next++), true, "Push must succeed until the queue is full");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.Push (next), false, "Push must fail on a full queue");
+      NS_TEST_ASSERT_MSG_EQ (queue.GetSize (), 8, "The queue must be full");
+      for (uint32_t i = 0; i < 5; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (queue.Pop (item), true, "Pop must succeed on a non-empty queue");
+          NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.GetSize (), 3, "Wrong size after popping");
+      while (queue.Pop (item))
+        {
+          NS_TEST_ASSERT_MSG_EQ (item, expected++, "The items must be popped in order");
+        }
+      NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "The queue must be empty after popping all the items");
+    }
+  NS_TEST_ASSERT_MSG_EQ (expected, next, "All the items must be popped");
+}
+
+
+/**
+ * \ingroup spsc-queue-tests
+ *
+ * \brief Check that the items pushed by a thread are popped once and in
+ * order by another thread.
+ */
+class SpscQueueTwoThreadsTestCase : public TestCase
+{
+public:
+  /** Constructor. */
+  SpscQueueTwoThreadsTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+SpscQueueTwoThreadsTestCase::SpscQueueTwoThreadsTestCase ()
+  : TestCase ("Check the order of the items pushed by another thread")
+{}
+
+void
+SpscQueueTwoThreadsTestCase::DoRun (void)
+{
+  const uint64_t items = 1000000;
+  // small queue, to exercise the full queue case
+  SpscQueue<uint64_t> queue (64);
+
+  std::thread producer ([&queue, items] ()
+    {
+      for (uint64_t i = 0; i < items; i++)
+        {
+          while (!queue.Push (i))
+            {
+              std::this_thread::yield ();
+            }
+        }
+    });
+
+  uint64_t expected = 0;
+  bool ordered = true;
+  uint64_t item;
+  while (expected < items)
+    {
+      if (!queue.Pop (item))
+        {
+          std::this_thread::yield ();
+          continue;
+        }
+      ordered = ordered && (item == expected);
+      expected++;
+    }
+  producer.join ();
+
+  NS_TEST_ASSERT_MSG_EQ (ordered, true, "The items must be popped in order");
+  NS_TEST_ASSERT_MSG_EQ (queue.IsEmpty (), true, "No item must be left");
+}
+
+
+/**
+ * \ingroup spsc-queue-tests
+ *
+ * \brief SpscQueue test suite.
+ */
+class SpscQueueTestSuite : public TestSuite
+{
+public:
+  /** Constructor. */
+  SpscQueueTestSuite ();
+};
+
+SpscQueueTestSuite::SpscQueueTestSuite ()
+  : TestSuite ("spsc-queue")
+{
+  AddTestCase (new SpscQueueSingleThreadTestCase ());
+  AddTestCase (new SpscQueueTwoThreadsTestCase ());
+}
+
+/**
+ * \ingroup spsc-queue-tests
+ * SpscQueueTestSuite instance variable.
+ */
+static SpscQueueTestSuite g_spscQueueTestSuite;
+
+
+}    // namespace tests
+
+}    // namespace ns3
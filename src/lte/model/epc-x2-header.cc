@@ -2461,16 +2461,16 @@ NS_OBJECT_ENSURE_REGISTERED (EpcX2UeImsiSinrUpdateHeader);
 
 EpcX2UeImsiSinrUpdateHeader::EpcX2UeImsiSinrUpdateHeader ()
   : m_numberOfIes (1 + 1),
-    m_headerLength (2 + 2)
+    m_headerLength (2 + 2),
+    m_sourceCellId (0)
 {
-  m_map.clear ();
 }
 
 EpcX2UeImsiSinrUpdateHeader::~EpcX2UeImsiSinrUpdateHeader ()
 {
   m_numberOfIes = 0;
   m_headerLength = 0;
-  m_map.clear ();
+  m_list.clear ();
 }
 
 TypeId
@@ -2502,14 +2502,12 @@ EpcX2UeImsiSinrUpdateHeader::Serialize (Buffer::Iterator start) const
   Buffer::Iterator i = start;
 
   i.WriteHtonU16 (m_sourceCellId);
+  i.WriteHtonU16 (m_list.size ());  // number of elements in the list
 
-  std::map <uint64_t, double>::size_type sz = m_map.size ();
-  i.WriteHtonU16 (sz);              // number of elements in the map
-
-  for (std::map<uint64_t, double>::const_iterator iter = m_map.begin(); iter != m_map.end(); ++iter)
+  for (std::vector<EpcX2Sap::UeImsiSinr>::const_iterator iter = m_list.begin (); iter != m_list.end (); ++iter)
     {
-      i.WriteHtonU64 (iter->first); // imsi
-      i.WriteHtonU64 (pack754(iter->second)); // sinr
+      i.WriteHtonU64 (iter->imsi);
+      i.WriteHtonU16 (static_cast<uint16_t> (iter->sinr));
     }
 }
 
@@ -2520,19 +2518,19 @@ EpcX2UeImsiSinrUpdateHeader::Deserialize (Buffer::Iterator start)
 
   m_headerLength = 0;
 
-  m_sourceCellId = i.ReadNtohU16();
+  m_sourceCellId = i.ReadNtohU16 ();
   m_headerLength += 2;
   m_numberOfIes = 1;
 
-  int sz = i.ReadNtohU16 ();
-  for (int j = 0; j < sz; j++)
+  uint16_t sz = i.ReadNtohU16 ();
+  m_list.resize (sz);
+  for (uint16_t j = 0; j < sz; j++)
     {
-      uint64_t imsi = i.ReadNtohU64();
-      double sinr = unpack754(i.ReadNtohU64());
-      m_map[imsi] = sinr;
+      m_list[j].imsi = i.ReadNtohU64 ();
+      m_list[j].sinr = static_cast<int16_t> (i.ReadNtohU16 ());
     }
 
-  m_headerLength += 2 + sz * 16;
+  m_headerLength += 2 + sz * 10;
   m_numberOfIes += 1 + sz;
 
   return GetSerializedSize ();
@@ -2542,38 +2540,38 @@ void
 EpcX2UeImsiSinrUpdateHeader::Print (std::ostream &os) const
 {
   os << "SourceCellId " << m_sourceCellId;
-  for(std::map<uint64_t, double>::const_iterator iter = m_map.begin(); iter != m_map.end(); ++iter)
-  {
-    os << " Imsi " << iter->first << " sinr " << 10*std::log10(iter->second);
-  }
+  for (std::vector<EpcX2Sap::UeImsiSinr>::const_iterator iter = m_list.begin (); iter != m_list.end (); ++iter)
+    {
+      os << " Imsi " << iter->imsi << " sinr " << iter->sinr * EpcX2Sap::SINR_STEP_DB;
+    }
 }
 
-uint16_t 
+uint16_t
 EpcX2UeImsiSinrUpdateHeader::GetSourceCellId () const
 {
   return m_sourceCellId;
 }
 
 void
-EpcX2UeImsiSinrUpdateHeader::SetSourceCellId(uint16_t cellId)
+EpcX2UeImsiSinrUpdateHeader::SetSourceCellId (uint16_t cellId)
 {
   m_sourceCellId = cellId;
 }
 
-std::map <uint64_t, double>
-EpcX2UeImsiSinrUpdateHeader::GetUeImsiSinrMap () const
+const std::vector<EpcX2Sap::UeImsiSinr> &
+EpcX2UeImsiSinrUpdateHeader::GetUeImsiSinrList () const
 {
-  return m_map;
+  return m_list;
 }
 
 void
-EpcX2UeImsiSinrUpdateHeader::SetUeImsiSinrMap (std::map <uint64_t, double> map)
+EpcX2UeImsiSinrUpdateHeader::SetUeImsiSinrList (const std::vector<EpcX2Sap::UeImsiSinr> &list)
 {
-  m_map = map;
+  NS_ASSERT_MSG (list.size () <= UINT16_MAX, "Too many SINRs in an UpdateUeSinr message");
+  m_list = list;
 
-  std::map <uint64_t, double>::size_type sz = m_map.size ();
-  m_headerLength += sz * 16;
-  m_numberOfIes += sz;
+  m_headerLength = 2 + 2 + m_list.size () * 10;
+  m_numberOfIes = 1 + 1 + m_list.size ();
 }
 
 uint32_t
@@ -2588,67 +2586,6 @@ EpcX2UeImsiSinrUpdateHeader::GetNumberOfIes () const
   return m_numberOfIes;
 }
 
-uint64_t 
-EpcX2UeImsiSinrUpdateHeader::pack754(long double f)
-{
-  uint16_t bits = 64;
-  uint16_t expbits = 11;
-  long double fnorm;
-  int shift;
-  long long sign, exp, significand;
-  unsigned significandbits = bits - expbits - 1; // -1 for sign bit
-
-  if (f == 0.0) return 0; // get this special case out of the way
-
-  // check sign and begin normalization
-  if (f < 0) { sign = 1; fnorm = -f; }
-  else { sign = 0; fnorm = f; }
-
-  // get the normalized form of f and track the exponent
-  shift = 0;
-  while(fnorm >= 2.0) { fnorm /= 2.0; shift++; }
-  while(fnorm < 1.0) { fnorm *= 2.0; shift--; }
-  fnorm = fnorm - 1.0;
-
-  // calculate the binary form (non-float) of the significand data
-  significand = fnorm * ((1LL<<significandbits) + 0.5f);
-
-  // get the biased exponent
-  exp = shift + ((1<<(expbits-1)) - 1); // shift + bias
-
-  // return the final answer
-  return (sign<<(bits-1)) | (exp<<(bits-expbits-1)) | significand;
-}
-
-long double 
-EpcX2UeImsiSinrUpdateHeader::unpack754(uint64_t i)
-{
-  uint16_t bits = 64;
-  uint16_t expbits = 11;
-  long double result;
-  long long shift;
-  unsigned bias;
-  unsigned significandbits = bits - expbits - 1; // -1 for sign bit
-
-  if (i == 0) return 0.0;
-
-  // pull the significand
-  result = (i&((1LL<<significandbits)-1)); // mask
-  result /= (1LL<<significandbits); // convert back to float
-  result += 1.0f; // add the one back on
-
-  // deal with the exponent
-  bias = (1<<(expbits-1)) - 1;
-  shift = ((i>>significandbits)&((1LL<<expbits)-1)) - bias;
-  while(shift > 0) { result *= 2.0; shift--; }
-  while(shift < 0) { result /= 2.0; shift++; }
-
-  // sign it
-  result *= (i>>(bits-1))&1? -1.0: 1.0;
-
-  return result;
-}
-
 /////////////////////////////////////////////////////////////////////
 
 NS_OBJECT_ENSURE_REGISTERED (EpcX2ConnectionSwitchHeader);
@@ -886,8 +886,15 @@ public:
   virtual void Print (std::ostream &os) const;
 
 
-  std::map <uint64_t, double> GetUeImsiSinrMap () const;
-  void SetUeImsiSinrMap (std::map<uint64_t, double> map);
+  /**
+   * \returns the SINRs of the UEs, sorted by IMSI
+   */
+  const std::vector<EpcX2Sap::UeImsiSinr> & GetUeImsiSinrList () const;
+
+  /**
+   * \param list the SINRs of the UEs, sorted by IMSI
+   */
+  void SetUeImsiSinrList (const std::vector<EpcX2Sap::UeImsiSinr> &list);
 
   uint16_t GetSourceCellId () const;
   void SetSourceCellId (uint16_t sourceCellId);
@@ -899,12 +906,7 @@ private:
   uint32_t          m_numberOfIes;
   uint32_t          m_headerLength;
 
-  // from http://beej.us/guide/bgnet/examples/ieee754.c, to convert
-  // uint64_t to double and viceversa according to IEEE754 format
-  static uint64_t pack754(long double f);
-  static long double unpack754(uint64_t i);
-
-  std::map <uint64_t, double> m_map;
+  std::vector<EpcX2Sap::UeImsiSinr> m_list;
   uint16_t m_sourceCellId;
 };
 
@@ -24,13 +24,39 @@
 
 #include "ns3/epc-x2-sap.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3 {
 
 
+const double EpcX2Sap::SINR_STEP_DB = 0.01;
+
 EpcX2Sap::~EpcX2Sap ()
 {
 }
 
+int16_t
+EpcX2Sap::QuantizeSinr (double sinr)
+{
+  if (sinr <= 0)
+    {
+      return INT16_MIN;
+    }
+  double steps = std::round (10 * std::log10 (sinr) / SINR_STEP_DB);
+  return static_cast<int16_t> (std::min (std::max (steps, INT16_MIN + 1.0), (double) INT16_MAX));
+}
+
+double
+EpcX2Sap::DequantizeSinr (int16_t sinr)
+{
+  if (sinr == INT16_MIN)
+    {
+      return 0;
+    }
+  return std::pow (10, sinr * SINR_STEP_DB / 10);
+}
+
 EpcX2Sap::ErabToBeSetupItem::ErabToBeSetupItem () :
   erabLevelQosParameters (EpsBearer (EpsBearer::GBR_CONV_VOICE))
 {
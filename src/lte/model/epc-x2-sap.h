@@ -31,6 +31,7 @@
 #include <ns3/lte-enb-cmac-sap.h>
 #include <bitset>
 #include <map>
+#include <vector>
 
 namespace ns3 {
 
@@ -376,13 +377,39 @@ public:
     uint16_t oldEnbUeX2apId;
   };
 
+  /**
+   * SINR of a UE in an UpdateUeSinr message, quantized with QuantizeSinr
+   */
+  struct UeImsiSinr
+  {
+    uint64_t imsi;
+    int16_t  sinr;
+  };
+
   struct UeImsiSinrParams
   {
     uint16_t    sourceCellId;
     uint16_t    targetCellId;
-    std::map<uint64_t, double> ueImsiSinrMap;
+    std::vector<UeImsiSinr> ueImsiSinrList; ///< sorted by IMSI, only the SINRs that changed since the previous message
   };
 
+  /// Step of the quantized SINR, in dB
+  static const double SINR_STEP_DB;
+
+  /**
+   * Quantize a SINR in steps of SINR_STEP_DB, between -327.67 and 327.67 dB
+   *
+   * \param sinr the linear SINR
+   * \returns the quantized SINR, or INT16_MIN if the SINR is null
+   */
+  static int16_t QuantizeSinr (double sinr);
+
+  /**
+   * \param sinr a SINR quantized with QuantizeSinr
+   * \returns the linear SINR
+   */
+  static double DequantizeSinr (int16_t sinr);
+
   struct HandoverFailedParams
   {
     uint64_t imsi;
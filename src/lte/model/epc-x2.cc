@@ -498,7 +498,7 @@ EpcX2::RecvFromX2cSocket (Ptr<Socket> socket)
       NS_LOG_INFO ("X2 SinrUpdateHeader header: " << x2ueSinrUpdateHeader);
 
       EpcX2SapUser::UeImsiSinrParams params;
-      params.ueImsiSinrMap = x2ueSinrUpdateHeader.GetUeImsiSinrMap();
+      params.ueImsiSinrList = x2ueSinrUpdateHeader.GetUeImsiSinrList ();
       params.sourceCellId = x2ueSinrUpdateHeader.GetSourceCellId();
 
       m_x2SapUser->RecvUeSinrUpdate(params);  
@@ -1296,7 +1296,7 @@ EpcX2::DoSendUeSinrUpdate(EpcX2Sap::UeImsiSinrParams params)
 
   // Build the X2 message
   EpcX2UeImsiSinrUpdateHeader x2imsiSinrHeader;
-  x2imsiSinrHeader.SetUeImsiSinrMap (params.ueImsiSinrMap);
+  x2imsiSinrHeader.SetUeImsiSinrList (params.ueImsiSinrList);
   x2imsiSinrHeader.SetSourceCellId (params.sourceCellId);
 
   EpcX2Header x2Header;
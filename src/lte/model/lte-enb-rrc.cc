@@ -39,6 +39,7 @@
 #include <ns3/object-map.h>
 #include <ns3/object-factory.h>
 #include <ns3/simulator.h>
+#include <algorithm>
 
 #include <ns3/lte-radio-bearer-info.h>
 #include <ns3/eps-bearer-tag.h>
@@ -2451,7 +2452,7 @@ UeManager::SwitchToState (State newState)
             {
               uint16_t maxSinrCellId = m_rrc->m_bestMmWaveCellForImsiMap.at(m_imsi);
               // get the SINR
-              double maxSinrDb = 10*std::log10(m_rrc->m_imsiCellSinrMap.find(m_imsi)->second.find(maxSinrCellId)->second);
+              double maxSinrDb = 10*std::log10(m_rrc->GetMmWaveSinr (m_imsi, maxSinrCellId));
               if(maxSinrDb > m_rrc->m_outageThreshold)
               {
                 // there is a MmWave cell to which the UE can connect
@@ -2682,6 +2683,7 @@ LteEnbRrc::LteEnbRrc ()
     m_lastAllocatedConfigurationIndex (0),
     m_reconfigureUes (false),
     m_firstSibTime (16),
+    m_numSinrReports (0),
     m_numNewSinrReports (0),
     m_numberOfComponentCarriers (0),
     m_carriersConfigured (false)
@@ -2696,7 +2698,7 @@ LteEnbRrc::LteEnbRrc ()
   m_s1SapUser = new MemberEpcEnbS1SapUser<LteEnbRrc> (this);
   m_cphySapUser.push_back (new MemberLteEnbCphySapUser<LteEnbRrc> (this));
 
-  m_imsiCellSinrMap.clear();
+  m_mmWaveSinrs.Clear ();
   m_x2_received_cnt = 0;
   m_switchEnabled = true;
   m_lteCellId = 0;
@@ -2992,6 +2994,18 @@ LteEnbRrc::GetTypeId (void)
             BooleanValue (true),
             MakeBooleanAccessor (&LteEnbRrc::m_reportAllUeMeas),
             MakeBooleanChecker ())
+   .AddAttribute ("SinrReportThreshold",
+            "Change of the SINR of a UE [dB] above which the MmWave eNB reports it again to the LTE coordinator. "
+            "With 0, every change larger than the quantization step of the X2 message is reported",
+            DoubleValue (0.0),
+            MakeDoubleAccessor (&LteEnbRrc::m_sinrReportThreshold),
+            MakeDoubleChecker<double> (0.0))
+   .AddAttribute ("SinrFullReportPeriod",
+            "Number of SINR reports after which the MmWave eNB sends again to the LTE coordinator the SINRs of all the UEs, "
+            "whether they changed or not. The SINRs of all the UEs are sent also after a UE attaches. With 0, they are sent only then",
+            UintegerValue (10),
+            MakeUintegerAccessor (&LteEnbRrc::m_sinrFullReportPeriod),
+            MakeUintegerChecker<uint32_t> ())
     // Trace sources
     .AddTraceSource ("NewUeContext",
                      "Fired upon creation of a new UE context.",
@@ -3469,7 +3483,7 @@ LteEnbRrc::ConfigureCell (std::map<uint8_t, Ptr<ComponentCarrierEnb>> ccPhyConf)
    * SystemInformationPeriodicity attribute to configure this).
    */
   Simulator::Schedule (MilliSeconds (16), &LteEnbRrc::SendSystemInformation, this);
-  m_imsiCellSinrMap.clear();
+  m_mmWaveSinrs.Clear ();
   m_firstReport = true;
   m_configured = true;
 
@@ -3560,7 +3574,7 @@ LteEnbRrc::ConfigureCell (std::map<uint8_t, MmWaveComponentCarrierConf> ccPhyCon
    */
    // mmWave module: Changed scheduling of initial system information to +2ms
   Simulator::Schedule (MilliSeconds (m_firstSibTime), &LteEnbRrc::SendSystemInformation, this);
-  m_imsiCellSinrMap.clear();
+  m_mmWaveSinrs.Clear ();
   m_firstReport = true;
   m_configured = true;
 
@@ -3602,119 +3616,244 @@ LteEnbRrc::GetCellId () const
   return m_cellId;
 }
 
-void
-LteEnbRrc::DoUpdateUeSinrEstimate(LteEnbCphySapUser::UeAssociatedSinrInfo info)
+double
+LteEnbRrc::GetMmWaveSinr (uint64_t imsi, uint16_t cellId) const
 {
-  NS_LOG_FUNCTION(this);
-
-  NS_LOG_INFO ("CC " << (uint16_t)info.componentCarrierId << " reports the ueImsiSinrMap");
-  m_ueImsiSinrMap[info.componentCarrierId]=info.ueImsiSinrMap; // store the received report in m_ueImsiSinrMap
+  return m_mmWaveSinrs.Get (imsi, cellId);
+}
 
-  // TODO report immediately or with some filtering
-  if(m_lteCellId > 0) // i.e., only if a LTE eNB was actually registered in the scenario
-                      // (this is done when an X2 interface among mmWave eNBs and LTE eNB is added)
-  {
-    // send the report to the LTE coordinator
-    EpcX2SapProvider::UeImsiSinrParams params;
-    params.targetCellId = m_lteCellId;
-    params.sourceCellId = m_cellId;
+void
+MmWaveSinrMatrix::Set (uint64_t imsi, uint16_t cellId, double sinr)
+{
+  std::size_t column = AddColumn (cellId);
+  std::size_t index = AddRow (imsi) * m_cellIds.size () + column;
+  m_sinrs[index] = sinr;
+  m_reported[index] = 1;
+}
 
-    //if (m_reportAllUeMeas == true)
-    if(false)
+double
+MmWaveSinrMatrix::Get (uint64_t imsi, uint16_t cellId) const
+{
+  std::vector<uint64_t>::const_iterator row = std::lower_bound (m_imsis.begin (), m_imsis.end (), imsi);
+  std::vector<uint16_t>::const_iterator column = std::lower_bound (m_cellIds.begin (), m_cellIds.end (), cellId);
+  if (row == m_imsis.end () || *row != imsi || column == m_cellIds.end () || *column != cellId)
     {
-      params.ueImsiSinrMap = info.ueImsiSinrMap;
-      m_ueImsiSinrMap.clear(); // delete the reports
+      return 0;
     }
-    else
+  return GetAt (row - m_imsis.begin (), column - m_cellIds.begin ());
+}
+
+bool
+MmWaveSinrMatrix::IsReported (uint64_t imsi, uint16_t cellId) const
+{
+  std::vector<uint64_t>::const_iterator row = std::lower_bound (m_imsis.begin (), m_imsis.end (), imsi);
+  std::vector<uint16_t>::const_iterator column = std::lower_bound (m_cellIds.begin (), m_cellIds.end (), cellId);
+  if (row == m_imsis.end () || *row != imsi || column == m_cellIds.end () || *column != cellId)
     {
-      if (m_ueImsiSinrMap.size() == m_numberOfComponentCarriers) // if we received the ueImsiSinrMap report from all the CCs
-      {
-        // Build the ueImsiSinrMapToSend containing, for each UE, the max SINR among all the CCs
-        NS_LOG_DEBUG ("Number of ueImsiSinrMaps in m_ueImsiSinrMap " << (uint16_t)m_ueImsiSinrMap.size() );
+      return false;
+    }
+  return IsReportedAt (row - m_imsis.begin (), column - m_cellIds.begin ());
+}
 
-        std::map<uint64_t, double> ueImsiSinrMapToSend; // map which contains the max SINR for each UE among the CCs
-        ueImsiSinrMapToSend = m_ueImsiSinrMap.at(0); // initialization
+const std::vector<uint64_t> &
+MmWaveSinrMatrix::GetImsis () const
+{
+  return m_imsis;
+}
 
-        for(uint8_t cc = 1; cc < m_numberOfComponentCarriers; cc++)
-        {
-          NS_ASSERT_MSG (m_ueImsiSinrMap.find(cc) != m_ueImsiSinrMap.end(), "CC " << (uint16_t)cc << " didn't report the ueImsiSinrMap");
+const std::vector<uint16_t> &
+MmWaveSinrMatrix::GetCellIds () const
+{
+  return m_cellIds;
+}
 
-          for (std::map<uint64_t, double>::iterator ue = ueImsiSinrMapToSend.begin(); ue != ueImsiSinrMapToSend.end(); ue++)
-          {
-            NS_ASSERT_MSG (m_ueImsiSinrMap.at(cc).find(ue->first) != m_ueImsiSinrMap.at(cc).end(), "CC " << (uint16_t)cc << " didn't report SINR for UE "<< ue->first );
+double
+MmWaveSinrMatrix::GetAt (std::size_t row, std::size_t column) const
+{
+  return m_sinrs[row * m_cellIds.size () + column];
+}
+
+bool
+MmWaveSinrMatrix::IsReportedAt (std::size_t row, std::size_t column) const
+{
+  return m_reported[row * m_cellIds.size () + column] != 0;
+}
+
+bool
+MmWaveSinrMatrix::IsEmpty () const
+{
+  return m_imsis.empty ();
+}
+
+void
+MmWaveSinrMatrix::Clear ()
+{
+  m_imsis.clear ();
+  m_cellIds.clear ();
+  m_sinrs.clear ();
+  m_reported.clear ();
+}
 
-            NS_LOG_DEBUG ("UE " << ue->first << " current SINR " << ue->second << " is higher than " << m_ueImsiSinrMap.at(cc).at(ue->first) << " ?");
-            if (ue->second < m_ueImsiSinrMap.at(cc).at(ue->first))
+std::size_t
+MmWaveSinrMatrix::AddRow (uint64_t imsi)
+{
+  std::vector<uint64_t>::iterator row = std::lower_bound (m_imsis.begin (), m_imsis.end (), imsi);
+  std::size_t index = row - m_imsis.begin ();
+  if (row == m_imsis.end () || *row != imsi)
+    {
+      m_imsis.insert (row, imsi);
+      m_sinrs.insert (m_sinrs.begin () + index * m_cellIds.size (), m_cellIds.size (), 0.0);
+      m_reported.insert (m_reported.begin () + index * m_cellIds.size (), m_cellIds.size (), 0);
+    }
+  return index;
+}
+
+std::size_t
+MmWaveSinrMatrix::AddColumn (uint16_t cellId)
+{
+  std::vector<uint16_t>::iterator column = std::lower_bound (m_cellIds.begin (), m_cellIds.end (), cellId);
+  std::size_t index = column - m_cellIds.begin ();
+  if (column == m_cellIds.end () || *column != cellId)
+    {
+      // the cells are few and known after the first reports, so rebuilding the matrix is rare
+      std::size_t numColumns = m_cellIds.size ();
+      m_cellIds.insert (column, cellId);
+      std::vector<double> sinrs (m_imsis.size () * m_cellIds.size (), 0.0);
+      std::vector<uint8_t> reported (sinrs.size (), 0);
+      for (std::size_t row = 0; row < m_imsis.size (); row++)
+        {
+          for (std::size_t oldColumn = 0; oldColumn < numColumns; oldColumn++)
             {
-              NS_LOG_DEBUG ("No, update SINR to " << m_ueImsiSinrMap.at(cc).at(ue->first));
-              ue->second = m_ueImsiSinrMap.at(cc).at(ue->first); // insert the max SINR for this UE among all the CCs
+              std::size_t newColumn = oldColumn < index ? oldColumn : oldColumn + 1;
+              sinrs[row * m_cellIds.size () + newColumn] = m_sinrs[row * numColumns + oldColumn];
+              reported[row * m_cellIds.size () + newColumn] = m_reported[row * numColumns + oldColumn];
             }
-          }
         }
-        params.ueImsiSinrMap = ueImsiSinrMapToSend;
-        m_ueImsiSinrMap.clear(); // delete the reports
-      }
+      m_sinrs.swap (sinrs);
+      m_reported.swap (reported);
     }
-
-    NS_LOG_INFO("number of SINR reported " << params.ueImsiSinrMap.size());
-    m_x2SapProvider->SendUeSinrUpdate (params);
-  }
-
+  return index;
 }
 
 void
-LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
+LteEnbRrc::DoUpdateUeSinrEstimate(LteEnbCphySapUser::UeAssociatedSinrInfo info)
 {
   NS_LOG_FUNCTION(this);
-  NS_LOG_LOGIC("Recv Ue SINR Update from cell " << params.sourceCellId);
-  uint16_t mmWaveCellId = params.sourceCellId;
-  if(m_cellSinrMap.find(mmWaveCellId) != m_cellSinrMap.end())
-  {     // update the entry
-    m_cellSinrMap[mmWaveCellId] = params.ueImsiSinrMap;
-    m_numNewSinrReports++;
-  }
-  else  // add the entry
-  {
-    m_cellSinrMap.insert(std::pair<uint16_t, ImsiSinrMap> (mmWaveCellId, params.ueImsiSinrMap));
-    m_numNewSinrReports++;
-  }
-  // cycle on all the Imsi whose SINR is known in cell mmWaveCellId
-  for(std::map<uint64_t, double>::iterator imsiIter = params.ueImsiSinrMap.begin(); imsiIter != params.ueImsiSinrMap.end(); ++imsiIter)
-  {
-    uint64_t imsi = imsiIter->first;
-    double sinr = imsiIter->second;
 
-    m_notifyMmWaveSinrTrace(imsi, mmWaveCellId, sinr);
+  NS_LOG_INFO ("CC " << (uint16_t)info.componentCarrierId << " reports the ueImsiSinrMap");
+  m_ueImsiSinrMap[info.componentCarrierId].swap (info.ueImsiSinrMap); // store the received report in m_ueImsiSinrMap
 
-    NS_LOG_LOGIC("Imsi " << imsi << " sinr " << sinr);
+  // TODO report immediately or with some filtering
+  if(m_lteCellId > 0 // i.e., only if a LTE eNB was actually registered in the scenario
+                     // (this is done when an X2 interface among mmWave eNBs and LTE eNB is added)
+     && m_ueImsiSinrMap.size() == m_numberOfComponentCarriers) // if we received the ueImsiSinrMap report from all the CCs
+  {
+    // Build the ueImsiSinrMapToSend containing, for each UE, the max SINR among all the CCs.
+    // The maps are sorted by IMSI, so that those of the other CCs are walked along the first one
+    NS_LOG_DEBUG ("Number of ueImsiSinrMaps in m_ueImsiSinrMap " << (uint16_t)m_ueImsiSinrMap.size() );
+    ImsiSinrMap &ueImsiSinrMapToSend = m_ueImsiSinrMap.at(0);
+    for(uint8_t cc = 1; cc < m_numberOfComponentCarriers; cc++)
+    {
+      NS_ASSERT_MSG (m_ueImsiSinrMap.find(cc) != m_ueImsiSinrMap.end(), "CC " << (uint16_t)cc << " didn't report the ueImsiSinrMap");
+      const ImsiSinrMap &ccMap = m_ueImsiSinrMap.at(cc);
+      ImsiSinrMap::const_iterator ccUe = ccMap.begin();
+      for (ImsiSinrMap::iterator ue = ueImsiSinrMapToSend.begin(); ue != ueImsiSinrMapToSend.end(); ue++)
+      {
+        while (ccUe != ccMap.end() && ccUe->first < ue->first)
+        {
+          ccUe++;
+        }
+        NS_ASSERT_MSG (ccUe != ccMap.end() && ccUe->first == ue->first, "CC " << (uint16_t)cc << " didn't report SINR for UE "<< ue->first );
 
-    if(m_imsiCellSinrMap.find(imsi) != m_imsiCellSinrMap.end())
+        NS_LOG_DEBUG ("UE " << ue->first << " current SINR " << ue->second << " is higher than " << ccUe->second << " ?");
+        if (ue->second < ccUe->second)
+        {
+          NS_LOG_DEBUG ("No, update SINR to " << ccUe->second);
+          ue->second = ccUe->second; // insert the max SINR for this UE among all the CCs
+        }
+      }
+    }
+
+    // send to the LTE coordinator only the SINRs which changed by more than
+    // m_sinrReportThreshold since they were last reported, and those of new UEs.
+    // Every m_sinrFullReportPeriod reports all the SINRs are sent, so that the
+    // coordinator recovers from a lost report
+    if (m_sinrFullReportPeriod > 0 && ++m_numSinrReports >= m_sinrFullReportPeriod)
+    {
+      m_reportedSinrs.clear ();
+    }
+    if (m_reportedSinrs.empty ())
     {
-      if(m_imsiCellSinrMap[imsi].find(mmWaveCellId) != m_imsiCellSinrMap[imsi].end())
+      m_numSinrReports = 0;
+    }
+    EpcX2SapProvider::UeImsiSinrParams params;
+    params.targetCellId = m_lteCellId;
+    params.sourceCellId = m_cellId;
+    std::vector<EpcX2Sap::UeImsiSinr> reportedSinrs;
+    reportedSinrs.reserve (ueImsiSinrMapToSend.size ());
+    std::vector<EpcX2Sap::UeImsiSinr>::const_iterator reported = m_reportedSinrs.begin ();
+    for (ImsiSinrMap::const_iterator ue = ueImsiSinrMapToSend.begin(); ue != ueImsiSinrMapToSend.end(); ue++)
+    {
+      EpcX2Sap::UeImsiSinr ueSinr {ue->first, EpcX2Sap::QuantizeSinr (ue->second)};
+      while (reported != m_reportedSinrs.end () && reported->imsi < ue->first)
       {
-        // update the SINR measure
-        m_imsiCellSinrMap[imsi].find(mmWaveCellId)->second = sinr;
+        reported++;
       }
-      else // new cell for this Imsi
+      if (reported != m_reportedSinrs.end () && reported->imsi == ue->first
+          && (ueSinr.sinr == reported->sinr
+              || std::abs (ueSinr.sinr - reported->sinr) * EpcX2Sap::SINR_STEP_DB <= m_sinrReportThreshold))
       {
-        // insert a new SINR measure
-        m_imsiCellSinrMap[imsi].insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
+        reportedSinrs.push_back (*reported);
+      }
+      else
+      {
+        reportedSinrs.push_back (ueSinr);
+        params.ueImsiSinrList.push_back (ueSinr);
       }
     }
-    else // new imsi
+    m_reportedSinrs.swap (reportedSinrs);
+    m_ueImsiSinrMap.clear(); // delete the reports
+
+    NS_LOG_INFO("number of SINR reported " << params.ueImsiSinrList.size());
+    if (!params.ueImsiSinrList.empty ())
     {
-      CellSinrMap map;
-      map.insert(std::pair<uint16_t, double>(mmWaveCellId, sinr));
-      m_imsiCellSinrMap.insert(std::pair<uint64_t, CellSinrMap> (imsi, map));
+      m_x2SapProvider->SendUeSinrUpdate (params);
     }
   }
 
-  for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+}
+
+void
+LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
+{
+  NS_LOG_FUNCTION(this);
+  NS_LOG_LOGIC("Recv Ue SINR Update from cell " << params.sourceCellId);
+  uint16_t mmWaveCellId = params.sourceCellId;
+  m_numNewSinrReports++;
+
+  // the SINRs which are not in the list did not change since the previous report
+  for(std::vector<EpcX2Sap::UeImsiSinr>::const_iterator imsiIter = params.ueImsiSinrList.begin(); imsiIter != params.ueImsiSinrList.end(); ++imsiIter)
+  {
+    uint64_t imsi = imsiIter->imsi;
+    double sinr = EpcX2Sap::DequantizeSinr (imsiIter->sinr);
+
+    NS_LOG_LOGIC("Imsi " << imsi << " mmWaveCell " << mmWaveCellId << " sinr " << sinr);
+
+    m_mmWaveSinrs.Set (imsi, mmWaveCellId, sinr);
+  }
+
+  // notify the SINRs of all the UEs known by this cell, as if they were all reported
+  const std::vector<uint64_t> &imsis = m_mmWaveSinrs.GetImsis ();
+  const std::vector<uint16_t> &cellIds = m_mmWaveSinrs.GetCellIds ();
+  std::size_t column = std::lower_bound (cellIds.begin (), cellIds.end (), mmWaveCellId) - cellIds.begin ();
+  if (column < cellIds.size () && cellIds[column] == mmWaveCellId)
   {
-    NS_LOG_LOGIC("Imsi " << imsiIter->first);
-    for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
+    for (std::size_t row = 0; row < imsis.size (); row++)
     {
-      NS_LOG_LOGIC("mmWaveCell " << cellIter->first << " sinr " <<  cellIter->second);
+      if (m_mmWaveSinrs.IsReportedAt (row, column))
+      {
+        m_notifyMmWaveSinrTrace(imsis[row], mmWaveCellId, m_mmWaveSinrs.GetAt (row, column));
+      }
     }
   }
 
@@ -3738,9 +3877,8 @@ LteEnbRrc::DoRecvUeSinrUpdate(EpcX2SapUser::UeImsiSinrParams params)
 }
 
 void
-LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -3765,7 +3903,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
   double currentSinrDb = 0;
   if(alreadyAssociatedImsi && m_lastMmWaveCell.find(imsi) != m_lastMmWaveCell.end())
   {
-    currentSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[m_lastMmWaveCell[imsi]]);
+    currentSinrDb = 10*std::log10(m_mmWaveSinrs.Get (imsi, m_lastMmWaveCell[imsi]));
     NS_LOG_DEBUG("Current SINR " << currentSinrDb);
   }
 
@@ -3856,7 +3994,7 @@ LteEnbRrc::TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter,
         uint16_t targetCellId = handoverEvent->second.targetCellId;
         NS_LOG_INFO("------ Handover was scheduled for " << handoverEvent->second.targetCellId << " but now maxSinrCellId is " << maxSinrCellId);
         //  get the SINR for the scheduled targetCellId: if the diff is smaller than 3 dB handover anyway
-        double originalTargetSinrDb = 10*std::log10(m_imsiCellSinrMap.find(imsi)->second[targetCellId]);
+        double originalTargetSinrDb = 10*std::log10(m_mmWaveSinrs.Get (imsi, targetCellId));
         if(maxSinrDb - originalTargetSinrDb > m_sinrThresholdDifference) // this parameter is the same as the one for ThresholdBasedSecondaryCellHandover
         {
           // delete this event
@@ -4021,9 +4159,8 @@ LteEnbRrc::PerformHandover(uint64_t imsi)
 }
 
 void
-LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4135,11 +4272,13 @@ LteEnbRrc::ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::
 void
 LteEnbRrc::TriggerUeAssociationUpdate()
 {
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  if(!m_mmWaveSinrs.IsEmpty ()) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    const std::vector<uint64_t> &imsis = m_mmWaveSinrs.GetImsis ();
+    const std::vector<uint16_t> &cellIds = m_mmWaveSinrs.GetCellIds ();
+    for(std::size_t row = 0; row < imsis.size (); ++row)
     {
-      uint64_t imsi = imsiIter->first;
+      uint64_t imsi = imsis[row];
       long double maxSinr = 0;
       long double currentSinr = 0;
       uint16_t maxSinrCellId = 0;
@@ -4164,17 +4303,22 @@ LteEnbRrc::TriggerUeAssociationUpdate()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
+      for(std::size_t column = 0; column < cellIds.size (); ++column)
       {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        if(cellIter->second > maxSinr)
+        if (!m_mmWaveSinrs.IsReportedAt (row, column))
+        {
+          continue;
+        }
+        double sinr = m_mmWaveSinrs.GetAt (row, column);
+        NS_LOG_INFO("Cell " << cellIds[column] << " reports " << 10*std::log10(sinr));
+        if(sinr > maxSinr)
         {
-          maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first;
+          maxSinr = sinr;
+          maxSinrCellId = cellIds[column];
         }
-        if(m_lastMmWaveCell[imsi] == cellIter->first)
+        if(m_lastMmWaveCell[imsi] == cellIds[column])
         {
-          currentSinr = cellIter->second;
+          currentSinr = sinr;
         }
       }
       long double sinrDifference = std::abs(10*(std::log10((long double)maxSinr) - std::log10((long double)currentSinr)));
@@ -4219,11 +4363,11 @@ LteEnbRrc::TriggerUeAssociationUpdate()
         m_bestMmWaveCellForImsiMap[imsi] = maxSinrCellId;
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedSecondaryCellHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          ThresholdBasedSecondaryCellHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
-          TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
@@ -4237,9 +4381,8 @@ LteEnbRrc::TriggerUeAssociationUpdate()
 }
 
 void
-LteEnbRrc::ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
+LteEnbRrc::ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb)
 {
-  uint64_t imsi = imsiIter->first;
   bool alreadyAssociatedImsi = false;
   bool onHandoverImsi = true;
   // On RecvRrcConnectionRequest for a new RNTI, the Lte Enb RRC stores the imsi
@@ -4323,11 +4466,13 @@ void
 LteEnbRrc::UpdateUeHandoverAssociation()
 {
   // TODO rules for possible ho of each UE
-  if(m_imsiCellSinrMap.size() > 0) // there are some entries
+  if(!m_mmWaveSinrs.IsEmpty ()) // there are some entries
   {
-    for(std::map<uint64_t, CellSinrMap>::iterator imsiIter = m_imsiCellSinrMap.begin(); imsiIter != m_imsiCellSinrMap.end(); ++imsiIter)
+    const std::vector<uint64_t> &imsis = m_mmWaveSinrs.GetImsis ();
+    const std::vector<uint16_t> &cellIds = m_mmWaveSinrs.GetCellIds ();
+    for(std::size_t row = 0; row < imsis.size (); ++row)
     {
-      uint64_t imsi = imsiIter->first;
+      uint64_t imsi = imsis[row];
       long double maxSinr = 0;
       long double currentSinr = 0;
       uint16_t maxSinrCellId = 0;
@@ -4350,17 +4495,22 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       }
       NS_LOG_INFO("alreadyAssociatedImsi " << alreadyAssociatedImsi << " onHandoverImsi " << onHandoverImsi);
 
-      for(CellSinrMap::iterator cellIter = imsiIter->second.begin(); cellIter != imsiIter->second.end(); ++cellIter)
+      for(std::size_t column = 0; column < cellIds.size (); ++column)
       {
-        NS_LOG_INFO("Cell " << cellIter->first << " reports " << 10*std::log10(cellIter->second));
-        if(cellIter->second > maxSinr)
+        if (!m_mmWaveSinrs.IsReportedAt (row, column))
+        {
+          continue;
+        }
+        double sinr = m_mmWaveSinrs.GetAt (row, column);
+        NS_LOG_INFO("Cell " << cellIds[column] << " reports " << 10*std::log10(sinr));
+        if(sinr > maxSinr)
         {
-          maxSinr = cellIter->second;
-          maxSinrCellId = cellIter->first;
+          maxSinr = sinr;
+          maxSinrCellId = cellIds[column];
         }
-        if(m_lastMmWaveCell[imsi] == cellIter->first)
+        if(m_lastMmWaveCell[imsi] == cellIds[column])
         {
-          currentSinr = cellIter->second;
+          currentSinr = sinr;
         }
       }
 
@@ -4412,12 +4562,12 @@ LteEnbRrc::UpdateUeHandoverAssociation()
       {
         if(m_handoverMode == THRESHOLD)
         {
-          ThresholdBasedInterRatHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          ThresholdBasedInterRatHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else if(m_handoverMode == FIXED_TTT || m_handoverMode == DYNAMIC_TTT)
         {
           m_bestMmWaveCellForImsiMap[imsi] = maxSinrCellId;
-          TttBasedHandover(imsiIter, sinrDifference, maxSinrCellId, maxSinrDb);
+          TttBasedHandover(imsi, sinrDifference, maxSinrCellId, maxSinrDb);
         }
         else
         {
@@ -5115,6 +5265,8 @@ LteEnbRrc::AddUe (UeManager::State state, uint8_t componentCarrierId)
   const uint16_t cellId = ComponentCarrierToCellId (componentCarrierId);
   NS_LOG_DEBUG (this << " New UE RNTI " << rnti << " cellId " << cellId << " srs CI " << ueManager->GetSrsConfigurationIndex ());
   m_newUeContextTrace (cellId, rnti);
+  // send all the SINRs to the coordinator with the next report, which adds those of the new UE
+  m_reportedSinrs.clear ();
   return rnti;
 }
 
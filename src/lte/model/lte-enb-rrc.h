@@ -77,6 +77,85 @@ class Packet;
 typedef std::map<uint64_t, double> ImsiSinrMap;
 typedef std::map<uint16_t, double> CellSinrMap;
 
+/**
+ * \ingroup lte
+ *
+ * The SINRs of the UEs towards the MmWave cells known by the LTE coordinator,
+ * stored as a dense matrix with a row per IMSI and a column per cell. The rows
+ * and the columns are sorted by IMSI and by cell ID. A SINR which was never
+ * reported is 0.
+ */
+class MmWaveSinrMatrix
+{
+public:
+  /**
+   * Set the SINR of a UE towards a cell, adding its row and column if needed
+   *
+   * \param imsi the IMSI of the UE
+   * \param cellId the ID of the MmWave cell
+   * \param sinr the SINR (linear)
+   */
+  void Set (uint64_t imsi, uint16_t cellId, double sinr);
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \param cellId the ID of the MmWave cell
+   * \return the SINR (linear) of the UE towards the cell, 0 if never reported
+   */
+  double Get (uint64_t imsi, uint16_t cellId) const;
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \param cellId the ID of the MmWave cell
+   * \return true if the cell reported the SINR of the UE
+   */
+  bool IsReported (uint64_t imsi, uint16_t cellId) const;
+
+  /// \return the IMSIs of the rows, sorted
+  const std::vector<uint64_t> & GetImsis () const;
+
+  /// \return the cell IDs of the columns, sorted
+  const std::vector<uint16_t> & GetCellIds () const;
+
+  /**
+   * \param row the index of the row, i.e., of the IMSI in GetImsis ()
+   * \param column the index of the column, i.e., of the cell in GetCellIds ()
+   * \return the SINR (linear) in the row and column, 0 if never reported
+   */
+  double GetAt (std::size_t row, std::size_t column) const;
+
+  /**
+   * \param row the index of the row, i.e., of the IMSI in GetImsis ()
+   * \param column the index of the column, i.e., of the cell in GetCellIds ()
+   * \return true if the SINR in the row and column was reported
+   */
+  bool IsReportedAt (std::size_t row, std::size_t column) const;
+
+  /// \return true if no SINR was reported
+  bool IsEmpty () const;
+
+  /// Remove all the rows and the columns
+  void Clear ();
+
+private:
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the index of the row of the IMSI, added if needed
+   */
+  std::size_t AddRow (uint64_t imsi);
+
+  /**
+   * \param cellId the ID of the MmWave cell
+   * \return the index of the column of the cell, added if needed
+   */
+  std::size_t AddColumn (uint16_t cellId);
+
+  std::vector<uint64_t> m_imsis;      ///< the IMSIs of the rows, sorted
+  std::vector<uint16_t> m_cellIds;    ///< the cell IDs of the columns, sorted
+  std::vector<double> m_sinrs;        ///< the SINRs, row-major
+  std::vector<uint8_t> m_reported;    ///< 1 if the SINR with the same index was reported, row-major
+};
+
 /**
  * \ingroup lte
  * Manages all the radio bearer information possessed by the ENB RRC for a
@@ -1076,6 +1155,15 @@ public:
    */
   uint16_t GetCellId () const;
 
+  /**
+   * If this is the LTE coordinator, get the last SINR reported by a MmWave cell for a UE
+   *
+   * \param imsi the IMSI of the UE
+   * \param cellId the ID of the MmWave cell
+   * \return the SINR (linear), 0 if the cell never reported it
+   */
+  double GetMmWaveSinr (uint64_t imsi, uint16_t cellId) const;
+
 
   /**
    * set the cell id of this eNB
@@ -1629,21 +1717,21 @@ private:
 
   /**
    * Trigger an handover according to certain conditions on the SINR
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the IMSI of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void ThresholdBasedSecondaryCellHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedSecondaryCellHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
     /**
    * Trigger an handover according to certain conditions on the SINR and the TTT
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the IMSI of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void TttBasedHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void TttBasedHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
   /**
    * Compute the TTT according to the sinrDifference and the dynamic handover algorithm
@@ -1664,12 +1752,12 @@ private:
 
   /**
    * Trigger an handover according to certain conditions on the SINR (for single-connectivity devices)
-   * @params the iterator on m_imsiCellSinrMap
+   * @params the IMSI of the UE
    * @params the sinrDifference between the current and the maxSinr cell
    * @params the CellId of the maximum SINR cell
    * @params the value of the SINR for this cell
    */
-  void ThresholdBasedInterRatHandover(std::map<uint64_t, CellSinrMap>::iterator imsiIter, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
+  void ThresholdBasedInterRatHandover(uint64_t imsi, double sinrDifference, uint16_t maxSinrCellId, double maxSinrDb);
 
   Callback <void, Ptr<Packet> > m_forwardUpCallback;  ///< forward up callback function
 
@@ -1905,15 +1993,18 @@ private:
   // for MmWave eNBs
   std::map<uint8_t, ImsiSinrMap> m_ueImsiSinrMap; // this map contains the ueImsiSinrMap reports sent by the CCs
   bool m_reportAllUeMeas; // if true, the MmWave eNB reports to the coordinator all the received UE measures, i.e. one per CC
+  double m_sinrReportThreshold; // change in dB of the SINR of a UE for which it is reported again to the coordinator
+  uint32_t m_sinrFullReportPeriod; // number of SINR reports after which all the SINRs are sent to the coordinator, 0 to disable
+  uint32_t m_numSinrReports; // SINR reports sent since all the SINRs were last sent
+  std::vector<EpcX2Sap::UeImsiSinr> m_reportedSinrs; // the SINRs known by the coordinator, sorted by IMSI
 
   // for LTE eNBs
-  std::map<uint16_t, ImsiSinrMap> m_cellSinrMap;
   uint16_t m_numNewSinrReports;
   std::map<uint64_t, uint16_t> m_bestMmWaveCellForImsiMap;
   std::map<uint64_t, uint16_t> m_lastMmWaveCell;
   std::map<uint64_t, bool> m_mmWaveCellSetupCompleted;
   std::map<uint64_t, bool> m_imsiUsingLte;
-  std::map<uint64_t, CellSinrMap> m_imsiCellSinrMap;
+  MmWaveSinrMatrix m_mmWaveSinrs;
   std::map<uint64_t, uint16_t> m_imsiRntiMap;
   std::map<uint16_t, uint64_t> m_rntiImsiMap;
 
@@ -37,12 +37,32 @@
 #include "ns3/ipv4-queue-disc-item.h"
 #include "ns3/ipv4-packet-filter.h"
 
+#include <algorithm>
+
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("LteRlcAm");
 
 NS_OBJECT_ENSURE_REGISTERED (LteRlcAm);
 
+namespace {
+
+/**
+ * The AM entities that have not been disposed, see LteRlcAm::GetInstances.
+ * Never destroyed, since the entities held by static objects unregister
+ * themselves at exit.
+ */
+std::map<uint64_t, LteRlcAm *> &
+GetRegistry (void)
+{
+  static std::map<uint64_t, LteRlcAm *> *instances = new std::map<uint64_t, LteRlcAm *> ();
+  return *instances;
+}
+
+/// The key in the registry of the next AM entity
+uint64_t g_nextInstanceId = 0;
+
+} // unnamed namespace
 
 LteRlcAm::LteRlcAm ()
 {
@@ -50,10 +70,9 @@ LteRlcAm::LteRlcAm ()
 
   // Buffers
   m_txonBufferSize = 0;
-  m_retxSegBuffer.resize (1024);
-  m_retxBuffer.resize (1024);
+  m_txWindow.resize (1024);
   m_retxBufferSize = 0;
-  m_txedBuffer.resize (1024);
+  m_retxBufferPdus = 0;
   m_txedBufferSize = 0;
 
   // LL HO
@@ -105,39 +124,14 @@ LteRlcAm::LteRlcAm ()
   m_txonQueue = CreateObject<CoDelQueueDisc> ();
   m_txonQueue->Initialize ();
 
-  m_traceBufferSizeEvent = Simulator::Schedule(MilliSeconds(2), &LteRlcAm::BufferSizeTrace, this);
-}
-
-void
-LteRlcAm::BufferSizeTrace()
-{
-  NS_LOG_LOGIC("BufferSizeTrace " << Simulator::Now().GetSeconds() << " " << m_rnti << " " << m_lcid << " " << m_txonBufferSize);
-  // write to file
-  /*if(!m_bufferSizeFile.is_open())
-  {
-    m_bufferSizeFile.open(GetBufferSizeFilename().c_str(), std::ofstream::app);
-    NS_LOG_LOGIC("File opened");
-  }
-  m_bufferSizeFile << Simulator::Now().GetSeconds() << " " << m_rnti << " " << (uint16_t) m_lcid << " " << m_txonBufferSize << std::endl;
-  */
-  m_traceBufferSizeEvent = Simulator::Schedule(MilliSeconds(10), &LteRlcAm::BufferSizeTrace, this);
-}
-
-std::string
-LteRlcAm::GetBufferSizeFilename()
-{
-  return m_bufferSizeFilename;
-}
-
-void
-LteRlcAm::SetBufferSizeFilename(std::string filename)
-{
-  m_bufferSizeFilename = filename;
+  m_instanceId = g_nextInstanceId++;
+  GetRegistry ()[m_instanceId] = this;
 }
 
 LteRlcAm::~LteRlcAm ()
 {
   NS_LOG_FUNCTION (this);
+  Unregister ();
 }
 
 TypeId
@@ -185,11 +179,6 @@ LteRlcAm::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&LteRlcAm::m_enableAqm),
                    MakeBooleanChecker ())
-   .AddAttribute ("BufferSizeFilename",
-                   "Name of the file where the buffer size will be periodically written.",
-                   StringValue ("RlcAmBufferSize.txt"),
-                   MakeStringAccessor (&LteRlcAm::SetBufferSizeFilename),
-                   MakeStringChecker ())
     ;
   return tid;
 }
@@ -205,10 +194,10 @@ LteRlcAm::DoDispose ()
 
   m_txonBuffer.clear ();
   m_txonBufferSize = 0;
-  m_txedBuffer.clear ();
+  m_txWindow.clear ();
   m_txedBufferSize = 0;
-  m_retxBuffer.clear ();
   m_retxBufferSize = 0;
+  m_retxBufferPdus = 0;
   m_rxonBuffer.clear ();
   m_sdusBuffer.clear ();
   m_keepS0 = 0;
@@ -225,8 +214,7 @@ LteRlcAm::DoDispose ()
   m_txedRlcSduBuffer.clear ();
   m_txedRlcSduBufferSize = 0;
 
-  m_traceBufferSizeEvent.Cancel();
-  m_bufferSizeFile.close();
+  Unregister ();
 
   LteRlc::DoDispose ();
 }
@@ -424,24 +412,25 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
       for (sn = m_vtA; sn < m_vtS; sn++)
         {
           uint16_t seqNumberValue = sn.GetValue ();
-          NS_LOG_LOGIC ("SN = " << seqNumberValue << " m_pdu " << m_retxBuffer.at (seqNumberValue).m_pdu);
+          TxPdu &txPdu = m_txWindow.at (seqNumberValue);
+          NS_LOG_LOGIC ("SN = " << seqNumberValue << " state " << (uint16_t) txPdu.m_state);
 
-          if (m_retxSegBuffer.at (seqNumberValue).m_lastSegSent)
+          if (txPdu.m_lastSegSent)
           {
             return; // all segments sent, need to wait for ACK or reorder timer to expire
           }
 
           Ptr<Packet> packet;
           bool segment = false;
-          if (m_retxSegBuffer.at (seqNumberValue).m_pdu)
+          if (txPdu.m_nextSegment)
           {
-            packet = m_retxSegBuffer.at (seqNumberValue).m_pdu->Copy ();
+            packet = txPdu.m_nextSegment->Copy ();
             found = true;
             segment = true;
           }
-          else if (m_retxBuffer.at (seqNumberValue).m_pdu)
+          else if (txPdu.m_state == TX_PDU_RETX_PENDING)
           {
-            packet = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
+            packet = txPdu.m_pdu->Copy ();
             found = true;
           }
           if (found == true)
@@ -459,8 +448,8 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
                     NS_LOG_INFO ("Sending last RLC PDU segment, sn= " << seqNumberValue << " offset= " << rlcAmHeader.GetSegmentOffset()
                                                      << " size= " << rlcAmHeader.GetLastOffset()-rlcAmHeader.GetSegmentOffset());
                     // opportunity is large enough to transmit remaining segment, so clear segment buffer
-                    m_retxSegBuffer.at(seqNumberValue).m_pdu = 0;
-                    m_retxSegBuffer.at(seqNumberValue).m_lastSegSent = true;
+                    txPdu.m_nextSegment = 0;
+                    txPdu.m_lastSegSent = true;
                     rlcAmHeader.SetLastSegmentFlag (LteRlcAmHeader::LAST_PDU_SEGMENT);
                   }
 
@@ -513,27 +502,23 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
                   m_macSapProvider->TransmitPdu (params);
 
-                  m_retxBuffer.at (seqNumberValue).m_retxCount++;
+                  txPdu.m_retxCount++;
                   NS_LOG_INFO ("Incr RETX_COUNT for SN = " << seqNumberValue);
-                  if (m_retxBuffer.at (seqNumberValue).m_retxCount >= m_maxRetxThreshold)
+                  if (txPdu.m_retxCount >= m_maxRetxThreshold)
                     {
                       NS_LOG_INFO ("Max RETX_COUNT for SN = " << seqNumberValue);
                     }
 
                   NS_LOG_INFO ("Move SN = " << seqNumberValue << " back to txedBuffer");
-                  m_txedBuffer.at (seqNumberValue).m_pdu = m_retxBuffer.at (seqNumberValue).m_pdu->Copy ();
-                  m_txedBuffer.at (seqNumberValue).m_retxCount = m_retxBuffer.at (seqNumberValue).m_retxCount;
-                  NS_ASSERT_MSG(m_txedBuffer.at (seqNumberValue).m_pdu, "Just inserted an invalid pointer");
-                  m_txedBufferSize += m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-
-                  m_retxBufferSize -= m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_retxBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = 0;
+                  NS_ASSERT_MSG (txPdu.m_state == TX_PDU_RETX_PENDING, "SN " << seqNumberValue << " not in the retxBuffer");
+                  txPdu.m_state = TX_PDU_TXED;
+                  m_txedBufferSize += txPdu.m_pdu->GetSize ();
+                  m_retxBufferSize -= txPdu.m_pdu->GetSize ();
+                  m_retxBufferPdus--;
 
                   // reset segment buffer
-                  m_retxSegBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_retxCount = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_lastSegSent = 0;
+                  txPdu.m_nextSegment = 0;
+                  txPdu.m_lastSegSent = false;
 
                   NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
 
@@ -624,7 +609,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
                   nextSeg->AddHeader (nextSegHdr);
 
                   // add next segment to reTX segment buffer
-                  m_retxSegBuffer.at (seqNumberValue).m_pdu = nextSeg;
+                  txPdu.m_nextSegment = nextSeg;
 
                   NS_LOG_LOGIC ("new AM RLC header: " << firstSegHdr);
 
@@ -715,16 +700,14 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   }
 
 
-  Ptr<Packet> packet = Create<Packet> ();
   LteRlcAmHeader rlcAmHeader;
   rlcAmHeader.SetDataPdu ();
 
   // Build Data field
   uint32_t nextSegmentSize = txOpParams.bytes - 4;
   uint32_t nextSegmentId = 1;
-  uint32_t dataFieldTotalSize = 0;
   uint32_t dataFieldAddedSize = 0;
-  std::vector < Ptr<Packet> > dataField;
+  LteRlcDataField &dataField = m_dataField;
 
   // Remove the first packet from the transmission buffer.
   // If only a segment of the packet is taken, then the remaining is given back later
@@ -747,7 +730,9 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
     m_txonBufferSize += tempP->GetSize ();
   }
 
-  Ptr<Packet> firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
+  // The SDUs are not modified while the Data field is built, they are only
+  // referred to by the Data field
+  Ptr<Packet> firstSegment = *(m_txonBuffer.begin ());
 
   // LL HO
   // tricky: store the incomplete Rlc SDU for forwarding to
@@ -762,7 +747,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
   m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txonBufferSize );
-  m_txonBuffer.erase (m_txonBuffer.begin ());
+  m_txonBuffer.pop_front ();
 
   while ( firstSegment && (firstSegment->GetSize () > 0) && (nextSegmentSize > 0) )
     {
@@ -783,18 +768,17 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
           // Segment txBuffer.FirstBuffer and
           // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
           // LL HO: This firstSegment is fragmented. Update the status variable.
           is_fragmented = 1;
 
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
+          NS_LOG_LOGIC ("    newSegment size   = " << currSegmentSize);
 
           // Status tag of the new and remaining segments
           // Note: This is the only place where a PDU is segmented and
           // therefore its status can change
           LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
+          firstSegment->PeekPacketTag (oldTag);
+          newTag.SetStatus (oldTag.GetStatus ());
           if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
             {
               newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
@@ -807,25 +791,17 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             }
 
           // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
+          uint32_t remainingSize = firstSegment->GetSize () - currSegmentSize;
+          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << remainingSize);
+          if (remainingSize > 0)
             {
-              firstSegment->AddPacketTag (oldTag);
+              Ptr<Packet> remainingSegment = firstSegment->CreateFragment (currSegmentSize, remainingSize);
+              remainingSegment->ReplacePacketTag (oldTag);
 
               //LL HO Mark the first SDU is txonBuffer is fragmented. This maybe not needed.
               is_fragmented = 1;
 
-              // m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-
-              if(m_txonBuffer.empty())
-              {
-                m_txonBuffer.push_back(firstSegment);
-              }
-              else
-              {
-                m_txonBuffer.insert (m_txonBuffer.begin (), firstSegment);
-              }
+              m_txonBuffer.push_front (remainingSegment);
 
               m_txonBufferSize += (*(m_txonBuffer.begin()))->GetSize ();
 
@@ -848,17 +824,11 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             }
           // Segment is completely taken or
           // the remaining segment is given back to the transmission buffer
+          // Add Segment to Data field, with its status once it has been adjusted
+          dataFieldAddedSize = currSegmentSize;
+          dataField.AddAtEnd (firstSegment, 0, currSegmentSize, newTag.GetStatus ());
           firstSegment = 0;
 
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
-
-          // Add Segment to Data field
-          dataFieldAddedSize = newSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (newSegment);
-          newSegment = 0;
-
           // ExtensionBit (Next_Segment - 1) = 0
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::DATA_FIELD_FOLLOWS);
 
@@ -879,8 +849,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
           // Add txBuffer.FirstBuffer to DataField
           dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
+          dataField.AddAtEnd (firstSegment);
           firstSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
@@ -909,8 +878,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txonBuffer.size > 0");
           // Add txBuffer.FirstBuffer to DataField
           dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
+          dataField.AddAtEnd (firstSegment);
 
           // ExtensionBit (Next_Segment - 1) = 1
           rlcAmHeader.PushExtensionBit (LteRlcAmHeader::E_LI_FIELDS_FOLLOWS);
@@ -939,7 +907,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
             m_txonBufferSize += tempP->GetSize ();
           }
 
-          firstSegment = (*(m_txonBuffer.begin ()))->Copy ();
+          firstSegment = *(m_txonBuffer.begin ());
 
           // LL HO
           // New complete SDU is taken from txonBuffer so reset the
@@ -957,7 +925,7 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
           entireSdu = (*(m_txonBuffer.begin ()))->Copy ();
 
           m_txonBufferSize -= (*(m_txonBuffer.begin()))->GetSize ();
-          m_txonBuffer.erase (m_txonBuffer.begin ());
+          m_txonBuffer.pop_front ();
           NS_LOG_LOGIC ("        txBufferSize = " << m_txonBufferSize );
         }
     }
@@ -986,14 +954,11 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
 
   // Calculate FramingInfo flag according the status of the SDUs in the DataField
   uint8_t framingInfo = 0;
-  std::vector< Ptr<Packet> >::iterator it;
-  it = dataField.begin ();
 
   // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-       (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT)
+  uint8_t status = dataField.GetFirstStatus ();
+  if ( (status == LteRlcSduStatusTag::FULL_SDU) ||
+       (status == LteRlcSduStatusTag::FIRST_SEGMENT)
      )
     {
       framingInfo |= LteRlcAmHeader::FIRST_BYTE;
@@ -1002,22 +967,16 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
     {
       framingInfo |= LteRlcAmHeader::NO_FIRST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Add all SDUs (in DataField) to the Packet
-  while (it < dataField.end ())
-    {
-      NS_LOG_LOGIC ("Adding SDU/segment to packet, length = " << (*it)->GetSize ());
-
-      packet->AddAtEnd (*it);
-      it++;
-    }
+  NS_LOG_LOGIC ("Adding " << dataField.GetNSegments () << " SDUs/segments to packet, length = " << dataField.GetSize ());
+  Ptr<Packet> packet = dataField.Serialize ();
 
   // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
+  status = dataField.GetLastStatus ();
+  dataField.Clear ();
+  if ( (status == LteRlcSduStatusTag::FULL_SDU) ||
+        (status == LteRlcSduStatusTag::LAST_SEGMENT) )
     {
       framingInfo |= LteRlcAmHeader::LAST_BYTE;
     }
@@ -1025,7 +984,6 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
     {
       framingInfo |= LteRlcAmHeader::NO_LAST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   // Set the FramingInfo flag after the calculation
   rlcAmHeader.SetFramingInfo (framingInfo);
@@ -1083,9 +1041,14 @@ LteRlcAm::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters txOpPara
   // Store new PDU into the Transmitted PDU Buffer
   NS_LOG_LOGIC ("Put transmitted PDU in the txedBuffer");
   m_txedBufferSize += packet->GetSize ();
-  m_txedBuffer.at ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_pdu = packet->Copy ();
-  m_txedBuffer.at ( rlcAmHeader.GetSequenceNumber ().GetValue () ).m_retxCount = 0;
-  NS_ASSERT_MSG(m_txedBuffer.at (rlcAmHeader.GetSequenceNumber ().GetValue ()).m_pdu, "Just inserted an invalid pointer");
+  TxPdu &txPdu = m_txWindow.at (rlcAmHeader.GetSequenceNumber ().GetValue ());
+  NS_ASSERT_MSG (txPdu.m_state == TX_PDU_EMPTY, "SN " << rlcAmHeader.GetSequenceNumber () << " still in the window");
+  txPdu.m_pdu = packet->Copy ();
+  txPdu.m_nextSegment = 0;
+  txPdu.m_txTime = Simulator::Now ();
+  txPdu.m_retxCount = 0;
+  txPdu.m_state = TX_PDU_TXED;
+  txPdu.m_lastSegSent = false;
 
   // Sender timestamp
   RlcTag rlcTag (Simulator::Now ());
@@ -1132,9 +1095,16 @@ uint32_t LteRlcAm::GetTxBufferSize()
 std::vector < LteRlcAm::RetxPdu >
 LteRlcAm::GetTxedBuffer()
 {
-  //std::vector < LteRlcAm::RetxPdu > toBeReturned;
-  //toBeReturned.insert(toBeReturned.begin(), m_txedBuffer.begin(), m_txedBuffer.end());
-  return m_txedBuffer;
+  std::vector < LteRlcAm::RetxPdu > toBeReturned (m_txWindow.size ());
+  for (uint32_t sn = 0; sn < m_txWindow.size (); sn++)
+    {
+      if (m_txWindow[sn].m_state == TX_PDU_TXED)
+        {
+          toBeReturned[sn].m_pdu = m_txWindow[sn].m_pdu;
+          toBeReturned[sn].m_retxCount = m_txWindow[sn].m_retxCount;
+        }
+    }
+  return toBeReturned;
 }
 uint32_t
 LteRlcAm::GetTxedBufferSize()
@@ -1145,8 +1115,15 @@ LteRlcAm::GetTxedBufferSize()
 std::vector < LteRlcAm::RetxPdu >
 LteRlcAm::GetRetxBuffer()
 {
-  std::vector < LteRlcAm::RetxPdu > toBeReturned;
-  toBeReturned.insert(toBeReturned.begin(), m_retxBuffer.begin(), m_retxBuffer.end());
+  std::vector < LteRlcAm::RetxPdu > toBeReturned (m_txWindow.size ());
+  for (uint32_t sn = 0; sn < m_txWindow.size (); sn++)
+    {
+      if (m_txWindow[sn].m_state == TX_PDU_RETX_PENDING)
+        {
+          toBeReturned[sn].m_pdu = m_txWindow[sn].m_pdu;
+          toBeReturned[sn].m_retxCount = m_txWindow[sn].m_retxCount;
+        }
+    }
   return toBeReturned;
 }
 
@@ -1156,6 +1133,57 @@ LteRlcAm::GetRetxBufferSize()
   return m_retxBufferSize;
 }
 
+LteRlcAm::BufferStatus
+LteRlcAm::GetBufferStatus (void) const
+{
+  Time now = Simulator::Now ();
+  BufferStatus status;
+  status.m_txonBufferSize = m_txonBufferSize + m_txonQueue->GetNBytes ();
+  status.m_txonHolDelay = Seconds (0);
+  if (!m_txonBuffer.empty ())
+    {
+      // a packet without a tag does not count for the delay
+      RlcTag holTimeTag;
+      if (m_txonBuffer.front ()->PeekPacketTag (holTimeTag))
+        {
+          status.m_txonHolDelay = now - holTimeTag.GetSenderTimestamp ();
+        }
+    }
+  status.m_retxBufferPdus = m_retxBufferPdus;
+  status.m_retxBufferSize = m_retxBufferSize;
+  status.m_retxHolDelay = Seconds (0);
+  if (m_retxBufferPdus > 0)
+    {
+      // the PDUs to retransmit are usually close to VT(A)
+      SequenceNumber10 sn = m_vtA;
+      sn.SetModulusBase (m_vtA);
+      for (; sn < m_vtS; sn++)
+        {
+          const TxPdu &txPdu = m_txWindow.at (sn.GetValue ());
+          if (txPdu.m_state == TX_PDU_RETX_PENDING)
+            {
+              status.m_retxHolDelay = now - txPdu.m_txTime;
+              break;
+            }
+        }
+    }
+  status.m_txedBufferSize = m_txedBufferSize;
+  return status;
+}
+
+const std::map<uint64_t, LteRlcAm *> &
+LteRlcAm::GetInstances (void)
+{
+  return GetRegistry ();
+}
+
+void
+LteRlcAm::Unregister (void)
+{
+  // does nothing if the entity was already removed
+  GetRegistry ().erase (m_instanceId);
+}
+
 std::map < uint32_t, Ptr<Packet> >
 LteRlcAm::GetTransmittingRlcSduBuffer()
 {
@@ -1204,18 +1232,8 @@ LteRlcAm::DoNotifyDlHarqDeliveryFailure (uint8_t harqId)
   NS_ASSERT (it != m_harqIdToSnMap.end ());
 
   uint16_t seqNumberValue = it->second;
-  if (m_txedBuffer.at (seqNumberValue).m_pdu != 0)
-  {
-    NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-    m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
-    m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
-    m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-
-    m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-    m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-    m_txedBuffer.at (seqNumberValue).m_retxCount = 0;
-  }
-  NS_ASSERT (m_retxBuffer.at (seqNumberValue).m_pdu != 0);
+  MoveToRetxBuffer (seqNumberValue);
+  NS_ASSERT (m_txWindow.at (seqNumberValue).m_state == TX_PDU_RETX_PENDING);
 */
 }
 
@@ -2104,7 +2122,6 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
       NS_LOG_INFO ("Control AM RLC PDU");
 
       SequenceNumber10 ackSn = rlcAmHeader.GetAckSn ();
-      SequenceNumber10 sn;
 
       NS_LOG_INFO ("ackSn     = " << ackSn);
       NS_LOG_INFO ("VT(A)     = " << m_vtA);
@@ -2116,93 +2133,67 @@ LteRlcAm::DoReceivePdu (LteMacSapUser::ReceivePduParameters rxPduParams)
       m_vtS.SetModulusBase (m_vtA);
       m_vtMs.SetModulusBase (m_vtA);
       ackSn.SetModulusBase (m_vtA);
-      sn.SetModulusBase (m_vtA);
-
-      bool incrementVtA = true;
 
-      for (sn = m_vtA; sn < ackSn && sn < m_vtS; sn++)
+      // The STATUS PDU covers VT(A) <= SN < min (ACK_SN, VT(S)). The SNs
+      // are handled as offsets from VT(A), and the NACKs split this span
+      // in spans of ACKed PDUs.
+      uint16_t vtA = m_vtA.GetValue ();
+      uint16_t span = std::min ((ackSn.GetValue () - vtA + 1024) % 1024,
+                                (m_vtS.GetValue () - vtA + 1024) % 1024);
+      std::vector<uint16_t> nackOffsets;
+      for (int nack = rlcAmHeader.PopNack (); nack != -1; nack = rlcAmHeader.PopNack ())
         {
-          NS_LOG_LOGIC ("sn = " << sn);
-
-          uint16_t seqNumberValue = sn.GetValue ();
-
-          if (m_pollRetransmitTimer.IsRunning ()
-              && (seqNumberValue == m_pollSn.GetValue ()))
+          uint16_t offset = (nack - vtA + 1024) % 1024;
+          if (offset < span)
             {
-              m_pollRetransmitTimer.Cancel ();
+              nackOffsets.push_back (offset);
             }
+        }
+      std::sort (nackOffsets.begin (), nackOffsets.end ());
+      nackOffsets.erase (std::unique (nackOffsets.begin (), nackOffsets.end ()), nackOffsets.end ());
+      nackOffsets.push_back (span);
 
-          if (rlcAmHeader.IsNackPresent (sn))
-            {
-              NS_LOG_LOGIC ("sn " << sn << " is NACKed");
-
-              incrementVtA = false;
-
-              if (m_txedBuffer.at (seqNumberValue).m_pdu)
-                {
-                  NS_LOG_INFO ("Move SN = " << seqNumberValue << " to retxBuffer");
-                  m_retxBuffer.at (seqNumberValue).m_pdu = m_txedBuffer.at (seqNumberValue).m_pdu->Copy ();
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = m_txedBuffer.at (seqNumberValue).m_retxCount;
-                  m_retxBufferSize += m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-
-                  m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_txedBuffer.at (seqNumberValue).m_retxCount = 0;
-                }
-
-              NS_ASSERT (m_retxBuffer.at (seqNumberValue).m_pdu);
+      if (m_pollRetransmitTimer.IsRunning ()
+          && (m_pollSn.GetValue () - vtA + 1024) % 1024 < span)
+        {
+          m_pollRetransmitTimer.Cancel ();
+        }
 
-            }
-          else
+      uint16_t offset = 0;
+      for (uint16_t nackOffset : nackOffsets)
+        {
+          for (; offset < nackOffset; offset++)
             {
-              NS_LOG_LOGIC ("sn " << sn << " is ACKed");
-
-              if (m_txedBuffer.at (seqNumberValue).m_pdu)
-                {
-                  NS_LOG_INFO ("ACKed SN = " << seqNumberValue << " from txedBuffer");
-                  //               NS_LOG_INFO ("m_txedBuffer( " << m_vtA << " )->GetSize = " << m_txedBuffer.at (m_vtA.GetValue ())->GetSize ());
-                  NS_LOG_LOGIC("m_txCompletedCallback " << m_rnti);
-                  m_txCompletedCallback(m_rnti, m_lcid, m_txedBuffer.at (seqNumberValue).m_pdu->GetSize (), 0); // 0 retransmissions at the RLC layer
-
-                  m_txedBufferSize -= m_txedBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  m_txedBuffer.at (seqNumberValue).m_pdu = 0;
-                  NS_ASSERT (!m_retxBuffer.at (seqNumberValue).m_pdu);
-                }
-
-              if (m_retxBuffer.at (seqNumberValue).m_pdu)
-                {
-                  NS_LOG_INFO ("ACKed SN = " << seqNumberValue << " from retxBuffer");
-                  m_retxBufferSize -= m_retxBuffer.at (seqNumberValue).m_pdu->GetSize ();
-                  NS_LOG_LOGIC("m_txCompletedCallback " << m_rnti);
-
-                  m_txCompletedCallback(m_rnti, m_lcid, m_retxBuffer.at (seqNumberValue).m_pdu->GetSize (), m_retxBuffer.at (seqNumberValue).m_retxCount);
-
-                  m_retxBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxBuffer.at (seqNumberValue).m_retxCount = 0;
-                  // reset segment buffer
-                  m_retxSegBuffer.at (seqNumberValue).m_pdu = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_retxCount = 0;
-                  m_retxSegBuffer.at (seqNumberValue).m_lastSegSent = 0;
-                }
-
+              AckTxPdu ((vtA + offset) % 1024);
             }
-
-          NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
-          NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
-
-          if (incrementVtA)
+          if (offset < span)
             {
-              m_vtA++;
-              m_vtMs = m_vtA + m_windowSize;
-              NS_LOG_INFO ("New VT(A) = " << m_vtA);
-              m_vtA.SetModulusBase (m_vtA);
-              m_vtMs.SetModulusBase (m_vtA);
-              m_vtS.SetModulusBase (m_vtA);
-              ackSn.SetModulusBase (m_vtA);
-              sn.SetModulusBase (m_vtA);
+              uint16_t seqNumberValue = (vtA + offset) % 1024;
+              NS_LOG_LOGIC ("sn " << seqNumberValue << " is NACKed");
+              MoveToRetxBuffer (seqNumberValue);
+              NS_ASSERT (m_txWindow.at (seqNumberValue).m_state == TX_PDU_RETX_PENDING);
+              offset++;
             }
+        }
 
-        } // loop over SN : VT(A) <= SN < ACK SN
+      NS_LOG_LOGIC ("retxBufferSize = " << m_retxBufferSize);
+      NS_LOG_LOGIC ("txedBufferSize = " << m_txedBufferSize);
+
+      // advance VT(A) up to the first NACKed PDU
+      uint16_t acked = nackOffsets.front ();
+      for (offset = 0; offset < acked; offset++)
+        {
+          m_txWindow.at ((vtA + offset) % 1024).m_state = TX_PDU_EMPTY;
+        }
+      if (acked > 0)
+        {
+          m_vtA = m_vtA + acked;
+          m_vtMs = m_vtA + m_windowSize;
+          NS_LOG_INFO ("New VT(A) = " << m_vtA);
+          m_vtA.SetModulusBase (m_vtA);
+          m_vtMs.SetModulusBase (m_vtA);
+          m_vtS.SetModulusBase (m_vtA);
+        }
 
       return;
 
@@ -2699,14 +2690,7 @@ LteRlcAm::DoReportBufferStatus (void)
   RlcTag retxQueueHolTimeTag;
   if ( m_retxBufferSize > 0 )
     {
-      if (m_retxBuffer.at (m_vtA.GetValue ()).m_pdu)
-        {
-          m_retxBuffer.at (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
-        }
-      else
-        {
-          m_txedBuffer.at (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
-        }
+      m_txWindow.at (m_vtA.GetValue ()).m_pdu->PeekPacketTag (retxQueueHolTimeTag);
       retxQueueHolDelay = now - retxQueueHolTimeTag.GetSenderTimestamp ();
     }
   else
@@ -2829,63 +2813,11 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
       || (m_vtS == m_vtMs))
     {
       NS_LOG_INFO ("txonBuffer and retxBuffer empty. Move PDUs up to = " << m_vtS.GetValue () - 1 << " to retxBuffer");
-      uint16_t sn = 0;
-      uint16_t acked =  m_vtA.GetValue();
-      uint16_t sent = m_vtS.GetValue ();
-      if(acked <= sent) //If no overflow, no change.
+      uint16_t vtA = m_vtA.GetValue ();
+      uint16_t numPdus = (m_vtS.GetValue () - vtA + 1024) % 1024;
+      for (uint16_t offset = 0; offset < numPdus; offset++)
         {
-      for ( sn = m_vtA.GetValue(); sn < m_vtS.GetValue (); sn++ )
-      {
-        bool pduAvailable = (bool)m_txedBuffer.at (sn).m_pdu;
-
-         if ( pduAvailable )
-         {
-           NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
-           m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
-           m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
-           m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
-           m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
-           m_txedBuffer.at (sn).m_pdu = 0;
-           m_txedBuffer.at (sn).m_retxCount = 0;
-         }
-       }
-         }
-       else//If overflow happened, we retransmit from acked sequence to 1023, then from 0 to sent sequence.
-         {
-       for ( sn = m_vtA.GetValue(); sn < 1024; sn++ )
-         {
-         bool pduAvailable = (bool)m_txedBuffer.at (sn).m_pdu;
-
-         if ( pduAvailable )
-         {
-           NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
-           m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
-           m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
-           m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
-           m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
-           m_txedBuffer.at (sn).m_pdu = 0;
-           m_txedBuffer.at (sn).m_retxCount = 0;
-         }
-      }
-
-      for ( sn = 0; sn < m_vtS.GetValue (); sn++ )
-      {
-        bool pduAvailable = (bool)m_txedBuffer.at (sn).m_pdu;
-
-         if ( pduAvailable )
-         {
-           NS_LOG_INFO ("Move PDU " << sn << " from txedBuffer to retxBuffer");
-           m_retxBuffer.at (sn).m_pdu = m_txedBuffer.at (sn).m_pdu->Copy ();
-           m_retxBuffer.at (sn).m_retxCount = m_txedBuffer.at (sn).m_retxCount;
-           m_retxBufferSize += m_retxBuffer.at (sn).m_pdu->GetSize ();
-
-           m_txedBufferSize -= m_txedBuffer.at (sn).m_pdu->GetSize ();
-           m_txedBuffer.at (sn).m_pdu = 0;
-           m_txedBuffer.at (sn).m_retxCount = 0;
-         }
-      }
+          MoveToRetxBuffer ((vtA + offset) % 1024);
         }
     }
 
@@ -2893,6 +2825,48 @@ LteRlcAm::ExpirePollRetransmitTimer (void)
 }
 
 
+void
+LteRlcAm::MoveToRetxBuffer (uint16_t sn)
+{
+  TxPdu &txPdu = m_txWindow.at (sn);
+  if (txPdu.m_state == TX_PDU_TXED)
+    {
+      NS_LOG_INFO ("Move SN = " << sn << " to retxBuffer");
+      txPdu.m_state = TX_PDU_RETX_PENDING;
+      m_retxBufferSize += txPdu.m_pdu->GetSize ();
+      m_retxBufferPdus++;
+      m_txedBufferSize -= txPdu.m_pdu->GetSize ();
+    }
+}
+
+void
+LteRlcAm::AckTxPdu (uint16_t sn)
+{
+  TxPdu &txPdu = m_txWindow.at (sn);
+  if (txPdu.m_state == TX_PDU_TXED)
+    {
+      NS_LOG_INFO ("ACKed SN = " << sn << " from txedBuffer");
+      m_txCompletedCallback (m_rnti, m_lcid, txPdu.m_pdu->GetSize (), 0); // 0 retransmissions at the RLC layer
+      m_txedBufferSize -= txPdu.m_pdu->GetSize ();
+    }
+  else if (txPdu.m_state == TX_PDU_RETX_PENDING)
+    {
+      NS_LOG_INFO ("ACKed SN = " << sn << " from retxBuffer");
+      m_txCompletedCallback (m_rnti, m_lcid, txPdu.m_pdu->GetSize (), txPdu.m_retxCount);
+      m_retxBufferSize -= txPdu.m_pdu->GetSize ();
+      m_retxBufferPdus--;
+    }
+  else
+    {
+      return;
+    }
+  txPdu.m_pdu = 0;
+  txPdu.m_nextSegment = 0;
+  txPdu.m_retxCount = 0;
+  txPdu.m_state = TX_PDU_ACKED;
+  txPdu.m_lastSegSent = false;
+}
+
 void
 LteRlcAm::ExpireStatusProhibitTimer (void)
 {
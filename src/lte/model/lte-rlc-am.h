@@ -32,10 +32,11 @@
 #include <ns3/lte-rlc.h>
 #include <ns3/epc-x2-sap.h>
 #include <ns3/lte-pdcp-header.h>
+#include <ns3/lte-rlc-data-field.h>
 
+#include <deque>
 #include <vector>
 #include <map>
-#include <fstream>
 #include <string>
 
 #include "ns3/codel-queue-disc.h"
@@ -96,6 +97,30 @@ public:
     return m_txedRlcSduBuffer;
   }
 
+  /// Occupancy of the transmission and retransmission buffers
+  struct BufferStatus
+  {
+    uint32_t m_txonBufferSize;    ///< bytes waiting for a first transmission, including the AQM queue
+    Time     m_txonHolDelay;      ///< time spent in the transmission buffer by its first SDU
+    uint32_t m_retxBufferPdus;    ///< PDUs considered for retransmission
+    uint32_t m_retxBufferSize;    ///< bytes considered for retransmission
+    Time     m_retxHolDelay;      ///< time since the first transmission of the oldest PDU to retransmit
+    uint32_t m_txedBufferSize;    ///< bytes transmitted and waiting for an ACK
+  };
+
+  /**
+   * \returns the current occupancy of the buffers
+   */
+  BufferStatus GetBufferStatus (void) const;
+
+  /**
+   * Get the AM entities that have not been disposed, so that their buffers
+   * can be sampled without an event per entity
+   *
+   * \returns the entities, keyed and thus ordered by their creation
+   */
+  static const std::map<uint64_t, LteRlcAm *> & GetInstances (void);
+
 private:
   //whether the last SDU in the txonBuffer is a complete SDU.
   bool is_fragmented;
@@ -137,6 +162,20 @@ private:
    */
   void ExpireStatusProhibitTimer (void);
 
+  /**
+   * Consider a transmitted PDU for retransmission
+   *
+   * \param sn the SN of the PDU
+   */
+  void MoveToRetxBuffer (uint16_t sn);
+
+  /**
+   * Release an ACKed PDU of the transmission window
+   *
+   * \param sn the SN of the PDU
+   */
+  void AckTxPdu (uint16_t sn);
+
   /**
    * method called when the T_status_prohibit timer expires
    *
@@ -171,18 +210,35 @@ private:
    */
   void DoReportBufferStatus ();
 
-  std::string GetBufferSizeFilename();
-  void SetBufferSizeFilename(std::string filename);
-  void BufferSizeTrace();
+  /**
+   * Remove this entity from the instances returned by GetInstances
+   */
+  void Unregister (void);
+
+  uint64_t m_instanceId; ///< key of this entity in the instances returned by GetInstances
 
 private:
-    std::vector < Ptr<Packet> > m_txonBuffer; ///< Transmission buffer
+    std::deque < Ptr<Packet> > m_txonBuffer; ///< Transmission buffer, segments are given back at its front
+    LteRlcDataField m_dataField; ///< Data field of the PDU being built, reused across the PDUs
+
+    /// State of a PDU in the transmission window
+    enum TxPduState
+    {
+      TX_PDU_EMPTY = 0,       ///< no PDU with this SN
+      TX_PDU_TXED,            ///< transmitted or retransmitted, not considered for retransmission
+      TX_PDU_RETX_PENDING,    ///< considered for retransmission
+      TX_PDU_ACKED            ///< ACKed after a NACKed PDU, VT(A) not advanced over it yet
+    };
 
-    struct RetxSegPdu
+    /// A PDU of the transmission window
+    struct TxPdu
     {
-      Ptr<Packet> m_pdu; ///< PDU
-      uint16_t    m_retxCount; ///< retransmit count
-      bool      m_lastSegSent;    // all segments sent, waiting for ACK
+      Ptr<Packet> m_pdu;          ///< the PDU, as first transmitted
+      Ptr<Packet> m_nextSegment;  ///< the rest of a PDU retransmitted in segments
+      Time        m_txTime;       ///< time of the first transmission
+      uint16_t    m_retxCount;    ///< retransmit count
+      uint8_t     m_state;        ///< TxPduState
+      bool        m_lastSegSent;  ///< all segments sent, waiting for ACK
     };
 
   // LL HO: store a complete version of the incomplete RLC SDU at the
@@ -191,11 +247,10 @@ private:
   // to assure no packet is lost.
   Ptr<Packet> m_segmented_rlcsdu;
 
-  std::vector <RetxPdu> m_txedBuffer;  ///< Buffer for transmitted and retransmitted PDUs
-                                       ///< that have not been acked but are not considered
-                                       ///< for retransmission
-  std::vector <RetxPdu> m_retxBuffer;  ///< Buffer for PDUs considered for retransmission
-  std::vector <RetxSegPdu> m_retxSegBuffer;  // buffer for AM PDU segments
+  /// Transmitted PDUs that have not been acked, indexed by SN. A PDU moves
+  /// between the txed and the retx buffers, i.e., the TX_PDU_TXED and the
+  /// TX_PDU_RETX_PENDING states, without being copied
+  std::vector <TxPdu> m_txWindow;
 
   Ptr<CoDelQueueDisc> m_txonQueue;
 
@@ -207,6 +262,7 @@ private:
 
     uint32_t m_txonBufferSize;  ///< transmit on buffer size
     uint32_t m_retxBufferSize;  ///< transmit on buffer size
+    uint32_t m_retxBufferPdus;  ///< number of PDUs in the retransmission buffer
     uint32_t m_txedBufferSize;  ///< transmit ed buffer size
 
     bool     m_statusPduRequested; ///< status PDU requested
@@ -304,10 +360,6 @@ private:
 
   uint32_t m_maxTxBufferSize;
 
-  std::string m_bufferSizeFilename;
-  std::ofstream m_bufferSizeFile;
-  EventId m_traceBufferSizeEvent;
-
   bool m_enableAqm;
 
 };
@@ -0,0 +1,125 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "lte-rlc-data-field.h"
+#include "lte-rlc-sdu-status-tag.h"
+
+#include "ns3/log.h"
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("LteRlcDataField");
+
+LteRlcDataField::LteRlcDataField ()
+  : m_size (0)
+{
+}
+
+void
+LteRlcDataField::AddAtEnd (Ptr<const Packet> sdu, uint32_t offset, uint32_t length, uint8_t status)
+{
+  NS_LOG_FUNCTION (this << sdu << offset << length << (uint16_t) status);
+  NS_ASSERT_MSG (offset + length <= sdu->GetSize (), "Segment beyond the end of the SDU");
+  Segment segment;
+  segment.m_sdu = sdu;
+  segment.m_offset = offset;
+  segment.m_length = length;
+  segment.m_status = status;
+  m_segments.push_back (segment);
+  m_size += length;
+}
+
+void
+LteRlcDataField::AddAtEnd (Ptr<const Packet> sdu)
+{
+  NS_LOG_FUNCTION (this << sdu);
+  Segment segment;
+  segment.m_sdu = sdu;
+  segment.m_offset = 0;
+  segment.m_length = sdu->GetSize ();
+  segment.m_status = STATUS_IN_TAG;
+  m_segments.push_back (segment);
+  m_size += segment.m_length;
+}
+
+void
+LteRlcDataField::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_segments.clear ();
+  m_size = 0;
+}
+
+uint32_t
+LteRlcDataField::GetSize (void) const
+{
+  return m_size;
+}
+
+uint32_t
+LteRlcDataField::GetNSegments (void) const
+{
+  return m_segments.size ();
+}
+
+uint8_t
+LteRlcDataField::GetFirstStatus (void) const
+{
+  NS_ASSERT (!m_segments.empty ());
+  return GetStatus (m_segments.front ());
+}
+
+uint8_t
+LteRlcDataField::GetLastStatus (void) const
+{
+  NS_ASSERT (!m_segments.empty ());
+  return GetStatus (m_segments.back ());
+}
+
+uint8_t
+LteRlcDataField::GetStatus (const Segment &segment)
+{
+  if (segment.m_status != STATUS_IN_TAG)
+    {
+      return segment.m_status;
+    }
+  LteRlcSduStatusTag tag;
+  segment.m_sdu->PeekPacketTag (tag);
+  return tag.GetStatus ();
+}
+
+Ptr<Packet>
+LteRlcDataField::Serialize (void) const
+{
+  NS_LOG_FUNCTION (this << m_segments.size () << m_size);
+
+  Ptr<Packet> packet = Create<Packet> ();
+  for (std::vector<Segment>::const_iterator it = m_segments.begin (); it != m_segments.end (); ++it)
+    {
+      if (it->m_offset == 0 && it->m_length == it->m_sdu->GetSize ())
+        {
+          packet->AddAtEnd (it->m_sdu);
+        }
+      else
+        {
+          packet->AddAtEnd (it->m_sdu->CreateFragment (it->m_offset, it->m_length));
+        }
+    }
+  NS_ASSERT (packet->GetSize () == m_size);
+  return packet;
+}
+
+} // namespace ns3
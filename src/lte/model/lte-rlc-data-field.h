@@ -0,0 +1,117 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LTE_RLC_DATA_FIELD_H
+#define LTE_RLC_DATA_FIELD_H
+
+#include "ns3/packet.h"
+
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup lte
+ *
+ * The Data field of an RLC PDU, kept as a list of views on the SDUs, i.e.,
+ * (SDU, offset, length), while the PDU is built by segmentation and
+ * concatenation. The SDUs are neither fragmented nor copied until the Data
+ * field is serialized, once, when the PDU is handed to the MAC.
+ */
+class LteRlcDataField
+{
+public:
+  LteRlcDataField ();
+
+  /**
+   * Add a segment of an SDU at the end of the Data field
+   *
+   * \param sdu the SDU, which must not be modified until the Data field is serialized
+   * \param offset the offset of the segment in the SDU
+   * \param length the length of the segment
+   * \param status the LteRlcSduStatusTag status of the segment
+   */
+  void AddAtEnd (Ptr<const Packet> sdu, uint32_t offset, uint32_t length, uint8_t status);
+
+  /**
+   * Add a whole SDU at the end of the Data field. Its status is read from
+   * its LteRlcSduStatusTag only if it turns out to be the first or the last
+   * segment, as the status of the others is not needed.
+   *
+   * \param sdu the SDU, which must not be modified until the Data field is serialized
+   */
+  void AddAtEnd (Ptr<const Packet> sdu);
+
+  /**
+   * Remove all the segments and release the SDUs. The memory of the list is
+   * kept, so that reusing the Data field for the next PDU does not allocate.
+   */
+  void Clear (void);
+
+  /**
+   * \returns the size of the Data field, in bytes
+   */
+  uint32_t GetSize (void) const;
+
+  /**
+   * \returns the number of segments in the Data field
+   */
+  uint32_t GetNSegments (void) const;
+
+  /**
+   * \returns the LteRlcSduStatusTag status of the first segment
+   */
+  uint8_t GetFirstStatus (void) const;
+
+  /**
+   * \returns the LteRlcSduStatusTag status of the last segment
+   */
+  uint8_t GetLastStatus (void) const;
+
+  /**
+   * Build the packet holding the Data field. The byte tags of the SDUs are
+   * kept, as if the segments were added with Packet::AddAtEnd.
+   *
+   * \returns the packet
+   */
+  Ptr<Packet> Serialize (void) const;
+
+private:
+  /// Status of a whole SDU whose LteRlcSduStatusTag has not been read yet
+  static const uint8_t STATUS_IN_TAG = 0;
+
+  /// A view on a segment of an SDU
+  struct Segment
+  {
+    Ptr<const Packet> m_sdu;  ///< the SDU
+    uint32_t m_offset;        ///< offset of the segment in the SDU
+    uint32_t m_length;        ///< length of the segment
+    uint8_t m_status;         ///< LteRlcSduStatusTag status of the segment, or STATUS_IN_TAG
+  };
+
+  /**
+   * \param segment a segment
+   * \returns the LteRlcSduStatusTag status of the segment
+   */
+  static uint8_t GetStatus (const Segment &segment);
+
+  std::vector<Segment> m_segments;  ///< the segments, in order
+  uint32_t m_size;                  ///< sum of the lengths of the segments
+};
+
+} // namespace ns3
+
+#endif // LTE_RLC_DATA_FIELD_H
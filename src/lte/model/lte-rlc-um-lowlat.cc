@@ -199,15 +199,13 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
      NS_LOG_DEBUG("LteRlcUmLowLat rnti " << m_rnti << " lcid " << m_lcid << " allocated " << txOpParams.bytes << " bufsize " << m_txBufferSize);
    }
 
-  Ptr<Packet> packet = Create<Packet> ();
   LteRlcHeader rlcHeader;
 
   // Build Data field
   uint32_t nextSegmentSize = txOpParams.bytes - 2;
   uint32_t nextSegmentId = 1;
-  uint32_t dataFieldTotalSize = 0;
   uint32_t dataFieldAddedSize = 0;
-  std::vector < Ptr<Packet> > dataField;
+  LteRlcDataField &dataField = m_dataField;
 
   // Remove the first packet from the transmission buffer.
   // If only a segment of the packet is taken, then the remaining is given back later
@@ -222,7 +220,9 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
   NS_LOG_LOGIC ("First SDU size    = " << (*(m_txBuffer.begin()))->GetSize ());
   NS_LOG_LOGIC ("Next segment size = " << nextSegmentSize);
   NS_LOG_LOGIC ("Remove SDU from TxBuffer");
-  Ptr<Packet> firstSegment = (*(m_txBuffer.begin ()))->Copy ();
+  // The SDUs are not modified while the Data field is built, they are only
+  // referred to by the Data field
+  Ptr<Packet> firstSegment = *(m_txBuffer.begin ());
   m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
   NS_LOG_LOGIC ("txBufferSize      = " << m_txBufferSize );
   m_txBuffer.erase (m_txBuffer.begin ());
@@ -246,15 +246,14 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
 
           // Segment txBuffer.FirstBuffer and
           // Give back the remaining segment to the transmission buffer
-          Ptr<Packet> newSegment = firstSegment->CreateFragment (0, currSegmentSize);
-          NS_LOG_LOGIC ("    newSegment size   = " << newSegment->GetSize ());
+          NS_LOG_LOGIC ("    newSegment size   = " << currSegmentSize);
 
           // Status tag of the new and remaining segments
           // Note: This is the only place where a PDU is segmented and
           // therefore its status can change
           LteRlcSduStatusTag oldTag, newTag;
-          firstSegment->RemovePacketTag (oldTag);
-          newSegment->RemovePacketTag (newTag);
+          firstSegment->PeekPacketTag (oldTag);
+          newTag.SetStatus (oldTag.GetStatus ());
           if (oldTag.GetStatus () == LteRlcSduStatusTag::FULL_SDU)
             {
               newTag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
@@ -267,13 +266,14 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
             }
 
           // Give back the remaining segment to the transmission buffer
-          firstSegment->RemoveAtStart (currSegmentSize);
-          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << firstSegment->GetSize ());
-          if (firstSegment->GetSize () > 0)
+          uint32_t remainingSize = firstSegment->GetSize () - currSegmentSize;
+          NS_LOG_LOGIC ("    firstSegment size (after RemoveAtStart) = " << remainingSize);
+          if (remainingSize > 0)
             {
-              firstSegment->AddPacketTag (oldTag);
+              Ptr<Packet> remainingSegment = firstSegment->CreateFragment (currSegmentSize, remainingSize);
+              remainingSegment->ReplacePacketTag (oldTag);
 
-              m_txBuffer.insert (m_txBuffer.begin (), firstSegment);
+              m_txBuffer.insert (m_txBuffer.begin (), remainingSegment);
               m_txBufferSize += (*(m_txBuffer.begin()))->GetSize ();
 
               NS_LOG_LOGIC ("    TX buffer: Give back the remaining segment");
@@ -295,17 +295,11 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
             }
           // Segment is completely taken or
           // the remaining segment is given back to the transmission buffer
+          // Add Segment to Data field, with its status once it has been adjusted
+          dataFieldAddedSize = currSegmentSize;
+          dataField.AddAtEnd (firstSegment, 0, currSegmentSize, newTag.GetStatus ());
           firstSegment = 0;
 
-          // Put status tag once it has been adjusted
-          newSegment->AddPacketTag (newTag);
-
-          // Add Segment to Data field
-          dataFieldAddedSize = newSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (newSegment);
-          newSegment = 0;
-
           // ExtensionBit (Next_Segment - 1) = 0
           rlcHeader.PushExtensionBit (LteRlcHeader::DATA_FIELD_FOLLOWS);
 
@@ -324,8 +318,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
           NS_LOG_LOGIC ("    IF nextSegmentSize - firstSegment->GetSize () <= 2 || txBuffer.size == 0");
           // Add txBuffer.FirstBuffer to DataField
           dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
+          dataField.AddAtEnd (firstSegment);
           firstSegment = 0;
 
           // ExtensionBit (Next_Segment - 1) = 0
@@ -354,8 +347,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
           NS_LOG_LOGIC ("    IF firstSegment < NextSegmentSize && txBuffer.size > 0");
           // Add txBuffer.FirstBuffer to DataField
           dataFieldAddedSize = firstSegment->GetSize ();
-          dataFieldTotalSize += dataFieldAddedSize;
-          dataField.push_back (firstSegment);
+          dataField.AddAtEnd (firstSegment);
 
           // ExtensionBit (Next_Segment - 1) = 1
           rlcHeader.PushExtensionBit (LteRlcHeader::E_LI_FIELDS_FOLLOWS);
@@ -376,7 +368,7 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
           NS_LOG_LOGIC ("        Remove SDU from TxBuffer");
 
           // (more segments)
-          firstSegment = (*(m_txBuffer.begin ()))->Copy ();
+          firstSegment = *(m_txBuffer.begin ());
           m_txBufferSize -= (*(m_txBuffer.begin()))->GetSize ();
           m_txBuffer.erase (m_txBuffer.begin ());
           NS_LOG_LOGIC ("        txBufferSize = " << m_txBufferSize );
@@ -388,16 +380,12 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
   rlcHeader.SetSequenceNumber (m_sequenceNumber++);
 
   // Build RLC PDU with DataField and Header
-  std::vector< Ptr<Packet> >::iterator it;
-  it = dataField.begin ();
-
   uint8_t framingInfo = 0;
 
   // FIRST SEGMENT
-  LteRlcSduStatusTag tag;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::FIRST_SEGMENT) )
+  uint8_t status = dataField.GetFirstStatus ();
+  if ( (status == LteRlcSduStatusTag::FULL_SDU) ||
+        (status == LteRlcSduStatusTag::FIRST_SEGMENT) )
     {
       framingInfo |= LteRlcHeader::FIRST_BYTE;
     }
@@ -405,21 +393,15 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
     {
       framingInfo |= LteRlcHeader::NO_FIRST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
-  while (it < dataField.end ())
-    {
-      NS_LOG_LOGIC ("Adding SDU/segment to packet, length = " << (*it)->GetSize ());
-
-      packet->AddAtEnd (*it);
-      it++;
-    }
+  NS_LOG_LOGIC ("Adding " << dataField.GetNSegments () << " SDUs/segments to packet, length = " << dataField.GetSize ());
+  Ptr<Packet> packet = dataField.Serialize ();
 
   // LAST SEGMENT (Note: There could be only one and be the first one)
-  it--;
-  (*it)->RemovePacketTag (tag);
-  if ( (tag.GetStatus () == LteRlcSduStatusTag::FULL_SDU) ||
-        (tag.GetStatus () == LteRlcSduStatusTag::LAST_SEGMENT) )
+  status = dataField.GetLastStatus ();
+  dataField.Clear ();
+  if ( (status == LteRlcSduStatusTag::FULL_SDU) ||
+        (status == LteRlcSduStatusTag::LAST_SEGMENT) )
     {
       framingInfo |= LteRlcHeader::LAST_BYTE;
     }
@@ -427,7 +409,6 @@ LteRlcUmLowLat::DoNotifyTxOpportunity (LteMacSapUser::TxOpportunityParameters tx
     {
       framingInfo |= LteRlcHeader::NO_LAST_BYTE;
     }
-  (*it)->AddPacketTag (tag);
 
   rlcHeader.SetFramingInfo (framingInfo);
 
@@ -30,6 +30,7 @@
 
 #include "ns3/lte-rlc-sequence-number.h"
 #include "ns3/lte-rlc.h"
+#include "ns3/lte-rlc-data-field.h"
 #include <ns3/epc-x2-sap.h>
 
 #include <ns3/event-id.h>
@@ -90,6 +91,7 @@ private:
   uint32_t m_maxTxBufferSize;
   uint32_t m_txBufferSize;
   std::vector < Ptr<Packet> > m_txBuffer;       // Transmission buffer
+  LteRlcDataField m_dataField;                  // Data field of the PDU being built, reused across the PDUs
   std::map <uint16_t, Ptr<Packet> > m_rxBuffer; // Reception buffer
   std::vector < Ptr<Packet> > m_reasBuffer;     // Reassembling buffer
 
@@ -161,6 +161,18 @@ LteRlc::SetLcId (uint8_t lcId)
   m_lcid = lcId;
 }
 
+uint16_t
+LteRlc::GetRnti (void) const
+{
+  return m_rnti;
+}
+
+uint8_t
+LteRlc::GetLcId (void) const
+{
+  return m_lcid;
+}
+
 void
 LteRlc::SetLteRlcSapUser (LteRlcSapUser * s)
 {
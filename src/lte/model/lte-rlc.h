@@ -102,6 +102,16 @@ public:
    */
   void SetLcId (uint8_t lcId);
 
+  /**
+   * \returns the RNTI
+   */
+  uint16_t GetRnti (void) const;
+
+  /**
+   * \returns the LCID
+   */
+  uint8_t GetLcId (void) const;
+
   /**
    *
    *
@@ -0,0 +1,202 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+#include "ns3/epc-x2-header.h"
+#include "ns3/epc-x2-sap.h"
+#include "ns3/lte-enb-rrc.h"
+
+#include <cmath>
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestEpcX2UeSinrUpdate");
+
+namespace ns3 {
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks the quantization of the SINRs reported to the LTE coordinator
+ */
+class EpcX2SinrQuantizationTestCase : public TestCase
+{
+public:
+  EpcX2SinrQuantizationTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EpcX2SinrQuantizationTestCase::EpcX2SinrQuantizationTestCase ()
+  : TestCase ("Quantization of the SINR")
+{
+}
+
+void
+EpcX2SinrQuantizationTestCase::DoRun (void)
+{
+  for (double sinrDb : {-30.0, -5.004, 0.0, 0.126, 12.3456, 40.0})
+    {
+      double sinr = std::pow (10, sinrDb / 10);
+      double dequantized = EpcX2Sap::DequantizeSinr (EpcX2Sap::QuantizeSinr (sinr));
+      NS_TEST_ASSERT_MSG_EQ_TOL (10 * std::log10 (dequantized), sinrDb, EpcX2Sap::SINR_STEP_DB / 2,
+                                 "Wrong quantized SINR " << sinrDb << " dB");
+    }
+  NS_TEST_ASSERT_MSG_EQ (EpcX2Sap::QuantizeSinr (0), INT16_MIN, "Wrong quantized null SINR");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2Sap::DequantizeSinr (INT16_MIN), 0, "A null SINR must stay null");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2Sap::QuantizeSinr (1e-40), INT16_MIN + 1, "A tiny SINR must be clamped");
+  NS_TEST_ASSERT_MSG_EQ (EpcX2Sap::QuantizeSinr (1e40), INT16_MAX, "A huge SINR must be clamped");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks the serialization of the X2 UpdateUeSinr message
+ */
+class EpcX2UeImsiSinrUpdateHeaderTestCase : public TestCase
+{
+public:
+  EpcX2UeImsiSinrUpdateHeaderTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+EpcX2UeImsiSinrUpdateHeaderTestCase::EpcX2UeImsiSinrUpdateHeaderTestCase ()
+  : TestCase ("Serialization of the UpdateUeSinr message")
+{
+}
+
+void
+EpcX2UeImsiSinrUpdateHeaderTestCase::DoRun (void)
+{
+  std::vector<EpcX2Sap::UeImsiSinr> list;
+  for (uint64_t imsi = 1; imsi <= 30; imsi++)
+    {
+      EpcX2Sap::UeImsiSinr ueSinr;
+      ueSinr.imsi = imsi * 1000 + 1;
+      ueSinr.sinr = static_cast<int16_t> (imsi * 211 - 3000);
+      list.push_back (ueSinr);
+    }
+  list.back ().sinr = INT16_MIN;
+
+  EpcX2UeImsiSinrUpdateHeader header;
+  header.SetSourceCellId (7);
+  header.SetUeImsiSinrList (list);
+  NS_TEST_ASSERT_MSG_EQ (header.GetSerializedSize (), 4 + 30 * 10, "Wrong serialized size");
+  NS_TEST_ASSERT_MSG_EQ (header.GetLengthOfIes (), header.GetSerializedSize (), "Wrong length of the IEs");
+  NS_TEST_ASSERT_MSG_EQ (header.GetNumberOfIes (), 2 + 30, "Wrong number of IEs");
+
+  Ptr<Packet> packet = Create<Packet> ();
+  packet->AddHeader (header);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), header.GetSerializedSize (), "Wrong packet size");
+
+  EpcX2UeImsiSinrUpdateHeader received;
+  packet->RemoveHeader (received);
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), 0, "The header was not fully read");
+  NS_TEST_ASSERT_MSG_EQ (received.GetSourceCellId (), 7, "Wrong source cell");
+  NS_TEST_ASSERT_MSG_EQ (received.GetNumberOfIes (), header.GetNumberOfIes (), "Wrong number of IEs");
+  const std::vector<EpcX2Sap::UeImsiSinr> &receivedList = received.GetUeImsiSinrList ();
+  NS_TEST_ASSERT_MSG_EQ (receivedList.size (), list.size (), "Wrong number of SINRs");
+  for (uint32_t i = 0; i < list.size () && i < receivedList.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (receivedList[i].imsi, list[i].imsi, "Wrong IMSI " << i);
+      NS_TEST_ASSERT_MSG_EQ (receivedList[i].sinr, list[i].sinr, "Wrong SINR " << i);
+    }
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks the matrix of the SINRs stored by the LTE coordinator
+ */
+class MmWaveSinrMatrixTestCase : public TestCase
+{
+public:
+  MmWaveSinrMatrixTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmWaveSinrMatrixTestCase::MmWaveSinrMatrixTestCase ()
+  : TestCase ("Matrix of the SINRs of the LTE coordinator")
+{
+}
+
+void
+MmWaveSinrMatrixTestCase::DoRun (void)
+{
+  MmWaveSinrMatrix matrix;
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsEmpty (), true, "A new matrix must be empty");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (1, 2), 0, "A missing SINR must be null");
+
+  // the rows and the columns are added out of order
+  matrix.Set (5, 3, 5.3);
+  matrix.Set (2, 3, 2.3);
+  matrix.Set (5, 1, 5.1);
+  matrix.Set (9, 2, 9.2);
+  matrix.Set (2, 3, 2.33);
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsEmpty (), false, "The matrix must not be empty");
+  NS_TEST_ASSERT_MSG_EQ ((matrix.GetImsis () == std::vector<uint64_t> {2, 5, 9}), true, "The rows are not sorted by IMSI");
+  NS_TEST_ASSERT_MSG_EQ ((matrix.GetCellIds () == std::vector<uint16_t> {1, 2, 3}), true, "The columns are not sorted by cell ID");
+
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (2, 3), 2.33, "Wrong SINR of IMSI 2 in cell 3");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 1), 5.1, "Wrong SINR of IMSI 5 in cell 1");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 3), 5.3, "Wrong SINR of IMSI 5 in cell 3");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (9, 2), 9.2, "Wrong SINR of IMSI 9 in cell 2");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetAt (1, 2), 5.3, "Wrong SINR in row 1 and column 2");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsReported (5, 3), true, "IMSI 5 was reported in cell 3");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsReported (5, 2), false, "IMSI 5 was not reported in cell 2");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (5, 2), 0, "A SINR which was not reported must be null");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsReported (7, 1), false, "IMSI 7 was not reported");
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsReported (2, 4), false, "Cell 4 did not report");
+
+  matrix.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (matrix.IsEmpty (), true, "The matrix must be empty after Clear");
+  NS_TEST_ASSERT_MSG_EQ (matrix.GetCellIds ().empty (), true, "The columns must be removed by Clear");
+  NS_TEST_ASSERT_MSG_EQ (matrix.Get (2, 3), 0, "A SINR removed by Clear must be null");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief X2 UpdateUeSinr message test suite
+ */
+class EpcX2UeSinrUpdateTestSuite : public TestSuite
+{
+public:
+  EpcX2UeSinrUpdateTestSuite ();
+} staticEpcX2UeSinrUpdateTestSuiteInstance; ///< the test suite
+
+EpcX2UeSinrUpdateTestSuite::EpcX2UeSinrUpdateTestSuite ()
+  : TestSuite ("epc-x2-ue-sinr-update", UNIT)
+{
+  AddTestCase (new EpcX2SinrQuantizationTestCase, TestCase::QUICK);
+  AddTestCase (new EpcX2UeImsiSinrUpdateHeaderTestCase, TestCase::QUICK);
+  AddTestCase (new MmWaveSinrMatrixTestCase, TestCase::QUICK);
+}
+
+} // namespace ns3
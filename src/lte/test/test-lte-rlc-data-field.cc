@@ -0,0 +1,161 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+
+#include "ns3/lte-rlc-data-field.h"
+#include "ns3/lte-rlc-sdu-status-tag.h"
+#include "ns3/lte-rlc-tag.h"
+
+#include <vector>
+
+
+NS_LOG_COMPONENT_DEFINE ("TestLteRlcDataField");
+
+namespace ns3 {
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief Checks that a Data field built from views on the SDUs serializes
+ * to the same bytes and byte tags as the SDUs and segments added one by one
+ * with Packet::AddAtEnd
+ */
+class LteRlcDataFieldTestCase : public TestCase
+{
+public:
+  LteRlcDataFieldTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+LteRlcDataFieldTestCase::LteRlcDataFieldTestCase ()
+  : TestCase ("Serialization of the RLC Data field")
+{
+}
+
+void
+LteRlcDataFieldTestCase::DoRun (void)
+{
+  // SDUs with actual bytes and a byte tag, and one followed by a zero-filled payload
+  std::vector<Ptr<Packet> > sdus;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::vector<uint8_t> bytes (100 + 50 * i);
+      for (uint32_t j = 0; j < bytes.size (); j++)
+        {
+          bytes[j] = i * 31 + j;
+        }
+      sdus.push_back (Create<Packet> (bytes.data (), bytes.size ()));
+      sdus.back ()->AddByteTag (RlcTag (MilliSeconds (i + 1)));
+    }
+  sdus.push_back (sdus[0]->Copy ());
+  sdus.back ()->AddAtEnd (Create<Packet> (300));
+
+  // the last part of an SDU, full SDUs and the first part of an SDU
+  LteRlcDataField dataField;
+  Ptr<Packet> expected = Create<Packet> ();
+  dataField.AddAtEnd (sdus[1], 40, 110, LteRlcSduStatusTag::LAST_SEGMENT);
+  expected->AddAtEnd (sdus[1]->CreateFragment (40, 110));
+  for (uint32_t i = 2; i < sdus.size (); i++)
+    {
+      dataField.AddAtEnd (sdus[i], 0, sdus[i]->GetSize (), LteRlcSduStatusTag::FULL_SDU);
+      expected->AddAtEnd (sdus[i]);
+    }
+  dataField.AddAtEnd (sdus[0], 0, 60, LteRlcSduStatusTag::FIRST_SEGMENT);
+  expected->AddAtEnd (sdus[0]->CreateFragment (0, 60));
+
+  NS_TEST_ASSERT_MSG_EQ (dataField.GetNSegments (), sdus.size (), "Wrong number of segments");
+  NS_TEST_ASSERT_MSG_EQ (dataField.GetSize (), expected->GetSize (), "Wrong size");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) dataField.GetFirstStatus (), LteRlcSduStatusTag::LAST_SEGMENT, "Wrong first status");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) dataField.GetLastStatus (), LteRlcSduStatusTag::FIRST_SEGMENT, "Wrong last status");
+
+  Ptr<Packet> packet = dataField.Serialize ();
+  NS_TEST_ASSERT_MSG_EQ (packet->GetSize (), expected->GetSize (), "Wrong serialized size");
+  std::vector<uint8_t> packetBytes (packet->GetSize ());
+  std::vector<uint8_t> expectedBytes (expected->GetSize ());
+  packet->CopyData (packetBytes.data (), packetBytes.size ());
+  expected->CopyData (expectedBytes.data (), expectedBytes.size ());
+  NS_TEST_ASSERT_MSG_EQ ((packetBytes == expectedBytes), true, "Wrong serialized bytes");
+
+  ByteTagIterator packetTags = packet->GetByteTagIterator ();
+  ByteTagIterator expectedTags = expected->GetByteTagIterator ();
+  uint32_t nTags = 0;
+  while (expectedTags.HasNext ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (packetTags.HasNext (), true, "Missing byte tag");
+      ByteTagIterator::Item packetTag = packetTags.Next ();
+      ByteTagIterator::Item expectedTag = expectedTags.Next ();
+      NS_TEST_ASSERT_MSG_EQ (packetTag.GetStart (), expectedTag.GetStart (), "Wrong start of byte tag " << nTags);
+      NS_TEST_ASSERT_MSG_EQ (packetTag.GetEnd (), expectedTag.GetEnd (), "Wrong end of byte tag " << nTags);
+      RlcTag packetRlcTag;
+      RlcTag expectedRlcTag;
+      packetTag.GetTag (packetRlcTag);
+      expectedTag.GetTag (expectedRlcTag);
+      NS_TEST_ASSERT_MSG_EQ (packetRlcTag.GetSenderTimestamp (), expectedRlcTag.GetSenderTimestamp (),
+                             "Wrong byte tag " << nTags);
+      nTags++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (packetTags.HasNext (), false, "Extra byte tag");
+  NS_TEST_ASSERT_MSG_GT (nTags, 0, "No byte tag checked");
+
+  // the SDUs are left untouched
+  NS_TEST_ASSERT_MSG_EQ (sdus[1]->GetSize (), 150, "An SDU was modified");
+  NS_TEST_ASSERT_MSG_EQ (sdus[0]->GetSize (), 100, "An SDU was modified");
+
+  // whole SDUs, whose status is read from their LteRlcSduStatusTag
+  Ptr<Packet> first = sdus[2]->Copy ();
+  Ptr<Packet> last = sdus[3]->Copy ();
+  LteRlcSduStatusTag tag;
+  tag.SetStatus (LteRlcSduStatusTag::LAST_SEGMENT);
+  first->AddPacketTag (tag);
+  tag.SetStatus (LteRlcSduStatusTag::FIRST_SEGMENT);
+  last->AddPacketTag (tag);
+  LteRlcDataField wholeSdus;
+  wholeSdus.AddAtEnd (first);
+  wholeSdus.AddAtEnd (sdus[4]);
+  wholeSdus.AddAtEnd (last);
+  NS_TEST_ASSERT_MSG_EQ (wholeSdus.GetNSegments (), 3, "Wrong number of whole SDUs");
+  NS_TEST_ASSERT_MSG_EQ (wholeSdus.GetSize (), first->GetSize () + sdus[4]->GetSize () + last->GetSize (), "Wrong size of whole SDUs");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) wholeSdus.GetFirstStatus (), LteRlcSduStatusTag::LAST_SEGMENT, "Wrong first status from the tag");
+  NS_TEST_ASSERT_MSG_EQ ((uint16_t) wholeSdus.GetLastStatus (), LteRlcSduStatusTag::FIRST_SEGMENT, "Wrong last status from the tag");
+  NS_TEST_ASSERT_MSG_EQ (wholeSdus.Serialize ()->GetSize (), wholeSdus.GetSize (), "Wrong serialized size of whole SDUs");
+}
+
+/**
+ * \ingroup lte-test
+ * \ingroup tests
+ *
+ * \brief RLC Data field test suite
+ */
+class LteRlcDataFieldTestSuite : public TestSuite
+{
+public:
+  LteRlcDataFieldTestSuite ();
+} staticLteRlcDataFieldTestSuiteInstance; ///< the test suite
+
+LteRlcDataFieldTestSuite::LteRlcDataFieldTestSuite ()
+  : TestSuite ("lte-rlc-data-field", UNIT)
+{
+  AddTestCase (new LteRlcDataFieldTestCase, TestCase::QUICK);
+}
+
+} // namespace ns3
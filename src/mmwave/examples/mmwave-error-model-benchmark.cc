@@ -0,0 +1,123 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2020 University of Padova, Dep. of Information Engineering, SIGNET lab.
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "ns3/core-module.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/mmwave-error-model.h"
+#include <iostream>
+#include <numeric>
+
+using namespace ns3;
+using namespace mmwave;
+
+/*
+ * This program measures how many transport blocks per second can be decoded
+ * by the error models, when a new error model is created for each TB and
+ * when the same instance is used for all the TBs (as in MmWaveSpectrumPhy).
+ * The SINR of each RB is drawn uniformly (in dB) in [minSinrDb, maxSinrDb].
+*/
+
+/**
+ * Decode numTbs TBs and return the decoding rate
+ * \param emType the type of the error model
+ * \param reuse if true, the same error model is used for all the TBs
+ * \param sinrs the SINR of the TBs
+ * \param tbSize the size of the TBs in bytes
+ * \param mcs the MCS of the TBs
+ * \return the number of TBs decoded per second
+ */
+static double
+DecodeTbs (TypeId emType, bool reuse, const std::vector<SpectrumValue> &sinrs, uint32_t tbSize, uint8_t mcs)
+{
+  ObjectFactory emFactory;
+  emFactory.SetTypeId (emType);
+  Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel> (emFactory.Create ());
+
+  std::vector<int> map (sinrs.front ().GetValuesN ());
+  std::iota (map.begin (), map.end (), 0);
+  MmWaveErrorModel::MmWaveErrorModelHistory history;
+
+  double tblerSum = 0.0;
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (const SpectrumValue &sinr : sinrs)
+    {
+      if (!reuse)
+        {
+          em = DynamicCast<MmWaveErrorModel> (emFactory.Create ());
+        }
+      tblerSum += em->GetTbDecodificationStats (sinr, map, tbSize, mcs, history)->m_tbler;
+    }
+  int64_t elapsedMs = std::max<int64_t> (clock.End (), 1);
+
+  NS_LOG_UNCOND ("  average TBLER " << tblerSum / sinrs.size ());
+  return sinrs.size () * 1000.0 / elapsedMs;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numTbs = 100000;
+  uint32_t numRbs = 72;
+  uint32_t tbSize = 2000;
+  uint32_t mcs = 14;
+  double minSinrDb = 5;
+  double maxSinrDb = 20;
+
+  CommandLine cmd;
+  cmd.AddValue ("numTbs", "Number of TBs decoded by each error model", numTbs);
+  cmd.AddValue ("numRbs", "Number of RBs of each TB", numRbs);
+  cmd.AddValue ("tbSize", "Size of each TB [bytes]", tbSize);
+  cmd.AddValue ("mcs", "MCS of each TB", mcs);
+  cmd.AddValue ("minSinrDb", "Minimum SINR of an RB [dB]", minSinrDb);
+  cmd.AddValue ("maxSinrDb", "Maximum SINR of an RB [dB]", maxSinrDb);
+  cmd.Parse (argc, argv);
+
+  std::vector<double> freqs;
+  for (uint32_t i = 0; i < numRbs; i++)
+    {
+      freqs.push_back (28e9 + i * 1e6);
+    }
+  Ptr<SpectrumModel> sm = Create<SpectrumModel> (freqs);
+
+  Ptr<UniformRandomVariable> sinrDb = CreateObject<UniformRandomVariable> ();
+  sinrDb->SetAttribute ("Min", DoubleValue (minSinrDb));
+  sinrDb->SetAttribute ("Max", DoubleValue (maxSinrDb));
+  std::vector<SpectrumValue> sinrs (numTbs, SpectrumValue (sm));
+  for (SpectrumValue &sinr : sinrs)
+    {
+      for (uint32_t i = 0; i < numRbs; i++)
+        {
+          sinr[i] = std::pow (10, sinrDb->GetValue () / 10);
+        }
+    }
+
+  for (std::string emType : {"ns3::MmWaveEesmIrT1", "ns3::MmWaveEesmIrT2",
+                             "ns3::MmWaveEesmCcT1", "ns3::MmWaveEesmCcT2",
+                             "ns3::MmWaveLteMiErrorModel"})
+    {
+      for (bool reuse : {false, true})
+        {
+          NS_LOG_UNCOND (emType << (reuse ? ", same instance for all the TBs" : ", new instance for each TB"));
+          double rate = DecodeTbs (TypeId::LookupByName (emType), reuse, sinrs, tbSize, mcs);
+          NS_LOG_UNCOND ("  " << rate << " TBs/s");
+        }
+    }
+
+  return 0;
+}
@@ -0,0 +1,384 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2020 University of Padova, Dep. of Information Engineering, SIGNET lab.
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-mac-scheduler.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/*
+ * This program measures the time needed by the flex-TTI schedulers to
+ * schedule a slot, as a function of the number of UEs in the cell.
+ * The scheduler is driven directly through its SAPs, as MmWaveEnbMac does:
+ * in each slot the UEs report random DL RLC buffers, BSRs and DL CQIs, and
+ * the UL CQIs and the HARQ feedback of the previous allocations are sent back
+ * to the scheduler. The inputs only depend on the seed, therefore the digest
+ * of the allocations printed for each run can be used to check that a change
+ * of the schedulers does not change their decisions.
+*/
+
+/**
+ * Receives the allocations of the scheduler and computes a digest of them
+ */
+class BenchmarkSchedSapUser : public MmWaveMacSchedSapUser
+{
+public:
+  BenchmarkSchedSapUser ()
+    : m_digest (14695981039346656037ULL),
+      m_numSymAlloc (0)
+  {
+  }
+
+  virtual void SchedConfigInd (const struct SchedConfigIndParameters& params)
+  {
+    m_slotAllocInfo = params.m_slotAllocInfo;
+    m_numSymAlloc += params.m_slotAllocInfo.m_numSymAlloc;
+    Add (params.m_slotAllocInfo.m_numSymAlloc);
+    for (const TtiAllocInfo &tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+      {
+        Add (tti.m_tddMode);
+        Add (tti.m_ttiType);
+        Add (tti.m_ttiIdx);
+        Add (tti.m_rnti);
+        Add (tti.m_dci.m_rnti);
+        Add (tti.m_dci.m_format);
+        Add (tti.m_dci.m_symStart);
+        Add (tti.m_dci.m_numSym);
+        Add (tti.m_dci.m_mcs);
+        Add (tti.m_dci.m_tbSize);
+        Add (tti.m_dci.m_ndi);
+        Add (tti.m_dci.m_rv);
+        Add (tti.m_dci.m_harqProcess);
+        for (const RlcPduInfo &rlcPdu : tti.m_rlcPduInfo)
+          {
+            Add (rlcPdu.m_lcid);
+            Add (rlcPdu.m_size);
+          }
+      }
+  }
+
+  SlotAllocInfo m_slotAllocInfo; //!< the allocation of the last slot
+  uint64_t m_digest; //!< FNV-1a hash of the allocations
+  uint64_t m_numSymAlloc; //!< total number of allocated symbols
+
+private:
+  /**
+   * Adds a value to the digest
+   * \param value the value
+   */
+  void Add (uint32_t value)
+  {
+    for (int i = 0; i < 4; i++)
+      {
+        m_digest ^= (value >> (8 * i)) & 0xFF;
+        m_digest *= 1099511628211ULL;
+      }
+  }
+};
+
+/**
+ * Ignores the confirmations of the scheduler
+ */
+class BenchmarkCschedSapUser : public MmWaveMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+};
+
+/**
+ * Configures a UE with a signalling and a data logical channel
+ * \param csched the CSCHED SAP of the scheduler
+ * \param rnti the RNTI of the UE
+ */
+static void
+ConfigureUe (MmWaveMacCschedSapProvider *csched, uint16_t rnti)
+{
+  MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+  ueParams.m_rnti = rnti;
+  ueParams.m_transmissionMode = 0;
+  csched->CschedUeConfigReq (ueParams);
+
+  for (uint8_t lcid : {1, 3})
+    {
+      MmWaveMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+      lcParams.m_rnti = rnti;
+      lcParams.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lccle;
+      lccle.m_logicalChannelIdentity = lcid;
+      lccle.m_logicalChannelGroup = (lcid == 1) ? 0 : 1;
+      lccle.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lccle.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lccle.m_qci = 9;
+      lccle.m_eRabMaximulBitrateUl = 0;
+      lccle.m_eRabMaximulBitrateDl = 0;
+      lccle.m_eRabGuaranteedBitrateUl = 0;
+      lccle.m_eRabGuaranteedBitrateDl = 0;
+      lcParams.m_logicalChannelConfigList.push_back (lccle);
+      csched->CschedLcConfigReq (lcParams);
+    }
+}
+
+/**
+ * Schedules numSlots slots and returns the average scheduling time
+ * \param schedType the type of the scheduler
+ * \param harq the value of the HarqEnabled attribute
+ * \param numUes the number of UEs in the cell
+ * \param numSlots the number of slots
+ * \param [out] digest the digest of the allocations
+ * \return the average time needed to schedule a slot, in microseconds
+ */
+static double
+ScheduleSlots (TypeId schedType, bool harq, uint16_t numUes, uint32_t numSlots, uint64_t &digest)
+{
+  Ptr<MmWavePhyMacCommon> config = CreateObject<MmWavePhyMacCommon> ();
+  ObjectFactory schedFactory;
+  schedFactory.SetTypeId (schedType);
+  schedFactory.Set ("HarqEnabled", BooleanValue (harq));
+  Ptr<MmWaveMacScheduler> sched = DynamicCast<MmWaveMacScheduler> (schedFactory.Create ());
+  sched->ConfigureCommonParameters (config);
+  BenchmarkSchedSapUser schedSapUser;
+  BenchmarkCschedSapUser cschedSapUser;
+  sched->SetMacSchedSapUser (&schedSapUser);
+  sched->SetMacCschedSapUser (&cschedSapUser);
+  MmWaveMacSchedSapProvider *schedSap = sched->GetMacSchedSapProvider ();
+  MmWaveMacCschedSapProvider *cschedSap = sched->GetMacCschedSapProvider ();
+
+  MmWaveMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = config->GetNumRb ();
+  cellParams.m_dlBandwidth = config->GetNumRb ();
+  cschedSap->CschedCellConfigReq (cellParams);
+  std::list<uint16_t> ueList;
+  for (uint16_t rnti = 1; rnti <= numUes; rnti++)
+    {
+      ConfigureUe (cschedSap, rnti);
+      ueList.push_back (rnti);
+    }
+
+  // the same inputs for all the schedulers
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+
+  std::vector<MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters> ulCqis;
+  std::vector<DlHarqInfo> dlHarqFeedback;
+  std::vector<UlHarqInfo> ulHarqFeedback;
+  SfnSf sfn (1, 0, 0, 0);
+  std::chrono::steady_clock::duration elapsed (0);
+  for (uint32_t slot = 0; slot < numSlots; slot++)
+    {
+      std::vector<MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> rlcReports;
+      MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqiParams;
+      dlCqiParams.m_sfnsf = sfn;
+      MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+      bsrParams.m_sfnSf = sfn;
+      for (uint16_t rnti = 1; rnti <= numUes; rnti++)
+        {
+          if (rv->GetValue () < 0.3)
+            {
+              MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcParams;
+              rlcParams.m_rnti = rnti;
+              rlcParams.m_logicalChannelIdentity = (rv->GetValue () < 0.1) ? 1 : 3;
+              rlcParams.m_rlcTransmissionQueueSize = 0;
+              rlcParams.m_rlcTransmissionQueueHolDelay = rv->GetInteger (0, 20);
+              rlcParams.m_rlcRetransmissionQueueSize = 0;
+              rlcParams.m_rlcRetransmissionHolDelay = 0;
+              rlcParams.m_rlcStatusPduSize = 0;
+              rlcParams.m_arrivalRate = 0;
+              uint32_t numPackets = rv->GetInteger (0, 10);
+              for (uint32_t i = 0; i < numPackets; i++)
+                {
+                  uint32_t size = rv->GetInteger (40, 1500);
+                  rlcParams.m_rlcTransmissionQueueSize += size;
+                  rlcParams.m_txPacketSizes.push_back (size);
+                  rlcParams.m_txPacketDelays.push_back (rv->GetInteger (0, 20000));
+                }
+              rlcReports.push_back (rlcParams);
+            }
+          if (rv->GetValue () < 0.2)
+            {
+              DlCqiInfo cqi;
+              cqi.m_rnti = rnti;
+              cqi.m_ri = 1;
+              cqi.m_cqiType = DlCqiInfo::WB;
+              cqi.m_wbCqi = rv->GetInteger (0, 15);
+              cqi.m_wbPmi = 0;
+              dlCqiParams.m_cqiList.push_back (cqi);
+            }
+          if (rv->GetValue () < 0.2)
+            {
+              MacCeElement bsr;
+              bsr.m_rnti = rnti;
+              bsr.m_macCeType = MacCeElement::BSR;
+              bsr.m_macCeValue.m_phr = 0;
+              bsr.m_macCeValue.m_crnti = 0;
+              bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+              bsr.m_macCeValue.m_bufferStatus[1] = rv->GetInteger (0, 40);
+              bsrParams.m_macCeList.push_back (bsr);
+            }
+        }
+
+      MmWaveMacSchedSapProvider::SchedTriggerReqParameters triggerParams;
+      triggerParams.m_snfSf = sfn;
+      triggerParams.m_ueList = ueList;
+      triggerParams.m_dlHarqInfoList.swap (dlHarqFeedback);
+      triggerParams.m_ulHarqInfoList.swap (ulHarqFeedback);
+
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      for (const MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters &rlcParams : rlcReports)
+        {
+          schedSap->SchedDlRlcBufferReq (rlcParams);
+        }
+      schedSap->SchedDlCqiInfoReq (dlCqiParams);
+      for (const MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters &ulCqi : ulCqis)
+        {
+          schedSap->SchedUlCqiInfoReq (ulCqi);
+        }
+      if (!bsrParams.m_macCeList.empty ())
+        {
+          schedSap->SchedUlMacCtrlInfoReq (bsrParams);
+        }
+      schedSap->SchedTriggerReq (triggerParams);
+      elapsed += std::chrono::steady_clock::now () - start;
+
+      // the UL CQIs and the HARQ feedback of this slot are received in the next one
+      ulCqis.clear ();
+      const SlotAllocInfo &alloc = schedSapUser.m_slotAllocInfo;
+      for (const TtiAllocInfo &tti : alloc.m_ttiAllocInfo)
+        {
+          if (tti.m_ttiType == TtiAllocInfo::CTRL)
+            {
+              continue;
+            }
+          bool ok = rv->GetValue () > 0.1;
+          if (tti.m_tddMode == TtiAllocInfo::DL_slotAllocInfo)
+            {
+              DlHarqInfo info;
+              info.m_rnti = tti.m_dci.m_rnti;
+              info.m_harqProcessId = tti.m_dci.m_harqProcess;
+              info.m_harqStatus = ok ? DlHarqInfo::ACK : DlHarqInfo::NACK;
+              info.m_numRetx = tti.m_dci.m_rv;
+              if (harq)
+                {
+                  dlHarqFeedback.push_back (info);
+                }
+              continue;
+            }
+          UlHarqInfo info;
+          info.m_rnti = tti.m_dci.m_rnti;
+          info.m_harqProcessId = tti.m_dci.m_harqProcess;
+          info.m_receptionStatus = ok ? UlHarqInfo::Ok : UlHarqInfo::NotOk;
+          info.m_numRetx = tti.m_dci.m_rv;
+          if (harq)
+            {
+              ulHarqFeedback.push_back (info);
+            }
+
+          MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqi;
+          ulCqi.m_ulCqi.m_type = UlCqiInfo::PUSCH;
+          double sinr = std::pow (10, rv->GetValue (0, 25) / 10);
+          ulCqi.m_ulCqi.m_sinr.assign (config->GetNumRb (), sinr);
+          // the schedulers identify the UL allocations either by the start
+          // symbol or by the slot index replaced by the start symbol
+          ulCqi.m_sfnSf = alloc.m_sfnSf;
+          ulCqi.m_sfnSf.m_symStart = tti.m_dci.m_symStart;
+          ulCqis.push_back (ulCqi);
+          SfnSf otherSfn = alloc.m_sfnSf;
+          otherSfn.m_slotNum = tti.m_dci.m_symStart;
+          if (otherSfn.Encode () != ulCqi.m_sfnSf.Encode ())
+            {
+              ulCqi.m_sfnSf = otherSfn;
+              ulCqis.push_back (ulCqi);
+            }
+        }
+
+      if (++sfn.m_slotNum == config->GetSlotsPerSubframe ())
+        {
+          sfn.m_slotNum = 0;
+          if (++sfn.m_sfNum == config->GetSubframesPerFrame ())
+            {
+              sfn.m_sfNum = 0;
+              sfn.m_frameNum++;
+            }
+        }
+    }
+
+  digest = schedSapUser.m_digest;
+  NS_LOG_UNCOND ("  " << numUes << " UEs, " << schedSapUser.m_numSymAlloc / static_cast<double> (numSlots)
+                      << " allocated symbols per slot");
+  sched->Dispose ();
+  return std::chrono::duration<double, std::micro> (elapsed).count () / numSlots;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t numSlots = 10000;
+  uint32_t maxUes = 64;
+  bool harq = true;
+  std::string schedulers = "ns3::MmWaveFlexTtiMacScheduler,ns3::MmWaveFlexTtiPfMacScheduler,"
+                           "ns3::MmWaveFlexTtiMaxRateMacScheduler,ns3::MmWaveFlexTtiMaxWeightMacScheduler";
+
+  CommandLine cmd;
+  cmd.AddValue ("numSlots", "Number of slots scheduled in each run", numSlots);
+  cmd.AddValue ("maxUes", "Maximum number of UEs per cell, the runs double the UEs from 1 to maxUes", maxUes);
+  cmd.AddValue ("harq", "Value of the HarqEnabled attribute of the schedulers", harq);
+  cmd.AddValue ("schedulers", "Comma separated list of the types of the schedulers", schedulers);
+  cmd.Parse (argc, argv);
+
+  std::istringstream schedList (schedulers);
+  std::string schedType;
+  while (std::getline (schedList, schedType, ','))
+    {
+      NS_LOG_UNCOND (schedType << (harq ? ", HARQ enabled" : ", HARQ disabled"));
+      for (uint32_t numUes = 1; numUes <= maxUes; numUes *= 2)
+        {
+          uint64_t digest;
+          double time = ScheduleSlots (TypeId::LookupByName (schedType), harq, numUes, numSlots, digest);
+          std::ostringstream digestStr;
+          digestStr << std::hex << std::setw (16) << std::setfill ('0') << digest;
+          NS_LOG_UNCOND ("  " << time << " us per slot, digest " << digestStr.str ());
+        }
+    }
+
+  return 0;
+}
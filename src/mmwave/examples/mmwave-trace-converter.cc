@@ -0,0 +1,77 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "ns3/core-module.h"
+#include "ns3/mmwave-trace-writer.h"
+#include <fstream>
+#include <iostream>
+
+using namespace ns3;
+using namespace mmwave;
+
+/*
+ * This program converts a trace written in one of the binary formats of
+ * MmWaveTraceWriter, for instance with
+ * MmWaveHelper::EnableTraces (formats) or with the OutputFormat attribute
+ * of ns3::MmWavePhyTrace, to the text format that the trace would have had
+ * with the default TEXT format. The text is written to the standard output
+ * if no output file is given.
+ *
+ * ./ns3 run "mmwave-trace-converter --input=RxPacketTrace.bin --output=RxPacketTrace.txt"
+*/
+
+int
+main (int argc, char *argv[])
+{
+  std::string input;
+  std::string output;
+
+  CommandLine cmd;
+  cmd.AddValue ("input", "Binary trace to convert", input);
+  cmd.AddValue ("output", "Text file to write, standard output if empty", output);
+  cmd.Parse (argc, argv);
+
+  if (input.empty ())
+    {
+      NS_FATAL_ERROR ("No input trace, use --input=<file>");
+    }
+  std::ifstream inputFile (input.c_str (), std::ios::binary);
+  if (!inputFile.is_open ())
+    {
+      NS_FATAL_ERROR ("Could not open " << input);
+    }
+
+  bool valid;
+  if (output.empty ())
+    {
+      valid = MmWaveTraceWriter::ConvertToText (inputFile, std::cout);
+    }
+  else
+    {
+      std::ofstream outputFile (output.c_str ());
+      if (!outputFile.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open " << output);
+        }
+      valid = MmWaveTraceWriter::ConvertToText (inputFile, outputFile);
+    }
+  if (!valid)
+    {
+      std::cerr << input << " is not a valid binary trace, or is truncated" << std::endl;
+      return 1;
+    }
+  return 0;
+}
@@ -21,6 +21,7 @@
 
 #include "core-network-stats-calculator.h"
 #include "ns3/string.h"
+#include "ns3/enum.h"
 #include "ns3/nstime.h"
 #include <ns3/log.h>
 #include <vector>
@@ -34,7 +35,30 @@ namespace mmwave {
 
 NS_OBJECT_ENSURE_REGISTERED (CoreNetworkStatsCalculator);
 
+namespace {
+
+MmWaveTraceSchema
+MakeCoreNetworkTraceSchema (bool x2)
+{
+  MmWaveTraceSchema schema;
+  schema.AddColumn ("time", MmWaveTraceSchema::DOUBLE, " ")
+  .AddColumn ("sourceCellId", MmWaveTraceSchema::UINT16, " ")
+  .AddColumn ("targetCellId", MmWaveTraceSchema::UINT16, " ")
+  .AddColumn ("size", MmWaveTraceSchema::UINT32, " ")
+  .AddColumn ("delay", MmWaveTraceSchema::UINT64, x2 ? " " : "");
+  if (x2)
+    {
+      schema.AddColumn ("data", MmWaveTraceSchema::UINT8, "");
+    }
+  return schema;
+}
+
+} // unnamed namespace
+
 CoreNetworkStatsCalculator::CoreNetworkStatsCalculator ()
+  : m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_x2OutFile (MakeCoreNetworkTraceSchema (true)),
+    m_mmeOutFile (MakeCoreNetworkTraceSchema (false))
 {
   NS_LOG_FUNCTION (this);
 }
@@ -61,6 +85,11 @@ CoreNetworkStatsCalculator::GetTypeId (void)
                    StringValue ("MmeStats.txt"),
                    MakeStringAccessor (&CoreNetworkStatsCalculator::SetMmeOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("OutputFormat",
+                   "Format of the files where the packets on X2 and S1-MME will be logged.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&CoreNetworkStatsCalculator::m_outputFormat),
+                   MakeTraceFormatChecker ())
   ;
   return tid;
 }
@@ -69,6 +98,8 @@ void
 CoreNetworkStatsCalculator::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_x2OutFile.Close ();
+  m_mmeOutFile.Close ();
 }
 
 void
@@ -76,12 +107,12 @@ CoreNetworkStatsCalculator::LogX2Packet (std::string path, uint16_t sourceCellId
 {
   NS_LOG_FUNCTION (this << "LogX2Packet" << sourceCellId << targetCellId << size << delay);
 
-  if (!m_x2OutFile.is_open ())
+  if (!m_x2OutFile.IsOpen ())
     {
-      m_x2OutFile.open (GetX2OutputFilename ().c_str ());
+      m_x2OutFile.Open (GetX2OutputFilename (), m_outputFormat);
     }
 
-  m_x2OutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << sourceCellId << " " << targetCellId << " " << size << " " << delay << " " << data << std::endl;
+  m_x2OutFile.Write ({Simulator::Now ().GetNanoSeconds () / 1.0e9, sourceCellId, targetCellId, size, delay, data});
 }
 
 void
@@ -89,12 +120,12 @@ CoreNetworkStatsCalculator::LogMmePacket (std::string path, uint16_t sourceCellI
 {
   NS_LOG_FUNCTION (this << "LogX2Packet" << sourceCellId << targetCellId << size << delay);
 
-  if (!m_mmeOutFile.is_open ())
+  if (!m_mmeOutFile.IsOpen ())
     {
-      m_mmeOutFile.open (GetMmeOutputFilename ().c_str ());
+      m_mmeOutFile.Open (GetMmeOutputFilename (), m_outputFormat);
     }
 
-  m_mmeOutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << sourceCellId << " " << targetCellId << " " << size << " " << delay << std::endl;
+  m_mmeOutFile.Write ({Simulator::Now ().GetNanoSeconds () / 1.0e9, sourceCellId, targetCellId, size, delay});
 }
 
 std::string
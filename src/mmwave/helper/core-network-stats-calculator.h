@@ -27,6 +27,7 @@
 #include "ns3/object.h"
 #include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
+#include "ns3/mmwave-trace-writer.h"
 #include <string>
 #include <map>
 #include <fstream>
@@ -57,8 +58,10 @@ private:
   std::string m_mmeOutFileName;
   std::string m_x2OutFileName;
 
-  std::ofstream m_x2OutFile;
-  std::ofstream m_mmeOutFile;
+  MmWaveTraceWriter::Format m_outputFormat;
+
+  MmWaveTraceWriter m_x2OutFile;
+  MmWaveTraceWriter m_mmeOutFile;
 
 };
 
@@ -20,6 +20,7 @@
 
 #include "mc-stats-calculator.h"
 #include "ns3/string.h"
+#include "ns3/enum.h"
 #include "ns3/nstime.h"
 #include <ns3/log.h>
 #include <vector>
@@ -33,10 +34,41 @@ namespace mmwave {
 
 NS_OBJECT_ENSURE_REGISTERED ( McStatsCalculator);
 
+namespace {
+
+MmWaveTraceSchema
+MakeSwitchTraceSchema (std::string event)
+{
+  MmWaveTraceSchema schema;
+  schema.AddLabelColumn ("event", {event}, " ")
+  .AddColumn ("time", MmWaveTraceSchema::DOUBLE, " ")
+  .AddColumn ("imsi", MmWaveTraceSchema::UINT64, " ")
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT16, " ")
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16, " ");
+  return schema;
+}
+
+MmWaveTraceSchema
+MakeCellIdTraceSchema (void)
+{
+  MmWaveTraceSchema schema;
+  schema.AddColumn ("time", MmWaveTraceSchema::DOUBLE, " ")
+  .AddColumn ("imsi", MmWaveTraceSchema::UINT64, " ")
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT16, " ")
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16, " ");
+  return schema;
+}
+
+} // unnamed namespace
+
 McStatsCalculator::McStatsCalculator ()
   : m_lteOutputFilename ("LteSwitchStats.txt"),
     m_mmWaveOutputFilename ("MmWaveSwitchStats.txt"),
-    m_cellInTimeFilename ("CellIdStats.txt")
+    m_cellInTimeFilename ("CellIdStats.txt"),
+    m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_lteOutFile (MakeSwitchTraceSchema ("SwitchToLte")),
+    m_mmWaveOutFile (MakeSwitchTraceSchema ("SwitchToMmWave")),
+    m_cellInTimeOutFile (MakeCellIdTraceSchema ())
 {
   NS_LOG_FUNCTION (this);
 }
@@ -44,18 +76,9 @@ McStatsCalculator::McStatsCalculator ()
 McStatsCalculator::~McStatsCalculator ()
 {
   NS_LOG_FUNCTION (this);
-  if (m_mmWaveOutFile.is_open ())
-    {
-      m_mmWaveOutFile.close ();
-    }
-  if (m_lteOutFile.is_open ())
-    {
-      m_lteOutFile.close ();
-    }
-  if (m_cellInTimeOutFile.is_open ())
-    {
-      m_cellInTimeOutFile.close ();
-    }
+  m_mmWaveOutFile.Close ();
+  m_lteOutFile.Close ();
+  m_cellInTimeOutFile.Close ();
 }
 
 TypeId
@@ -81,6 +104,11 @@ McStatsCalculator::GetTypeId (void)
                    StringValue ("CellIdStats.txt"),
                    MakeStringAccessor (&McStatsCalculator::SetCellIdInTimeOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("OutputFormat",
+                   "Format of the files where the switches and the cell IDs will be saved.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&McStatsCalculator::m_outputFormat),
+                   MakeTraceFormatChecker ())
   ;
   return tid;
 }
@@ -89,6 +117,9 @@ void
 McStatsCalculator::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
+  m_mmWaveOutFile.Close ();
+  m_lteOutFile.Close ();
+  m_cellInTimeOutFile.Close ();
 }
 
 void
@@ -133,18 +164,19 @@ McStatsCalculator::SwitchToLte (uint64_t imsi, uint16_t cellId, uint16_t rnti)
 {
   NS_LOG_FUNCTION (this << "SwitchToLte" << cellId << imsi << rnti);
 
-  if (!m_lteOutFile.is_open ())
+  if (!m_lteOutFile.IsOpen ())
     {
-      m_lteOutFile.open (GetLteOutputFilename ().c_str ());
+      m_lteOutFile.Open (GetLteOutputFilename (), m_outputFormat);
     }
 
-  m_lteOutFile << "SwitchToLte " << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << imsi << " " << cellId << " " << rnti << " " << std::endl;
+  double now = Simulator::Now ().GetNanoSeconds () / 1.0e9;
+  m_lteOutFile.Write ({0, now, imsi, cellId, rnti});
 
-  if (!m_cellInTimeOutFile.is_open ())
+  if (!m_cellInTimeOutFile.IsOpen ())
     {
-      m_cellInTimeOutFile.open (GetCellIdInTimeOutputFilename ().c_str ());
+      m_cellInTimeOutFile.Open (GetCellIdInTimeOutputFilename (), m_outputFormat);
     }
-  m_cellInTimeOutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << imsi << " " << cellId << " " << rnti << " " << std::endl;
+  m_cellInTimeOutFile.Write ({now, imsi, cellId, rnti});
 }
 
 void
@@ -152,18 +184,19 @@ McStatsCalculator::SwitchToMmWave (uint64_t imsi, uint16_t cellId, uint16_t rnti
 {
   NS_LOG_FUNCTION (this << "SwitchToMmWave " << cellId << imsi << rnti);
 
-  if (!m_mmWaveOutFile.is_open ())
+  if (!m_mmWaveOutFile.IsOpen ())
     {
-      m_mmWaveOutFile.open (GetMmWaveOutputFilename ().c_str ());
+      m_mmWaveOutFile.Open (GetMmWaveOutputFilename (), m_outputFormat);
     }
 
-  m_mmWaveOutFile << "SwitchToMmWave " << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << imsi << " " << cellId << " " << rnti << " " << std::endl;
+  double now = Simulator::Now ().GetNanoSeconds () / 1.0e9;
+  m_mmWaveOutFile.Write ({0, now, imsi, cellId, rnti});
 
-  if (!m_cellInTimeOutFile.is_open ())
+  if (!m_cellInTimeOutFile.IsOpen ())
     {
-      m_cellInTimeOutFile.open (GetCellIdInTimeOutputFilename ().c_str ());
+      m_cellInTimeOutFile.Open (GetCellIdInTimeOutputFilename (), m_outputFormat);
     }
-  m_cellInTimeOutFile << Simulator::Now ().GetNanoSeconds () / 1.0e9 << " " << imsi << " " << cellId << " " << rnti << " " << std::endl;
+  m_cellInTimeOutFile.Write ({now, imsi, cellId, rnti});
 }
 
 } // namespace mmwave
@@ -26,6 +26,7 @@
 #include "ns3/object.h"
 #include "ns3/basic-data-calculators.h"
 #include "ns3/lte-common.h"
+#include "ns3/mmwave-trace-writer.h"
 #include <string>
 #include <map>
 #include <fstream>
@@ -83,9 +84,14 @@ private:
 
   std::string m_cellInTimeFilename;
 
-  std::ofstream m_lteOutFile;
-  std::ofstream m_mmWaveOutFile;
-  std::ofstream m_cellInTimeOutFile;
+  /**
+   * Format of the output files
+   */
+  MmWaveTraceWriter::Format m_outputFormat;
+
+  MmWaveTraceWriter m_lteOutFile;
+  MmWaveTraceWriter m_mmWaveOutFile;
+  MmWaveTraceWriter m_cellInTimeOutFile;
 };
 
 } // namespace mmwave
@@ -34,6 +34,7 @@
 #include "ns3/string.h"
 #include "ns3/nstime.h"
 #include <ns3/boolean.h>
+#include <ns3/enum.h>
 #include <ns3/log.h>
 #include <vector>
 #include <algorithm>
@@ -46,11 +47,33 @@ namespace mmwave {
 
 NS_OBJECT_ENSURE_REGISTERED ( MmWaveBearerStatsCalculator);
 
+namespace {
+
+MmWaveTraceSchema
+MakePduTraceSchema (void)
+{
+  MmWaveTraceSchema schema ("TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t");
+  schema.AddLabelColumn ("TYPE", {"Tx", "Rx"})
+  .AddColumn ("TIME", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("CellId", MmWaveTraceSchema::UINT16)
+  .AddColumn ("IMSI", MmWaveTraceSchema::UINT64)
+  .AddColumn ("RNTI", MmWaveTraceSchema::UINT16)
+  .AddColumn ("LCID", MmWaveTraceSchema::UINT8)
+  .AddColumn ("SIZE", MmWaveTraceSchema::UINT32)
+  .AddColumn ("DELAY", MmWaveTraceSchema::UINT64);
+  return schema;
+}
+
+} // unnamed namespace
+
 MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator ()
   : m_firstWrite (true),
     m_pendingOutput (false),
     m_aggregatedStats (true),
-    m_protocolType ("RLC")
+    m_protocolType ("RLC"),
+    m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_dlOutFile (MakePduTraceSchema ()),
+    m_ulOutFile (MakePduTraceSchema ())
 {
   NS_LOG_FUNCTION (this);
 }
@@ -58,7 +81,10 @@ MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator ()
 MmWaveBearerStatsCalculator::MmWaveBearerStatsCalculator (std::string protocolType)
   : m_firstWrite (true),
     m_pendingOutput (false),
-    m_aggregatedStats (true)
+    m_aggregatedStats (true),
+    m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_dlOutFile (MakePduTraceSchema ()),
+    m_ulOutFile (MakePduTraceSchema ())
 {
   NS_LOG_FUNCTION (this);
   m_protocolType = protocolType;
@@ -111,6 +137,11 @@ MmWaveBearerStatsCalculator::GetTypeId (void)
                    StringValue ("UlPdcpStats.txt"),
                    MakeStringAccessor (&MmWaveBearerStatsCalculator::SetUlPdcpOutputFilename),
                    MakeStringChecker ())
+    .AddAttribute ("OutputFormat",
+                   "Format of the per-PDU results, saved when they are not aggregated.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWaveBearerStatsCalculator::m_outputFormat),
+                   MakeTraceFormatChecker ())
   ;
   return tid;
 }
@@ -123,6 +154,8 @@ MmWaveBearerStatsCalculator::DoDispose ()
     {
       ShowResults ();
     }
+  m_dlOutFile.Close ();
+  m_ulOutFile.Close ();
 }
 
 void
@@ -175,14 +208,7 @@ MmWaveBearerStatsCalculator::UlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
   }
   else
   {
-    if (!m_ulOutFile.is_open ())
-      {
-        m_ulOutFile.open (GetUlOutputFilename ().c_str ());
-        m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-      }
-    m_ulOutFile << "Tx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
-    << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << 0 << "\t" << std::endl;
+    WritePdu (m_ulOutFile, GetUlOutputFilename (), 0, cellId, imsi, rnti, lcid, packetSize, 0);
   }
 }
 
@@ -204,14 +230,7 @@ MmWaveBearerStatsCalculator::DlTxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
   }            
   else
   {
-    if (!m_dlOutFile.is_open ())
-      {
-        m_dlOutFile.open (GetDlOutputFilename ().c_str ());
-        m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-      }
-    m_dlOutFile << "Tx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
-    << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << 0 << "\t" << std::endl;
+    WritePdu (m_dlOutFile, GetDlOutputFilename (), 0, cellId, imsi, rnti, lcid, packetSize, 0);
   }
 }
 
@@ -243,14 +262,7 @@ MmWaveBearerStatsCalculator::UlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
   }
   else
   {
-    if (!m_ulOutFile.is_open ())
-      {
-        m_ulOutFile.open (GetUlOutputFilename ().c_str ());
-        m_ulOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
-      }
-    m_ulOutFile << "Rx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
-    << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << delay << "\t" << std::endl;
+    WritePdu (m_ulOutFile, GetUlOutputFilename (), 1, cellId, imsi, rnti, lcid, packetSize, delay);
   }
 }
 
@@ -281,15 +293,19 @@ MmWaveBearerStatsCalculator::DlRxPdu (uint16_t cellId, uint64_t imsi, uint16_t r
   }
   else
   {
-    if (!m_dlOutFile.is_open ())
+    WritePdu (m_dlOutFile, GetDlOutputFilename (), 1, cellId, imsi, rnti, lcid, packetSize, delay);
+  }
+}
+
+void
+MmWaveBearerStatsCalculator::WritePdu (MmWaveTraceWriter& writer, std::string fileName, uint8_t type, uint16_t cellId,
+                                       uint64_t imsi, uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay)
+{
+  if (!writer.IsOpen ())
     {
-      m_dlOutFile.open (GetDlOutputFilename ().c_str ());
-      m_dlOutFile << "TYPE\tTIME\tCellId\tIMSI\tRNTI\tLCID\tSIZE\tDELAY\t" << std::endl;
+      writer.Open (fileName, m_outputFormat);
     }
-    m_dlOutFile << "Rx\t" << Simulator::Now ().GetNanoSeconds () / 1.0e9 << "\t" 
-    << cellId << "\t" << imsi << "\t" << rnti << "\t" << (uint32_t) lcid << "\t" 
-    << packetSize << "\t" << delay << "\t" << std::endl;
-  }
+  writer.Write ({type, Simulator::Now ().GetNanoSeconds () / 1.0e9, cellId, imsi, rnti, lcid, packetSize, delay});
 }
 
 void
@@ -34,6 +34,7 @@
 #include "ns3/uinteger.h"
 #include "ns3/object.h"
 #include "ns3/basic-data-calculators.h"
+#include "ns3/mmwave-trace-writer.h"
 #include "ns3/lte-common.h"
 #include <string>
 #include <map>
@@ -461,8 +462,19 @@ private:
    */
   std::string m_ulPdcpOutputFilename;
 
-  std::ofstream m_dlOutFile;
-  std::ofstream m_ulOutFile;
+  /**
+   * Write a PDU in the per-PDU trace of a direction, opening it if needed
+   */
+  void WritePdu (MmWaveTraceWriter& writer, std::string fileName, uint8_t type, uint16_t cellId, uint64_t imsi,
+                 uint16_t rnti, uint8_t lcid, uint32_t packetSize, uint64_t delay);
+
+  /**
+   * Format of the per-PDU traces, written when the results are not aggregated
+   */
+  MmWaveTraceWriter::Format m_outputFormat;
+
+  MmWaveTraceWriter m_dlOutFile;
+  MmWaveTraceWriter m_ulOutFile;
 };
 
 } // namespace mmwave
@@ -82,6 +82,7 @@ MmWaveHelper::MmWaveHelper (void)
     m_cellIdCounter (1),
     m_harqEnabled (false),
     m_rlcAmEnabled (false),
+    m_useSlotBarrier (false),
     m_snrTest (false),
     m_useIdealRrc (false)
 {
@@ -150,6 +151,12 @@ MmWaveHelper::GetTypeId (void)
                    BooleanValue (true),
                    MakeBooleanAccessor (&MmWaveHelper::m_harqEnabled),
                    MakeBooleanChecker ())
+    .AddAttribute ("SlotBarrier",
+                   "Schedule together the slots of the mmWave eNBs that start at the "
+                   "same time, see ns3::MmWaveSlotBarrier",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWaveHelper::m_useSlotBarrier),
+                   MakeBooleanChecker ())
     .AddAttribute ("RlcAmEnabled",
                    "Enable RLC Acknowledged Mode",
                    BooleanValue (false),
@@ -277,6 +284,7 @@ MmWaveHelper::DoDispose (void)
   m_channel.clear ();
   m_componentCarrierPhyParams.clear ();
   m_lteComponentCarrierPhyParams.clear ();
+  m_slotBarrier = 0;
   Object::DoDispose ();
 }
 
@@ -1812,6 +1820,14 @@ MmWaveHelper::InstallSingleEnbDevice (Ptr<Node> n)
       Ptr<LteFfrAlgorithm> ffrAlgorithm = m_ffrAlgorithmFactory.Create<LteFfrAlgorithm> ();
       */
       sched->ConfigureCommonParameters (ccEnb->GetConfigurationParameters ());
+      if (m_useSlotBarrier)
+        {
+          if (!m_slotBarrier)
+            {
+              m_slotBarrier = CreateObject<MmWaveSlotBarrier> ();
+            }
+          mac->SetSlotBarrier (m_slotBarrier, sched);
+        }
 
       /**********************************************************
       //To do later?
@@ -2800,13 +2816,25 @@ MmWaveHelper::ActivateDataRadioBearer (Ptr<NetDevice> ueDevice, EpsBearer bearer
 void
 MmWaveHelper::EnableTraces (void)
 {
+  EnableTraces (TraceFormats ());
+}
+
+void
+MmWaveHelper::EnableTraces (const TraceFormats &formats)
+{
+  m_phyStats->SetAttribute ("OutputFormat", EnumValue (formats.m_rxPacketTrace));
+  m_phyStats->SetAttribute ("UlPhyTransmissionFormat", EnumValue (formats.m_phyTxTrace));
+  m_phyStats->SetAttribute ("DlPhyTransmissionFormat", EnumValue (formats.m_phyTxTrace));
   EnableDlPhyTrace ();
   EnableUlPhyTrace ();
   EnableEnbSchedTrace ();
   //EnableTransportBlockTrace (); //the callback does nothing
   EnableRlcTraces ();
+  m_rlcStats->SetAttribute ("OutputFormat", EnumValue (formats.m_rlcTrace));
   EnablePdcpTraces ();
+  m_pdcpStats->SetAttribute ("OutputFormat", EnumValue (formats.m_pdcpTrace));
   EnableMcTraces ();
+  m_mcStats->SetAttribute ("OutputFormat", EnumValue (formats.m_mcTrace));
 }
 
 
@@ -2849,6 +2877,42 @@ MmWaveHelper::EnableUlPhyTrace (void)
                    MakeBoundCallback (&MmWavePhyTrace::RxPacketTraceEnbCallback, m_phyStats));
 }
 
+void
+MmWaveHelper::EnableRxPacketStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_rxPacketStats, "please make sure that MmWaveHelper::EnableRxPacketStats is called at most once");
+  m_rxPacketStats = CreateObject<MmWaveRxPacketStatsCalculator> ();
+
+  Config::ConnectFailSafe ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/MmWaveUePhy/DlSpectrumPhy/RxPacketTraceUe",
+                           MakeBoundCallback (&MmWaveRxPacketStatsCalculator::RxPacketTraceUeCallback, m_rxPacketStats));
+  Config::ConnectFailSafe ("/NodeList/*/DeviceList/*/MmWaveComponentCarrierMapUe/*/MmWaveUePhy/DlSpectrumPhy/RxPacketTraceUe",
+                           MakeBoundCallback (&MmWaveRxPacketStatsCalculator::RxPacketTraceUeCallback, m_rxPacketStats));
+  Config::ConnectFailSafe ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/MmWaveEnbPhy/DlSpectrumPhy/RxPacketTraceEnb",
+                           MakeBoundCallback (&MmWaveRxPacketStatsCalculator::RxPacketTraceEnbCallback, m_rxPacketStats));
+}
+
+Ptr<MmWaveRxPacketStatsCalculator>
+MmWaveHelper::GetRxPacketStats (void)
+{
+  return m_rxPacketStats;
+}
+
+void
+MmWaveHelper::EnableRlcBufferStats (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_rlcBufferStats, "please make sure that MmWaveHelper::EnableRlcBufferStats is called at most once");
+  m_rlcBufferStats = CreateObject<MmWaveRlcBufferStatsCalculator> ();
+  m_rlcBufferStats->Start ();
+}
+
+Ptr<MmWaveRlcBufferStatsCalculator>
+MmWaveHelper::GetRlcBufferStats (void)
+{
+  return m_rlcBufferStats;
+}
+
 void
 MmWaveHelper::EnableTransportBlockTrace ()
 {
@@ -53,6 +53,7 @@
 #include <ns3/mmwave-enb-phy.h>
 #include <ns3/mmwave-spectrum-value-helper.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-slot-barrier.h>
 #include <ns3/mmwave-rrc-protocol-ideal.h>
 #include "mmwave-phy-trace.h"
 #include "mmwave-mac-trace.h"
@@ -77,6 +78,9 @@
 #include <ns3/lte-anr.h>
 #include <ns3/lte-spectrum-value-helper.h>
 #include <ns3/core-network-stats-calculator.h>
+#include <ns3/mmwave-trace-writer.h>
+#include <ns3/mmwave-rx-packet-stats-calculator.h>
+#include <ns3/mmwave-rlc-buffer-stats-calculator.h>
 #include <ns3/mmwave-component-carrier-enb.h>
 
 
@@ -251,8 +255,26 @@ public:
   void AttachIrToClosestEnb (NetDeviceContainer ueDevices, NetDeviceContainer mmWaveEnbDevices, NetDeviceContainer lteEnbDevices);
 
 
+  /**
+   * Format of each trace enabled by EnableTraces
+   */
+  struct TraceFormats
+  {
+    MmWaveTraceWriter::Format m_rxPacketTrace = MmWaveTraceWriter::TEXT;   //!< RxPacketTrace
+    MmWaveTraceWriter::Format m_phyTxTrace = MmWaveTraceWriter::TEXT;      //!< UL and DL PHY transmission traces
+    MmWaveTraceWriter::Format m_rlcTrace = MmWaveTraceWriter::TEXT;        //!< per-PDU RLC traces
+    MmWaveTraceWriter::Format m_pdcpTrace = MmWaveTraceWriter::TEXT;       //!< per-PDU PDCP traces
+    MmWaveTraceWriter::Format m_mcTrace = MmWaveTraceWriter::TEXT;         //!< MC switch and cell ID traces
+  };
+
   void EnableTraces ();
 
+  /**
+   * Enable the traces, writing each of them in the given format
+   * \param formats the formats of the traces
+   */
+  void EnableTraces (const TraceFormats &formats);
+
   void SetSchedulerType (std::string type);
   std::string GetSchedulerType () const;
 
@@ -363,6 +385,22 @@ public:
   void EnableUlPhyTrace ();
   void EnableEnbSchedTrace ();
 
+  /**
+   * Aggregate RxPacketTraceUe and RxPacketTraceEnb in time windows with a
+   * MmWaveRxPacketStatsCalculator, which only writes a summary per window,
+   * cell and RNTI. It can be used instead of the per-TB RxPacketTrace of
+   * EnableDlPhyTrace and EnableUlPhyTrace.
+   */
+  void EnableRxPacketStats (void);
+  Ptr<MmWaveRxPacketStatsCalculator> GetRxPacketStats (void);
+
+  /**
+   * Sample the buffers of all the LteRlcAm entities every SamplingPeriod
+   * with a MmWaveRlcBufferStatsCalculator, from a single event
+   */
+  void EnableRlcBufferStats (void);
+  Ptr<MmWaveRlcBufferStatsCalculator> GetRlcBufferStats (void);
+
   
 protected:
   virtual void DoInitialize ();
@@ -435,6 +473,8 @@ private:
 
   Ptr<MmWavePhyTrace> m_phyStats;
   Ptr<MmWaveMacTrace> m_enbStats;
+  Ptr<MmWaveRxPacketStatsCalculator> m_rxPacketStats;
+  Ptr<MmWaveRlcBufferStatsCalculator> m_rlcBufferStats;
 
   ObjectFactory m_lteUeAntennaModelFactory;             /// Factory of antenna object for Lte UE.
   ObjectFactory m_lteEnbAntennaModelFactory;       /// Factory of antenna objects for Lte eNB.
@@ -459,6 +499,8 @@ private:
 
   bool m_harqEnabled;
   bool m_rlcAmEnabled;
+  bool m_useSlotBarrier;
+  Ptr<MmWaveSlotBarrier> m_slotBarrier;       // shared by the eNB MACs if m_useSlotBarrier
   bool m_snrTest;
   bool m_useIdealRrc;       // Initialized as true in the constructor
 
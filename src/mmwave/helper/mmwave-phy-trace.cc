@@ -36,6 +36,7 @@
 #include <ns3/log.h>
 #include "mmwave-phy-trace.h"
 #include <ns3/simulator.h>
+#include <ns3/enum.h>
 #include <stdio.h>
 
 namespace ns3 {
@@ -46,14 +47,63 @@ namespace mmwave {
 
 NS_OBJECT_ENSURE_REGISTERED (MmWavePhyTrace);
 
-std::ofstream MmWavePhyTrace::m_rxPacketTraceFile;
+namespace {
+
+MmWaveTraceSchema
+MakeRxPacketTraceSchema (void)
+{
+  MmWaveTraceSchema schema ("DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler");
+  schema.AddLabelColumn ("DL/UL", {"DL", "UL"})
+  .AddColumn ("time", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("frame", MmWaveTraceSchema::UINT32)
+  .AddColumn ("subF", MmWaveTraceSchema::UINT8)
+  .AddColumn ("slot", MmWaveTraceSchema::UINT8)
+  .AddColumn ("1stSym", MmWaveTraceSchema::UINT8)
+  .AddColumn ("symbol#", MmWaveTraceSchema::UINT8)
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT64)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("ccId", MmWaveTraceSchema::UINT8)
+  .AddColumn ("tbSize", MmWaveTraceSchema::UINT32)
+  .AddColumn ("mcs", MmWaveTraceSchema::UINT8)
+  .AddColumn ("rv", MmWaveTraceSchema::UINT8)
+  .AddColumn ("SINR(dB)", MmWaveTraceSchema::DOUBLE)
+  // the legacy UL rows have a space before the tab
+  .SetSuffixByLabel ("DL/UL", {"\t", " \t"})
+  .AddColumn ("corrupt", MmWaveTraceSchema::UINT8)
+  .AddColumn ("TBler", MmWaveTraceSchema::DOUBLE, "");
+  return schema;
+}
+
+MmWaveTraceSchema
+MakePhyTransmissionTraceSchema (void)
+{
+  MmWaveTraceSchema schema ("frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId");
+  schema.AddColumn ("frame", MmWaveTraceSchema::UINT32)
+  .AddColumn ("subF", MmWaveTraceSchema::UINT8)
+  .AddColumn ("slot", MmWaveTraceSchema::UINT8)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("firstSym", MmWaveTraceSchema::UINT8)
+  .AddColumn ("numSym", MmWaveTraceSchema::UINT8)
+  .AddColumn ("type", MmWaveTraceSchema::UINT8)
+  .AddColumn ("tddMode", MmWaveTraceSchema::UINT8)
+  .AddColumn ("retxNum", MmWaveTraceSchema::UINT8)
+  .AddColumn ("ccId", MmWaveTraceSchema::UINT8, "");
+  return schema;
+}
+
+} // unnamed namespace
+
+MmWaveTraceWriter MmWavePhyTrace::m_rxPacketTraceFile (MakeRxPacketTraceSchema ());
 std::string MmWavePhyTrace::m_rxPacketTraceFilename;
+MmWaveTraceWriter::Format MmWavePhyTrace::m_rxPacketTraceFormat = MmWaveTraceWriter::TEXT;
 
-std::ofstream MmWavePhyTrace::m_ulPhyTraceFile {};
+MmWaveTraceWriter MmWavePhyTrace::m_ulPhyTraceFile (MakePhyTransmissionTraceSchema ());
 std::string MmWavePhyTrace::m_ulPhyTraceFilename {};
+MmWaveTraceWriter::Format MmWavePhyTrace::m_ulPhyTraceFormat = MmWaveTraceWriter::TEXT;
 
-std::ofstream MmWavePhyTrace::m_dlPhyTraceFile {};
+MmWaveTraceWriter MmWavePhyTrace::m_dlPhyTraceFile (MakePhyTransmissionTraceSchema ());
 std::string MmWavePhyTrace::m_dlPhyTraceFilename {};
+MmWaveTraceWriter::Format MmWavePhyTrace::m_dlPhyTraceFormat = MmWaveTraceWriter::TEXT;
 
 MmWavePhyTrace::MmWavePhyTrace ()
 {
@@ -61,10 +111,9 @@ MmWavePhyTrace::MmWavePhyTrace ()
 
 MmWavePhyTrace::~MmWavePhyTrace ()
 {
-  if (m_rxPacketTraceFile.is_open ())
-    {
-      m_rxPacketTraceFile.close ();
-    }
+  m_rxPacketTraceFile.Close ();
+  m_ulPhyTraceFile.Flush ();
+  m_dlPhyTraceFile.Flush ();
 }
 
 TypeId
@@ -88,7 +137,21 @@ MmWavePhyTrace::GetTypeId (void)
                    StringValue ("DlPhyTransmissionTrace.txt"),
                    MakeStringAccessor (&MmWavePhyTrace::SetDlPhyTxOutputFilename),
                    MakeStringChecker ())
-          
+    .AddAttribute ("OutputFormat",
+                   "Format of the file where the PHY reception results will be saved.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWavePhyTrace::SetPhyRxOutputFormat),
+                   MakeTraceFormatChecker ())
+    .AddAttribute ("UlPhyTransmissionFormat",
+                   "Format of the file where the UL transmission info will be saved.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWavePhyTrace::SetUlPhyTxOutputFormat),
+                   MakeTraceFormatChecker ())
+    .AddAttribute ("DlPhyTransmissionFormat",
+                   "Format of the file where the DL transmission info will be saved.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWavePhyTrace::SetDlPhyTxOutputFormat),
+                   MakeTraceFormatChecker ())
   ;
   return tid;
 }
@@ -114,6 +177,60 @@ MmWavePhyTrace::SetDlPhyTxOutputFilename (std::string fileName)
   m_dlPhyTraceFilename = fileName;
 }
 
+void
+MmWavePhyTrace::SetPhyRxOutputFormat (MmWaveTraceWriter::Format format)
+{
+  NS_LOG_INFO ("RxPacketTrace format: " << format);
+  m_rxPacketTraceFormat = format;
+}
+
+void
+MmWavePhyTrace::SetUlPhyTxOutputFormat (MmWaveTraceWriter::Format format)
+{
+  NS_LOG_INFO ("UL PHY transmission trace format: " << format);
+  m_ulPhyTraceFormat = format;
+}
+
+void
+MmWavePhyTrace::SetDlPhyTxOutputFormat (MmWaveTraceWriter::Format format)
+{
+  NS_LOG_INFO ("DL PHY transmission trace format: " << format);
+  m_dlPhyTraceFormat = format;
+}
+
+void
+MmWavePhyTrace::OpenTrace (MmWaveTraceWriter &writer, std::string fileName, MmWaveTraceWriter::Format format)
+{
+  if (!writer.IsOpen ())
+    {
+      writer.Open (fileName, format);
+    }
+}
+
+void
+MmWavePhyTrace::WriteRxPacketTrace (uint8_t direction, RxPacketTraceParams params)
+{
+  OpenTrace (m_rxPacketTraceFile, m_rxPacketTraceFilename, m_rxPacketTraceFormat);
+  m_rxPacketTraceFile.Write ({direction, Simulator::Now ().GetSeconds (),
+                              params.m_frameNum, params.m_sfNum,
+                              params.m_slotNum, params.m_symStart,
+                              params.m_numSym, params.m_cellId,
+                              params.m_rnti, params.m_ccId,
+                              params.m_tbSize, params.m_mcs,
+                              params.m_rv, 10 * std::log10 (params.m_sinr),
+                              params.m_corrupt, params.m_tbler});
+}
+
+void
+MmWavePhyTrace::WritePhyTransmissionTrace (MmWaveTraceWriter &writer, PhyTransmissionTraceParams param)
+{
+  writer.Write ({param.m_frameNum, param.m_sfNum,
+                 param.m_slotNum, param.m_rnti,
+                 param.m_symStart, param.m_numSym,
+                 param.m_ttiType, param.m_tddMode,
+                 param.m_rv, param.m_ccId});
+}
+
 void
 MmWavePhyTrace::ReportCurrentCellRsrpSinrCallback (Ptr<MmWavePhyTrace> phyStats, std::string path,
                                                      uint64_t imsi, SpectrumValue& sinr, SpectrumValue& power)
@@ -191,65 +308,25 @@ MmWavePhyTrace::ReportDLTbSize (uint64_t imsi, uint64_t tbSize)
 void 
 MmWavePhyTrace::ReportUlPhyTransmissionCallback (Ptr<MmWavePhyTrace> phyStats, PhyTransmissionTraceParams param)
 {
-  if (!m_ulPhyTraceFile.is_open ())
-    {
-      m_ulPhyTraceFile.open (m_ulPhyTraceFilename.c_str ());
-      if (!m_ulPhyTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-      m_ulPhyTraceFile << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
-    }
+  OpenTrace (m_ulPhyTraceFile, m_ulPhyTraceFilename, m_ulPhyTraceFormat);
 
   // Trace the UL PHY transmission info
-  m_ulPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t"
-                   << +param.m_slotNum << "\t" << +param.m_rnti << "\t" 
-                   << +param.m_symStart << "\t" << +param.m_numSym << "\t" 
-                   << +param.m_ttiType << "\t" << +param.m_tddMode << "\t" 
-                   << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+  WritePhyTransmissionTrace (m_ulPhyTraceFile, param);
 }
 
 void 
 MmWavePhyTrace::ReportDlPhyTransmissionCallback (Ptr<MmWavePhyTrace> phyStats, PhyTransmissionTraceParams param)
 {
-  if (!m_dlPhyTraceFile.is_open ())
-    {
-      m_dlPhyTraceFile.open (m_dlPhyTraceFilename.c_str ());
-      if (!m_dlPhyTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-      m_dlPhyTraceFile << "frame\tsubF\tslot\trnti\tfirstSym\tnumSym\ttype\ttddMode\tretxNum\tccId" << std::endl;
-    }
+  OpenTrace (m_dlPhyTraceFile, m_dlPhyTraceFilename, m_dlPhyTraceFormat);
 
   // Trace the DL PHY transmission info
-  m_dlPhyTraceFile << +param.m_frameNum << "\t" << +param.m_sfNum << "\t"
-                   << +param.m_slotNum << "\t" << +param.m_rnti << "\t" 
-                   << +param.m_symStart << "\t" << +param.m_numSym << "\t" 
-                   << +param.m_ttiType << "\t" << +param.m_tddMode << "\t" 
-                   << +param.m_rv << "\t" << +param.m_ccId << std::endl;
+  WritePhyTransmissionTrace (m_dlPhyTraceFile, param);
 }
 
 void
 MmWavePhyTrace::RxPacketTraceUeCallback (Ptr<MmWavePhyTrace> phyStats, std::string path, RxPacketTraceParams params)
 {
-  if (!m_rxPacketTraceFile.is_open ())
-    {
-      m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-      m_rxPacketTraceFile << "DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler" << std::endl;
-      if (!m_rxPacketTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-    }
-  m_rxPacketTraceFile << "DL\t" << Simulator::Now ().GetSeconds () << "\t" 
-                      << params.m_frameNum << "\t" << +params.m_sfNum << "\t" 
-                      << +params.m_slotNum << "\t" << +params.m_symStart << "\t" 
-                      << +params.m_numSym << "\t" << params.m_cellId << "\t" 
-                      << params.m_rnti << "\t" << +params.m_ccId << "\t" 
-                      << params.m_tbSize << "\t" << +params.m_mcs << "\t" 
-                      << +params.m_rv << "\t" << 10 * std::log10 (params.m_sinr) << "\t" 
-                      << params.m_corrupt << "\t" <<  params.m_tbler << std::endl;
+  WriteRxPacketTrace (0, params);
 
   if (params.m_corrupt)
     {
@@ -265,23 +342,7 @@ MmWavePhyTrace::RxPacketTraceUeCallback (Ptr<MmWavePhyTrace> phyStats, std::stri
 void
 MmWavePhyTrace::RxPacketTraceEnbCallback (Ptr<MmWavePhyTrace> phyStats, std::string path, RxPacketTraceParams params)
 {
-  if (!m_rxPacketTraceFile.is_open ())
-    {
-      m_rxPacketTraceFile.open (m_rxPacketTraceFilename.c_str ());
-      m_rxPacketTraceFile << "DL/UL\ttime\tframe\tsubF\tslot\t1stSym\tsymbol#\tcellId\trnti\tccId\ttbSize\tmcs\trv\tSINR(dB)\tcorrupt\tTBler" << std::endl;
-      if (!m_rxPacketTraceFile.is_open ())
-        {
-          NS_FATAL_ERROR ("Could not open tracefile");
-        }
-    }
-  m_rxPacketTraceFile << "UL\t" << Simulator::Now ().GetSeconds () << "\t" 
-                      << params.m_frameNum << "\t" << +params.m_sfNum << "\t" 
-                      << +params.m_slotNum << "\t" << +params.m_symStart << "\t" 
-                      << +params.m_numSym << "\t" << params.m_cellId << "\t" 
-                      << params.m_rnti << "\t" << +params.m_ccId << "\t" 
-                      << params.m_tbSize << "\t" << +params.m_mcs << "\t" 
-                      << +params.m_rv << "\t" << 10 * std::log10 (params.m_sinr) << " \t" 
-                      << params.m_corrupt << "\t" << params.m_tbler << std::endl;
+  WriteRxPacketTrace (1, params);
 
   if (params.m_corrupt)
     {
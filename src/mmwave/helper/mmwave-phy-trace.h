@@ -36,6 +36,7 @@
 #include <ns3/object.h>
 #include <ns3/spectrum-value.h>
 #include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-trace-writer.h>
 #include <fstream>
 #include <iostream>
 
@@ -84,17 +85,53 @@ public:
   */
   void SetDlPhyTxOutputFilename (std::string fileName);
 
+ /**
+  * Sets the format of the PHY reception traces
+  * \param format the format
+  */
+  void SetPhyRxOutputFormat (MmWaveTraceWriter::Format format);
+
+ /**
+  * Sets the format of the UL PHY tranmission traces
+  * \param format the format
+  */
+  void SetUlPhyTxOutputFormat (MmWaveTraceWriter::Format format);
+
+ /**
+  * Sets the format of the DL PHY tranmission traces
+  * \param format the format
+  */
+  void SetDlPhyTxOutputFormat (MmWaveTraceWriter::Format format);
+
 private:
+  /**
+   * Open a trace writer if it is not open yet
+   */
+  static void OpenTrace (MmWaveTraceWriter &writer, std::string fileName, MmWaveTraceWriter::Format format);
+
+  /**
+   * Write a record of the PHY reception trace
+   */
+  static void WriteRxPacketTrace (uint8_t direction, RxPacketTraceParams params);
+
+  /**
+   * Write a record of a PHY transmission trace
+   */
+  static void WritePhyTransmissionTrace (MmWaveTraceWriter &writer, PhyTransmissionTraceParams param);
+
   //void ReportInterferenceTrace (uint64_t imsi, SpectrumValue& sinr);
   //void ReportDLTbSize (uint64_t imsi, uint64_t tbSize);
-  static std::ofstream m_rxPacketTraceFile;   //!< Output stream for the PHY reception trace
+  static MmWaveTraceWriter m_rxPacketTraceFile;   //!< Writer of the PHY reception trace
   static std::string m_rxPacketTraceFilename;   //!< Output filename for the PHY reception trace
+  static MmWaveTraceWriter::Format m_rxPacketTraceFormat;   //!< Format of the PHY reception trace
 
-  static std::ofstream m_ulPhyTraceFile;    //!< Output stream for the UL PHY transmission trace
+  static MmWaveTraceWriter m_ulPhyTraceFile;    //!< Writer of the UL PHY transmission trace
   static std::string m_ulPhyTraceFilename;    //!< Output filename for the UL PHY transmission trace
+  static MmWaveTraceWriter::Format m_ulPhyTraceFormat;    //!< Format of the UL PHY transmission trace
   
-  static std::ofstream m_dlPhyTraceFile;    //!< Output stream for the DL PHY transmission trace
+  static MmWaveTraceWriter m_dlPhyTraceFile;    //!< Writer of the DL PHY transmission trace
   static std::string m_dlPhyTraceFilename;    //!< Output filename for the DL PHY transmission trace
+  static MmWaveTraceWriter::Format m_dlPhyTraceFormat;    //!< Format of the DL PHY transmission trace
   
 };
 
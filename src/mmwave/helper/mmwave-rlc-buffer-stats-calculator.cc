@@ -0,0 +1,160 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#include "mmwave-rlc-buffer-stats-calculator.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/boolean.h>
+#include <ns3/enum.h>
+#include <ns3/lte-rlc-am.h>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveRlcBufferStatsCalculator");
+
+namespace mmwave {
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveRlcBufferStatsCalculator);
+
+namespace {
+
+MmWaveTraceSchema
+MakeRlcBufferStatsSchema (void)
+{
+  MmWaveTraceSchema schema ("time\trnti\tlcid\ttxBytes\ttxHolDelay(us)\tretxPdus\tretxBytes\tretxHolDelay(us)\ttxedBytes");
+  schema.AddColumn ("time", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("lcid", MmWaveTraceSchema::UINT8)
+  .AddColumn ("txBytes", MmWaveTraceSchema::UINT32)
+  .AddColumn ("txHolDelay(us)", MmWaveTraceSchema::UINT64)
+  .AddColumn ("retxPdus", MmWaveTraceSchema::UINT32)
+  .AddColumn ("retxBytes", MmWaveTraceSchema::UINT32)
+  .AddColumn ("retxHolDelay(us)", MmWaveTraceSchema::UINT64)
+  .AddColumn ("txedBytes", MmWaveTraceSchema::UINT32, "");
+  return schema;
+}
+
+} // unnamed namespace
+
+MmWaveRlcBufferStatsCalculator::MmWaveRlcBufferStatsCalculator ()
+  : m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_nRows (0),
+    m_outFile (MakeRlcBufferStatsSchema ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmWaveRlcBufferStatsCalculator::~MmWaveRlcBufferStatsCalculator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+MmWaveRlcBufferStatsCalculator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MmWaveRlcBufferStatsCalculator")
+    .SetParent<Object> ()
+    .SetGroupName ("MmWave")
+    .AddConstructor<MmWaveRlcBufferStatsCalculator> ()
+    .AddAttribute ("SamplingPeriod",
+                   "Interval between two samples of the RLC buffers.",
+                   TimeValue (MilliSeconds (10)),
+                   MakeTimeAccessor (&MmWaveRlcBufferStatsCalculator::m_samplingPeriod),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("WriteIdleEntities",
+                   "If true, also write the rows of the entities whose buffers are empty.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&MmWaveRlcBufferStatsCalculator::m_writeIdleEntities),
+                   MakeBooleanChecker ())
+    .AddAttribute ("OutputFilename",
+                   "Name of the file where the samples of the RLC buffers will be saved.",
+                   StringValue ("RlcBufferStats.txt"),
+                   MakeStringAccessor (&MmWaveRlcBufferStatsCalculator::m_outputFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("OutputFormat",
+                   "Format of the output file.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWaveRlcBufferStatsCalculator::m_outputFormat),
+                   MakeTraceFormatChecker ())
+  ;
+  return tid;
+}
+
+void
+MmWaveRlcBufferStatsCalculator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Stop ();
+  Object::DoDispose ();
+}
+
+void
+MmWaveRlcBufferStatsCalculator::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT_MSG (!m_outFile.IsOpen (), "The RLC buffer statistics were already started");
+  m_outFile.Open (m_outputFilename, m_outputFormat);
+  m_sampleEvent = Simulator::Schedule (m_samplingPeriod, &MmWaveRlcBufferStatsCalculator::Sample, this);
+  Simulator::ScheduleDestroy (&MmWaveRlcBufferStatsCalculator::Stop, Ptr<MmWaveRlcBufferStatsCalculator> (this));
+}
+
+void
+MmWaveRlcBufferStatsCalculator::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_sampleEvent.Cancel ();
+  if (m_outFile.IsOpen ())
+    {
+      m_outFile.Close ();
+    }
+}
+
+uint64_t
+MmWaveRlcBufferStatsCalculator::GetNRows (void) const
+{
+  return m_nRows;
+}
+
+void
+MmWaveRlcBufferStatsCalculator::Sample (void)
+{
+  const std::map<uint64_t, LteRlcAm *> &instances = LteRlcAm::GetInstances ();
+  NS_LOG_FUNCTION (this << instances.size ());
+  double time = Simulator::Now ().GetSeconds ();
+  for (const std::pair<const uint64_t, LteRlcAm *> &instance : instances)
+    {
+      LteRlcAm *rlc = instance.second;
+      LteRlcAm::BufferStatus status = rlc->GetBufferStatus ();
+      if (!m_writeIdleEntities && status.m_txonBufferSize == 0 && status.m_retxBufferSize == 0
+          && status.m_txedBufferSize == 0)
+        {
+          continue;
+        }
+      m_outFile.Write ({time, rlc->GetRnti (), rlc->GetLcId (), status.m_txonBufferSize,
+                        status.m_txonHolDelay.GetMicroSeconds (), status.m_retxBufferPdus,
+                        status.m_retxBufferSize, status.m_retxHolDelay.GetMicroSeconds (),
+                        status.m_txedBufferSize});
+      m_nRows++;
+    }
+  m_sampleEvent = Simulator::Schedule (m_samplingPeriod, &MmWaveRlcBufferStatsCalculator::Sample, this);
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,90 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_RLC_BUFFER_STATS_CALCULATOR_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_RLC_BUFFER_STATS_CALCULATOR_H_
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/event-id.h>
+#include <ns3/mmwave-trace-writer.h>
+#include <string>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief Samples the buffers of all the LteRlcAm entities
+ *
+ * Every SamplingPeriod, a single event walks the entities returned by
+ * LteRlcAm::GetInstances and writes a row per entity with the occupancy
+ * and the head of line delay of its transmission buffer, and the depth,
+ * occupancy and head of line delay of its retransmission buffer. The
+ * entities with empty buffers are skipped unless WriteIdleEntities is true.
+ *
+ * The entities of a UE and of its eNB share the RNTI and the LCID, as they
+ * do in the other RLC traces.
+ */
+class MmWaveRlcBufferStatsCalculator : public Object
+{
+public:
+  MmWaveRlcBufferStatsCalculator ();
+  virtual ~MmWaveRlcBufferStatsCalculator ();
+  static TypeId GetTypeId (void);
+
+  /**
+   * \brief Open the file and schedule the first sample, one SamplingPeriod from now
+   */
+  void Start (void);
+
+  /**
+   * \brief Stop sampling, and close the file
+   */
+  void Stop (void);
+
+  /**
+   * \brief Get the number of rows written so far
+   */
+  uint64_t GetNRows (void) const;
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * \brief Write a row per entity, and schedule the next sample
+   */
+  void Sample (void);
+
+  Time m_samplingPeriod;
+  bool m_writeIdleEntities;
+  std::string m_outputFilename;
+  MmWaveTraceWriter::Format m_outputFormat;
+
+  EventId m_sampleEvent;
+  uint64_t m_nRows;
+  MmWaveTraceWriter m_outFile;
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_RLC_BUFFER_STATS_CALCULATOR_H_ */
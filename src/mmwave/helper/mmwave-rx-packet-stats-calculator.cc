@@ -0,0 +1,368 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#include "mmwave-rx-packet-stats-calculator.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/double.h>
+#include <ns3/enum.h>
+#include <algorithm>
+#include <cmath>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveRxPacketStatsCalculator");
+
+namespace mmwave {
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveRxPacketStatsCalculator);
+
+namespace {
+
+MmWaveTraceSchema
+MakeRxPacketStatsSchema (void)
+{
+  MmWaveTraceSchema schema ("DL/UL\ttime\tcellId\trnti\tnumTb\tcorrupt\tretx\trxBytes\tthroughput(Mbps)\tBLER\tmeanMcs"
+                            "\tmeanSINR(dB)\tminSINR(dB)\tp5SINR(dB)\tp50SINR(dB)\tp95SINR(dB)");
+  schema.AddLabelColumn ("DL/UL", {"DL", "UL"})
+  .AddColumn ("time", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT64)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("numTb", MmWaveTraceSchema::UINT32)
+  .AddColumn ("corrupt", MmWaveTraceSchema::UINT32)
+  .AddColumn ("retx", MmWaveTraceSchema::UINT32)
+  .AddColumn ("rxBytes", MmWaveTraceSchema::UINT64)
+  .AddColumn ("throughput(Mbps)", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("BLER", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("meanMcs", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("meanSINR(dB)", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("minSINR(dB)", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("p5SINR(dB)", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("p50SINR(dB)", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("p95SINR(dB)", MmWaveTraceSchema::DOUBLE, "");
+  return schema;
+}
+
+MmWaveTraceSchema
+MakeRxPacketMcsStatsSchema (void)
+{
+  MmWaveTraceSchema schema ("DL/UL\ttime\tcellId\trnti\tmcs\tnumTb");
+  schema.AddLabelColumn ("DL/UL", {"DL", "UL"})
+  .AddColumn ("time", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT64)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("mcs", MmWaveTraceSchema::UINT8)
+  .AddColumn ("numTb", MmWaveTraceSchema::UINT32, "");
+  return schema;
+}
+
+} // unnamed namespace
+
+MmWaveQuantileSketch::MmWaveQuantileSketch (double resolution)
+  : m_resolution (resolution),
+    m_firstBin (0),
+    m_count (0),
+    m_min (0),
+    m_max (0)
+{
+  NS_ASSERT_MSG (resolution > 0, "The resolution must be positive");
+}
+
+void
+MmWaveQuantileSketch::Add (double value)
+{
+  int64_t bin = static_cast<int64_t> (std::floor (value / m_resolution));
+  if (m_bins.empty ())
+    {
+      m_firstBin = bin;
+      m_bins.push_back (0);
+    }
+  else if (bin < m_firstBin)
+    {
+      m_bins.insert (m_bins.begin (), m_firstBin - bin, 0);
+      m_firstBin = bin;
+    }
+  else if (bin >= m_firstBin + static_cast<int64_t> (m_bins.size ()))
+    {
+      m_bins.resize (bin - m_firstBin + 1, 0);
+    }
+  m_bins[bin - m_firstBin]++;
+
+  if (m_count == 0 || value < m_min)
+    {
+      m_min = value;
+    }
+  if (m_count == 0 || value > m_max)
+    {
+      m_max = value;
+    }
+  m_count++;
+}
+
+double
+MmWaveQuantileSketch::GetQuantile (double q) const
+{
+  if (m_count == 0)
+    {
+      return 0;
+    }
+  uint64_t rank = std::max<uint64_t> (1, static_cast<uint64_t> (std::ceil (q * m_count)));
+  uint64_t cumulative = 0;
+  for (uint32_t i = 0; i < m_bins.size (); i++)
+    {
+      cumulative += m_bins[i];
+      if (cumulative >= rank)
+        {
+          double center = (m_firstBin + i + 0.5) * m_resolution;
+          return std::min (std::max (center, m_min), m_max);
+        }
+    }
+  return m_max;
+}
+
+uint64_t
+MmWaveQuantileSketch::GetCount (void) const
+{
+  return m_count;
+}
+
+double
+MmWaveQuantileSketch::GetMin (void) const
+{
+  return m_min;
+}
+
+double
+MmWaveQuantileSketch::GetMax (void) const
+{
+  return m_max;
+}
+
+void
+MmWaveQuantileSketch::Reset (void)
+{
+  m_bins.clear ();
+  m_count = 0;
+  m_min = 0;
+  m_max = 0;
+}
+
+bool
+MmWaveRxPacketStatsCalculator::Key::operator< (const Key &other) const
+{
+  if (m_direction != other.m_direction)
+    {
+      return m_direction < other.m_direction;
+    }
+  if (m_cellId != other.m_cellId)
+    {
+      return m_cellId < other.m_cellId;
+    }
+  return m_rnti < other.m_rnti;
+}
+
+MmWaveRxPacketStatsCalculator::MmWaveRxPacketStatsCalculator ()
+  : m_outputFormat (MmWaveTraceWriter::TEXT),
+    m_started (false),
+    m_window (0),
+    m_pendingOutput (false),
+    m_outFile (MakeRxPacketStatsSchema ()),
+    m_mcsOutFile (MakeRxPacketMcsStatsSchema ())
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmWaveRxPacketStatsCalculator::~MmWaveRxPacketStatsCalculator ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+TypeId
+MmWaveRxPacketStatsCalculator::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MmWaveRxPacketStatsCalculator")
+    .SetParent<Object> ()
+    .SetGroupName ("MmWave")
+    .AddConstructor<MmWaveRxPacketStatsCalculator> ()
+    .AddAttribute ("EpochDuration",
+                   "Duration of the windows in which the transport blocks are aggregated.",
+                   TimeValue (MilliSeconds (100)),
+                   MakeTimeAccessor (&MmWaveRxPacketStatsCalculator::m_epochDuration),
+                   MakeTimeChecker (NanoSeconds (1)))
+    .AddAttribute ("SinrResolution",
+                   "Width in dB of the bins used to estimate the quantiles of the SINR.",
+                   DoubleValue (0.1),
+                   MakeDoubleAccessor (&MmWaveRxPacketStatsCalculator::m_sinrResolution),
+                   MakeDoubleChecker<double> (1e-6))
+    .AddAttribute ("OutputFilename",
+                   "Name of the file where the statistics of each window will be saved.",
+                   StringValue ("RxPacketStats.txt"),
+                   MakeStringAccessor (&MmWaveRxPacketStatsCalculator::m_outputFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("McsOutputFilename",
+                   "Name of the file where the MCS histogram of each window will be saved.",
+                   StringValue ("RxPacketMcsStats.txt"),
+                   MakeStringAccessor (&MmWaveRxPacketStatsCalculator::m_mcsOutputFilename),
+                   MakeStringChecker ())
+    .AddAttribute ("OutputFormat",
+                   "Format of the output files.",
+                   EnumValue (MmWaveTraceWriter::TEXT),
+                   MakeEnumAccessor (&MmWaveRxPacketStatsCalculator::m_outputFormat),
+                   MakeTraceFormatChecker ())
+  ;
+  return tid;
+}
+
+void
+MmWaveRxPacketStatsCalculator::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  Finish ();
+  m_stats.clear ();
+  Object::DoDispose ();
+}
+
+void
+MmWaveRxPacketStatsCalculator::RxPacketTraceUeCallback (Ptr<MmWaveRxPacketStatsCalculator> stats, std::string path,
+                                                        RxPacketTraceParams params)
+{
+  stats->AddTransportBlock (0, params);
+}
+
+void
+MmWaveRxPacketStatsCalculator::RxPacketTraceEnbCallback (Ptr<MmWaveRxPacketStatsCalculator> stats, std::string path,
+                                                         RxPacketTraceParams params)
+{
+  stats->AddTransportBlock (1, params);
+}
+
+void
+MmWaveRxPacketStatsCalculator::AddTransportBlock (uint8_t direction, const RxPacketTraceParams &params)
+{
+  int64_t window = Simulator::Now ().GetTimeStep () / m_epochDuration.GetTimeStep ();
+  if (!m_started)
+    {
+      m_outFile.Open (m_outputFilename, m_outputFormat);
+      m_mcsOutFile.Open (m_mcsOutputFilename, m_outputFormat);
+      m_started = true;
+      m_window = window;
+      Simulator::ScheduleDestroy (&MmWaveRxPacketStatsCalculator::Finish, Ptr<MmWaveRxPacketStatsCalculator> (this));
+    }
+  else if (window != m_window)
+    {
+      WriteWindow ();
+      m_window = window;
+    }
+
+  Key key {direction, params.m_cellId, params.m_rnti};
+  std::map<Key, WindowStats>::iterator it = m_stats.find (key);
+  if (it == m_stats.end ())
+    {
+      NS_LOG_DEBUG ("Creating the statistics of direction " << +direction << " cell " << params.m_cellId
+                                                            << " RNTI " << params.m_rnti);
+      WindowStats stats {0, 0, 0, 0, 0, 0, MmWaveQuantileSketch (m_sinrResolution), {}};
+      it = m_stats.insert (std::make_pair (key, stats)).first;
+    }
+  WindowStats &stats = it->second;
+
+  // a null SINR would be -inf dB
+  double sinrDb = 10 * std::log10 (std::max (params.m_sinr, 1e-30));
+  stats.m_numTb++;
+  if (params.m_corrupt)
+    {
+      stats.m_numCorrupt++;
+    }
+  else
+    {
+      stats.m_rxBytes += params.m_tbSize;
+    }
+  if (params.m_rv > 0)
+    {
+      stats.m_numRetx++;
+    }
+  stats.m_sumSinr += sinrDb;
+  stats.m_sinr.Add (sinrDb);
+  stats.m_sumMcs += params.m_mcs;
+  if (params.m_mcs >= stats.m_mcs.size ())
+    {
+      stats.m_mcs.resize (params.m_mcs + 1, 0);
+    }
+  stats.m_mcs[params.m_mcs]++;
+  m_pendingOutput = true;
+}
+
+void
+MmWaveRxPacketStatsCalculator::WriteWindow (void)
+{
+  NS_LOG_FUNCTION (this << m_window);
+  if (!m_pendingOutput)
+    {
+      return;
+    }
+  double time = (m_epochDuration * m_window).GetSeconds ();
+  double epoch = m_epochDuration.GetSeconds ();
+  for (std::map<Key, WindowStats>::iterator it = m_stats.begin (); it != m_stats.end (); ++it)
+    {
+      const Key &key = it->first;
+      WindowStats &stats = it->second;
+      if (stats.m_numTb == 0)
+        {
+          continue;
+        }
+      m_outFile.Write ({key.m_direction, time, key.m_cellId, key.m_rnti, stats.m_numTb, stats.m_numCorrupt,
+                        stats.m_numRetx, stats.m_rxBytes, stats.m_rxBytes * 8 / epoch / 1e6,
+                        static_cast<double> (stats.m_numCorrupt) / stats.m_numTb,
+                        static_cast<double> (stats.m_sumMcs) / stats.m_numTb, stats.m_sumSinr / stats.m_numTb,
+                        stats.m_sinr.GetMin (), stats.m_sinr.GetQuantile (0.05), stats.m_sinr.GetQuantile (0.5),
+                        stats.m_sinr.GetQuantile (0.95)});
+      for (uint32_t mcs = 0; mcs < stats.m_mcs.size (); mcs++)
+        {
+          if (stats.m_mcs[mcs] > 0)
+            {
+              m_mcsOutFile.Write ({key.m_direction, time, key.m_cellId, key.m_rnti, mcs, stats.m_mcs[mcs]});
+              stats.m_mcs[mcs] = 0;
+            }
+        }
+      stats.m_numTb = 0;
+      stats.m_numCorrupt = 0;
+      stats.m_numRetx = 0;
+      stats.m_rxBytes = 0;
+      stats.m_sumSinr = 0;
+      stats.m_sumMcs = 0;
+      stats.m_sinr.Reset ();
+    }
+  m_pendingOutput = false;
+}
+
+void
+MmWaveRxPacketStatsCalculator::Finish (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_started)
+    {
+      WriteWindow ();
+      m_outFile.Close ();
+      m_mcsOutFile.Close ();
+      m_started = false;
+    }
+}
+
+} // namespace mmwave
+
+} // namespace ns3
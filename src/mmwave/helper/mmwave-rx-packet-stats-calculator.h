@@ -0,0 +1,184 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_RX_PACKET_STATS_CALCULATOR_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_RX_PACKET_STATS_CALCULATOR_H_
+
+#include <ns3/object.h>
+#include <ns3/nstime.h>
+#include <ns3/mmwave-phy-mac-common.h>
+#include <ns3/mmwave-trace-writer.h>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief A streaming estimator of the quantiles of a sequence of values
+ *
+ * The values are counted in bins of fixed width, allocated on demand
+ * between the smallest and the largest value seen, as in an HDR histogram:
+ * applied to values in dB, such as the SINR, the error of a quantile is a
+ * fixed fraction of its linear value. A quantile is the center of its bin,
+ * within half a bin of the exact value, and clamped to the smallest and
+ * largest values.
+ */
+class MmWaveQuantileSketch
+{
+public:
+  /**
+   * \param resolution the width of a bin
+   */
+  explicit MmWaveQuantileSketch (double resolution = 0.1);
+
+  /**
+   * \brief Count a value
+   */
+  void Add (double value);
+
+  /**
+   * \brief Get the q-quantile of the values counted so far
+   * \param q the quantile, between 0 and 1
+   * \return the quantile, or 0 if no value was counted
+   */
+  double GetQuantile (double q) const;
+
+  uint64_t GetCount (void) const;
+  double GetMin (void) const;
+  double GetMax (void) const;
+
+  /**
+   * \brief Forget the values, keeping the memory of the bins
+   */
+  void Reset (void);
+
+private:
+  double m_resolution;
+  int64_t m_firstBin;               // index of the bin counted in m_bins[0]
+  std::vector<uint32_t> m_bins;     // counts from m_firstBin on
+  uint64_t m_count;
+  double m_min;
+  double m_max;
+};
+
+/**
+ * \ingroup mmwave
+ * \brief Aggregates RxPacketTraceUe and RxPacketTraceEnb in time windows
+ *
+ * Instead of a row per transport block, as in the RxPacketTrace of
+ * MmWavePhyTrace, this class writes a row per direction, cell and RNTI
+ * every EpochDuration, with the number of transport blocks, the BLER, the
+ * throughput of the correctly received blocks, the mean MCS, and the mean
+ * and quantiles of the SINR. The histogram of the MCS is written in a
+ * second file, with a row per MCS used in the window.
+ *
+ * The windows are aligned to multiples of EpochDuration, and a window is
+ * written when the first block of a later window is received, or at
+ * Simulator::Destroy: no event is scheduled while no block is received,
+ * and the windows without blocks are not written.
+ */
+class MmWaveRxPacketStatsCalculator : public Object
+{
+public:
+  MmWaveRxPacketStatsCalculator ();
+  virtual ~MmWaveRxPacketStatsCalculator ();
+  static TypeId GetTypeId (void);
+
+  /**
+   * Callback connected to RxPacketTraceUe, counting a DL transport block
+   */
+  static void RxPacketTraceUeCallback (Ptr<MmWaveRxPacketStatsCalculator> stats, std::string path,
+                                       RxPacketTraceParams params);
+
+  /**
+   * Callback connected to RxPacketTraceEnb, counting a UL transport block
+   */
+  static void RxPacketTraceEnbCallback (Ptr<MmWaveRxPacketStatsCalculator> stats, std::string path,
+                                        RxPacketTraceParams params);
+
+  /**
+   * \brief Count a transport block in the current window
+   * \param direction 0 for DL, 1 for UL
+   * \param params the parameters of the transport block
+   */
+  void AddTransportBlock (uint8_t direction, const RxPacketTraceParams &params);
+
+  /**
+   * \brief Write the current window, and close the files
+   */
+  void Finish (void);
+
+protected:
+  virtual void DoDispose (void);
+
+private:
+  /**
+   * The statistics of a direction, cell and RNTI in a window
+   */
+  struct WindowStats
+  {
+    uint32_t m_numTb;
+    uint32_t m_numCorrupt;
+    uint32_t m_numRetx;
+    uint64_t m_rxBytes;       // bytes of the blocks received without errors
+    double m_sumSinr;         // in dB
+    uint64_t m_sumMcs;
+    MmWaveQuantileSketch m_sinr;
+    std::vector<uint32_t> m_mcs;
+  };
+
+  /**
+   * (direction, cell ID, RNTI)
+   */
+  struct Key
+  {
+    uint8_t m_direction;
+    uint64_t m_cellId;
+    uint16_t m_rnti;
+
+    bool operator< (const Key &other) const;
+  };
+
+  /**
+   * \brief Write the statistics of the current window, and reset them
+   */
+  void WriteWindow (void);
+
+  Time m_epochDuration;
+  double m_sinrResolution;
+  std::string m_outputFilename;
+  std::string m_mcsOutputFilename;
+  MmWaveTraceWriter::Format m_outputFormat;
+
+  bool m_started;                         // whether the files are open
+  int64_t m_window;                       // index of the current window
+  bool m_pendingOutput;                   // whether the current window has blocks
+  std::map<Key, WindowStats> m_stats;     // kept across windows to reuse the memory of the sketches
+  MmWaveTraceWriter m_outFile;
+  MmWaveTraceWriter m_mcsOutFile;
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_RX_PACKET_STATS_CALCULATOR_H_ */
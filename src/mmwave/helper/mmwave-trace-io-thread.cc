@@ -0,0 +1,239 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#include "mmwave-trace-io-thread.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/global-value.h>
+#include <ns3/boolean.h>
+#include <ns3/uinteger.h>
+#include <chrono>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTraceIoThread");
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \anchor GlobalValueMmWaveAsyncTraces
+ * Whether the mmWave traces are written by a background thread.
+ *
+ * Read when a trace file is opened.
+ */
+static GlobalValue g_asyncTraces = GlobalValue ("MmWaveAsyncTraces",
+                                                "Whether the records of the mmWave traces are written to their "
+                                                "files by a background thread rather than by the simulation thread",
+                                                BooleanValue (false),
+                                                MakeBooleanChecker ());
+
+/**
+ * \ingroup mmwave
+ * \anchor GlobalValueMmWaveAsyncTraceQueueSize
+ * Number of records queued for the background thread of the mmWave traces.
+ *
+ * Read when the thread is started.
+ */
+static GlobalValue g_asyncTraceQueueSize = GlobalValue ("MmWaveAsyncTraceQueueSize",
+                                                        "Number of records of the mmWave traces that can be queued "
+                                                        "for the background thread before the simulation waits for it",
+                                                        UintegerValue (16384),
+                                                        MakeUintegerChecker<uint32_t> (1));
+
+MmWaveTraceIoThread::MmWaveTraceIoThread ()
+  : m_running (false),
+    m_sleeping (false),
+    m_pushed (0),
+    m_written (0),
+    m_stats {0, 0, 0, 0}
+{
+}
+
+MmWaveTraceIoThread&
+MmWaveTraceIoThread::Get (void)
+{
+  static MmWaveTraceIoThread *instance = new MmWaveTraceIoThread ();
+  return *instance;
+}
+
+bool
+MmWaveTraceIoThread::IsEnabled (void)
+{
+  BooleanValue async;
+  g_asyncTraces.GetValue (async);
+  return async.Get ();
+}
+
+void
+MmWaveTraceIoThread::Start (void)
+{
+  NS_LOG_FUNCTION (this);
+  // the queue of the last run, if any, is empty
+  UintegerValue size;
+  g_asyncTraceQueueSize.GetValue (size);
+  m_queue.reset (new SpscQueue<Item> (size.Get ()));
+  m_running = true;
+  m_thread = std::thread (&MmWaveTraceIoThread::Run, this);
+  Simulator::ScheduleDestroy (&MmWaveTraceIoThread::Stop);
+}
+
+void
+MmWaveTraceIoThread::Run (void)
+{
+  Item item;
+  while (true)
+    {
+      if (m_queue->Pop (item))
+        {
+          item.m_writer->DoWrite (item.m_record);
+          m_written.store (m_written.load (std::memory_order_relaxed) + 1, std::memory_order_release);
+          continue;
+        }
+      if (!m_running.load (std::memory_order_acquire))
+        {
+          // Stop drains the queue before stopping the thread
+          break;
+        }
+      std::unique_lock<std::mutex> lock (m_mutex);
+      m_sleeping.store (true);
+      std::atomic_thread_fence (std::memory_order_seq_cst);
+      if (m_queue->IsEmpty () && m_running.load ())
+        {
+          // the timeout bounds the delay of a missed wake up
+          m_wakeup.wait_for (lock, std::chrono::milliseconds (1));
+        }
+      m_sleeping.store (false, std::memory_order_relaxed);
+    }
+}
+
+void
+MmWaveTraceIoThread::Wake (void)
+{
+  std::lock_guard<std::mutex> lock (m_mutex);
+  m_wakeup.notify_one ();
+}
+
+void
+MmWaveTraceIoThread::Register (MmWaveTraceWriter *writer)
+{
+  MmWaveTraceIoThread &thread = Get ();
+  if (!thread.m_running)
+    {
+      thread.Start ();
+    }
+  thread.m_writers.insert (writer);
+}
+
+void
+MmWaveTraceIoThread::Unregister (MmWaveTraceWriter *writer)
+{
+  // no logging: the static writers of MmWavePhyTrace are closed after the
+  // log components may be destroyed
+  Drain ();
+  Get ().m_writers.erase (writer);
+}
+
+void
+MmWaveTraceIoThread::Push (MmWaveTraceWriter *writer, const MmWaveTraceRecord &record)
+{
+  MmWaveTraceIoThread &thread = Get ();
+  if (!thread.m_running)
+    {
+      // the thread was stopped by the last Simulator::Destroy
+      thread.Start ();
+    }
+  Item item {writer, record};
+  if (!thread.m_queue->Push (item))
+    {
+      thread.m_stats.m_stalls++;
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      thread.Wake ();
+      while (!thread.m_queue->Push (item))
+        {
+          std::this_thread::yield ();
+        }
+      thread.m_stats.m_stallTime += std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start).count ();
+    }
+  thread.m_pushed++;
+  thread.m_stats.m_records++;
+  // not m_pushed - m_written: the record being written has already left
+  // the queue, and its slot may hold a new record
+  uint64_t size = thread.m_queue->GetSize ();
+  if (size > thread.m_stats.m_peakSize)
+    {
+      thread.m_stats.m_peakSize = size;
+    }
+  std::atomic_thread_fence (std::memory_order_seq_cst);
+  if (thread.m_sleeping.load (std::memory_order_relaxed))
+    {
+      thread.Wake ();
+    }
+}
+
+void
+MmWaveTraceIoThread::Drain (void)
+{
+  MmWaveTraceIoThread &thread = Get ();
+  while (thread.m_written.load (std::memory_order_acquire) != thread.m_pushed)
+    {
+      if (thread.m_sleeping.load ())
+        {
+          thread.Wake ();
+        }
+      std::this_thread::yield ();
+    }
+}
+
+void
+MmWaveTraceIoThread::Stop (void)
+{
+  MmWaveTraceIoThread &thread = Get ();
+  NS_LOG_FUNCTION (&thread);
+  if (!thread.m_running)
+    {
+      return;
+    }
+  Drain ();
+  for (MmWaveTraceWriter *writer : thread.m_writers)
+    {
+      writer->Flush ();
+    }
+  thread.m_running = false;
+  thread.Wake ();
+  thread.m_thread.join ();
+  NS_LOG_INFO (thread.m_stats.m_records << " records written, peak queue size " << thread.m_stats.m_peakSize
+                                        << ", " << thread.m_stats.m_stalls << " records waited "
+                                        << thread.m_stats.m_stallTime << " ns for a full queue");
+}
+
+MmWaveTraceIoThread::Stats
+MmWaveTraceIoThread::GetStats (void)
+{
+  return Get ().m_stats;
+}
+
+void
+MmWaveTraceIoThread::ResetStats (void)
+{
+  Get ().m_stats = Stats {0, 0, 0, 0};
+}
+
+} // namespace mmwave
+
+} // namespace ns3
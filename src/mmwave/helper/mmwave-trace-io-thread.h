@@ -0,0 +1,140 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_TRACE_IO_THREAD_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_TRACE_IO_THREAD_H_
+
+#include <ns3/mmwave-trace-writer.h>
+#include <ns3/spsc-queue.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief A background thread writing the records of the mmWave traces
+ *
+ * When the MmWaveAsyncTraces global value is true, the MmWaveTraceWriter
+ * opened afterwards do not format and write their records in the
+ * simulation thread: Write pushes the record to a lock-free queue, and this
+ * thread pops it and writes it to the file of its writer. The thread is
+ * shared by all the writers, i.e., by MmWavePhyTrace,
+ * MmWaveBearerStatsCalculator, CoreNetworkStatsCalculator and
+ * McStatsCalculator.
+ *
+ * The records must be written by the simulation thread only. When the queue
+ * is full the simulation thread waits for the I/O thread, and the waits are
+ * accounted in the statistics of the thread. The queue is drained before a
+ * writer is flushed or closed, and at Simulator::Destroy all the writers are
+ * flushed and the thread is stopped; it is started again by the next write.
+ */
+class MmWaveTraceIoThread
+{
+public:
+  /**
+   * Statistics of the thread
+   */
+  struct Stats
+  {
+    uint64_t m_records;     //!< records queued
+    uint64_t m_stalls;      //!< records that found the queue full
+    uint64_t m_stallTime;   //!< time spent waiting for the queue, in ns
+    uint64_t m_peakSize;    //!< largest number of records in the queue
+  };
+
+  /**
+   * \brief Check if the writers opened now should use the thread
+   */
+  static bool IsEnabled (void);
+
+  /**
+   * \brief Start using the thread for a writer, starting the thread if needed
+   */
+  static void Register (MmWaveTraceWriter *writer);
+
+  /**
+   * \brief Stop using the thread for a writer, once its records are written
+   */
+  static void Unregister (MmWaveTraceWriter *writer);
+
+  /**
+   * \brief Queue a record of a writer, waiting if the queue is full
+   */
+  static void Push (MmWaveTraceWriter *writer, const MmWaveTraceRecord &record);
+
+  /**
+   * \brief Wait until all the queued records are written
+   */
+  static void Drain (void);
+
+  /**
+   * \brief Drain the queue, flush the writers and stop the thread
+   *
+   * Scheduled at Simulator::Destroy when the thread is started.
+   */
+  static void Stop (void);
+
+  static Stats GetStats (void);
+  static void ResetStats (void);
+
+private:
+  /**
+   * An entry of the queue
+   */
+  struct Item
+  {
+    MmWaveTraceWriter *m_writer;
+    MmWaveTraceRecord m_record;
+  };
+
+  MmWaveTraceIoThread ();
+
+  /**
+   * \brief Get the instance, never destroyed since writers can be closed
+   *        by static destructors
+   */
+  static MmWaveTraceIoThread& Get (void);
+
+  void Start (void);
+  void Run (void);
+  void Wake (void);
+
+  std::unique_ptr<SpscQueue<Item> > m_queue;
+  std::thread m_thread;
+  std::atomic<bool> m_running;            // false to stop the thread
+  std::atomic<bool> m_sleeping;           // true while the thread waits for m_wakeup
+  uint64_t m_pushed;                      // records queued by the simulation thread
+  std::atomic<uint64_t> m_written;        // records written by the thread
+  std::mutex m_mutex;
+  std::condition_variable m_wakeup;
+  std::set<MmWaveTraceWriter*> m_writers; // writers using the thread
+  Stats m_stats;
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_TRACE_IO_THREAD_H_ */
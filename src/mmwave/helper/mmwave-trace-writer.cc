@@ -0,0 +1,713 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#include "mmwave-trace-writer.h"
+#include "mmwave-trace-io-thread.h"
+#include <ns3/log.h>
+#include <ns3/assert.h>
+#include <ns3/abort.h>
+#include <ns3/fatal-error.h>
+#include <ns3/enum.h>
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTraceWriter");
+
+namespace mmwave {
+
+namespace {
+
+const char TRACE_MAGIC[8] = {'M', 'M', 'W', 'T', 'R', 'A', 'C', 'E'};
+const uint32_t TRACE_VERSION = 2;
+
+// codec of a block
+enum BlockCodec
+{
+  CODEC_NONE = 0,
+  CODEC_ZSTD = 1,
+  CODEC_LZ4 = 2,
+};
+
+#ifdef HAVE_ZSTD
+const int ZSTD_LEVEL = 3;
+#endif
+
+template <typename T>
+void
+WriteInt (std::ostream& os, T value)
+{
+  os.write (reinterpret_cast<const char*> (&value), sizeof (T));
+}
+
+template <typename T>
+bool
+ReadInt (std::istream& is, T& value)
+{
+  is.read (reinterpret_cast<char*> (&value), sizeof (T));
+  return is.gcount () == sizeof (T);
+}
+
+void
+WriteString (std::ostream& os, const std::string& s)
+{
+  NS_ASSERT (s.size () <= UINT16_MAX);
+  WriteInt<uint16_t> (os, s.size ());
+  os.write (s.data (), s.size ());
+}
+
+bool
+ReadString (std::istream& is, std::string& s)
+{
+  uint16_t size;
+  if (!ReadInt (is, size))
+    {
+      return false;
+    }
+  s.resize (size);
+  is.read (&s[0], size);
+  return is.gcount () == size;
+}
+
+} // unnamed namespace
+
+MmWaveTraceRecord::MmWaveTraceRecord (std::initializer_list<MmWaveTraceValue> values)
+  : m_numValues (0)
+{
+  NS_ASSERT (values.size () <= MAX_COLUMNS);
+  for (const MmWaveTraceValue& v : values)
+    {
+      m_values[m_numValues++] = v;
+    }
+}
+
+MmWaveTraceSchema::MmWaveTraceSchema (std::string textHeader)
+  : m_textHeader (textHeader)
+{
+}
+
+MmWaveTraceSchema&
+MmWaveTraceSchema::AddColumn (std::string name, ColumnType type, std::string suffix)
+{
+  NS_ASSERT_MSG (m_columns.size () < MmWaveTraceRecord::MAX_COLUMNS, "Too many columns");
+  m_columns.push_back (Column {name, type, suffix, {}, 0, {}});
+  return *this;
+}
+
+MmWaveTraceSchema&
+MmWaveTraceSchema::AddLabelColumn (std::string name, std::vector<std::string> labels, std::string suffix)
+{
+  NS_ASSERT_MSG (labels.size () <= UINT8_MAX, "Too many labels");
+  AddColumn (name, LABEL, suffix);
+  m_columns.back ().m_labels = labels;
+  return *this;
+}
+
+MmWaveTraceSchema&
+MmWaveTraceSchema::SetSuffixByLabel (std::string labelColumn, std::vector<std::string> suffixes)
+{
+  NS_ASSERT_MSG (!m_columns.empty (), "No column");
+  for (uint32_t i = 0; i + 1 < m_columns.size (); i++)
+    {
+      if (m_columns[i].m_name == labelColumn)
+        {
+          NS_ASSERT_MSG (m_columns[i].m_type == LABEL, "Column " << labelColumn << " is not a LABEL column");
+          NS_ASSERT_MSG (suffixes.size () == m_columns[i].m_labels.size (), "One suffix is needed for each label");
+          m_columns.back ().m_suffixColumn = i;
+          m_columns.back ().m_suffixes = suffixes;
+          return *this;
+        }
+    }
+  NS_FATAL_ERROR ("No column " << labelColumn << " before column " << m_columns.back ().m_name);
+  return *this;
+}
+
+const std::string&
+MmWaveTraceSchema::GetTextHeader (void) const
+{
+  return m_textHeader;
+}
+
+uint32_t
+MmWaveTraceSchema::GetNColumns (void) const
+{
+  return m_columns.size ();
+}
+
+const MmWaveTraceSchema::Column&
+MmWaveTraceSchema::GetColumn (uint32_t i) const
+{
+  NS_ASSERT (i < m_columns.size ());
+  return m_columns[i];
+}
+
+uint32_t
+MmWaveTraceSchema::GetWidth (ColumnType type)
+{
+  switch (type)
+    {
+    case UINT8:
+    case LABEL:
+      return 1;
+    case UINT16:
+      return 2;
+    case UINT32:
+      return 4;
+    case UINT64:
+    case DOUBLE:
+      return 8;
+    }
+  NS_FATAL_ERROR ("Unknown column type " << type);
+  return 0;
+}
+
+void
+MmWaveTraceSchema::WriteText (std::ostream& os, const MmWaveTraceRecord& record) const
+{
+  NS_ASSERT_MSG (record.m_numValues == m_columns.size (), "The record does not match the schema");
+  for (uint32_t i = 0; i < m_columns.size (); i++)
+    {
+      const Column& column = m_columns[i];
+      const MmWaveTraceValue& value = record.m_values[i];
+      switch (column.m_type)
+        {
+        case DOUBLE:
+          os << value.GetDouble ();
+          break;
+        case LABEL:
+          NS_ASSERT (value.GetUint () < column.m_labels.size ());
+          os << column.m_labels[value.GetUint ()];
+          break;
+        default:
+          os << value.GetUint ();
+          break;
+        }
+      if (column.m_suffixes.empty ())
+        {
+          os << column.m_suffix;
+        }
+      else
+        {
+          os << column.m_suffixes[record.m_values[column.m_suffixColumn].GetUint ()];
+        }
+    }
+  os << '\n';
+}
+
+void
+MmWaveTraceSchema::Serialize (std::ostream& os) const
+{
+  WriteInt<uint32_t> (os, m_textHeader.size ());
+  os.write (m_textHeader.data (), m_textHeader.size ());
+  WriteInt<uint16_t> (os, m_columns.size ());
+  for (const Column& column : m_columns)
+    {
+      WriteInt<uint8_t> (os, column.m_type);
+      WriteString (os, column.m_name);
+      WriteString (os, column.m_suffix);
+      WriteInt<uint8_t> (os, column.m_labels.size ());
+      for (const std::string& label : column.m_labels)
+        {
+          WriteString (os, label);
+        }
+      WriteInt<uint8_t> (os, column.m_suffixes.size ());
+      if (!column.m_suffixes.empty ())
+        {
+          WriteInt<uint8_t> (os, column.m_suffixColumn);
+          for (const std::string& suffix : column.m_suffixes)
+            {
+              WriteString (os, suffix);
+            }
+        }
+    }
+}
+
+bool
+MmWaveTraceSchema::Deserialize (std::istream& is)
+{
+  uint32_t headerSize;
+  if (!ReadInt (is, headerSize))
+    {
+      return false;
+    }
+  m_textHeader.resize (headerSize);
+  is.read (&m_textHeader[0], headerSize);
+  uint16_t numColumns;
+  if (is.gcount () != headerSize || !ReadInt (is, numColumns)
+      || numColumns > MmWaveTraceRecord::MAX_COLUMNS)
+    {
+      return false;
+    }
+  m_columns.resize (numColumns);
+  for (uint32_t i = 0; i < numColumns; i++)
+    {
+      Column& column = m_columns[i];
+      uint8_t type;
+      uint8_t numLabels;
+      if (!ReadInt (is, type) || type > LABEL
+          || !ReadString (is, column.m_name)
+          || !ReadString (is, column.m_suffix)
+          || !ReadInt (is, numLabels))
+        {
+          return false;
+        }
+      column.m_type = static_cast<ColumnType> (type);
+      column.m_labels.resize (numLabels);
+      for (std::string& label : column.m_labels)
+        {
+          if (!ReadString (is, label))
+            {
+              return false;
+            }
+        }
+      uint8_t numSuffixes;
+      uint8_t suffixColumn = 0;
+      if (!ReadInt (is, numSuffixes)
+          || (numSuffixes > 0 && !ReadInt (is, suffixColumn)))
+        {
+          return false;
+        }
+      // the suffix is selected by a previous LABEL column, with one suffix per label
+      if (numSuffixes > 0
+          && (suffixColumn >= i || m_columns[suffixColumn].m_type != LABEL
+              || m_columns[suffixColumn].m_labels.size () != numSuffixes))
+        {
+          return false;
+        }
+      column.m_suffixColumn = suffixColumn;
+      column.m_suffixes.resize (numSuffixes);
+      for (std::string& suffix : column.m_suffixes)
+        {
+          if (!ReadString (is, suffix))
+            {
+              return false;
+            }
+        }
+    }
+  return true;
+}
+
+MmWaveTraceWriter::MmWaveTraceWriter (const MmWaveTraceSchema& schema)
+  : m_schema (schema),
+    m_format (TEXT),
+    m_open (false),
+    m_async (false),
+    m_numRecords (0)
+{
+}
+
+MmWaveTraceWriter::~MmWaveTraceWriter ()
+{
+  Close ();
+}
+
+bool
+MmWaveTraceWriter::IsFormatSupported (Format format)
+{
+  switch (format)
+    {
+    case TEXT:
+    case BINARY:
+      return true;
+    case BINARY_ZSTD:
+#ifdef HAVE_ZSTD
+      return true;
+#else
+      return false;
+#endif
+    case BINARY_LZ4:
+#ifdef HAVE_LZ4
+      return true;
+#else
+      return false;
+#endif
+    }
+  return false;
+}
+
+void
+MmWaveTraceWriter::Open (std::string fileName, Format format)
+{
+  NS_LOG_FUNCTION (this << fileName << format);
+  NS_ASSERT_MSG (!m_open, "The trace is already open");
+  if (!IsFormatSupported (format))
+    {
+      NS_FATAL_ERROR ("Trace format " << format << " is not supported, ns-3 was built without its compression library");
+    }
+  m_format = format;
+  m_numRecords = 0;
+  if (format == TEXT)
+    {
+      m_file.open (fileName.c_str ());
+      if (!m_file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open tracefile");
+        }
+      if (!m_schema.GetTextHeader ().empty ())
+        {
+          m_file << m_schema.GetTextHeader () << std::endl;
+        }
+    }
+  else
+    {
+      m_file.open (fileName.c_str (), std::ios::out | std::ios::binary);
+      if (!m_file.is_open ())
+        {
+          NS_FATAL_ERROR ("Could not open tracefile");
+        }
+      m_file.write (TRACE_MAGIC, sizeof (TRACE_MAGIC));
+      WriteInt<uint32_t> (m_file, TRACE_VERSION);
+      m_schema.Serialize (m_file);
+
+      m_columnOffset.clear ();
+      uint32_t offset = 0;
+      for (uint32_t i = 0; i < m_schema.GetNColumns (); i++)
+        {
+          m_columnOffset.push_back (offset);
+          offset += BLOCK_RECORDS * MmWaveTraceSchema::GetWidth (m_schema.GetColumn (i).m_type);
+        }
+      m_block.resize (offset);
+    }
+  m_open = true;
+  // the header is written before the thread can access the file
+  m_async = MmWaveTraceIoThread::IsEnabled ();
+  if (m_async)
+    {
+      MmWaveTraceIoThread::Register (this);
+    }
+}
+
+bool
+MmWaveTraceWriter::IsOpen (void) const
+{
+  return m_open;
+}
+
+void
+MmWaveTraceWriter::Write (const MmWaveTraceRecord& record)
+{
+  NS_ASSERT_MSG (m_open, "The trace is not open");
+  if (m_async)
+    {
+      MmWaveTraceIoThread::Push (this, record);
+    }
+  else
+    {
+      DoWrite (record);
+    }
+}
+
+void
+MmWaveTraceWriter::DoWrite (const MmWaveTraceRecord& record)
+{
+  if (m_format == TEXT)
+    {
+      m_schema.WriteText (m_file, record);
+      return;
+    }
+
+  NS_ASSERT_MSG (record.m_numValues == m_schema.GetNColumns (), "The record does not match the schema");
+  for (uint32_t i = 0; i < record.m_numValues; i++)
+    {
+      uint8_t *dst = &m_block[m_columnOffset[i]];
+      uint64_t value = record.m_values[i].GetUint ();
+      switch (m_schema.GetColumn (i).m_type)
+        {
+        case MmWaveTraceSchema::UINT8:
+        case MmWaveTraceSchema::LABEL:
+          dst[m_numRecords] = static_cast<uint8_t> (value);
+          break;
+        case MmWaveTraceSchema::UINT16:
+          {
+            uint16_t v = value;
+            std::memcpy (dst + m_numRecords * sizeof (v), &v, sizeof (v));
+            break;
+          }
+        case MmWaveTraceSchema::UINT32:
+          {
+            uint32_t v = value;
+            std::memcpy (dst + m_numRecords * sizeof (v), &v, sizeof (v));
+            break;
+          }
+        case MmWaveTraceSchema::UINT64:
+        case MmWaveTraceSchema::DOUBLE:
+          std::memcpy (dst + m_numRecords * sizeof (value), &value, sizeof (value));
+          break;
+        }
+    }
+  if (++m_numRecords == BLOCK_RECORDS)
+    {
+      WriteBlock ();
+    }
+}
+
+// no logging in WriteBlock, Flush and Close: the static writers of
+// MmWavePhyTrace are closed after the log components may be destroyed
+void
+MmWaveTraceWriter::WriteBlock (void)
+{
+  if (m_numRecords == 0)
+    {
+      return;
+    }
+
+  // move the columns of a partial block next to each other
+  uint32_t rawSize = 0;
+  for (uint32_t i = 0; i < m_schema.GetNColumns (); i++)
+    {
+      uint32_t size = m_numRecords * MmWaveTraceSchema::GetWidth (m_schema.GetColumn (i).m_type);
+      if (rawSize != m_columnOffset[i])
+        {
+          std::memmove (&m_block[rawSize], &m_block[m_columnOffset[i]], size);
+        }
+      rawSize += size;
+    }
+
+  uint8_t codec = CODEC_NONE;
+  const uint8_t *payload = m_block.data ();
+  uint32_t storedSize = rawSize;
+#ifdef HAVE_ZSTD
+  if (m_format == BINARY_ZSTD)
+    {
+      m_payload.resize (ZSTD_compressBound (rawSize));
+      size_t size = ZSTD_compress (m_payload.data (), m_payload.size (), m_block.data (), rawSize, ZSTD_LEVEL);
+      NS_ABORT_MSG_IF (ZSTD_isError (size), "zstd compression failed: " << ZSTD_getErrorName (size));
+      codec = CODEC_ZSTD;
+      payload = m_payload.data ();
+      storedSize = size;
+    }
+#endif
+#ifdef HAVE_LZ4
+  if (m_format == BINARY_LZ4)
+    {
+      m_payload.resize (LZ4_compressBound (rawSize));
+      int size = LZ4_compress_default (reinterpret_cast<const char*> (m_block.data ()),
+                                       reinterpret_cast<char*> (m_payload.data ()),
+                                       rawSize, m_payload.size ());
+      NS_ABORT_MSG_IF (size <= 0, "LZ4 compression failed");
+      codec = CODEC_LZ4;
+      payload = m_payload.data ();
+      storedSize = size;
+    }
+#endif
+
+  WriteInt<uint32_t> (m_file, m_numRecords);
+  WriteInt<uint8_t> (m_file, codec);
+  WriteInt<uint32_t> (m_file, rawSize);
+  WriteInt<uint32_t> (m_file, storedSize);
+  m_file.write (reinterpret_cast<const char*> (payload), storedSize);
+  m_numRecords = 0;
+}
+
+void
+MmWaveTraceWriter::Flush (void)
+{
+  if (m_open)
+    {
+      if (m_async)
+        {
+          MmWaveTraceIoThread::Drain ();
+        }
+      if (m_format != TEXT)
+        {
+          WriteBlock ();
+        }
+      m_file.flush ();
+    }
+}
+
+void
+MmWaveTraceWriter::Close (void)
+{
+  if (m_open)
+    {
+      Flush ();
+      if (m_async)
+        {
+          MmWaveTraceIoThread::Unregister (this);
+          m_async = false;
+        }
+      m_file.close ();
+      m_open = false;
+    }
+}
+
+bool
+MmWaveTraceWriter::ConvertToText (std::istream& is, std::ostream& os)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  char magic[sizeof (TRACE_MAGIC)];
+  uint32_t version;
+  is.read (magic, sizeof (magic));
+  if (is.gcount () != sizeof (magic) || std::memcmp (magic, TRACE_MAGIC, sizeof (magic)) != 0
+      || !ReadInt (is, version) || version != TRACE_VERSION)
+    {
+      NS_LOG_WARN ("Not a binary mmWave trace");
+      return false;
+    }
+  MmWaveTraceSchema schema;
+  if (!schema.Deserialize (is))
+    {
+      NS_LOG_WARN ("Invalid schema");
+      return false;
+    }
+  if (!schema.GetTextHeader ().empty ())
+    {
+      os << schema.GetTextHeader () << std::endl;
+    }
+  uint32_t recordWidth = 0;
+  for (uint32_t i = 0; i < schema.GetNColumns (); i++)
+    {
+      recordWidth += MmWaveTraceSchema::GetWidth (schema.GetColumn (i).m_type);
+    }
+
+  std::vector<uint8_t> stored;
+  std::vector<uint8_t> raw;
+  while (true)
+    {
+      uint32_t numRecords;
+      uint8_t codec;
+      uint32_t rawSize;
+      uint32_t storedSize;
+      if (!ReadInt (is, numRecords))
+        {
+          // end of the trace
+          return is.gcount () == 0;
+        }
+      if (!ReadInt (is, codec) || !ReadInt (is, rawSize) || !ReadInt (is, storedSize)
+          || rawSize != numRecords * recordWidth)
+        {
+          NS_LOG_WARN ("Invalid block header");
+          return false;
+        }
+      stored.resize (storedSize);
+      is.read (reinterpret_cast<char*> (stored.data ()), storedSize);
+      if (is.gcount () != storedSize)
+        {
+          NS_LOG_WARN ("Truncated block");
+          return false;
+        }
+
+      const uint8_t *data = stored.data ();
+      switch (codec)
+        {
+        case CODEC_NONE:
+          if (storedSize != rawSize)
+            {
+              return false;
+            }
+          break;
+#ifdef HAVE_ZSTD
+        case CODEC_ZSTD:
+          {
+            raw.resize (rawSize);
+            size_t size = ZSTD_decompress (raw.data (), rawSize, stored.data (), storedSize);
+            if (ZSTD_isError (size) || size != rawSize)
+              {
+                NS_LOG_WARN ("Invalid zstd block");
+                return false;
+              }
+            data = raw.data ();
+            break;
+          }
+#endif
+#ifdef HAVE_LZ4
+        case CODEC_LZ4:
+          {
+            raw.resize (rawSize);
+            int size = LZ4_decompress_safe (reinterpret_cast<const char*> (stored.data ()),
+                                            reinterpret_cast<char*> (raw.data ()),
+                                            storedSize, rawSize);
+            if (size < 0 || static_cast<uint32_t> (size) != rawSize)
+              {
+                NS_LOG_WARN ("Invalid LZ4 block");
+                return false;
+              }
+            data = raw.data ();
+            break;
+          }
+#endif
+        default:
+          NS_LOG_WARN ("Unsupported block codec " << +codec);
+          return false;
+        }
+
+      MmWaveTraceRecord record;
+      record.m_numValues = schema.GetNColumns ();
+      for (uint32_t r = 0; r < numRecords; r++)
+        {
+          const uint8_t *column = data;
+          for (uint32_t i = 0; i < schema.GetNColumns (); i++)
+            {
+              uint32_t width = MmWaveTraceSchema::GetWidth (schema.GetColumn (i).m_type);
+              uint64_t value = 0;
+              switch (width)
+                {
+                case 1:
+                  value = column[r];
+                  break;
+                case 2:
+                  {
+                    uint16_t v;
+                    std::memcpy (&v, column + r * width, width);
+                    value = v;
+                    break;
+                  }
+                case 4:
+                  {
+                    uint32_t v;
+                    std::memcpy (&v, column + r * width, width);
+                    value = v;
+                    break;
+                  }
+                default:
+                  std::memcpy (&value, column + r * width, width);
+                  break;
+                }
+              if (schema.GetColumn (i).m_type == MmWaveTraceSchema::LABEL
+                  && value >= schema.GetColumn (i).m_labels.size ())
+                {
+                  NS_LOG_WARN ("Invalid label");
+                  return false;
+                }
+              record.m_values[i] = value;
+              column += numRecords * width;
+            }
+          schema.WriteText (os, record);
+        }
+    }
+}
+
+Ptr<const AttributeChecker>
+MakeTraceFormatChecker (void)
+{
+  return MakeEnumChecker (MmWaveTraceWriter::TEXT, "Text",
+                          MmWaveTraceWriter::BINARY, "Binary",
+                          MmWaveTraceWriter::BINARY_ZSTD, "BinaryZstd",
+                          MmWaveTraceWriter::BINARY_LZ4, "BinaryLz4");
+}
+
+} // namespace mmwave
+
+} // namespace ns3
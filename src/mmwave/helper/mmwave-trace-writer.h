@@ -0,0 +1,305 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_
+#define SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_
+
+#include <ns3/attribute.h>
+#include <ns3/ptr.h>
+#include <stdint.h>
+#include <cstring>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief A value of a trace record, either an unsigned integer or a double
+ */
+class MmWaveTraceValue
+{
+public:
+  MmWaveTraceValue ()
+    : m_bits (0)
+  {
+  }
+
+  /**
+   * \param value an unsigned integer, a bool or a floating point value
+   */
+  template <typename T>
+  MmWaveTraceValue (T value)
+  {
+    if (std::is_floating_point<T>::value)
+      {
+        double d = static_cast<double> (value);
+        std::memcpy (&m_bits, &d, sizeof (d));
+      }
+    else
+      {
+        m_bits = static_cast<uint64_t> (value);
+      }
+  }
+
+  uint64_t GetUint (void) const
+  {
+    return m_bits;
+  }
+
+  double GetDouble (void) const
+  {
+    double d;
+    std::memcpy (&d, &m_bits, sizeof (d));
+    return d;
+  }
+
+private:
+  uint64_t m_bits;    // the integer, or the bits of the double
+};
+
+/**
+ * \ingroup mmwave
+ * \brief A fixed-size record of a trace, with one value per column of its schema
+ */
+struct MmWaveTraceRecord
+{
+  static const uint32_t MAX_COLUMNS = 16;
+
+  MmWaveTraceRecord ()
+    : m_numValues (0)
+  {
+  }
+
+  /**
+   * \brief Construct a record from its values, in the order of the columns
+   */
+  MmWaveTraceRecord (std::initializer_list<MmWaveTraceValue> values);
+
+  uint32_t m_numValues;
+  MmWaveTraceValue m_values[MAX_COLUMNS];
+};
+
+/**
+ * \ingroup mmwave
+ * \brief The columns of a trace, and how they are printed in its text format
+ *
+ * A row of the text format is made of the values of the columns, each
+ * followed by the suffix of its column, usually a tab. The label columns
+ * hold the index of a string, such as "DL" or "UL", which is printed instead
+ * of the index. The suffix of a column may also depend on the label of a
+ * previous column, to keep the legacy text formats that differ between
+ * the rows of the DL and the UL.
+ */
+class MmWaveTraceSchema
+{
+public:
+  enum ColumnType
+  {
+    UINT8 = 0,
+    UINT16 = 1,
+    UINT32 = 2,
+    UINT64 = 3,
+    DOUBLE = 4,
+    LABEL = 5,
+  };
+
+  struct Column
+  {
+    std::string m_name;
+    ColumnType m_type;
+    std::string m_suffix;
+    std::vector<std::string> m_labels;  // only for LABEL columns
+    uint32_t m_suffixColumn;            // LABEL column selecting the suffix, if m_suffixes is not empty
+    std::vector<std::string> m_suffixes; // suffix for each label of m_suffixColumn
+  };
+
+  /**
+   * \param textHeader the first line of the text format, without its end of line,
+   *        or an empty string if the text format has no header
+   */
+  explicit MmWaveTraceSchema (std::string textHeader = "");
+
+  /**
+   * \brief Append a column
+   * \param name the name of the column
+   * \param type the type of its values
+   * \param suffix the separator printed after its values in the text format
+   */
+  MmWaveTraceSchema& AddColumn (std::string name, ColumnType type, std::string suffix = "\t");
+
+  /**
+   * \brief Append a LABEL column
+   * \param name the name of the column
+   * \param labels the strings printed for the values 0, 1, ...
+   * \param suffix the separator printed after its values in the text format
+   */
+  MmWaveTraceSchema& AddLabelColumn (std::string name, std::vector<std::string> labels, std::string suffix = "\t");
+
+  /**
+   * \brief Select the suffix of the last column by the label of a previous column
+   * \param labelColumn the name of the LABEL column
+   * \param suffixes the separator printed after the values of the last column,
+   *        for each label of the LABEL column
+   */
+  MmWaveTraceSchema& SetSuffixByLabel (std::string labelColumn, std::vector<std::string> suffixes);
+
+  const std::string& GetTextHeader (void) const;
+  uint32_t GetNColumns (void) const;
+  const Column& GetColumn (uint32_t i) const;
+
+  /**
+   * \brief Get the number of bytes of a value of a column in the binary format
+   */
+  static uint32_t GetWidth (ColumnType type);
+
+  /**
+   * \brief Print a record in the text format, with its end of line
+   */
+  void WriteText (std::ostream& os, const MmWaveTraceRecord& record) const;
+
+  /**
+   * \brief Serialize the schema in the header of a binary trace
+   */
+  void Serialize (std::ostream& os) const;
+
+  /**
+   * \brief Read the schema from the header of a binary trace
+   * \return false if the stream does not hold a valid schema
+   */
+  bool Deserialize (std::istream& is);
+
+private:
+  std::string m_textHeader;
+  std::vector<Column> m_columns;
+};
+
+/**
+ * \ingroup mmwave
+ * \brief Writes the records of a trace in text or in a binary columnar format
+ *
+ * The binary format starts with a header holding the schema of the trace,
+ * followed by blocks of up to BLOCK_RECORDS records. Within a block, the
+ * values of each column are stored one after the other, in the byte order
+ * of the host, and the block can be compressed with zstd or LZ4 when ns-3
+ * was built with these libraries. The records are buffered and written a
+ * block at a time.
+ *
+ * ConvertToText turns a binary trace back into the text format, which is
+ * the same that would have been written with the TEXT format.
+ *
+ * When the MmWaveAsyncTraces global value is true, the records are
+ * formatted and written by the MmWaveTraceIoThread rather than by the
+ * caller of Write.
+ */
+class MmWaveTraceWriter
+{
+public:
+  enum Format
+  {
+    TEXT = 0,           //!< the legacy text format
+    BINARY = 1,         //!< uncompressed blocks
+    BINARY_ZSTD = 2,    //!< blocks compressed with zstd
+    BINARY_LZ4 = 3,     //!< blocks compressed with LZ4
+  };
+
+  static const uint32_t BLOCK_RECORDS = 4096;
+
+  explicit MmWaveTraceWriter (const MmWaveTraceSchema& schema);
+  ~MmWaveTraceWriter ();
+
+  MmWaveTraceWriter (const MmWaveTraceWriter&) = delete;
+  MmWaveTraceWriter& operator= (const MmWaveTraceWriter&) = delete;
+
+  /**
+   * \brief Open the file and write the header of the trace
+   * \param fileName the file name
+   * \param format the format of the file
+   */
+  void Open (std::string fileName, Format format);
+  bool IsOpen (void) const;
+
+  /**
+   * \brief Write a record, buffered until its block is full in the binary formats
+   */
+  void Write (const MmWaveTraceRecord& record);
+
+  /**
+   * \brief Write the buffered records and flush the file
+   */
+  void Flush (void);
+
+  /**
+   * \brief Flush and close the file
+   */
+  void Close (void);
+
+  /**
+   * \brief Check if a binary format can be used in this build
+   */
+  static bool IsFormatSupported (Format format);
+
+  /**
+   * \brief Convert a binary trace to the text format
+   * \param is the binary trace
+   * \param os the stream where the text is written
+   * \return false if the binary trace is not valid
+   */
+  static bool ConvertToText (std::istream& is, std::ostream& os);
+
+private:
+  friend class MmWaveTraceIoThread;
+
+  /**
+   * \brief Format a record, or add it to the current block
+   */
+  void DoWrite (const MmWaveTraceRecord& record);
+
+  /**
+   * \brief Write the records of the current block
+   */
+  void WriteBlock (void);
+
+  MmWaveTraceSchema m_schema;
+  std::ofstream m_file;
+  Format m_format;
+  bool m_open;                            // whether the file is open
+  bool m_async;                           // whether the records go through MmWaveTraceIoThread
+  std::vector<uint32_t> m_columnOffset;   // offset of each column in m_block
+  std::vector<uint8_t> m_block;           // BLOCK_RECORDS values of each column
+  std::vector<uint8_t> m_payload;         // the block to write, compacted and compressed
+  uint32_t m_numRecords;                  // records in the current block
+};
+
+/**
+ * \ingroup mmwave
+ * \brief Make the checker of the EnumValue attributes selecting the format of a trace
+ */
+Ptr<const AttributeChecker> MakeTraceFormatChecker (void);
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_HELPER_MMWAVE_TRACE_WRITER_H_ */
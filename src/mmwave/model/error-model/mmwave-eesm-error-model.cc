@@ -26,6 +26,7 @@
 #include "ns3/log.h"
 #include <cmath>
 #include <algorithm>
+#include <mutex>
 #include "ns3/enum.h"
 #include <ns3/mmwave-phy-mac-common.h>
 
@@ -80,17 +81,21 @@ MmWaveEesmErrorModel::SinrEff (const SpectrumValue& sinr, const std::vector<int>
   NS_ABORT_MSG_IF (map.size () == 0,
                    " Error: number of allocated RBs cannot be 0 - EESM method - SinrEff function");
 
+  const size_t numRbs = sinr.GetValuesN ();
+  NS_ABORT_MSG_IF (numRbs == 0, " Error: empty SINR - EESM method - SinrEff function");
+
   double SINR = 0.0;
   double SINRsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
+  const double *sinrLin = &(*sinr.ConstValuesBegin ());
 
   double beta = GetBetaTable ()->at (mcs);
 
-  for (uint32_t i = 0; i < map.size (); i++)
+  // the RBs are accumulated in the order of the map, so that the effective
+  // SINR does not depend on the platform
+  for (int rb : map)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      SINR = exp ( -sinrLin / beta );
-      SINRsum += SINR;
+      NS_ASSERT_MSG (rb >= 0 && static_cast<size_t> (rb) < numRbs, "RB " << rb << " out of range");
+      SINRsum += exp ( -sinrLin[rb] / beta );
     }
 
   SINR = -beta * log ( SINRsum / map.size () );
@@ -101,18 +106,113 @@ MmWaveEesmErrorModel::SinrEff (const SpectrumValue& sinr, const std::vector<int>
 }
 
 
-const std::vector<double> &
-MmWaveEesmErrorModel::GetSinrDbVectorFromSimulatedValues (MmWaveEesmErrorModel::GraphType graphType,
-                                                      uint8_t mcs, uint32_t cbSizeIndex) const
+/**
+ * \brief Get the code block sizes (in bits) that can be returned by the code
+ * block segmentation, i.e., the lifting sizes multiplied by 22 (BG1) or 10 (BG2)
+ * \return the sorted code block sizes
+ */
+static const std::vector<uint32_t> &
+GetCbSizeBuckets ()
 {
-  return std::get<0> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
+  // a function-local static is initialized once, even by concurrent callers
+  static const std::vector<uint32_t> buckets = [] ()
+    {
+      std::vector<uint32_t> sizes;
+      for (uint16_t z : LiftingSizeTableBG)
+        {
+          sizes.push_back (z * 22);
+          sizes.push_back (z * 10);
+        }
+      std::sort (sizes.begin (), sizes.end ());
+      sizes.erase (std::unique (sizes.begin (), sizes.end ()), sizes.end ());
+      return sizes;
+    } ();
+  return buckets;
 }
 
-const std::vector<double> &
-MmWaveEesmErrorModel::GetBLERVectorFromSimulatedValues (MmWaveEesmErrorModel::GraphType graphType,
-                                                    uint8_t mcs, uint32_t cbSizeIndex) const
+/**
+ * \brief Get the index of a code block size in GetCbSizeBuckets
+ * \param cbSizeBit the code block size in bits
+ * \return the index, or the number of buckets if the size is not a bucket
+ */
+static uint32_t
+GetCbSizeBucket (uint32_t cbSizeBit)
 {
-  return std::get<1> (GetSimulatedBlerFromSINR ()->at (graphType).at (mcs).at (cbSizeIndex));
+  const std::vector<uint32_t> &buckets = GetCbSizeBuckets ();
+  static const std::vector<uint8_t> bucketOfSize = [&buckets] ()
+    {
+      NS_ASSERT (buckets.size () < UINT8_MAX);
+      std::vector<uint8_t> bucketOf (buckets.back () + 1, static_cast<uint8_t> (buckets.size ()));
+      for (uint32_t i = 0; i < buckets.size (); i++)
+        {
+          bucketOf[buckets[i]] = static_cast<uint8_t> (i);
+        }
+      return bucketOf;
+    } ();
+  return cbSizeBit < bucketOfSize.size () ? bucketOfSize[cbSizeBit] : buckets.size ();
+}
+
+const MmWaveEesmErrorModel::BlerCurveTable &
+MmWaveEesmErrorModel::GetBlerCurveTable () const
+{
+  if (m_blerCurveTable != nullptr)
+    {
+      return *m_blerCurveTable;
+    }
+
+  // one table for each set of simulated curves, shared by all the instances
+  static std::map<const SimulatedBlerFromSINR *, BlerCurveTable> tables;
+  static std::mutex tablesMutex;
+  std::lock_guard<std::mutex> lock (tablesMutex);
+  const SimulatedBlerFromSINR *simulated = GetSimulatedBlerFromSINR ();
+  auto tableIt = tables.find (simulated);
+  if (tableIt == tables.end ())
+    {
+      NS_LOG_LOGIC ("Build the BLER-SINR curves for " << GetInstanceTypeId ().GetName ());
+      const std::vector<uint32_t> &buckets = GetCbSizeBuckets ();
+      BlerCurveTable table;
+      table.m_numMcs = simulated->at (FIRST).size ();
+      NS_ABORT_MSG_IF (simulated->at (SECOND).size () != table.m_numMcs,
+                       "The BLER-SINR tables of the two base graphs have a different number of MCSs");
+      table.m_curves.resize (2 * table.m_numMcs * buckets.size ());
+
+      for (GraphType bg_type : {FIRST, SECOND})
+        {
+          for (uint32_t mcs = 0; mcs < table.m_numMcs; mcs++)
+            {
+              const auto &cbMap = simulated->at (bg_type).at (mcs);
+              std::map<uint32_t, BlerCurveTable::Curve> cbCurves;
+              for (const auto &cb : cbMap)
+                {
+                  const DoubleVector &sinrDb = std::get<0> (cb.second);
+                  const DoubleVector &bler = std::get<1> (cb.second);
+                  NS_ABORT_MSG_IF (sinrDb.empty () || sinrDb.size () != bler.size (),
+                                   "Malformed BLER-SINR curve for MCS " << mcs << " and CB size " << cb.first);
+                  BlerCurveTable::Curve curve;
+                  curve.m_offset = table.m_sinrDb.size ();
+                  curve.m_size = sinrDb.size ();
+                  table.m_sinrDb.insert (table.m_sinrDb.end (), sinrDb.begin (), sinrDb.end ());
+                  table.m_bler.insert (table.m_bler.end (), bler.begin (), bler.end ());
+                  cbCurves[cb.first] = curve;
+                }
+
+              for (uint32_t bucket = 0; bucket < buckets.size (); bucket++)
+                {
+                  // the lowest CB size simulated including this CB, as in MappingSinrBler
+                  auto cbIt = cbMap.upper_bound (buckets[bucket]);
+                  if (cbIt != cbMap.begin ())
+                    {
+                      cbIt--;
+                    }
+                  table.m_curves[(bg_type * table.m_numMcs + mcs) * buckets.size () + bucket] = cbCurves[cbIt->first];
+                }
+            }
+        }
+      tableIt = tables.insert (std::make_pair (simulated, table)).first;
+    }
+
+  m_blerCurveTable = &tableIt->second;
+  return *m_blerCurveTable;
 }
 
 double
@@ -128,40 +228,56 @@ MmWaveEesmErrorModel::MappingSinrBler (double sinr, uint8_t mcs, uint32_t cbSize
   double sinr_db = 10 * log10 (sinr);
   GraphType bg_type = GetBaseGraphType (cbSizeBit, mcs);
 
-  // Get the index of CBSIZE in the map
+  // Get the curve of the CBSIZE
   NS_LOG_INFO ("For sinr " << sinr << " and mcs " << +mcs <<
                 " CbSizebit " << cbSizeBit << " we got bg type " << m_bgTypeName[bg_type]);
-  auto cbMap = GetSimulatedBlerFromSINR ()->at (bg_type).at (mcs);
-  auto cbIt = cbMap.upper_bound (cbSizeBit);
-
-  if (cbIt != cbMap.begin ())
+  const BlerCurveTable &table = GetBlerCurveTable ();
+  const uint32_t numBuckets = GetCbSizeBuckets ().size ();
+  uint32_t bucket = GetCbSizeBucket (cbSizeBit);
+  const double *sinrDb;
+  const double *blerValues;
+  uint32_t curveSize;
+  if (bucket < numBuckets && mcs < table.m_numMcs)
+    {
+      const BlerCurveTable::Curve &curve = table.m_curves[(bg_type * table.m_numMcs + mcs) * numBuckets + bucket];
+      sinrDb = &table.m_sinrDb[curve.m_offset];
+      blerValues = &table.m_bler[curve.m_offset];
+      curveSize = curve.m_size;
+    }
+  else
     {
-      cbIt--;
+      // the CB size is not one of those returned by CodeBlockSegmentation
+      const auto &cbMap = GetSimulatedBlerFromSINR ()->at (bg_type).at (mcs);
+      auto cbIt = cbMap.upper_bound (cbSizeBit);
+
+      if (cbIt != cbMap.begin ())
+        {
+          cbIt--;
+        }
+      sinrDb = std::get<0> (cbIt->second).data ();
+      blerValues = std::get<1> (cbIt->second).data ();
+      curveSize = std::get<0> (cbIt->second).size ();
     }
 
-  if (sinr_db < GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).front ())
+  if (sinr_db < sinrDb[0])
     {
       bler = 1.0;
     }
-  else if (sinr_db > GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).back ())
+  else if (sinr_db > sinrDb[curveSize - 1])
     {
       bler = 0.0;
     }
   else
     {
       // Get the index of SINR in the vector
-      auto sinrIt = std::upper_bound (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                      GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).end (),
-                                      sinr_db);
+      const double *sinrIt = std::upper_bound (sinrDb, sinrDb + curveSize, sinr_db);
 
-      if (sinrIt != GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin ())
+      if (sinrIt != sinrDb)
         {
           sinrIt--;
         }
 
-      auto sinr_index = std::distance (GetSinrDbVectorFromSimulatedValues (bg_type, mcs, cbIt->first).begin (),
-                                       sinrIt);
-      bler = GetBLERVectorFromSimulatedValues (bg_type, mcs, cbIt->first).at (sinr_index);
+      bler = blerValues[sinrIt - sinrDb];
     }
 
   NS_LOG_LOGIC ("SINR effective: " << sinr << " BLER:" << bler);
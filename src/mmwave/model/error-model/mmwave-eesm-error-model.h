@@ -242,6 +242,38 @@ protected:
 private:
   static std::vector<std::string> m_bgTypeName; //!< Base graph name
 
+  /**
+   * \brief BLER-SINR curves of a SimulatedBlerFromSINR table, stored in
+   * contiguous arrays and indexed by base graph type, MCS and by the code
+   * block sizes that CodeBlockSegmentation can return
+   */
+  struct BlerCurveTable
+  {
+    /**
+     * \brief Position of a BLER-SINR curve in the arrays
+     */
+    struct Curve
+    {
+      uint32_t m_offset {0}; //!< index of the first point of the curve
+      uint32_t m_size {0};   //!< number of points of the curve
+    };
+
+    uint32_t m_numMcs {0};          //!< number of MCSs in the table
+    std::vector<Curve> m_curves;    //!< curves, indexed by (BG type, MCS, CB size bucket)
+    std::vector<double> m_sinrDb;   //!< SINR (dB) of the points of all the curves
+    std::vector<double> m_bler;     //!< BLER of the points of all the curves
+  };
+
+  /**
+   * \brief Get the BLER-SINR curves of the table returned by GetSimulatedBlerFromSINR.
+   * The curves are built the first time the table is used, and then shared
+   * among all the error model instances
+   * \return the BLER-SINR curves
+   */
+  const BlerCurveTable & GetBlerCurveTable () const;
+
+  mutable const BlerCurveTable *m_blerCurveTable {nullptr}; //!< BLER-SINR curves of this error model
+
   /**
    * \brief map the effective SINR into CBLER for the specified MCS and CB size,
    * according to the EESM method
@@ -301,23 +333,6 @@ private:
    */
   std::pair<uint32_t, uint32_t>
   CodeBlockSegmentation (uint32_t B, GraphType bg_type) const;
-
-  /**
-   * \brief Get SinrDb Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
-   */
-  const std::vector<double> & GetSinrDbVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
-  /**
-   * \brief Get BLER Vector From Simulated Values
-   * \param graphType
-   * \param mcs
-   * \param cbSizeIndex
-   * \return
-   */
-  const std::vector<double> & GetBLERVectorFromSimulatedValues (GraphType graphType, uint8_t mcs, uint32_t cbSizeIndex) const;
 };
 
 
@@ -24,6 +24,11 @@
 #include <ns3/log.h>
 #include "mmwave-lte-mi-error-model.h"
 
+#if defined (__GNUC__) && (defined (__x86_64__) || defined (__i386__))
+#define MMWAVE_MI_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ns3 {
 
 namespace mmwave {
@@ -337,93 +342,175 @@ MmWaveLteMiErrorModel::GetInstanceTypeId() const
   return MmWaveLteMiErrorModel::GetTypeId ();
 }
 
-double
-MmWaveLteMiErrorModel::Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
-{
-  NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
+namespace {
 
-  double MI;
-  double MIsum = 0.0;
-  SpectrumValue sinrCopy = sinr;
+/**
+ * The MI map of a modulation
+ */
+struct MiMap
+{
+  const double *m_values; //!< the MI of each point of the axis
+  double m_axisMin;       //!< the first SINR of the axis
+  double m_axisMax;       //!< the last SINR of the axis
+  double m_scalingCoeff;  //!< the number of points of the axis per unit of SINR
+  uint16_t m_size;        //!< the number of points of the axis
+};
 
-  for (uint32_t i = 0; i < map.size (); i++)
+/**
+ * \brief Map the SINR of each RB to its MI, one RB at a time
+ * \param sinrs the SINRs of the RBs
+ * \param n the number of RBs
+ * \param miMap the MI map of the modulation
+ * \param [out] mi the MI of each RB
+ */
+void
+MapMiScalar (const double *sinrs, size_t n, const MiMap &miMap, double *mi)
+{
+  for (size_t i = 0; i < n; i++)
     {
-      double sinrLin = sinrCopy[map.at (i)];
-      if (mcs <= MI_QPSK_MAX_ID) // QPSK
+      if (sinrs[i] > miMap.m_axisMax)
         {
-
-          if (sinrLin > MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1])
-            {
-              MI = 1;
-            }
-          else
-            {
-              // since the values in MI_map_qpsk_axis are uniformly spaced, we have
-              // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-              // the scaling coefficient is always the same, so we use a static const
-              // to speed up the calculation
-              static const double scalingCoeffQpsk =
-                (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]);
-              double sinrIndexDouble = (sinrLin -  MI_map_qpsk_axis[0]) * scalingCoeffQpsk + 1;
-              uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-              NS_ASSERT_MSG (sinrIndex < MI_MAP_QPSK_SIZE, "MI map out of data");
-              MI = MI_map_qpsk[sinrIndex];
-            }
+          mi[i] = 1;
         }
       else
         {
-          if (mcs > MI_QPSK_MAX_ID && mcs <= MI_16QAM_MAX_ID )  // 16-QAM
-            {
-              if (sinrLin > MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_16QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff16qam =
-                    (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_16qam_axis[0]) * scalingCoeff16qam + 1;
-                  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_16QAM_SIZE, "MI map out of data");
-                  MI = MI_map_16qam[sinrIndex];
-                }
-            }
-          else // 64-QAM
-            {
-              if (sinrLin > MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1])
-                {
-                  MI = 1;
-                }
-              else
-                {
-                  // since the values in MI_map_64QAM_axis are uniformly spaced, we have
-                  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
-                  // the scaling coefficient is always the same, so we use a static const
-                  // to speed up the calculation
-                  static const double scalingCoeff64qam =
-                    (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]);
-                  double sinrIndexDouble = (sinrLin -  MI_map_64qam_axis[0]) * scalingCoeff64qam + 1;
-                  uint32_t sinrIndex = std::max (0.0, std::floor (sinrIndexDouble));
-                  NS_ASSERT_MSG (sinrIndex < MI_MAP_64QAM_SIZE, "MI map out of data");
-                  MI = MI_map_64qam[sinrIndex];
-                }
-            }
+          double sinrIndexDouble = (sinrs[i] - miMap.m_axisMin) * miMap.m_scalingCoeff + 1;
+          // a SINR equal to the last point of the axis gives an index past
+          // the end of the map
+          uint32_t sinrIndex = std::min (std::max (0.0, std::floor (sinrIndexDouble)), miMap.m_size - 1.0);
+          mi[i] = miMap.m_values[sinrIndex];
         }
-      NS_LOG_LOGIC (" RB " << map.at (i) << "Minimum SNR = " << 10 * std::log10 (sinrLin) << " dB, " << sinrLin << " V, MCS = " << (uint16_t)mcs << ", MI = " << MI);
-      MIsum += MI;
     }
+}
+
+#ifdef MMWAVE_MI_AVX2
+/**
+ * \brief Map the SINR of each RB to its MI, four RBs at a time
+ *
+ * The operations on each lane are those of MapMiScalar, without FMA, so
+ * that the results are the same on all the machines.
+ *
+ * \param sinrs the SINRs of the RBs
+ * \param n the number of RBs
+ * \param miMap the MI map of the modulation
+ * \param [out] mi the MI of each RB
+ */
+__attribute__ ((target ("avx2")))
+void
+MapMiAvx2 (const double *sinrs, size_t n, const MiMap &miMap, double *mi)
+{
+  const __m256d axisMin = _mm256_set1_pd (miMap.m_axisMin);
+  const __m256d axisMax = _mm256_set1_pd (miMap.m_axisMax);
+  const __m256d scalingCoeff = _mm256_set1_pd (miMap.m_scalingCoeff);
+  const __m256d zero = _mm256_setzero_pd ();
+  const __m256d one = _mm256_set1_pd (1);
+  const __m256d lastIndex = _mm256_set1_pd (miMap.m_size - 1.0);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4)
+    {
+      __m256d sinr = _mm256_loadu_pd (sinrs + i);
+      __m256d sinrIndexDouble = _mm256_add_pd (_mm256_mul_pd (_mm256_sub_pd (sinr, axisMin), scalingCoeff), one);
+      // the NaN lanes get index 0, as with std::max (0.0, NaN)
+      sinrIndexDouble = _mm256_max_pd (_mm256_floor_pd (sinrIndexDouble), zero);
+      sinrIndexDouble = _mm256_min_pd (sinrIndexDouble, lastIndex);
+      // the lanes above the axis are not looked up, and keep an MI of 1
+      __m256d inMap = _mm256_cmp_pd (sinr, axisMax, _CMP_NGT_UQ);
+      __m128i sinrIndex = _mm256_cvttpd_epi32 (sinrIndexDouble);
+      _mm256_storeu_pd (mi + i, _mm256_mask_i32gather_pd (one, miMap.m_values, sinrIndex, inMap, 8));
+    }
+  MapMiScalar (sinrs + i, n - i, miMap, mi + i);
+}
+#endif /* MMWAVE_MI_AVX2 */
+
+/**
+ * A function that maps the SINR of each RB to its MI
+ */
+typedef void (*MapMiFunction) (const double *sinrs, size_t n, const MiMap &miMap, double *mi);
+
+/**
+ * \brief Select the fastest MapMiFunction supported by the CPU
+ * \return the function
+ */
+MapMiFunction
+SelectMapMi (void)
+{
+#ifdef MMWAVE_MI_AVX2
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    {
+      return &MapMiAvx2;
+    }
+#endif /* MMWAVE_MI_AVX2 */
+  return &MapMiScalar;
+}
+
+} // unnamed namespace
+
+double
+MmWaveLteMiMib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs)
+{
+  NS_LOG_FUNCTION (sinr << &map << (uint32_t) mcs);
+
+  // select the MI map of the modulation once for all the RBs.
+  // since the values in the axis of each map are uniformly spaced, we have
+  // index = ((sinrLin - value[0]) / (value[SIZE-1] - value[0])) * (SIZE-1)
+  // the scaling coefficient is always the same, so we use a static const
+  // to speed up the calculation
+  static const MiMap miMapQpsk = {MI_map_qpsk, MI_map_qpsk_axis[0], MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1],
+                                  (MI_MAP_QPSK_SIZE - 1) / (MI_map_qpsk_axis[MI_MAP_QPSK_SIZE - 1] - MI_map_qpsk_axis[0]),
+                                  MI_MAP_QPSK_SIZE};
+  static const MiMap miMap16qam = {MI_map_16qam, MI_map_16qam_axis[0], MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1],
+                                   (MI_MAP_16QAM_SIZE - 1) / (MI_map_16qam_axis[MI_MAP_16QAM_SIZE - 1] - MI_map_16qam_axis[0]),
+                                   MI_MAP_16QAM_SIZE};
+  static const MiMap miMap64qam = {MI_map_64qam, MI_map_64qam_axis[0], MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1],
+                                   (MI_MAP_64QAM_SIZE - 1) / (MI_map_64qam_axis[MI_MAP_64QAM_SIZE - 1] - MI_map_64qam_axis[0]),
+                                   MI_MAP_64QAM_SIZE};
+  static const MapMiFunction mapMi = SelectMapMi ();
+
+  const MiMap *miMap;
+  if (mcs <= MI_QPSK_MAX_ID) // QPSK
+    {
+      miMap = &miMapQpsk;
+    }
+  else if (mcs <= MI_16QAM_MAX_ID) // 16-QAM
+    {
+      miMap = &miMap16qam;
+    }
+  else // 64-QAM
+    {
+      miMap = &miMap64qam;
+    }
+
   if (map.size () == 0)
     {
-      MI = 0;
+      NS_LOG_LOGIC (" MI = 0");
+      return 0;
     }
-  else
+
+  // gather the SINRs of the allocated RBs, and map all of them at once
+  const size_t numRbs = sinr.GetValuesN ();
+  NS_ABORT_MSG_IF (numRbs == 0, "Empty SINR");
+  const double *sinrValues = &(*sinr.ConstValuesBegin ());
+  thread_local std::vector<double> rbSinrs;
+  thread_local std::vector<double> rbMis;
+  rbSinrs.resize (map.size ());
+  rbMis.resize (map.size ());
+  for (size_t i = 0; i < map.size (); i++)
+    {
+      NS_ASSERT_MSG (map[i] >= 0 && static_cast<size_t> (map[i]) < numRbs, "RB " << map[i] << " out of range");
+      rbSinrs[i] = sinrValues[map[i]];
+    }
+  mapMi (rbSinrs.data (), map.size (), *miMap, rbMis.data ());
+
+  // the RBs are accumulated in the order of the map, so that the MI does not
+  // depend on the platform
+  double MIsum = 0.0;
+  for (size_t i = 0; i < map.size (); i++)
     {
-      MI = MIsum / map.size ();
+      NS_LOG_LOGIC (" RB " << map[i] << "Minimum SNR = " << 10 * std::log10 (rbSinrs[i]) << " dB, " << rbSinrs[i] << " V, MCS = " << (uint16_t)mcs << ", MI = " << rbMis[i]);
+      MIsum += rbMis[i];
     }
+  double MI = MIsum / map.size ();
 
   NS_LOG_LOGIC (" MI = " << MI);
   return MI;
@@ -495,7 +582,7 @@ MmWaveLteMiErrorModel::GetTbBitDecodificationStats (const SpectrumValue& sinr,
 
   NS_LOG_DEBUG (" mcs " << static_cast<uint32_t>(mcs) << " TBSize in bit " << size);
 
-  double tbMi = Mib (sinr, map, mcs);
+  double tbMi = MmWaveLteMiMib (sinr, map, mcs);
   double MI = tbMi;
   double Reff = 0.0;
 
@@ -158,17 +158,6 @@ private:
                                                                uint32_t size, uint8_t mcs,
                                                                const MmWaveErrorModelHistory &history);
 
-  /**
-   * \brief compute the mmib (mean mutual information per bit) for the
-   * specified MCS and SINR, according to the MIESM method
-   *
-   * \param sinr the perceived SIMmWaves in the whole bandwidth
-   * \param map the actives RBs for the TB
-   * \param mcs the MCS of the TB
-   * \return the mmib
-   */
-  static double Mib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
-
   /**
    * \brief map the mmib (mean mutual information per bit) into CBLER for
    * the specified MCS and CB size, according to the MIESM method
@@ -181,6 +170,19 @@ private:
   static double MappingMiBler (double mib, uint8_t ecrId, uint32_t cbSize);
 };
 
+/**
+ * \ingroup error-models
+ * \brief compute the mmib (mean mutual information per bit) for the
+ * specified MCS and SINR, according to the MIESM method, as done by
+ * MmWaveLteMiErrorModel
+ *
+ * \param sinr the perceived SIMmWaves in the whole bandwidth
+ * \param map the actives RBs for the TB
+ * \param mcs the MCS of the TB
+ * \return the mmib
+ */
+double MmWaveLteMiMib (const SpectrumValue& sinr, const std::vector<int>& map, uint8_t mcs);
+
 
 } // namespace ns3
 } // namespace mmwave 
@@ -258,7 +258,7 @@ MmWaveSvdBeamforming::SetBeamformingVectorForDevice (Ptr<NetDevice> otherDevice,
 
   if (!m_useCache || toCache)
     {
-      if (channelMatrix->m_channel[0][0].size () == 0)
+      if (channelMatrix->m_channel.GetNumPages () == 0)
         {
           NS_LOG_LOGIC ("Channel has no MPCs");
 
@@ -318,9 +318,9 @@ std::pair<PhasedArrayModel::ComplexVector, PhasedArrayModel::ComplexVector>
 MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelModel::ChannelMatrix> params) const
 {
   //generate transmitter side spatial correlation matrix
-  uint16_t aSize = params->m_channel.size ();
-  uint16_t bSize = params->m_channel[0].size ();
-  uint16_t clusterSize = params->m_channel[0][0].size ();
+  uint16_t aSize = params->m_channel.GetNumRows ();
+  uint16_t bSize = params->m_channel.GetNumCols ();
+  uint16_t clusterSize = params->m_channel.GetNumPages ();
 
   // compute narrowband channel by summing over the cluster index
   MatrixBasedChannelModel::Complex2DVector narrowbandChannel;
@@ -338,7 +338,7 @@ MmWaveSvdBeamforming::ComputeBeamformingVectors (Ptr<const MatrixBasedChannelMod
           std::complex<double> cSum (0, 0);
           for (uint16_t cIndex = 0; cIndex < clusterSize; cIndex++)
             {
-              cSum += params->m_channel[aIndex][bIndex][cIndex];
+              cSum += params->m_channel (aIndex, bIndex, cIndex);
             }
           narrowbandChannel[aIndex][bIndex] = cSum;
         }
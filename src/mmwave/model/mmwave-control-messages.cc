@@ -273,5 +273,11 @@ MmWaveDlHarqFeedbackMessage::GetDlHarqFeedback (void)
   return m_dlHarqInfo;
 }
 
+void
+MmWaveControlMessageList::Clear (void)
+{
+  m_messages.clear ();
+}
+
 }
 }
@@ -316,6 +316,25 @@ private:
 
 };
 
+/**
+ * \ingroup mmwave
+ * \brief The control messages of a transmission
+ *
+ * The list is shared, by reference count, by the signal parameters of all
+ * the receivers of the transmission, and it is not modified once
+ * transmitted. The PHYs draw the lists from a MmWaveTxPool.
+ */
+class MmWaveControlMessageList : public SimpleRefCount<MmWaveControlMessageList>
+{
+public:
+  /**
+  * \brief Remove all the messages, before the list is reused
+  */
+  void Clear (void);
+
+  std::list<Ptr<MmWaveControlMessage> > m_messages;
+};
+
 } // namespace mmwave
 
 } // namespace ns3
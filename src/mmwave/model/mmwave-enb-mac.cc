@@ -409,6 +409,8 @@ MmWaveEnbMac::DoDispose (void)
   //  m_dlHarqInfoListReceived.clear ();
   //  m_ulHarqInfoListReceived.clear ();
   m_miDlHarqProcessesPackets.clear ();
+  m_slotBarrier = 0;
+  m_slotBarrierScheduler = 0;
   delete m_macSapProvider;
   delete m_cmacSapProvider;
   delete m_macSchedSapUser;
@@ -571,7 +573,14 @@ MmWaveEnbMac::DoSlotIndication (SfnSf sfnSf)
         }
 
       params.m_ueList = m_associatedUe;
-      m_macSchedSapProvider->SchedTriggerReq (params);
+      if (m_slotBarrier)
+        {
+          m_slotBarrier->SchedTriggerReq (m_cellId, m_slotBarrierScheduler, params);
+        }
+      else
+        {
+          m_macSchedSapProvider->SchedTriggerReq (params);
+        }
     }
 }
 
@@ -581,6 +590,15 @@ MmWaveEnbMac::SetCellId (uint16_t cellId)
   m_cellId = cellId;
 }
 
+void
+MmWaveEnbMac::SetSlotBarrier (Ptr<MmWaveSlotBarrier> barrier, Ptr<MmWaveMacScheduler> scheduler)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_phyMacConfig->GetL1L2Latency () == 0, "The slot barrier requires a L1-L2 latency of at least one slot");
+  m_slotBarrier = barrier;
+  m_slotBarrierScheduler = scheduler;
+}
+
 void
 MmWaveEnbMac::SetMcs (int mcs)
 {
@@ -41,6 +41,8 @@
 #include <ns3/lte-enb-cmac-sap.h>
 #include <ns3/lte-mac-sap.h>
 #include "mmwave-phy-mac-common.h"
+#include "mmwave-mac-scheduler.h"
+#include "mmwave-slot-barrier.h"
 #include <ns3/lte-ccm-mac-sap.h>
 
 namespace ns3 {
@@ -120,6 +122,13 @@ public:
 
   void SetCellId (uint16_t cellId);
 
+  /**
+   * \brief Schedule the slots through a barrier shared with other cells
+   * \param barrier the barrier
+   * \param scheduler the scheduler attached to the SCHED SAP of this MAC
+   */
+  void SetSlotBarrier (Ptr<MmWaveSlotBarrier> barrier, Ptr<MmWaveMacScheduler> scheduler);
+
   // forwarded from LteMacSapProvider
   void DoTransmitPdu (LteMacSapProvider::TransmitPduParameters);
   void DoReportBufferStatus (LteMacSapProvider::ReportBufferStatusParameters);
@@ -246,6 +255,9 @@ private:
   MmWaveMacCschedSapProvider* m_macCschedSapProvider;
   MmWaveMacCschedSapUser* m_macCschedSapUser;
 
+  Ptr<MmWaveSlotBarrier> m_slotBarrier;          // if set, the slot triggers go through the barrier
+  Ptr<MmWaveMacScheduler> m_slotBarrierScheduler;
+
   std::map<uint8_t, uint32_t> m_receivedRachPreambleCount;
 
   std::map <uint16_t, std::map<uint8_t, LteMacSapUser*> > m_rlcAttached;
@@ -50,6 +50,9 @@
 #include "mc-ue-net-device.h"
 
 #include <ns3/phased-array-model.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/three-gpp-channel-model.h>
+#include <ns3/uinteger.h>
 #include <ns3/node-list.h> 
 #include <ns3/node.h>
 #include <ns3/pointer.h>
@@ -111,6 +114,12 @@ MmWaveEnbPhy::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&MmWaveEnbPhy::m_noiseAndFilter),
                    MakeBooleanChecker ())
+    .AddAttribute ("SinrEstimateCache",
+                   "If true, the periodic SINR estimate reuses the rx PSD of the links for which "
+                   "positions, pathloss, channel realization and beamforming vectors did not change",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWaveEnbPhy::m_sinrEstimateCache),
+                   MakeBooleanChecker ())
     .AddAttribute ("UpdateSinrEstimatePeriod",
                    "Period (in microseconds) of update of SINR estimate of all the UE",
                    IntegerValue (1600),     //TODO considering refactoring in MmWavePhyMacCommon
@@ -158,6 +167,10 @@ MmWaveEnbPhy::GetTypeId (void)
                      "Report the allocation info for the current DL transmission",
                      MakeTraceSourceAccessor (&MmWaveEnbPhy::m_dlPhyTrace),
                      "ns3::DlPhyTransmission::TracedCallback")
+    .AddTraceSource ("SinrEstimateCacheStats",
+                     "Cell ID, number of recomputed links and number of reused links at each periodic SINR estimate",
+                     MakeTraceSourceAccessor (&MmWaveEnbPhy::m_sinrEstimateCacheTrace),
+                     "ns3::SinrEstimateCacheStats::TracedCallback")
 
   ;
   return tid;
@@ -196,6 +209,7 @@ MmWaveEnbPhy::DoInitialize (void)
   if (m_noiseAndFilter)
     {
       NS_ASSERT_MSG ((double)m_transient / m_updateSinrPeriod >= 16, "Window too small to compute the variance according to the ApplyFilter method");
+      m_sinrFilterTable.SetCapacity (static_cast<uint32_t> (m_transient / m_updateSinrPeriod) + 1);      // samples collected until the end of the transient
     }
   Simulator::Schedule (MicroSeconds (0), &MmWaveEnbPhy::UpdateUeSinrEstimate, this);
   MmWavePhy::DoInitialize ();
@@ -549,6 +563,7 @@ void
 MmWaveEnbPhy::SetSubChannels (std::vector<int> mask )
 {
   m_listOfSubchannels = mask;
+  m_sinrEstimateLinkStates.clear ();      // the tx PSD of the links changes
   Ptr<SpectrumValue> txPsd = CreateTxPowerSpectralDensity ();
   NS_ASSERT (txPsd);
   m_downlinkSpectrumPhy->SetTxPowerSpectralDensity (txPsd);
@@ -566,6 +581,65 @@ MmWaveEnbPhy::GetUlSpectrumPhy () const
   return m_uplinkSpectrumPhy;
 }
 
+void
+MmWaveEnbPhy::GenerateUeChannels ()
+{
+  NS_LOG_FUNCTION (this);
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+    DynamicCast<ThreeGppSpectrumPropagationLossModel> (m_phasedArraySpectrumPropagationLossModel);
+  if (!threeGppSplm)
+    {
+      return;
+    }
+  Ptr<ThreeGppChannelModel> channelModel = DynamicCast<ThreeGppChannelModel> (threeGppSplm->GetChannelModel ());
+  if (!channelModel)
+    {
+      return;
+    }
+  UintegerValue numThreads;
+  channelModel->GetAttribute ("NumThreads", numThreads);
+  if (numThreads.Get () <= 1)
+    {
+      return;
+    }
+
+  // the same links as in UpdateUeSinrEstimate, which the transmissions of the slot use as well
+  Ptr<MobilityModel> enbMob = m_netDevice->GetNode ()->GetObject<MobilityModel> ();
+  Ptr<PhasedArrayModel> rxPam = DynamicCast<PhasedArrayModel> (GetDlSpectrumPhy ()->GetAntenna ());
+  std::vector<ThreeGppChannelModel::ChannelLink> links;
+  for (std::map<uint64_t, Ptr<NetDevice> >::iterator ue = m_ueAttachedImsiMap.begin (); ue != m_ueAttachedImsiMap.end (); ++ue)
+    {
+      Ptr<MmWaveUePhy> uePhy;
+      Ptr<mmwave::MmWaveUeNetDevice> ueNetDevice = DynamicCast<mmwave::MmWaveUeNetDevice> (ue->second);
+      Ptr<McUeNetDevice> mcUeDev = DynamicCast<McUeNetDevice> (ue->second);
+      if (ueNetDevice)
+        {
+          uePhy = ueNetDevice->GetPhy ();
+        }
+      else if (mcUeDev)
+        {
+          uePhy = mcUeDev->GetMmWavePhy ();
+        }
+      Ptr<PhasedArrayModel> txPam;
+      if (uePhy)
+        {
+          txPam = DynamicCast<PhasedArrayModel> (uePhy->GetDlSpectrumPhy ()->GetAntenna ());
+        }
+      if (!txPam || !rxPam)
+        {
+          continue;
+        }
+      ThreeGppChannelModel::ChannelLink link;
+      link.m_aMob = ue->second->GetNode ()->GetObject<MobilityModel> ();
+      link.m_bMob = enbMob;
+      link.m_aAntenna = txPam;
+      link.m_bAntenna = rxPam;
+      links.push_back (link);
+    }
+  channelModel->GenerateChannels (links, m_phyMacConfig->GetSlotPeriod ());
+}
+
 void
 MmWaveEnbPhy::UpdateUeSinrEstimate ()
 {
@@ -577,6 +651,8 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
 
   Ptr<SpectrumValue> noisePsd = MmWaveSpectrumValueHelper::CreateNoisePowerSpectralDensity (m_phyMacConfig, m_noiseFigure);
   Ptr<SpectrumValue> totalReceivedPsd = Create <SpectrumValue> (SpectrumValue (noisePsd->GetSpectrumModel ()));
+  uint32_t recomputedLinks = 0;
+  uint32_t reusedLinks = 0;
 
   for (std::map<uint64_t, Ptr<NetDevice> >::iterator ue = m_ueAttachedImsiMap.begin (); ue != m_ueAttachedImsiMap.end (); ++ue)
     {
@@ -602,16 +678,6 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
           NS_FATAL_ERROR ("Unrecognized device");
         }
       NS_LOG_LOGIC ("UE Tx power = " << ueTxPower);
-      double powerTxW = std::pow (10., (ueTxPower - 30) / 10);
-      double txPowerDensity = 0;
-      txPowerDensity = (powerTxW / (m_phyMacConfig->GetBandwidth ()));
-      NS_LOG_LOGIC ("Linear UE Tx power = " << powerTxW);
-      NS_LOG_LOGIC ("System bandwidth = " << m_phyMacConfig->GetBandwidth ());
-      NS_LOG_LOGIC ("txPowerDensity = " << txPowerDensity);
-      // create tx psd
-      Ptr<SpectrumValue> txPsd =                                                        // it is the eNB that dictates the conf, m_listOfSubchannels contains all the subch
-        MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (m_phyMacConfig, ueTxPower, m_listOfSubchannels);
-      NS_LOG_LOGIC ("TxPsd " << *txPsd);
 
       // get this node and remote node mobility
       Ptr<MobilityModel> enbMob = m_netDevice->GetNode ()->GetObject<MobilityModel> ();
@@ -619,8 +685,6 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
       Ptr<MobilityModel> ueMob = ue->second->GetNode ()->GetObject<MobilityModel> ();
       NS_LOG_DEBUG ("UE mobility " << ueMob->GetPosition ());
 
-      // compute rx psd
-
       // adjuts beamforming of antenna model wrt user
       m_downlinkSpectrumPhy->ConfigureBeamforming (ue->second);
       uePhy->GetDlSpectrumPhy ()->ConfigureBeamforming (m_netDevice);
@@ -635,25 +699,87 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
       
       NS_LOG_DEBUG ("Total pathLoss = " << pathLossDb << " dB");
 
-      double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-      Ptr<SpectrumValue> rxPsd = txPsd->Copy ();
-      *(rxPsd) *= pathGainLinear;
-
       // Not actually used for the gain, but needed for the call to CalcRxPowerSpectralDensity anyway
       Ptr<PhasedArrayModel> rxPam = DynamicCast<PhasedArrayModel>(GetDlSpectrumPhy ()->GetAntenna ());
       Ptr<PhasedArrayModel> txPam = DynamicCast<PhasedArrayModel>(uePhy->GetDlSpectrumPhy ()->GetAntenna ());
 
-      Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters> ();
-      rxParams->psd = rxPsd->Copy ();
+      // collect what the rx PSD depends on, and check if the one of the last round can be reused
+      SinrEstimateLinkState linkState;
+      linkState.m_enbPosition = enbMob->GetPosition ();
+      linkState.m_uePosition = ueMob->GetPosition ();
+      linkState.m_ueTxPower = ueTxPower;
+      linkState.m_pathLossDb = pathLossDb;
+      bool cacheable = m_sinrEstimateCache && !m_spectrumPropagationLossModel;
+      if (cacheable && m_phasedArraySpectrumPropagationLossModel)
+        {
+          // the fast fading is time-invariant only for a static link, and only the 3GPP model
+          // exposes the channel realization it is based on
+          Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+            DynamicCast<ThreeGppSpectrumPropagationLossModel> (m_phasedArraySpectrumPropagationLossModel);
+          cacheable = threeGppSplm && txPam && rxPam
+            && ueMob->GetVelocity () == Vector () && enbMob->GetVelocity () == Vector ();
+          if (cacheable)
+            {
+              // the same calls are made by CalcRxPowerSpectralDensity, thus the channel is not
+              // updated in a different way if the rx PSD is recomputed
+              Ptr<MatrixBasedChannelModel> channelModel = threeGppSplm->GetChannelModel ();
+              linkState.m_channel = channelModel->GetChannel (ueMob, enbMob, txPam, rxPam);
+              linkState.m_channelParams = channelModel->GetParams (ueMob, enbMob);
+              linkState.m_enbBfVector = rxPam->GetBeamformingVector ();
+              linkState.m_ueBfVector = txPam->GetBeamformingVector ();
+            }
+        }
 
-      if (m_spectrumPropagationLossModel)
-      {
-        rxPsd = m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxParams, ueMob, enbMob);
-      }
-      else if (m_phasedArraySpectrumPropagationLossModel)
-      {
-        rxPsd = m_phasedArraySpectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxParams, ueMob, enbMob, txPam, rxPam);
-      }
+      Ptr<SpectrumValue> rxPsd;
+      std::map<uint64_t, SinrEstimateLinkState>::iterator cachedState = m_sinrEstimateLinkStates.find (ue->first);
+      if (cacheable && cachedState != m_sinrEstimateLinkStates.end ()
+          && IsSinrEstimateLinkStateValid (cachedState->second, linkState))
+        {
+          NS_LOG_LOGIC ("Reuse the rx PSD of UE " << ue->first);
+          rxPsd = cachedState->second.m_rxPsd;
+          reusedLinks++;
+        }
+      else
+        {
+          double powerTxW = std::pow (10., (ueTxPower - 30) / 10);
+          double txPowerDensity = 0;
+          txPowerDensity = (powerTxW / (m_phyMacConfig->GetBandwidth ()));
+          NS_LOG_LOGIC ("Linear UE Tx power = " << powerTxW);
+          NS_LOG_LOGIC ("System bandwidth = " << m_phyMacConfig->GetBandwidth ());
+          NS_LOG_LOGIC ("txPowerDensity = " << txPowerDensity);
+          // create tx psd
+          Ptr<SpectrumValue> txPsd =                                                        // it is the eNB that dictates the conf, m_listOfSubchannels contains all the subch
+            MmWaveSpectrumValueHelper::CreateTxPowerSpectralDensity (m_phyMacConfig, ueTxPower, m_listOfSubchannels);
+          NS_LOG_LOGIC ("TxPsd " << *txPsd);
+
+          // compute rx psd
+          double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
+          rxPsd = txPsd->Copy ();
+          *(rxPsd) *= pathGainLinear;
+
+          Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters> ();
+          rxParams->psd = rxPsd->Copy ();
+
+          if (m_spectrumPropagationLossModel)
+          {
+            rxPsd = m_spectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxParams, ueMob, enbMob);
+          }
+          else if (m_phasedArraySpectrumPropagationLossModel)
+          {
+            rxPsd = m_phasedArraySpectrumPropagationLossModel->CalcRxPowerSpectralDensity (rxParams, ueMob, enbMob, txPam, rxPam);
+          }
+          recomputedLinks++;
+
+          if (cacheable)
+            {
+              linkState.m_rxPsd = rxPsd;
+              m_sinrEstimateLinkStates[ue->first] = linkState;
+            }
+          else
+            {
+              m_sinrEstimateLinkStates.erase (ue->first);
+            }
+        }
 
       NS_LOG_LOGIC ("RxPsd " << *rxPsd);
 
@@ -681,6 +807,8 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
         }
 
     }
+  NS_LOG_DEBUG ("CellId " << m_cellId << " recomputed the rx PSD of " << recomputedLinks << " links, reused " << reusedLinks);
+  m_sinrEstimateCacheTrace (m_cellId, recomputedLinks, reusedLinks);
 
   for (std::map<uint64_t, Ptr<SpectrumValue> >::iterator ue = m_rxPsdMap.begin (); ue != m_rxPsdMap.end (); ++ue)
     {
@@ -694,156 +822,21 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
 
       if (m_noiseAndFilter)
         {
-          pairDevices_t pairDevices = std::make_pair (ue->first, m_cellId);              // this is the current pair (UE-eNB)
-          std::map< pairDevices_t, std::vector<double> >::iterator iteratorSinr =
-            m_sinrVector.find (pairDevices);                                                     // pair [pairDevices,Sinrvalue]
-
-          if (iteratorSinr != m_sinrVector.end ())              // this map has already been initialized, so I can add a new element for the SINR collection
-            {
-              if (Now ().GetMicroSeconds () <= m_transient )
-                {
-                  m_sinrVector.at (pairDevices).push_back (sinrAvg);                     // before transient, so just collect SINR values
-                }
-              else
-                {
-                  m_sinrVector.at (pairDevices).erase (m_sinrVector.at (pairDevices).begin ());
-                  m_sinrVector.at (pairDevices).push_back (sinrAvg);                     // before transient, so just collect SINR values
-                }
-
-              NS_LOG_DEBUG ("At time " << Now ().GetMicroSeconds () << " push back the REAL SINR " << 10 * std::log10 (sinrAvg) <<
-                            " for pair with CellId " << m_cellId << " and UE " << ue->first);
-            }
-          else               // vector is not initialized, so it means that we are still in the initial transient phase, for that pair
-            {
-              m_sinrVector.insert (std::pair<pairDevices_t, std::vector<double> > (pairDevices,std::vector<double> ()));
-              m_sinrVector.at (pairDevices).push_back (sinrAvg);                 // push back a new SINR value
-              NS_LOG_DEBUG ("At time " << Now ().GetMicroSeconds () << " first initializazion and push back the SINR " << 10 * std::log10 (sinrAvg) <<
-                            " for pair with CellId " << m_cellId << " and UE " << ue->first);
-            }
-
-
-
-
-          std::map< pairDevices_t, std::vector<double> >::iterator iteratorFinalTrace =
-            m_finalSinrVector.find (pairDevices);                                             // pair [pairDevices,Sinrvalue]
-          /* INITIALIZATION OF VECTORS */
-          if (iteratorFinalTrace == m_finalSinrVector.end ())
-            {
-              m_samplesFilter.insert (std::pair<pairDevices_t,std::pair<uint64_t,uint64_t> > (pairDevices,std::pair<uint64_t,uint64_t> ()));
-              m_finalSinrVector.insert (std::pair<pairDevices_t,std::vector<double> > (pairDevices,std::vector<double> ()) );
-            }
-
-
-          std::map< pairDevices_t, std::vector<double> >::iterator iteratorSinrToFilter =
-            m_sinrVectorToFilter.find (pairDevices);                                             // pair [pairDevices,Sinrvalue]
-          /* INITIALIZATION OF VECTORS */
-          if (iteratorSinrToFilter == m_sinrVectorToFilter.end ())
-            {
-              m_sinrVectorToFilter.insert (std::pair<pairDevices_t,std::vector<double> > (pairDevices,std::vector<double> ()));
-              m_sinrVectorNoisy.insert (std::pair<pairDevices_t,std::vector<double> > (pairDevices,std::vector<double> ()));
-            }
-
           /* generate Gaussian noise for the last SINR value (that is the current one) */
-          double sinrNoisy = AddGaussianNoise (m_sinrVector.at (pairDevices).back ());
-
-
-          /* UPDATE TRACE TO BE FILTERED */
-          if (Now ().GetMicroSeconds () <= m_transient)
-            {
-              m_sinrVectorNoisy.at (pairDevices).push_back (sinrNoisy);
-
-              // if (sinrNoisy < 0)
-              // {
-              //        NS_LOG_DEBUG("Old SINR value was " << 10*std::log10(sinrNoisy) << " while now is " << 10*std::log10(0.1));
-              //        sinrNoisy = 0.1;
-              // }
-              m_sinrVectorToFilter.at (pairDevices).push_back (sinrNoisy);
-
-            }
-          else
-            {
-              m_sinrVectorNoisy.at (pairDevices).erase (m_sinrVectorNoisy.at (pairDevices).begin ());
-              m_sinrVectorNoisy.at (pairDevices).push_back (sinrNoisy);
-
-              // if (sinrNoisy < 0)
-              // {
-              //        NS_LOG_DEBUG("Old SINR value was " << 10*std::log10(sinrNoisy) << " while now is " << 10*std::log10(0.1));
-              //        sinrNoisy = 0.1;
-              // }
-
-              double toPlot = *m_sinrVectorToFilter.at (pairDevices).begin ();
-              double toPlotbis = sinrNoisy;
-              NS_LOG_DEBUG ("(Remove SINR)  " << toPlot);
-              NS_LOG_DEBUG ("(Add SINR)  " << toPlotbis);
-
-              m_sinrVectorToFilter.at (pairDevices).erase (m_sinrVectorToFilter.at (pairDevices).begin ());
-              m_sinrVectorToFilter.at (pairDevices).push_back (sinrNoisy);
-
-
-            }
-
-
-          if (Now ().GetMicroSeconds () > m_transient)             // apply filter only when I have a sufficiently large set of SINR samples
-            {
-              std::vector<double> vectorNoisy = m_sinrVectorNoisy.at (pairDevices);
-              std::pair <uint64_t, uint64_t > pairFiltering = ApplyFilter (vectorNoisy);                   // find where to apply the filter, according to the variance
-              m_samplesFilter.at (pairDevices) = pairFiltering;                  // where to apply the linear filter
-              NS_LOG_DEBUG ("£££££££££££££££ start at sample " << std::get<0> (pairFiltering) );
-              NS_LOG_DEBUG ("£££££££££££££££ end at sample " << std::get<1> (pairFiltering) );
-
-              /* just apply filter where the SINR is too low and we are in a blockage situation */
-              if (std::get<0> (m_samplesFilter.at (pairDevices)) == std::get<1> (m_samplesFilter.at (pairDevices)) )                 // if start = end
-                {
-                  m_finalSinrVector.at (pairDevices) = m_sinrVectorToFilter.at (pairDevices);                     // no need to apply the filter
-                  NS_LOG_DEBUG ("At time " << Now ().GetMicroSeconds () << " there is no need to apply the Kalman filter for mmWave eNB "
-                                           << m_cellId << " and UE " << ue->first);
-                }
-              else
-                {
-                  std::vector<double> vectorToFilter = m_sinrVectorToFilter.at (pairDevices);
-                  std::vector<double> sinrVector = m_sinrVector.at (pairDevices);
-                  std::pair<uint64_t, uint64_t> filterPair = m_samplesFilter.at (pairDevices);
-                  std::vector<double> finalTrace;
-                  finalTrace = MakeFilter (vectorNoisy, sinrVector, filterPair);
-                  NS_LOG_DEBUG ("finaltrace " << finalTrace.back ());
-                  m_finalSinrVector.at (pairDevices) = finalTrace;
-                  finalTrace.clear ();
-                }
-
-
-              /* the last sample in the filtered sequence is referred to the current time instant,
-              * referred to the uplink reference signal that is used to build the RT in the LteEnbRrc class */
-              double sampleToForward = m_finalSinrVector.at (pairDevices).back ();
-              if (sampleToForward < 0)                   // this would be converted in NaN, in the log scale
-                {
-                  sampleToForward = 1e-20;
-                }
-              NS_LOG_DEBUG (" mmWave eNB " << m_cellId << " reports the SINR " << 10 * std::log10 (sampleToForward) << " for UE " << ue->first);
-              m_sinrMap[ue->first] = sampleToForward;                   // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< in order to FORWARD to LteEnbRrc the value of SINR for the RT
+          double sinrNoisy = AddGaussianNoise (sinrAvg);
 
-              //m_sinrVectorToFilter.at(pairDevices).erase(m_sinrVectorToFilter.at(pairDevices).begin());
-              //m_sinrVectorToFilter.at(pairDevices).push_back(m_finalSinrVector.at(pairDevices).back());
-              m_sinrVectorToFilter.at (pairDevices).pop_back ();
-              m_sinrVectorToFilter.at (pairDevices).push_back (m_finalSinrVector.at (pairDevices).back ());
-            }
-          else               // before the transient is over, just forwart the (last) noisy sample, without having filtered
+          /* the window of SINR samples of each pair (UE-eNB) grows during the transient,
+          * then the filter is applied to the last samples, and the oldest ones are dropped
+          */
+          bool applyFilter = Now ().GetMicroSeconds () > m_transient;
+          double sampleToForward = m_sinrFilterTable.AddSamples (ue->first, sinrAvg, sinrNoisy, applyFilter);
+          if (sampleToForward < 0)                   // this would be converted in NaN, in the log scale
             {
-              double sampleToForward = m_sinrVectorToFilter.at (pairDevices).back ();
-              if (sampleToForward < 0)                   // this would be converted in NaN, in the log scale
-                {
-                  sampleToForward = 1e-20;
-                }
-              NS_LOG_DEBUG (" mmWave eNB " << m_cellId << " FIRST reports the SINR " << 10 * std::log10 (sampleToForward) << " for UE " << ue->first);
-              m_sinrMap[ue->first] = sampleToForward;                   // <<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<<< in order to FORWARD to LteEnbRrc the value of SINR for the RT
+              sampleToForward = 1e-20;
             }
-
-          /* after the SINR sample is forwarded, I need to REFRESH all the maps, so that
-          * a new SINR sequence can be created, to generate a new SINR sample
-          * for the next RT
-          */
-          m_finalSinrVector.erase (pairDevices);
-          m_samplesFilter.erase (pairDevices);
-          NS_LOG_DEBUG ("ERASE MAPS FOR RT");
+          NS_LOG_DEBUG (" mmWave eNB " << m_cellId << " reports the SINR " << 10 * std::log10 (sampleToForward) << " for UE " << ue->first
+                                       << (applyFilter ? "" : " before the end of the transient"));
+          m_sinrMap[ue->first] = sampleToForward;                   // in order to FORWARD to LteEnbRrc the value of SINR for the RT
         }
       else           // noise and filtering processes are not applied!
         {
@@ -887,12 +880,52 @@ MmWaveEnbPhy::UpdateUeSinrEstimate ()
   Simulator::Schedule (MicroSeconds (m_updateSinrPeriod), &MmWaveEnbPhy::UpdateUeSinrEstimate, this);     // recall after m_updateSinrPeriod microseconds
 }
 
+bool
+MmWaveEnbPhy::IsSinrEstimateLinkStateValid (const SinrEstimateLinkState &state,
+                                            const SinrEstimateLinkState &current) const
+{
+  if (state.m_enbPosition != current.m_enbPosition
+      || state.m_uePosition != current.m_uePosition
+      || state.m_ueTxPower != current.m_ueTxPower
+      || state.m_pathLossDb != current.m_pathLossDb)
+    {
+      return false;
+    }
+
+  if (!current.m_channel)
+    {
+      // no spectrum propagation loss model, the rx PSD only depends on the pathloss
+      return !state.m_channel;
+    }
+
+  if (state.m_channel != current.m_channel
+      || state.m_channel->m_generatedTime != current.m_channel->m_generatedTime
+      || state.m_channelParams != current.m_channelParams
+      || state.m_enbBfVector != current.m_enbBfVector
+      || state.m_ueBfVector != current.m_ueBfVector)
+    {
+      return false;
+    }
+
+  // the Doppler due to the moving scatterers changes over time also for a static link
+  for (double d : current.m_channelParams->m_D)
+    {
+      if (d != 0)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 void
 MmWaveEnbPhy::StartSlot (void)
 {
   NS_LOG_FUNCTION (this);
 
   m_lastSlotStart = Simulator::Now ();
+  // the channels which expire during the slot are generated again before its transmissions
+  GenerateUeChannels ();
   m_currSlotAllocInfo = m_slotAllocInfo[m_slotNum];
   NS_LOG_DEBUG ("currSlotAllocInfo referring to: frame " << m_currSlotAllocInfo.m_sfnSf.m_frameNum << " subframe " << (uint16_t)m_currSlotAllocInfo.m_sfnSf.m_sfNum);
   NS_LOG_DEBUG ("Member variables counters indicating: frame " << m_frameNum << " subframe " << (uint16_t)m_sfNum);
@@ -952,7 +985,7 @@ MmWaveEnbPhy::StartTti (void)
   if (m_ttiIndex == 0)       // First TTI: reserved DL control
     {
       // get control messages to be transmitted in DL-Control period
-      std::list <Ptr<MmWaveControlMessage > > ctrlMsgs = GetControlMessages ();
+      Ptr<MmWaveControlMessageList> ctrlMsgs = GetControlMessages ();
       //std::list <Ptr<MmWaveControlMessage > >::iterator it = ctrlMsgs.begin ();
       // find all DL/UL DCI elements and create DCI messages to be transmitted in DL control period
       for (unsigned iTti = 0; iTti < m_currSlotAllocInfo.m_ttiAllocInfo.size (); iTti++)
@@ -968,7 +1001,7 @@ MmWaveEnbPhy::StartTti (void)
                   dciMsg->SetDciInfoElement (dciElem);
                   dciMsg->SetSfnSf (sfn);
                   dciMsgList.push_back (dciMsg);
-                  ctrlMsgs.push_back (dciMsg);
+                  ctrlMsgs->m_messages.push_back (dciMsg);
                 }
             }
         }
@@ -987,7 +1020,7 @@ MmWaveEnbPhy::StartTti (void)
                   dciMsg->SetDciInfoElement (dciElem);
                   dciMsg->SetSfnSf (sfn);
                   //dciMsgList.push_back (dciMsg);
-                  ctrlMsgs.push_back (dciMsg);
+                  ctrlMsgs->m_messages.push_back (dciMsg);
                 }
             }
         }
@@ -1038,7 +1071,7 @@ MmWaveEnbPhy::StartTti (void)
           emptyPdu->AddPacketTag (tag);
           LteRadioBearerTag bearerTag (currTti.m_dci.m_rnti, 3, 0);
           emptyPdu->AddPacketTag (bearerTag);
-          pktBurst = CreateObject<PacketBurst> ();
+          pktBurst = m_packetBurstPool.Get ();
           pktBurst->AddPacket (emptyPdu);
         }
       NS_LOG_DEBUG ("ENB " << m_cellId << " TXing DL DATA frame " << m_frameNum << " subframe " << (unsigned)m_sfNum << " slot "
@@ -1184,12 +1217,12 @@ MmWaveEnbPhy::SendDataChannels (Ptr<PacketBurst> pb, Time slotPrd, TtiAllocInfo&
     }
 
 
-  std::list<Ptr<MmWaveControlMessage> > ctrlMsgs;
-  m_downlinkSpectrumPhy->StartTxDataFrames (pb, ctrlMsgs, slotPrd, slotInfo.m_ttiIdx);
+  // no control message in the data TTIs of the eNB
+  m_downlinkSpectrumPhy->StartTxDataFrames (pb, 0, slotPrd, slotInfo.m_ttiIdx);
 }
 
 void
-MmWaveEnbPhy::SendCtrlChannels (std::list<Ptr<MmWaveControlMessage> > ctrlMsgs, Time slotPrd)
+MmWaveEnbPhy::SendCtrlChannels (Ptr<MmWaveControlMessageList> ctrlMsgs, Time slotPrd)
 {
   /* Send Ctrl messages*/
   NS_LOG_FUNCTION (this << "Send Ctrl");
@@ -43,6 +43,8 @@
 #include <ns3/lte-enb-phy-sap.h>
 #include <ns3/lte-enb-cphy-sap.h>
 #include <ns3/mmwave-harq-phy.h>
+#include <ns3/mmwave-sinr-filter-table.h>
+#include <ns3/matrix-based-channel-model.h>
 
 namespace ns3 {
 
@@ -130,7 +132,7 @@ public:
 
   void SendDataChannels (Ptr<PacketBurst> pb, Time slotPrd, TtiAllocInfo& slotInfo);
 
-  void SendCtrlChannels (std::list<Ptr<MmWaveControlMessage> > ctrlMsg, Time slotPrd);
+  void SendCtrlChannels (Ptr<MmWaveControlMessageList> ctrlMsg, Time slotPrd);
 
   Ptr<MmWaveSpectrumPhy> GetDlSpectrumPhy () const;
   Ptr<MmWaveSpectrumPhy> GetUlSpectrumPhy () const;
@@ -188,6 +190,46 @@ private:
   void DoSetBandwidth (uint8_t Bandwidth );
   void DoSetEarfcn (uint16_t Earfcn );
 
+  /**
+   * State of an eNB-UE link, as used in the last call to UpdateUeSinrEstimate.
+   * The rx PSD is reused as long as none of the other fields changes.
+   */
+  struct SinrEstimateLinkState
+  {
+    Vector m_enbPosition;      //!< position of the eNB
+    Vector m_uePosition;       //!< position of the UE
+    double m_ueTxPower;        //!< UE tx power in dBm
+    double m_pathLossDb;       //!< pathloss in dB
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> m_channel;       //!< channel matrix of the link
+    Ptr<const MatrixBasedChannelModel::ChannelParams> m_channelParams; //!< channel params of the link
+    PhasedArrayModel::ComplexVector m_enbBfVector;       //!< beamforming vector of the eNB
+    PhasedArrayModel::ComplexVector m_ueBfVector;        //!< beamforming vector of the UE
+    Ptr<SpectrumValue> m_rxPsd;                          //!< rx PSD computed with the above
+  };
+
+  /**
+   * Checks whether the rx PSD stored in a link state can be reused.
+   *
+   * \param state the link state computed in a previous round
+   * \param current the link state of the current round, without the rx PSD
+   * \return true if the rx PSD does not need to be recomputed
+   */
+  bool IsSinrEstimateLinkStateValid (const SinrEstimateLinkState &state,
+                                     const SinrEstimateLinkState &current) const;
+
+  /**
+   * Called at the start of each slot. Generates in one batch the channel
+   * matrices of the links with the attached UEs which are new or expire
+   * during the slot, so that their coefficients are computed by the threads
+   * of the ThreeGppChannelModel instead of one at a time by the first
+   * transmission which looks them up. Nothing is done unless the attribute
+   * NumThreads of the channel model is greater than 1; the expired channels
+   * are then updated up to one slot earlier than otherwise. The channels do
+   * not depend on the order of the UEs only if the attribute
+   * PerLinkRandomStreams of the channel model is true.
+   */
+  void GenerateUeChannels ();
+
  /**
   * Triggers the callback for the ReportDlPhyTransmission Trace Source
   * 
@@ -219,11 +261,8 @@ private:
   std::map <uint64_t, Ptr<NetDevice> > m_ueAttachedImsiMap;
   std::map <uint64_t, double > m_sinrMap;
   std::map <uint64_t, Ptr<SpectrumValue> > m_rxPsdMap;
-  std::map <pairDevices_t, std::vector<double> > m_sinrVector;        // array containing all SINR values for a specific pair (UE-eNB)
-  std::map <pairDevices_t, std::vector<double> > m_sinrVectorToFilter;        // array containing the  SINR values that must be filtered
-  std::map <pairDevices_t, std::vector<double> > m_sinrVectorNoisy;        // array containing the  noisy SINR values that must be filteredF
-  std::map <pairDevices_t, std::vector<double> > m_finalSinrVector;        // array containing all  SINR values after the filtering for a specific pair (UE-eNB)
-  std::map <pairDevices_t, std::pair <uint64_t,uint64_t> > m_samplesFilter;       // array containing all noisy SINR values for a specific pair (UE-eNB)
+  MmWaveSinrFilterTable m_sinrFilterTable;        // windows of real and noisy SINR values for each pair (UE-eNB)
+  std::map <uint64_t, SinrEstimateLinkState> m_sinrEstimateLinkStates;       // state of each link (UE IMSI) at the last SINR estimate
 
   int m_updateSinrPeriod;       // the period of SINR update for eNBs
   double m_ueUpdateSinrPeriod;       // the period of SINR reporting to the UEs
@@ -231,6 +270,7 @@ private:
   uint16_t m_roundFromLastUeSinrUpdate;       // the ratio between the two above
   double m_transient;       // after m_transient, we can start apply the filter
   bool m_noiseAndFilter;       // If true, use noisy SINR samples, filtered. If false, just use the SINR measure
+  bool m_sinrEstimateCache;       // If true, reuse the rx PSD of the links whose channel did not change
 
   Ptr<MmWaveHarqPhy> m_harqPhyModule;
   std::vector <int> m_channelChunks;
@@ -240,6 +280,8 @@ private:
   TracedCallback< uint64_t, SpectrumValue&, SpectrumValue& > m_ulSinrTrace;
 
   TracedCallback<PhyTransmissionTraceParams> m_dlPhyTrace;   //!< Traces the current TTI allocation info, from the eNB side
+
+  TracedCallback<uint16_t, uint32_t, uint32_t> m_sinrEstimateCacheTrace;   //!< Traces the number of recomputed and reused links at each SINR estimate
 };
 
 } // namespace mmwave
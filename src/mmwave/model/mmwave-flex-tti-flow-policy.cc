@@ -0,0 +1,383 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*   Author: Marco Miozzo <marco.miozzo@cttc.es>
+*           Nicola Baldo  <nbaldo@cttc.es>
+*
+*   Modified by: Marco Mezzavilla < mezzavilla@nyu.edu>
+*                         Sourjya Dutta <sdutta@nyu.edu>
+*                         Russell Ford <russell.ford@nyu.edu>
+*                         Menglei Zhang <menglei@nyu.edu>
+*/
+
+
+
+#include <ns3/log.h>
+#include "mmwave-flex-tti-flow-policy.h"
+#include <ns3/eps-bearer.h>
+#include <algorithm>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveFlexTtiFlowPolicy");
+
+namespace mmwave {
+
+// averaging window of the PF throughput, in slots
+static const double g_timeWindow = 99.0;
+
+const uint32_t MmWaveFlexTtiFlowPolicy::NO_FLOW_ID;
+
+MmWaveFlexTtiFlowPolicy::MmWaveFlexTtiFlowPolicy (bool deadlineAware)
+  : m_deadlineAware (deadlineAware),
+    m_flowSeq (0)
+{
+}
+
+void
+MmWaveFlexTtiFlowPolicy::ConfigureLcInfo (UeInfo *ue, const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  if (ue == 0 || !ue->m_configured)
+    {
+      NS_LOG_ERROR ("Cannot find UE info entry");
+      return;
+    }
+  EpsBearer lowLatBearer (EpsBearer::NGBR_LOW_LAT_EMBB_AR);
+  for (uint16_t i = 0; i < params.m_logicalChannelConfigList.size (); i++)
+    {
+      const LogicalChannelConfigListElement_s &lc = params.m_logicalChannelConfigList[i];
+      if (lc.m_direction == LogicalChannelConfigListElement_s::DIR_DL)
+        {
+          uint8_t lcid = lc.m_logicalChannelIdentity;
+          for (unsigned j = ue->m_flowStatsDl.size (); j <= lcid; j++)
+            {
+              ue->m_flowStatsDl.push_back (FlowStats (false, j));
+            }
+          ue->m_flowStatsDl[lcid].m_qci = lc.m_qci;
+          if (lc.m_qci == EpsBearer::NGBR_LOW_LAT_EMBB_AR)
+            {
+              ue->m_flowStatsDl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+            }
+          if (m_deadlineAware)
+            {
+              RegisterFlow (ue->m_flowStatsDl[lcid], params.m_rnti);
+            }
+        }
+      else if (lc.m_direction == LogicalChannelConfigListElement_s::DIR_UL)
+        {
+          uint8_t lcid = lc.m_logicalChannelGroup;   // use LCG ID instead of LCID
+          for (unsigned j = ue->m_flowStatsUl.size (); j <= lcid; j++)
+            {
+              ue->m_flowStatsUl.push_back (FlowStats (true, j));
+            }
+          ue->m_flowStatsUl[lcid].m_qci = lc.m_qci;
+          if (lc.m_qci == EpsBearer::NGBR_LOW_LAT_EMBB_AR)
+            {
+              ue->m_flowStatsUl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+            }
+          if (m_deadlineAware)
+            {
+              RegisterFlow (ue->m_flowStatsUl[lcid], params.m_rnti);
+            }
+        }
+      else if (lc.m_direction == LogicalChannelConfigListElement_s::DIR_BOTH)
+        {
+          uint8_t lcid = lc.m_logicalChannelIdentity;
+          for (unsigned j = ue->m_flowStatsDl.size (); j <= lcid; j++)
+            {
+              ue->m_flowStatsDl.push_back (FlowStats (false, j));
+              ue->m_flowStatsUl.push_back (FlowStats (true, j));
+            }
+          ue->m_flowStatsDl[lcid].m_qci = lc.m_qci;
+          ue->m_flowStatsUl[lcid].m_qci = lc.m_qci;
+          ue->m_flowStatsDl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+          ue->m_flowStatsUl[lcid].m_deadlineUs = lowLatBearer.GetPacketDelayBudgetMs () * 1000;
+          if (m_deadlineAware)
+            {
+              RegisterFlow (ue->m_flowStatsDl[lcid], params.m_rnti);
+              RegisterFlow (ue->m_flowStatsUl[lcid], params.m_rnti);
+            }
+        }
+    }
+}
+
+void
+MmWaveFlexTtiFlowPolicy::UpdateDlRlcBufferInfo (UeInfo *ue, const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << params.m_rnti << (uint32_t) params.m_logicalChannelIdentity);
+  if (ue == 0 || !ue->m_configured)
+    {
+      NS_LOG_ERROR ("UE entry not found in sched info map");
+      return;
+    }
+  uint8_t lcid = params.m_logicalChannelIdentity;
+  if ((unsigned)lcid >= ue->m_flowStatsDl.size ())
+    {
+      NS_LOG_ERROR ("LC not registered");
+      return;
+    }
+  FlowStats &flow = ue->m_flowStatsDl[lcid];
+  if (params.m_txPacketSizes.size () > 0)
+    {
+      flow.m_txPacketSizes.clear ();
+      flow.m_txPacketDelays.clear ();
+      // add the new DL PDCP packet sizes and their delays
+      uint32_t totalSize = 0;
+      double maxDelay = 0.0;
+      std::list<uint32_t>::const_iterator itSize = params.m_txPacketSizes.begin ();
+      std::list<double>::const_iterator itDelay = params.m_txPacketDelays.begin ();
+      while (itSize != params.m_txPacketSizes.end () && itDelay != params.m_txPacketDelays.end ())
+        {
+          totalSize += *itSize;
+          if (totalSize > 0)
+            {
+              if (!m_deadlineAware)
+                {
+                  flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+                }
+              flow.m_txPacketSizes.push_back (*itSize);
+              flow.m_txPacketDelays.push_back (*itDelay);
+              if (*itDelay > maxDelay)
+                {
+                  maxDelay = *itDelay;
+                }
+            }
+          itSize++;
+          itDelay++;
+        }
+      flow.m_txQueueHolDelay = maxDelay;
+      UpdateFlowDeadline (flow);
+    }
+  else if (!m_deadlineAware && params.m_rlcTransmissionQueueSize > 0)        // case for RlcSm
+    {
+      flow.m_totalBufSize = params.m_rlcTransmissionQueueSize;
+    }
+}
+
+void
+MmWaveFlexTtiFlowPolicy::UpdateUlBufferInfo (UeInfo *ue, uint8_t lcg, uint32_t bufSize, double delayUs)
+{
+  if (ue == 0 || !ue->m_configured)
+    {
+      NS_LOG_ERROR ("UE entry not found in sched info map");
+      return;
+    }
+  FlowStats &flow = ue->m_flowStatsUl[lcg];
+  int diff = bufSize - flow.m_totalBufSize;
+  if (diff > 0)
+    {                               // estimate additional packet sizes
+      flow.m_totalBufSize += diff;
+      flow.m_txPacketSizes.push_back (diff);
+      flow.m_txPacketDelays.push_back (delayUs);
+      if (flow.m_txQueueHolDelay == 0)
+        {
+          flow.m_txQueueHolDelay = delayUs;
+          UpdateFlowDeadline (flow);
+        }
+    }
+}
+
+void
+MmWaveFlexTtiFlowPolicy::ReleaseUeInfo (UeInfo &ue, uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+  for (FlowStats &flow : ue.m_flowStatsDl)
+    {
+      ReleaseFlow (flow);
+    }
+  for (FlowStats &flow : ue.m_flowStatsUl)
+    {
+      ReleaseFlow (flow);
+    }
+  ue = UeInfo ();
+}
+
+void
+MmWaveFlexTtiFlowPolicy::RegisterFlow (FlowStats &flow, uint16_t rnti)
+{
+  if (flow.m_flowId != NO_FLOW_ID)
+    {
+      // LC configured again, the deadline may have changed
+      UpdateFlowDeadline (flow);
+      return;
+    }
+  if (m_freeFlowIds.empty ())
+    {
+      flow.m_flowId = m_flows.size ();
+      m_flows.push_back (FlowId (rnti, flow.m_isUplink, flow.m_lcid));
+    }
+  else
+    {
+      flow.m_flowId = m_freeFlowIds.back ();
+      m_freeFlowIds.pop_back ();
+      m_flows[flow.m_flowId] = FlowId (rnti, flow.m_isUplink, flow.m_lcid);
+    }
+  EdfKey key;
+  key.m_relDeadline = GetRelDeadline (flow);
+  key.m_seq = m_flowSeq++;
+  m_flowHeap.Update (flow.m_flowId, key);
+}
+
+void
+MmWaveFlexTtiFlowPolicy::ReleaseFlow (FlowStats &flow)
+{
+  if (flow.m_flowId != NO_FLOW_ID)
+    {
+      m_flowHeap.Remove (flow.m_flowId);
+      m_freeFlowIds.push_back (flow.m_flowId);
+      flow.m_flowId = NO_FLOW_ID;
+    }
+}
+
+void
+MmWaveFlexTtiFlowPolicy::UpdateFlowDeadline (const FlowStats &flow)
+{
+  if (flow.m_flowId != NO_FLOW_ID)
+    {
+      EdfKey key = m_flowHeap.GetKey (flow.m_flowId);
+      key.m_relDeadline = GetRelDeadline (flow);
+      m_flowHeap.Update (flow.m_flowId, key);
+    }
+}
+
+int
+MmWaveFlexTtiFlowPolicy::GetRelDeadline (const FlowStats &flow)
+{
+  int relDeadline = flow.m_deadlineUs - flow.m_txQueueHolDelay;
+  return relDeadline;
+}
+
+bool
+MmWaveFlexTtiFlowPolicy::AllocateSymbol (UeInfo &ue, Ptr<MmWaveAmc> amc, double slotPeriod)
+{
+  if (ue.m_totBufDl == 0)
+    {
+      ue.m_dlAllocDone = true;
+    }
+  if (ue.m_totBufUl == 0)
+    {
+      ue.m_ulAllocDone = true;
+    }
+
+  if ((ue.m_allocUlLast || ue.m_dlAllocDone) && !ue.m_ulAllocDone)
+    {
+      ue.m_ulSymbols++;
+      ue.m_ulTbSize = amc->CalculateTbSize (ue.m_ulMcs, ue.m_ulSymbols);
+      if (ue.m_ulTbSize >= ue.m_totBufUl)
+        {
+          ue.m_ulAllocDone = true;
+          ue.m_lastAvgTputUl = ue.m_avgTputUl;
+        }
+      ue.m_allocUlLast = true;
+
+      uint32_t tbSize = ue.m_ulTbSize * 8; // Bytes -> Bits
+      ue.m_currTputUl = std::min (ue.m_totBufUl, tbSize) / slotPeriod;
+      ue.m_avgTputUl = ((1.0 - (1.0 / g_timeWindow)) * ue.m_lastAvgTputUl) +
+        ((1.0 / g_timeWindow) * ((double)ue.m_ulTbSize / slotPeriod));
+      return true;
+    }
+  else if (!ue.m_dlAllocDone)
+    {
+      ue.m_dlSymbols++;
+      ue.m_dlTbSize = amc->CalculateTbSize (ue.m_dlMcs, ue.m_dlSymbols);
+      if (ue.m_dlTbSize >= ue.m_totBufDl)
+        {
+          ue.m_dlAllocDone = true;
+          ue.m_lastAvgTputDl = ue.m_avgTputDl;
+        }
+      ue.m_allocUlLast = false;
+
+      uint32_t tbSize = ue.m_dlTbSize * 8; // Bytes -> Bits
+      ue.m_currTputDl = std::min (ue.m_totBufDl, tbSize) / slotPeriod;
+      ue.m_avgTputDl = ((1.0 - (1.0 / g_timeWindow)) * ue.m_lastAvgTputDl) +
+        ((1.0 / g_timeWindow) * ((double)ue.m_dlTbSize / slotPeriod));
+      return true;
+    }
+  return false;
+}
+
+void
+MmWaveFlexTtiFlowPolicy::DistributeDlTbSize (UeInfo &ue, uint32_t tbSize)
+{
+  // distribute bytes between active RLC queues
+  unsigned numLc = ue.m_rlcPduInfo.size ();
+  unsigned bytesRem = tbSize;
+  unsigned numFulfilled = 0;
+  uint16_t avgPduSize = bytesRem / numLc;
+  // first for loop computes extra to add to average if some flows are less than average
+  for (unsigned i = 0; i < numLc; i++)
+    {
+      if (ue.m_rlcPduInfo[i].m_size < avgPduSize)
+        {
+          bytesRem -= ue.m_rlcPduInfo[i].m_size;
+          numFulfilled++;
+        }
+    }
+
+  if (numFulfilled < numLc)
+    {
+      avgPduSize = bytesRem / (numLc - numFulfilled);
+    }
+
+  for (unsigned i = 0; i < numLc; i++)
+    {
+      if (ue.m_rlcPduInfo[i].m_size > avgPduSize)
+        {
+          ue.m_rlcPduInfo[i].m_size = avgPduSize;
+        }
+      // else tbSize equals RLC queue size
+      NS_ASSERT (ue.m_rlcPduInfo[i].m_size > 0);
+    }
+
+  // every PDU is listed twice in the TTI, as done by the original PF and
+  // MaxRate schedulers
+  ue.m_rlcPduInfo.insert (ue.m_rlcPduInfo.end (), ue.m_rlcPduInfo.begin (), ue.m_rlcPduInfo.end ());
+}
+
+void
+MmWaveFlexTtiFlowPolicy::ResetSlot (UeInfo &ue)
+{
+  ue.m_dlSymbols = 0;
+  ue.m_ulSymbols = 0;
+  ue.m_dlTbSize = 0;
+  ue.m_ulTbSize = 0;
+  ue.m_currTputDl = 0;
+  ue.m_currTputUl = 0;
+  ue.m_avgTputDl = 0;
+  ue.m_avgTputUl = 0;
+  ue.m_totBufDl = 0;
+  ue.m_totBufUl = 0;
+  ue.m_dlAllocDone = false;
+  ue.m_ulAllocDone = false;
+  ue.m_rlcPduInfo.clear ();
+}
+
+void
+MmWaveFlexTtiFlowPolicy::InsertRnti (std::vector<uint16_t> &rntis, uint16_t rnti)
+{
+  std::vector<uint16_t>::iterator it = std::lower_bound (rntis.begin (), rntis.end (), rnti);
+  if (it == rntis.end () || *it != rnti)
+    {
+      rntis.insert (it, rnti);
+    }
+}
+
+} // namespace mmwave
+
+} // namespace ns3
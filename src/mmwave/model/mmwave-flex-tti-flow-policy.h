@@ -0,0 +1,363 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*   Author: Marco Miozzo <marco.miozzo@cttc.es>
+*           Nicola Baldo  <nbaldo@cttc.es>
+*
+*   Modified by: Marco Mezzavilla < mezzavilla@nyu.edu>
+*                         Sourjya Dutta <sdutta@nyu.edu>
+*                         Russell Ford <russell.ford@nyu.edu>
+*                         Menglei Zhang <menglei@nyu.edu>
+*/
+
+
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_FLOW_POLICY_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_FLOW_POLICY_H_
+
+
+#include "mmwave-flex-tti-mac-scheduler-engine.h"
+#include "mmwave-indexed-heap.h"
+#include <vector>
+#include <list>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief Per-flow bookkeeping shared by the PF, MaxRate and MaxWeight policies
+ *
+ * Every UE has one FlowStats per DL LC and per UL LC group, fed by the RLC
+ * buffer status reports and by the BSRs. The derived policies only implement
+ * ScheduleNewData.
+ */
+class MmWaveFlexTtiFlowPolicy
+{
+public:
+  static const uint32_t NO_FLOW_ID = 0xFFFFFFFF;
+
+  struct FlowStats
+  {
+    FlowStats (bool uplink, uint8_t lcid)
+      : m_isUplink (uplink),
+        m_lcid (lcid),
+        m_qci (0),
+        m_txQueueHolDelay (0),
+        m_deadlineUs (0),
+        m_totalBufSize (0),
+        m_flowId (NO_FLOW_ID)
+    {
+    }
+
+    bool            m_isUplink;                 // is uplink?
+    uint8_t         m_lcid;                     // LCID (for DL) or LC Group ID (for UL)
+    uint8_t         m_qci;                      // We interpret QCI 69 as delay critical
+    double          m_txQueueHolDelay;
+    double          m_deadlineUs;               // relative deadline
+    std::list<uint32_t> m_txPacketSizes;        // estimated packet sizes from consecutive BSRs
+    uint32_t        m_totalBufSize;
+    std::list<double> m_txPacketDelays;         // estimated delays for each packet
+    uint32_t        m_flowId;                   // id in m_flowHeap (deadline-aware policy only)
+  };
+
+  struct UeInfo
+  {
+    UeInfo ()
+      : m_configured (false),
+        m_dlMcs (0),
+        m_ulMcs (0),
+        m_dlSymbols (0),
+        m_ulSymbols (0),
+        m_dlTbSize (0),
+        m_ulTbSize (0),
+        m_dlAllocDone (false),
+        m_ulAllocDone (false),
+        m_avgTputDl (0.0),
+        m_avgTputUl (0.0),
+        m_lastAvgTputDl (0.0),
+        m_lastAvgTputUl (0.0),
+        m_currTputDl (0.0),
+        m_currTputUl (0.0),
+        m_totBufDl (0),
+        m_totBufUl (0),
+        m_allocUlLast (false)
+    {
+    }
+
+    bool            m_configured;               // the UE has been configured and not released
+    uint8_t         m_dlMcs;
+    uint8_t         m_ulMcs;
+    uint8_t         m_dlSymbols;
+    uint8_t         m_ulSymbols;
+    uint32_t        m_dlTbSize;
+    uint32_t        m_ulTbSize;
+    std::vector <struct RlcPduInfo> m_rlcPduInfo;
+    bool            m_dlAllocDone;
+    bool            m_ulAllocDone;
+    std::vector<FlowStats> m_flowStatsDl;       // for each LC
+    std::vector<FlowStats> m_flowStatsUl;       // for each LC group
+    double          m_avgTputDl;
+    double          m_avgTputUl;
+    double          m_lastAvgTputDl;
+    double          m_lastAvgTputUl;
+    double          m_currTputDl;
+    double          m_currTputUl;
+    uint32_t        m_totBufDl;
+    uint32_t        m_totBufUl;
+    bool            m_allocUlLast;
+  };
+
+  /**
+   * Reference to a flow, stable when the flow vectors of a UE grow
+   */
+  struct FlowId
+  {
+    FlowId (uint16_t rnti, bool uplink, uint8_t index)
+      : m_rnti (rnti),
+        m_isUplink (uplink),
+        m_index (index)
+    {
+    }
+
+    uint16_t        m_rnti;
+    bool            m_isUplink;
+    uint8_t         m_index;
+  };
+
+  /**
+   * Key of a flow in m_flowHeap: earlier relative deadline first, then
+   * earlier configured flow first
+   */
+  struct EdfKey
+  {
+    int             m_relDeadline;
+    uint32_t        m_seq;
+
+    bool operator< (const EdfKey &other) const
+    {
+      return m_relDeadline < other.m_relDeadline
+             || (m_relDeadline == other.m_relDeadline && m_seq < other.m_seq);
+    }
+  };
+
+  /**
+   * \param deadlineAware keep the configured flows in m_flowHeap and account
+   *        the buffers per packet only, as needed by the EDF policy
+   */
+  MmWaveFlexTtiFlowPolicy (bool deadlineAware);
+
+  template <class Engine>
+  void ConfigureUe (Engine &sched, uint16_t rnti);
+  template <class Engine>
+  void ConfigureLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  template <class Engine>
+  void ReleaseLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+  template <class Engine>
+  void ReleaseUe (Engine &sched, uint16_t rnti);
+
+  template <class Engine>
+  void UpdateDlRlcBuffer (Engine &sched, const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+  template <class Engine>
+  void UpdateBsr (Engine &sched, const struct MacCeElement& bsr);
+  template <class Engine>
+  void UpdateCqi (Engine &sched, uint16_t rnti);
+
+protected:
+  /**
+   * \brief Create the DCIs of the new data allocated to the UEs and close the slot
+   *
+   * The DL TTIs carry the m_rlcPduInfo of each UE. The UL control TTI is
+   * added with index 0xFF.
+   * \param allocRntis UEs allocated in the slot, sorted
+   */
+  template <class Engine>
+  void CreateDcis (Engine &sched, MmWaveFlexTtiSlotContext &ctx, const std::vector<uint16_t> &allocRntis);
+
+  /**
+   * \brief Give one more symbol to the UE, alternating between its DL and UL flows
+   * \return false if both directions are already fully allocated
+   */
+  bool AllocateSymbol (UeInfo &ue, Ptr<MmWaveAmc> amc, double slotPeriod);
+
+  /**
+   * \brief Divide a DL TB evenly among the LCs in m_rlcPduInfo
+   */
+  void DistributeDlTbSize (UeInfo &ue, uint32_t tbSize);
+
+  void ResetSlot (UeInfo &ue);
+
+  static void InsertRnti (std::vector<uint16_t> &rntis, uint16_t rnti);
+
+  template <class Engine>
+  FlowStats& GetFlow (Engine &sched, uint32_t flowId);
+
+  /**
+   * \brief Update the key of a flow in m_flowHeap after its HOL delay changed
+   */
+  void UpdateFlowDeadline (const FlowStats &flow);
+
+  /**
+   * \return the deadline of the HOL packet of the flow, relative to now (in microseconds)
+   */
+  static int GetRelDeadline (const FlowStats &flow);
+
+  bool m_deadlineAware;
+  // configured flows, deadline-aware policy only
+  std::vector<FlowId> m_flows;         // indexed by flow id
+  std::vector<uint32_t> m_freeFlowIds; // ids of the released flows
+  MmWaveIndexedHeap<EdfKey> m_flowHeap;  // flow ids, earliest deadline first
+  uint32_t m_flowSeq;                  // sequence number of the next configured flow
+
+private:
+  // the UeInfo pointers are 0 for unknown UEs
+  void ConfigureLcInfo (UeInfo *ue, const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  void UpdateDlRlcBufferInfo (UeInfo *ue, const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+  void UpdateUlBufferInfo (UeInfo *ue, uint8_t lcg, uint32_t bufSize, double delayUs);
+  void ReleaseUeInfo (UeInfo &ue, uint16_t rnti);
+  void RegisterFlow (FlowStats &flow, uint16_t rnti);
+  void ReleaseFlow (FlowStats &flow);
+};
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::ConfigureUe (Engine &sched, uint16_t rnti)
+{
+  UeInfo &ue = sched.GetUe (rnti).m_sched;
+  if (!ue.m_configured)
+    {
+      ue.m_configured = true;
+      for (unsigned i = 0; i <= 3; i++)
+        {
+          ue.m_flowStatsDl.push_back (FlowStats (false, i));
+          ue.m_flowStatsUl.push_back (FlowStats (true, i));
+        }
+    }
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::ConfigureLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+  typename Engine::UeState *ueState = sched.FindUe (params.m_rnti);
+  ConfigureLcInfo (ueState ? &ueState->m_sched : 0, params);
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::ReleaseLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+  // the flows of the LC are kept until the UE is released
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::ReleaseUe (Engine &sched, uint16_t rnti)
+{
+  ReleaseUeInfo (sched.FindUe (rnti)->m_sched, rnti);
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::UpdateDlRlcBuffer (Engine &sched, const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  typename Engine::UeState *ueState = sched.FindUe (params.m_rnti);
+  UpdateDlRlcBufferInfo (ueState ? &ueState->m_sched : 0, params);
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::UpdateBsr (Engine &sched, const struct MacCeElement& bsr)
+{
+  // since we expect the BSR to be generated following a packet arrival and sent at least by the end of the prev. subframe,
+  // the maximum delay is one SF (in microseconds)
+  double delayUs = m_deadlineAware ? sched.m_phyMacConfig->GetSubframePeriod ().GetMicroSeconds ()
+    : sched.m_phyMacConfig->GetSlotPeriod ().GetMicroSeconds ();
+  typename Engine::UeState *ueState = sched.FindUe (bsr.m_rnti);
+  for (uint8_t lcg = 1; lcg <= 3; ++lcg)
+    {
+      uint32_t bufSize = sched.BsrId2BufferSize (bsr.m_macCeValue.m_bufferStatus.at (lcg - 1));
+      if (bufSize > 0)
+        {
+          UpdateUlBufferInfo (ueState ? &ueState->m_sched : 0, lcg, bufSize, delayUs);
+        }
+    }
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::UpdateCqi (Engine &sched, uint16_t rnti)
+{
+  // the CQIs are read when the slot is scheduled
+}
+
+template <class Engine>
+MmWaveFlexTtiFlowPolicy::FlowStats&
+MmWaveFlexTtiFlowPolicy::GetFlow (Engine &sched, uint32_t flowId)
+{
+  const FlowId &id = m_flows[flowId];
+  UeInfo &ueInfo = sched.m_ues[id.m_rnti].m_sched;
+  return id.m_isUplink ? ueInfo.m_flowStatsUl[id.m_index] : ueInfo.m_flowStatsDl[id.m_index];
+}
+
+template <class Engine>
+void
+MmWaveFlexTtiFlowPolicy::CreateDcis (Engine &sched, MmWaveFlexTtiSlotContext &ctx, const std::vector<uint16_t> &allocRntis)
+{
+  // iterate through the allocated UEs, assign TDMA symbol indices and create DCIs
+  for (uint16_t rnti : allocRntis)
+    {
+      UeInfo &ueInfo = sched.m_ues[rnti].m_sched;
+      if (ueInfo.m_dlSymbols > 0)
+        {
+          TtiAllocInfo ttiInfo (ctx.m_ttiIdx++, TtiAllocInfo::DL_slotAllocInfo, TtiAllocInfo::CTRL_DATA, rnti);
+          ttiInfo.m_dci = sched.CreateDci (rnti, 0, ctx.m_symIdx, ueInfo.m_dlSymbols, ueInfo.m_dlMcs);
+          ctx.m_symIdx += ueInfo.m_dlSymbols;
+          ttiInfo.m_rlcPduInfo = ueInfo.m_rlcPduInfo;
+          sched.AddDlTti (ctx, ttiInfo, sched.m_harqOn);
+        }
+    }
+  const TtiAllocInfo &lastTti = ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.back ();
+  ctx.m_ttiIdx = lastTti.m_ttiIdx + 1;
+  ctx.m_symIdx = lastTti.m_dci.m_symStart + lastTti.m_dci.m_numSym;
+
+  for (uint16_t rnti : allocRntis)
+    {
+      UeInfo &ueInfo = sched.m_ues[rnti].m_sched;
+      // Note: UL-DCI applies to subframe i+Tsched
+      if (ueInfo.m_ulSymbols > 0)
+        {
+          TtiAllocInfo ttiInfo (ctx.m_ttiIdx++, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL_DATA, rnti);
+          ttiInfo.m_dci = sched.CreateDci (rnti, 1, ctx.m_symIdx, ueInfo.m_ulSymbols, ueInfo.m_ulMcs);
+          ctx.m_symIdx += ueInfo.m_ulSymbols;
+          SfnSf slotSfn = ctx.m_ret.m_slotAllocInfo.m_sfnSf;
+          slotSfn.m_slotNum = ttiInfo.m_dci.m_symStart;        // use the start symbol index of the slot because the absolute UL slot index depends on the future DL allocation
+          sched.AddUlTti (ctx, ttiInfo, slotSfn);
+        }
+    }
+
+  sched.AddUlCtrlTti (ctx, 0xFF);
+}
+
+} // namespace mmwave
+
+} // namespace ns3
+
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_FLOW_POLICY_H_ */
@@ -0,0 +1,1236 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2011 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*   Author: Marco Miozzo <marco.miozzo@cttc.es>
+*           Nicola Baldo  <nbaldo@cttc.es>
+*
+*   Modified by: Marco Mezzavilla < mezzavilla@nyu.edu>
+*                         Sourjya Dutta <sdutta@nyu.edu>
+*                         Russell Ford <russell.ford@nyu.edu>
+*                         Menglei Zhang <menglei@nyu.edu>
+*/
+
+
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_ENGINE_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_ENGINE_H_
+
+
+#include "mmwave-mac-sched-sap.h"
+#include "mmwave-mac-csched-sap.h"
+#include "mmwave-mac-scheduler.h"
+#include "mmwave-amc.h"
+#include "mmwave-spectrum-value-helper.h"
+#include <ns3/log.h>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <utility>
+
+namespace ns3 {
+
+namespace mmwave {
+
+class MmWaveFlexTtiFlowPolicy;
+
+template <class Policy>
+class MmWaveFlexTtiEngineSchedSapProvider;
+
+template <class Policy>
+class MmWaveFlexTtiEngineCschedSapProvider;
+
+/**
+ * \ingroup mmwave
+ * \brief State of the slot being scheduled by a flex-TTI scheduler
+ */
+struct MmWaveFlexTtiSlotContext
+{
+  MmWaveMacSchedSapUser::SchedConfigIndParameters m_ret;
+  int m_symAvail;                      // data symbols left in the slot
+  uint8_t m_ttiIdx;                    // index of the next TTI
+  uint8_t m_symIdx;                    // first free symbol
+  std::vector <uint16_t> m_retxRntis;  // UEs with a HARQ retx in this slot, sorted
+};
+
+/**
+ * \ingroup mmwave
+ * \brief Scheduler core shared by the flex-TTI TDMA schedulers
+ *
+ * The engine implements the SCHED/CSCHED SAPs, the CQI and HARQ bookkeeping
+ * and the scheduling of HARQ retransmissions, which are identical for all the
+ * flex-TTI schedulers. The allocation of the symbols left for new data is
+ * delegated to the compile-time \p Policy, which must provide:
+ *
+ * - a `UeInfo` type, stored for every UE next to the engine state;
+ * - ConfigureUe, ConfigureLc, ReleaseLc and ReleaseUe, called on the
+ *   corresponding CSCHED primitives;
+ * - UpdateDlRlcBuffer and UpdateBsr, called on RLC buffer status and BSR reports;
+ * - UpdateCqi, called when a DL or UL CQI of a UE is reported or expires;
+ * - ScheduleNewData, called once per slot after the HARQ retransmissions
+ *   have been placed. It must close the slot with AddUlCtrlTti.
+ *
+ * All the per-UE state is kept in a single array indexed by RNTI.
+ */
+template <class Policy>
+class MmWaveFlexTtiMacSchedulerEngine : public MmWaveMacScheduler
+{
+public:
+  typedef std::vector < uint8_t > HarqProcessesStatus_t;
+  typedef std::vector < uint8_t > HarqProcessesTimer_t;
+  typedef std::vector < DciInfoElementTdma > HarqProcessesDciInfoList_t;
+  typedef std::vector < std::vector <struct RlcPduInfo> > DlHarqRlcPduList_t;       // vector of the LCs per per UE HARQ process
+
+  /**
+   * Per-UE state, one element per RNTI in MmWaveFlexTtiMacSchedulerEngine::m_ues
+   */
+  struct UeState
+  {
+    UeState ()
+      : m_known (false),
+        m_harqConfigured (false),
+        m_dlCqiValid (false),
+        m_dlCqi (0),
+        m_dlCqiTimer (0),
+        m_ulCqiValid (false),
+        m_ulNumSym (0),
+        m_ulTbSize (0),
+        m_ulCqiTimer (0),
+        m_ulCqiWb (0),
+        m_ulMcsWb (0),
+        m_dlSymbolsRetx (0),
+        m_ulSymbolsRetx (0)
+    {
+    }
+
+    bool            m_known;             // the RNTI is listed in m_rntis
+    bool            m_harqConfigured;    // the HARQ processes below are allocated (UE configured and not released)
+
+    bool            m_dlCqiValid;
+    uint8_t         m_dlCqi;             // last DL wideband CQI
+    uint32_t        m_dlCqiTimer;        // TTIs before the DL CQI expires
+
+    bool            m_ulCqiValid;
+    std::vector <double> m_ulSinr;       // last UL SINR per chunk
+    uint8_t         m_ulNumSym;
+    uint32_t        m_ulTbSize;
+    uint32_t        m_ulCqiTimer;        // TTIs before the UL CQI expires
+    uint8_t         m_ulCqiWb;           // wideband CQI of m_ulSinr
+    uint8_t         m_ulMcsWb;           // wideband MCS of m_ulSinr
+
+    //HARQ status
+    // 0: process Id available
+    // x>0: process Id equal to `x` trasmission count
+    HarqProcessesStatus_t m_dlHarqStatus;
+    HarqProcessesTimer_t m_dlHarqTimer;
+    HarqProcessesDciInfoList_t m_dlHarqDci;
+    DlHarqRlcPduList_t m_dlHarqRlcPdu;
+    HarqProcessesStatus_t m_ulHarqStatus;
+    HarqProcessesTimer_t m_ulHarqTimer;
+    HarqProcessesDciInfoList_t m_ulHarqDci;
+
+    uint8_t         m_dlSymbolsRetx;     // DL symbols taken by a HARQ retx in the current slot
+    uint8_t         m_ulSymbolsRetx;     // UL symbols taken by a HARQ retx in the current slot
+
+    typename Policy::UeInfo m_sched;     // policy-specific state
+  };
+
+  typedef MmWaveFlexTtiSlotContext SlotContext;
+
+  MmWaveFlexTtiMacSchedulerEngine ();
+
+  virtual ~MmWaveFlexTtiMacSchedulerEngine ();
+  virtual void DoDispose (void) override;
+
+  virtual void SetMacSchedSapUser (MmWaveMacSchedSapUser* sap) override;
+  virtual void SetMacCschedSapUser (MmWaveMacCschedSapUser* s) override;
+
+  virtual MmWaveMacSchedSapProvider* GetMacSchedSapProvider () override;
+  virtual MmWaveMacCschedSapProvider* GetMacCschedSapProvider () override;
+
+  virtual void ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> config) override;
+
+  virtual void PrepareSlot (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params) override;
+  virtual void DeliverSlot (void) override;
+
+  friend Policy;
+  friend class MmWaveFlexTtiFlowPolicy;
+  friend class MmWaveFlexTtiEngineSchedSapProvider<Policy>;
+  friend class MmWaveFlexTtiEngineCschedSapProvider<Policy>;
+
+protected:
+  /**
+   * \brief Get the state of a UE, creating it if needed
+   *
+   * May reallocate m_ues: references to other UEs are invalidated.
+   */
+  UeState& GetUe (uint16_t rnti);
+
+  /**
+   * \return the state of a UE, or 0 if the RNTI is unknown
+   */
+  UeState* FindUe (uint16_t rnti);
+
+  /**
+   * \brief Wideband UL CQI and MCS of a UE from its last UL SINR report
+   * \pre ue.m_ulCqiValid
+   */
+  uint8_t GetUlCqi (UeState &ue, uint8_t &mcs);
+
+  /**
+   * \brief Compute the wideband UL CQI and MCS of a UE from m_ulSinr
+   *
+   * Called when the report is received rather than when the slot is
+   * scheduled, since it uses the spectrum model shared by all the cells.
+   */
+  void UpdateUlCqi (UeState &ue);
+
+  uint8_t UpdateDlHarqProcessId (uint16_t rnti);
+  uint8_t UpdateUlHarqProcessId (uint16_t rnti);
+
+  /**
+   * \brief Create the DCI of a new transmission and assign its HARQ process
+   * \param format 0 for DL, 1 for UL
+   */
+  DciInfoElementTdma CreateDci (uint16_t rnti, uint8_t format, uint8_t symStart, uint8_t numSym, uint8_t mcs);
+
+  /**
+   * \brief Add a DL data TTI to the slot and store it in the HARQ buffer
+   * \param reorder insert the TTI before the first UL TTI of the slot
+   */
+  void AddDlTti (SlotContext &ctx, TtiAllocInfo &ttiInfo, bool reorder);
+
+  /**
+   * \brief Add an UL data TTI to the slot and store it in the HARQ buffer
+   * \param allocSfn key under which the allocation is recalled when the UL-CQI is received
+   */
+  void AddUlTti (SlotContext &ctx, const TtiAllocInfo &ttiInfo, const SfnSf &allocSfn);
+
+  /**
+   * \brief Add the UL control TTI at the end of the slot
+   */
+  void AddUlCtrlTti (SlotContext &ctx, uint8_t ttiIdx);
+
+  uint32_t
+  BsrId2BufferSize (uint8_t val)
+  {
+    NS_ABORT_MSG_UNLESS (val < 64, "val = " << val << " is out of range");
+    return BufferSizeLevelBsrTable[val];
+  }
+
+  //
+  // Implementation of the CSCHED API primitives
+  // (See 4.1 for description of the primitives)
+  //
+
+  void DoCschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
+
+  void DoCschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
+
+  void DoCschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+
+  void DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+
+  void DoCschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
+
+  //
+  // Implementation of the SCHED API primitives
+  // (See 4.2 for description of the primitives)
+  //
+
+  void DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+
+  void DoSchedDlCqiInfoReq (const MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);
+
+  void DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
+
+  void DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
+
+  void DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+
+  void DoSchedSetMcs (int mcs);
+
+  void RefreshDlCqiMaps (void);
+  void RefreshUlCqiMaps (void);
+
+  /**
+   * \brief Refresh HARQ processes according to the timers
+   *
+   */
+  void RefreshHarqProcesses ();
+
+  /**
+   * \brief Place the pending HARQ retransmissions at the beginning of the slot
+   */
+  void ScheduleHarqRetx (SlotContext &ctx, const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+
+  Ptr<MmWaveAmc> m_amc;
+
+  std::vector <UeState> m_ues;         // per-UE state, indexed by RNTI
+  std::vector <uint16_t> m_rntis;      // RNTIs with an entry in m_ues, sorted
+
+  uint32_t m_cqiTimersThreshold;       // # of TTIs for which a CQI can be considered valid
+
+  uint8_t m_tbUid;
+
+  MmWaveMacSchedSapProvider* m_macSchedSapProvider;
+  MmWaveMacSchedSapUser* m_macSchedSapUser;
+  MmWaveMacCschedSapUser* m_macCschedSapUser;
+  MmWaveMacCschedSapProvider* m_macCschedSapProvider;
+
+  MmWaveMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
+
+  MmWaveMacSchedSapUser::SchedConfigIndParameters m_preparedSlot;   // allocation computed by PrepareSlot
+
+  struct AllocMapElem
+  {
+    AllocMapElem (uint16_t rnti, uint8_t nSym, uint32_t tbs)
+      : m_rnti (rnti),
+        m_numSym (nSym),
+        m_tbSize (tbs)
+    {
+    }
+
+    uint16_t m_rnti;                   // UE allocated on the whole bandwidth (TDMA)
+    uint8_t m_numSym;
+    uint32_t m_tbSize;
+  };
+  /*
+   * Map of previous UL allocations
+   * (used to retrieve info from UL-CQI)
+   */
+  std::map <uint32_t, struct AllocMapElem> m_ulAllocationMap;
+
+  // HARQ attributes
+  /**
+   * m_harqOn when false inhibit te HARQ mechanisms (by default active)
+   */
+  bool m_harqOn;
+  std::vector <DlHarqInfo> m_dlHarqInfoList;       // HARQ retx buffered
+  std::vector <UlHarqInfo> m_ulHarqInfoList;       // HARQ retx buffered
+
+  static const unsigned m_macHdrSize = 0;
+  static const unsigned m_subHdrSize = 4;
+  static const unsigned m_rlcHdrSize = 3;
+
+  bool            m_fixedMcsDl;
+  bool            m_fixedMcsUl;
+  uint8_t m_mcsDefaultDl;
+  uint8_t m_mcsDefaultUl;
+
+  bool m_dlOnly;
+  bool m_ulOnly;       //for testing
+
+  bool m_fixedTti;                      // one slot per TTI
+  uint8_t m_symPerSlot;       // symbols per slot
+
+  Policy m_policy;
+
+  NS_LOG_TEMPLATE_DECLARE;     //!< the log component
+};
+
+template <class Policy>
+class MmWaveFlexTtiEngineCschedSapProvider : public MmWaveMacCschedSapProvider
+{
+public:
+  MmWaveFlexTtiEngineCschedSapProvider (MmWaveFlexTtiMacSchedulerEngine<Policy>* scheduler)
+    : m_scheduler (scheduler)
+  {
+  }
+
+  // inherited from MmWaveMacCschedSapProvider
+  virtual void
+  CschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedCellConfigReq (params);
+  }
+  virtual void
+  CschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedUeConfigReq (params);
+  }
+  virtual void
+  CschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+  {
+    m_scheduler->DoCschedLcConfigReq (params);
+  }
+  virtual void
+  CschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+  {
+    m_scheduler->DoCschedLcReleaseReq (params);
+  }
+  virtual void
+  CschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+  {
+    m_scheduler->DoCschedUeReleaseReq (params);
+  }
+
+private:
+  MmWaveFlexTtiMacSchedulerEngine<Policy>* m_scheduler;
+};
+
+template <class Policy>
+class MmWaveFlexTtiEngineSchedSapProvider : public MmWaveMacSchedSapProvider
+{
+public:
+  MmWaveFlexTtiEngineSchedSapProvider (MmWaveFlexTtiMacSchedulerEngine<Policy>* sched)
+    : m_scheduler (sched)
+  {
+  }
+
+  virtual void
+  SchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+  {
+    m_scheduler->DoSchedDlRlcBufferReq (params);
+  }
+  virtual void
+  SchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+  {
+    m_scheduler->DoSchedTriggerReq (params);
+  }
+  virtual void
+  SchedDlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedDlCqiInfoReq (params);
+  }
+  virtual void
+  SchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedUlCqiInfoReq (params);
+  }
+  virtual void
+  SchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+  {
+    m_scheduler->DoSchedUlMacCtrlInfoReq (params);
+  }
+  virtual void
+  SchedSetMcs (int mcs)
+  {
+    m_scheduler->DoSchedSetMcs (mcs);
+  }
+
+private:
+  MmWaveFlexTtiMacSchedulerEngine<Policy>* m_scheduler;
+};
+
+
+template <class Policy>
+const unsigned MmWaveFlexTtiMacSchedulerEngine<Policy>::m_macHdrSize;
+template <class Policy>
+const unsigned MmWaveFlexTtiMacSchedulerEngine<Policy>::m_subHdrSize;
+template <class Policy>
+const unsigned MmWaveFlexTtiMacSchedulerEngine<Policy>::m_rlcHdrSize;
+
+template <class Policy>
+MmWaveFlexTtiMacSchedulerEngine<Policy>::MmWaveFlexTtiMacSchedulerEngine ()
+  : m_tbUid (0),
+    m_macSchedSapUser (0),
+    m_macCschedSapUser (0),
+    NS_LOG_TEMPLATE_DEFINE ("MmWaveFlexTtiMacSchedulerEngine")
+{
+  NS_LOG_FUNCTION (this);
+  m_macSchedSapProvider = new MmWaveFlexTtiEngineSchedSapProvider<Policy> (this);
+  m_macCschedSapProvider = new MmWaveFlexTtiEngineCschedSapProvider<Policy> (this);
+}
+
+template <class Policy>
+MmWaveFlexTtiMacSchedulerEngine<Policy>::~MmWaveFlexTtiMacSchedulerEngine ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_ues.clear ();
+  m_rntis.clear ();
+  m_ulAllocationMap.clear ();
+  m_dlHarqInfoList.clear ();
+  m_ulHarqInfoList.clear ();
+  delete m_macCschedSapProvider;
+  delete m_macSchedSapProvider;
+  MmWaveMacScheduler::DoDispose ();
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::SetMacSchedSapUser (MmWaveMacSchedSapUser* sap)
+{
+  m_macSchedSapUser = sap;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::SetMacCschedSapUser (MmWaveMacCschedSapUser* sap)
+{
+  m_macCschedSapUser = sap;
+}
+
+template <class Policy>
+MmWaveMacSchedSapProvider*
+MmWaveFlexTtiMacSchedulerEngine<Policy>::GetMacSchedSapProvider ()
+{
+  return m_macSchedSapProvider;
+}
+
+template <class Policy>
+MmWaveMacCschedSapProvider*
+MmWaveFlexTtiMacSchedulerEngine<Policy>::GetMacCschedSapProvider ()
+{
+  return m_macCschedSapProvider;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> config)
+{
+  m_phyMacConfig = config;
+  m_amc = CreateObject <MmWaveAmc> (m_phyMacConfig);
+}
+
+template <class Policy>
+typename MmWaveFlexTtiMacSchedulerEngine<Policy>::UeState&
+MmWaveFlexTtiMacSchedulerEngine<Policy>::GetUe (uint16_t rnti)
+{
+  if (rnti >= m_ues.size ())
+    {
+      m_ues.resize (rnti + 1);
+    }
+  UeState &ue = m_ues[rnti];
+  if (!ue.m_known)
+    {
+      ue.m_known = true;
+      m_rntis.insert (std::lower_bound (m_rntis.begin (), m_rntis.end (), rnti), rnti);
+    }
+  return ue;
+}
+
+template <class Policy>
+typename MmWaveFlexTtiMacSchedulerEngine<Policy>::UeState*
+MmWaveFlexTtiMacSchedulerEngine<Policy>::FindUe (uint16_t rnti)
+{
+  if (rnti < m_ues.size () && m_ues[rnti].m_known)
+    {
+      return &m_ues[rnti];
+    }
+  return 0;
+}
+
+template <class Policy>
+uint8_t
+MmWaveFlexTtiMacSchedulerEngine<Policy>::GetUlCqi (UeState &ue, uint8_t &mcs)
+{
+  NS_ASSERT (ue.m_ulCqiValid);
+  mcs = ue.m_ulMcsWb;
+  return ue.m_ulCqiWb;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::UpdateUlCqi (UeState &ue)
+{
+  // translate vector of doubles to SpectrumValue's
+  SpectrumValue specVals (MmWaveSpectrumValueHelper::GetSpectrumModel (m_phyMacConfig));
+  Values::iterator specIt = specVals.ValuesBegin ();
+  for (uint32_t ichunk = 0; ichunk < m_phyMacConfig->GetNumRb (); ichunk++)
+    {
+      NS_ASSERT (specIt != specVals.ValuesEnd ());
+      *specIt = ue.m_ulSinr.at (ichunk);                   //sinrLin;
+      specIt++;
+    }
+  ue.m_ulCqiWb = m_amc->CreateCqiFeedbackWbTdma (specVals, ue.m_ulMcsWb);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << params.m_rnti << (uint32_t) params.m_logicalChannelIdentity);
+  m_policy.UpdateDlRlcBuffer (*this, params);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedDlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (unsigned int i = 0; i < params.m_cqiList.size (); i++)
+    {
+      if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::WB )
+        {
+          // wideband CQI reporting, only codeword 0 at this stage (SISO)
+          UeState &ue = GetUe (params.m_cqiList.at (i).m_rnti);
+          ue.m_dlCqiValid = true;
+          ue.m_dlCqi = params.m_cqiList.at (i).m_wbCqi;
+          ue.m_dlCqiTimer = m_cqiTimersThreshold;
+          m_policy.UpdateCqi (*this, params.m_cqiList.at (i).m_rnti);
+        }
+      else if ( params.m_cqiList.at (i).m_cqiType == DlCqiInfo::SB )
+        {
+          // subband CQI reporting high layer configured
+          // Not used by the flex-TTI schedulers
+        }
+      else
+        {
+          NS_LOG_ERROR (this << " CQI type unknown");
+        }
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  switch (params.m_ulCqi.m_type)
+    {
+    case UlCqiInfo::PUSCH:
+      {
+        typename std::map <uint32_t, struct AllocMapElem>::iterator itMap;
+        itMap = m_ulAllocationMap.find (params.m_sfnSf.Encode ());
+        if (itMap == m_ulAllocationMap.end ())
+          {
+            NS_LOG_INFO (this << " Does not find info on allocation, size : " << m_ulAllocationMap.size ());
+            return;
+          }
+        // TDMA: the UE was allocated the whole bandwidth
+        uint16_t rnti = itMap->second.m_rnti;
+        UeState &ue = GetUe (rnti);
+        ue.m_ulSinr.resize (m_phyMacConfig->GetNumRb ());
+        for (unsigned i = 0; i < m_phyMacConfig->GetNumRb (); i++)
+          {
+            ue.m_ulSinr[i] = params.m_ulCqi.m_sinr.at (i);
+          }
+        ue.m_ulCqiValid = true;
+        UpdateUlCqi (ue);
+        ue.m_ulNumSym = itMap->second.m_numSym;
+        ue.m_ulTbSize = itMap->second.m_tbSize;
+        ue.m_ulCqiTimer = m_cqiTimersThreshold;
+        m_policy.UpdateCqi (*this, rnti);
+        NS_LOG_INFO ("UL CQI report for RNTI " << rnti << " frame " << params.m_sfnSf.m_frameNum << " subframe " << +params.m_sfnSf.m_sfNum <<
+                     " slot " << +params.m_sfnSf.m_slotNum << " startSym " << +params.m_sfnSf.m_symStart);
+        // remove obsolete info on allocation
+        m_ulAllocationMap.erase (itMap);
+      }
+      break;
+    default:
+      NS_FATAL_ERROR ("Unknown type of UL-CQI");
+    }
+  return;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  for (unsigned int i = 0; i < params.m_macCeList.size (); i++)
+    {
+      if ( params.m_macCeList.at (i).m_macCeType == MacCeElement::BSR )
+        {
+          m_policy.UpdateBsr (*this, params.m_macCeList.at (i));
+        }
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedSetMcs (int mcs)
+{
+  if (mcs >= 0 && mcs <= 28)
+    {
+      m_mcsDefaultDl = mcs;
+      m_mcsDefaultUl = mcs;
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::RefreshDlCqiMaps (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint16_t rnti : m_rntis)
+    {
+      UeState &ue = m_ues[rnti];
+      if (!ue.m_dlCqiValid)
+        {
+          continue;
+        }
+      if (ue.m_dlCqiTimer == 0)
+        {
+          NS_LOG_INFO (this << " P10-CQI exired for user " << rnti);
+          ue.m_dlCqiValid = false;
+          m_policy.UpdateCqi (*this, rnti);
+        }
+      else
+        {
+          ue.m_dlCqiTimer--;
+        }
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::RefreshUlCqiMaps (void)
+{
+  for (uint16_t rnti : m_rntis)
+    {
+      UeState &ue = m_ues[rnti];
+      if (!ue.m_ulCqiValid)
+        {
+          continue;
+        }
+      if (ue.m_ulCqiTimer == 0)
+        {
+          NS_LOG_INFO (this << " UL-CQI expired for user " << rnti);
+          ue.m_ulCqiValid = false;
+          ue.m_ulSinr.clear ();
+          m_policy.UpdateCqi (*this, rnti);
+        }
+      else
+        {
+          ue.m_ulCqiTimer--;
+        }
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::RefreshHarqProcesses ()
+{
+  NS_LOG_FUNCTION (this);
+
+  for (uint16_t rnti : m_rntis)
+    {
+      UeState &ue = m_ues[rnti];
+      if (!ue.m_harqConfigured)
+        {
+          continue;
+        }
+      for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
+        {
+          if (ue.m_dlHarqTimer.at (i) == m_phyMacConfig->GetHarqTimeout ())
+            {             // reset HARQ process
+              NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << rnti);
+              ue.m_dlHarqStatus.at (i) = 0;
+              ue.m_dlHarqTimer.at (i) = 0;
+            }
+          else
+            {
+              ue.m_dlHarqTimer.at (i)++;
+            }
+        }
+      for (uint16_t i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
+        {
+          if (ue.m_ulHarqTimer.at (i) == m_phyMacConfig->GetHarqTimeout ())
+            {             // reset HARQ process
+              NS_LOG_INFO (this << " Reset HARQ proc " << i << " for RNTI " << rnti);
+              ue.m_ulHarqStatus.at (i) = 0;
+              ue.m_ulHarqTimer.at (i) = 0;
+            }
+          else
+            {
+              ue.m_ulHarqTimer.at (i)++;
+            }
+        }
+    }
+}
+
+template <class Policy>
+uint8_t
+MmWaveFlexTtiMacSchedulerEngine<Policy>::UpdateDlHarqProcessId (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+
+  if (m_harqOn == false)
+    {
+      uint8_t tbUid = m_tbUid;
+      m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess ();
+      return tbUid;
+    }
+
+  UeState *ue = FindUe (rnti);
+  if (ue == 0 || !ue->m_harqConfigured)
+    {
+      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
+    }
+
+  // search for available process ID, if none available return numHarqProcess
+  uint8_t harqId = m_phyMacConfig->GetNumHarqProcess ();
+  for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
+    {
+      if (ue->m_dlHarqStatus[i] == 0)
+        {
+          ue->m_dlHarqStatus[i] = 1;
+          harqId = i;
+          break;
+        }
+    }
+  return harqId;
+}
+
+template <class Policy>
+uint8_t
+MmWaveFlexTtiMacSchedulerEngine<Policy>::UpdateUlHarqProcessId (uint16_t rnti)
+{
+  NS_LOG_FUNCTION (this << rnti);
+
+  if (m_harqOn == false)
+    {
+      uint8_t tbUid = m_tbUid;
+      m_tbUid = (m_tbUid + 1) % m_phyMacConfig->GetNumHarqProcess ();
+      return tbUid;
+    }
+
+  UeState *ue = FindUe (rnti);
+  if (ue == 0 || !ue->m_harqConfigured)
+    {
+      NS_FATAL_ERROR ("No Process Id Statusfound for this RNTI " << rnti);
+    }
+
+  // search for available process ID, if none available return numHarqProcess
+  uint8_t harqId = m_phyMacConfig->GetNumHarqProcess ();
+  for (unsigned i = 0; i < m_phyMacConfig->GetNumHarqProcess (); i++)
+    {
+      if (ue->m_ulHarqStatus[i] == 0)
+        {
+          ue->m_ulHarqStatus[i] = 1;
+          harqId = i;
+          break;
+        }
+    }
+  return harqId;
+}
+
+template <class Policy>
+DciInfoElementTdma
+MmWaveFlexTtiMacSchedulerEngine<Policy>::CreateDci (uint16_t rnti, uint8_t format, uint8_t symStart, uint8_t numSym, uint8_t mcs)
+{
+  DciInfoElementTdma dci;
+  dci.m_rnti = rnti;
+  dci.m_format = format;
+  dci.m_symStart = symStart;
+  dci.m_numSym = numSym;
+  dci.m_mcs = mcs;
+  dci.m_ndi = 1;
+  dci.m_rv = 0;
+  dci.m_tbSize = m_amc->CalculateTbSize (dci.m_mcs, dci.m_numSym);
+  NS_ASSERT (symStart + numSym <= m_phyMacConfig->GetSymbPerSlot () - m_phyMacConfig->GetUlCtrlSymbols ());
+  if (format == 0)
+    {
+      dci.m_harqProcess = UpdateDlHarqProcessId (rnti);
+    }
+  else
+    {
+      dci.m_harqProcess = UpdateUlHarqProcessId (rnti);
+    }
+  NS_ASSERT (dci.m_harqProcess < m_phyMacConfig->GetNumHarqProcess ());
+  NS_LOG_DEBUG ("UE" << rnti << (format == 0 ? " DL" : " UL") << " harqId " << +dci.m_harqProcess << " HARQ process assigned");
+  return dci;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::AddDlTti (SlotContext &ctx, TtiAllocInfo &ttiInfo, bool reorder)
+{
+  const DciInfoElementTdma &dci = ttiInfo.m_dci;
+  NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets DL OFDM symbols " << +dci.m_symStart << "-" << +(dci.m_symStart + dci.m_numSym - 1) <<
+                " tbs " << dci.m_tbSize << " mcs " << +dci.m_mcs << " harqId " << +dci.m_harqProcess << " rv " << +dci.m_rv <<
+                " in frame " << ctx.m_ret.m_sfnSf.m_frameNum << " subframe " << +ctx.m_ret.m_sfnSf.m_sfNum << " slot " << +ctx.m_ret.m_sfnSf.m_slotNum);
+
+  if (m_harqOn == true)
+    {                   // store DCI and RLC PDU list for HARQ
+      UeState *ue = FindUe (dci.m_rnti);
+      if (ue == 0 || !ue->m_harqConfigured)
+        {
+          NS_FATAL_ERROR ("Unable to find RNTI entry in DCI HARQ buffer for RNTI " << dci.m_rnti);
+        }
+      ue->m_dlHarqDci.at (dci.m_harqProcess) = dci;
+      // refresh timer
+      ue->m_dlHarqTimer.at (dci.m_harqProcess) = 0;
+      std::vector <struct RlcPduInfo> &harqPdus = ue->m_dlHarqRlcPdu.at (dci.m_harqProcess);
+      harqPdus.insert (harqPdus.end (), ttiInfo.m_rlcPduInfo.begin (), ttiInfo.m_rlcPduInfo.end ());
+    }
+
+  ctx.m_ret.m_slotAllocInfo.m_numSymAlloc += dci.m_numSym;
+  std::deque <TtiAllocInfo> &ttis = ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo;
+  if (reorder)
+    {
+      // reorder/reindex slots to maintain DL before UL slot order
+      for (unsigned iTti = 0; iTti < ttis.size (); iTti++)
+        {
+          if (ttis[iTti].m_tddMode == TtiAllocInfo::UL_slotAllocInfo)
+            {
+              ttiInfo.m_ttiIdx = ttis[iTti].m_ttiIdx;
+              ttiInfo.m_dci.m_symStart = ttis[iTti].m_dci.m_symStart;
+              ttis.insert (ttis.begin () + iTti, ttiInfo);
+              for (unsigned jTti = iTti + 1; jTti < ttis.size (); jTti++)
+                {
+                  ttis[jTti].m_ttiIdx++;                             // increase indices of UL slots
+                  ttis[jTti].m_dci.m_symStart = ttis[jTti - 1].m_dci.m_symStart + ttis[jTti - 1].m_dci.m_numSym;
+                }
+              return;
+            }
+        }
+    }
+  ttis.push_back (ttiInfo);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::AddUlTti (SlotContext &ctx, const TtiAllocInfo &ttiInfo, const SfnSf &allocSfn)
+{
+  const DciInfoElementTdma &dci = ttiInfo.m_dci;
+  NS_LOG_DEBUG ("UE" << dci.m_rnti << " gets UL OFDM symbols " << +dci.m_symStart << "-" << +(dci.m_symStart + dci.m_numSym - 1) <<
+                " tbs " << dci.m_tbSize << " mcs " << +dci.m_mcs << " harqId " << +dci.m_harqProcess << " rv " << +dci.m_rv <<
+                " in frame " << ctx.m_ret.m_sfnSf.m_frameNum << " subframe " << +ctx.m_ret.m_sfnSf.m_sfNum << " slot " << +ctx.m_ret.m_sfnSf.m_slotNum);
+
+  ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back (ttiInfo);
+  ctx.m_ret.m_slotAllocInfo.m_numSymAlloc += dci.m_numSym;
+  // insert into allocation map to recall previous allocations upon receiving UL-CQI
+  m_ulAllocationMap.insert (std::pair<uint32_t, struct AllocMapElem> (allocSfn.Encode (), AllocMapElem (dci.m_rnti, dci.m_numSym, dci.m_tbSize)));
+
+  if (m_harqOn == true)
+    {
+      UeState *ue = FindUe (dci.m_rnti);
+      if (ue == 0 || !ue->m_harqConfigured)
+        {
+          NS_FATAL_ERROR ("Unable to find RNTI entry in UL DCI HARQ buffer for RNTI " << dci.m_rnti);
+        }
+      ue->m_ulHarqDci.at (dci.m_harqProcess) = dci;
+      // Update HARQ process status (RV 0)
+      NS_ASSERT (ue->m_ulHarqStatus[dci.m_harqProcess] > 0);
+      // refresh timer
+      ue->m_ulHarqTimer.at (dci.m_harqProcess) = 0;
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::AddUlCtrlTti (SlotContext &ctx, uint8_t ttiIdx)
+{
+  // Add TTI for UL control at the end of the slot
+  TtiAllocInfo ulCtrlTti (ttiIdx, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
+  ulCtrlTti.m_dci.m_numSym = 1;
+  ulCtrlTti.m_dci.m_symStart = m_phyMacConfig->GetSymbPerSlot () - 1;
+  ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back (ulCtrlTti);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::ScheduleHarqRetx (SlotContext &ctx, const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+  // retrieve past HARQ retx buffered
+  m_dlHarqInfoList.insert (m_dlHarqInfoList.end (), params.m_dlHarqInfoList.begin (), params.m_dlHarqInfoList.end ());
+  m_ulHarqInfoList.insert (m_ulHarqInfoList.end (), params.m_ulHarqInfoList.begin (), params.m_ulHarqInfoList.end ());
+
+  if (m_harqOn == false)                // Ignore HARQ feedback
+    {
+      m_dlHarqInfoList.clear ();
+      m_ulHarqInfoList.clear ();
+      return;
+    }
+
+  // Process DL HARQ feedback and assign slots for RETX if resources available
+  std::vector <struct DlHarqInfo> dlInfoListUntxed;            // TBs not able to be retransmitted in this sf
+  std::vector <struct UlHarqInfo> ulInfoListUntxed;
+
+  for (unsigned i = 0; i < m_dlHarqInfoList.size (); i++)
+    {
+      if (ctx.m_symAvail == 0)
+        {
+          break;                    // no symbols left to allocate
+        }
+      uint8_t harqId = m_dlHarqInfoList.at (i).m_harqProcessId;
+      uint16_t rnti = m_dlHarqInfoList.at (i).m_rnti;
+      UeState *ue = FindUe (rnti);
+      if (ue == 0 || !ue->m_harqConfigured)
+        {
+          NS_FATAL_ERROR ("No HARQ status info found for UE " << rnti);
+        }
+      if (m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::ACK || ue->m_dlHarqStatus.at (harqId) == 0)
+        {             // acknowledgment or process timeout, reset process
+          ue->m_dlHarqStatus.at (harqId) = 0;                      // release process ID
+          ue->m_dlHarqRlcPdu.at (harqId).clear ();                 // clear RLC buffers
+          continue;
+        }
+      else if (m_dlHarqInfoList.at (i).m_harqStatus == DlHarqInfo::NACK)
+        {
+          DciInfoElementTdma dciInfoReTx = ue->m_dlHarqDci.at (harqId);
+          NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
+          NS_ASSERT (ue->m_dlHarqStatus.at (harqId) - 1 == dciInfoReTx.m_rv);
+          if (dciInfoReTx.m_rv == 3)                   // maximum number of retx reached -> drop process
+            {
+              NS_LOG_INFO ("Max number of retransmissions reached -> drop process");
+              ue->m_dlHarqStatus.at (harqId) = 0;
+              ue->m_dlHarqRlcPdu.at (harqId).clear ();
+              continue;
+            }
+
+          // allocate retx if enough symbols are available
+          if (ctx.m_symAvail >= dciInfoReTx.m_numSym)
+            {
+              ctx.m_symAvail -= dciInfoReTx.m_numSym;
+              dciInfoReTx.m_symStart = ctx.m_symIdx;
+              ctx.m_symIdx += dciInfoReTx.m_numSym;
+              NS_ASSERT (ctx.m_symIdx <= m_phyMacConfig->GetSymbPerSlot () - m_phyMacConfig->GetUlCtrlSymbols ());
+              dciInfoReTx.m_rv++;
+              dciInfoReTx.m_ndi = 0;
+              ue->m_dlHarqDci.at (harqId) = dciInfoReTx;
+              ue->m_dlHarqStatus.at (harqId) = ue->m_dlHarqStatus.at (harqId) + 1;
+              TtiAllocInfo ttiInfo (ctx.m_ttiIdx++, TtiAllocInfo::DL_slotAllocInfo, TtiAllocInfo::CTRL_DATA, rnti);
+              ttiInfo.m_dci = dciInfoReTx;
+              NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets DL OFDM symbols " << +dciInfoReTx.m_symStart << "-" << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1) <<
+                            " tbs " << dciInfoReTx.m_tbSize << " harqId " << +dciInfoReTx.m_harqProcess <<
+                            " rv " << +dciInfoReTx.m_rv << " in frame " << ctx.m_ret.m_sfnSf.m_frameNum << " subframe " << +ctx.m_ret.m_sfnSf.m_sfNum << " slot " <<
+                            +ctx.m_ret.m_sfnSf.m_slotNum << " RETX");
+              ttiInfo.m_rlcPduInfo = ue->m_dlHarqRlcPdu.at (dciInfoReTx.m_harqProcess);
+              ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back (ttiInfo);
+              ctx.m_ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+              ue->m_dlSymbolsRetx = dciInfoReTx.m_numSym;
+              std::vector <uint16_t>::iterator itRetx = std::lower_bound (ctx.m_retxRntis.begin (), ctx.m_retxRntis.end (), rnti);
+              if (itRetx == ctx.m_retxRntis.end () || *itRetx != rnti)
+                {
+                  ctx.m_retxRntis.insert (itRetx, rnti);
+                }
+            }
+          else
+            {
+              NS_LOG_INFO ("No resource for this retx -> buffer it");
+              dlInfoListUntxed.push_back (m_dlHarqInfoList.at (i));
+            }
+        }
+    }
+
+  m_dlHarqInfoList = dlInfoListUntxed;
+
+  // Process UL HARQ feedback
+  for (uint16_t i = 0; i < m_ulHarqInfoList.size (); i++)
+    {
+      if (ctx.m_symAvail == 0)
+        {
+          break;                    // no symbols left to allocate
+        }
+      UlHarqInfo harqInfo = m_ulHarqInfoList.at (i);
+      uint8_t harqId = harqInfo.m_harqProcessId;
+      uint16_t rnti = harqInfo.m_rnti;
+      UeState *ue = FindUe (rnti);
+      if (ue == 0 || !ue->m_harqConfigured)
+        {
+          NS_LOG_ERROR ("No info found in HARQ buffer for UE (might have changed eNB) " << rnti);
+          continue;
+        }
+      if (harqInfo.m_receptionStatus == UlHarqInfo::Ok || ue->m_ulHarqStatus.at (harqId) == 0)
+        {
+          ue->m_ulHarqStatus.at (harqId) = 0;                        // release process ID
+        }
+      else if (harqInfo.m_receptionStatus == UlHarqInfo::NotOk)
+        {
+          // retx correspondent block: retrieve the UL-DCI
+          DciInfoElementTdma dciInfoReTx = ue->m_ulHarqDci.at (harqId);
+          NS_ASSERT (harqId == dciInfoReTx.m_harqProcess);
+          NS_ASSERT (ue->m_ulHarqStatus.at (harqId) > 0);
+          NS_ASSERT (ue->m_ulHarqStatus.at (harqId) - 1 == dciInfoReTx.m_rv);
+          if (dciInfoReTx.m_rv == 3)
+            {
+              NS_LOG_INFO ("Max number of retransmissions reached (UL)-> drop process");
+              ue->m_ulHarqStatus.at (harqId) = 0;
+              continue;
+            }
+
+          if (ctx.m_symAvail >= dciInfoReTx.m_numSym)
+            {
+              ctx.m_symAvail -= dciInfoReTx.m_numSym;
+              dciInfoReTx.m_symStart = ctx.m_symIdx;
+              ctx.m_symIdx += dciInfoReTx.m_numSym;
+              NS_ASSERT (ctx.m_symIdx <= m_phyMacConfig->GetSymbPerSlot () - m_phyMacConfig->GetUlCtrlSymbols ());
+              dciInfoReTx.m_rv++;
+              dciInfoReTx.m_ndi = 0;
+              ue->m_ulHarqStatus.at (harqId) = ue->m_ulHarqStatus.at (harqId) + 1;
+              ue->m_ulHarqDci.at (harqId) = dciInfoReTx;
+              TtiAllocInfo ttiInfo (ctx.m_ttiIdx++, TtiAllocInfo::UL_slotAllocInfo, TtiAllocInfo::CTRL_DATA, rnti);
+              ttiInfo.m_dci = dciInfoReTx;
+              NS_LOG_DEBUG ("UE" << dciInfoReTx.m_rnti << " gets UL OFDM symbols " << +dciInfoReTx.m_symStart << "-" << +(dciInfoReTx.m_symStart + dciInfoReTx.m_numSym - 1) <<
+                            " tbs " << dciInfoReTx.m_tbSize << " harqId " << +dciInfoReTx.m_harqProcess << " rv " << +dciInfoReTx.m_rv << " in frame " << ctx.m_ret.m_sfnSf.m_frameNum << " subframe "
+                            << +ctx.m_ret.m_sfnSf.m_sfNum << " slot " << +ctx.m_ret.m_sfnSf.m_slotNum << " RETX");
+              ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back (ttiInfo);
+              ctx.m_ret.m_slotAllocInfo.m_numSymAlloc += dciInfoReTx.m_numSym;
+              ue->m_ulSymbolsRetx = dciInfoReTx.m_numSym;
+              std::vector <uint16_t>::iterator itRetx = std::lower_bound (ctx.m_retxRntis.begin (), ctx.m_retxRntis.end (), rnti);
+              if (itRetx == ctx.m_retxRntis.end () || *itRetx != rnti)
+                {
+                  ctx.m_retxRntis.insert (itRetx, rnti);
+                }
+            }
+          else
+            {
+              ulInfoListUntxed.push_back (m_ulHarqInfoList.at (i));
+            }
+        }
+    }
+
+  m_ulHarqInfoList = ulInfoListUntxed;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  PrepareSlot (params);
+  DeliverSlot ();
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::PrepareSlot (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+
+  SlotContext ctx;
+  ctx.m_ret.m_sfnSf = params.m_snfSf;
+  ctx.m_ret.m_slotAllocInfo.m_sfnSf = ctx.m_ret.m_sfnSf;
+
+  NS_LOG_DEBUG ("Creating scheduling allocation info for: frame " << params.m_snfSf.m_frameNum << " subframe "
+                << +params.m_snfSf.m_sfNum << " slot " << +params.m_snfSf.m_slotNum);
+
+  // Add TTI for DL control at the beginning of the slot
+  TtiAllocInfo dlCtrlSlot (0, TtiAllocInfo::DL_slotAllocInfo, TtiAllocInfo::CTRL, 0);
+  dlCtrlSlot.m_dci.m_numSym = 1;
+  dlCtrlSlot.m_dci.m_symStart = 0;
+  ctx.m_ret.m_slotAllocInfo.m_ttiAllocInfo.push_back (dlCtrlSlot);
+  int resvCtrl = m_phyMacConfig->GetDlCtrlSymbols () + m_phyMacConfig->GetUlCtrlSymbols ();
+  ctx.m_symAvail = m_phyMacConfig->GetSymbPerSlot () - resvCtrl;
+  ctx.m_ttiIdx = 1;
+  ctx.m_symIdx = m_phyMacConfig->GetDlCtrlSymbols ();      // symbols reserved for control at beginning of subframe
+
+  // process received CQIs
+  RefreshDlCqiMaps ();
+  RefreshUlCqiMaps ();
+
+  // Process DL HARQ feedback
+  RefreshHarqProcesses ();
+
+  ScheduleHarqRetx (ctx, params);
+
+  // ********************* END OF HARQ SECTION, START OF NEW DATA SCHEDULING ********************* //
+
+  m_policy.ScheduleNewData (*this, ctx);
+
+  m_preparedSlot = std::move (ctx.m_ret);
+
+  // reset the retx info for the next scheduler call
+  for (uint16_t rnti : ctx.m_retxRntis)
+    {
+      m_ues[rnti].m_dlSymbolsRetx = 0;
+      m_ues[rnti].m_ulSymbolsRetx = 0;
+    }
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DeliverSlot (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_macSchedSapUser->SchedConfigInd (m_preparedSlot);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoCschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  // Read the subset of parameters used
+  m_cschedCellConfig = params;
+  MmWaveMacCschedSapUser::CschedUeConfigCnfParameters cnf;
+  cnf.m_result = SUCCESS;
+  m_macCschedSapUser->CschedUeConfigCnf (cnf);
+  return;
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoCschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " RNTI " << params.m_rnti << " txMode " << (uint16_t)params.m_transmissionMode);
+
+  UeState &ue = GetUe (params.m_rnti);
+  if (!ue.m_harqConfigured)
+    {
+      uint8_t numHarqProcess = m_phyMacConfig->GetNumHarqProcess ();
+      ue.m_dlHarqStatus.assign (numHarqProcess, 0);
+      ue.m_dlHarqTimer.assign (numHarqProcess, 0);
+      ue.m_dlHarqDci.assign (numHarqProcess, DciInfoElementTdma ());
+      ue.m_dlHarqRlcPdu.assign (numHarqProcess, std::vector <struct RlcPduInfo> ());
+      ue.m_ulHarqStatus.assign (numHarqProcess, 0);
+      ue.m_ulHarqTimer.assign (numHarqProcess, 0);
+      ue.m_ulHarqDci.assign (numHarqProcess, DciInfoElementTdma ());
+      ue.m_harqConfigured = true;
+    }
+  m_policy.ConfigureUe (*this, params.m_rnti);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoCschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  m_policy.ConfigureLc (*this, params);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this);
+  m_policy.ReleaseLc (*this, params);
+}
+
+template <class Policy>
+void
+MmWaveFlexTtiMacSchedulerEngine<Policy>::DoCschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << " Release RNTI " << params.m_rnti);
+
+  UeState *ue = FindUe (params.m_rnti);
+  if (ue == 0)
+    {
+      return;
+    }
+  // the CQI reports are kept until they expire
+  ue->m_harqConfigured = false;
+  ue->m_dlHarqStatus.clear ();
+  ue->m_dlHarqTimer.clear ();
+  ue->m_dlHarqDci.clear ();
+  ue->m_dlHarqRlcPdu.clear ();
+  ue->m_ulHarqStatus.clear ();
+  ue->m_ulHarqTimer.clear ();
+  ue->m_ulHarqDci.clear ();
+  m_policy.ReleaseUe (*this, params.m_rnti);
+}
+
+} // namespace mmwave
+
+} // namespace ns3
+
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_FLEX_TTI_MAC_SCHEDULER_ENGINE_H_ */
@@ -31,62 +31,34 @@
 #define SRC_MMWAVE_MODEL_MMWAVE_RR_MAC_SCHEDULER_H_
 
 
-#include "mmwave-mac-sched-sap.h"
-#include "mmwave-mac-csched-sap.h"
-#include "mmwave-mac-scheduler.h"
-#include "mmwave-amc.h"
-#include "string"
+#include "mmwave-flex-tti-mac-scheduler-engine.h"
 #include <vector>
-#include <set>
+#include <list>
 
 namespace ns3 {
 
 namespace mmwave {
 
-class MmWaveFlexTtiMacScheduler : public MmWaveMacScheduler
+/**
+ * \ingroup mmwave
+ * \brief Round robin policy of the flex-TTI scheduler
+ *
+ * The symbols left after the HARQ retransmissions are divided evenly between
+ * the active DL and UL flows, starting each slot from the UE at which the
+ * previous slot left off.
+ */
+class MmWaveFlexTtiRrPolicy
 {
 public:
-  typedef std::vector < uint8_t > DlHarqProcessesStatus_t;
-  typedef std::vector < uint8_t > DlHarqProcessesTimer_t;
-  typedef std::vector < DciInfoElementTdma > DlHarqProcessesDciInfoList_t;
-  typedef std::vector < std::vector <struct RlcPduInfo> > DlHarqRlcPduList_t;       // vector of the LCs per per UE HARQ process
-  //	typedef std::vector < RlcPduElement > DlHarqRlcPduList_t; // vector of the 8 HARQ processes per UE
+  typedef MmWaveFlexTtiMacSchedulerEngine<MmWaveFlexTtiRrPolicy> Engine;
 
-  typedef std::vector < uint8_t > UlHarqProcessesTimer_t;
-  typedef std::vector < DciInfoElementTdma > UlHarqProcessesDciInfoList_t;
-  typedef std::vector < uint8_t > UlHarqProcessesStatus_t;
-
-
-  MmWaveFlexTtiMacScheduler ();
-
-  virtual ~MmWaveFlexTtiMacScheduler ();
-  virtual void DoDispose (void) override;
-  static TypeId GetTypeId (void);
-
-  virtual void SetMacSchedSapUser (MmWaveMacSchedSapUser* sap) override;
-  virtual void SetMacCschedSapUser (MmWaveMacCschedSapUser* s) override;
-
-  virtual MmWaveMacSchedSapProvider* GetMacSchedSapProvider () override;
-  virtual MmWaveMacCschedSapProvider* GetMacCschedSapProvider () override;
-
-  virtual void ConfigureCommonParameters (Ptr<MmWavePhyMacCommon> config) override;
-
-  static bool SortRlcBufferReq (MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters i, MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters j);
-
-  void RefreshDlCqiMaps (void);
-  void RefreshUlCqiMaps (void);
-
-  void UpdateDlRlcBufferInfo (uint16_t rnti, uint8_t lcid, uint16_t size);
-  void UpdateUlRlcBufferInfo (uint16_t rnti, uint16_t size);
-
-  friend class MmWaveFlexTtiMacSchedSapProvider;
-  friend class MmWaveFlexTtiMacCschedSapProvider;
-
-private:
-  struct UeSchedInfo
+  struct UeInfo
   {
-    UeSchedInfo ()
-      : m_dlMcs (0),
+    UeInfo ()
+      : m_bsrValid (false),
+        m_bsr (0),
+        m_inSlot (false),
+        m_dlMcs (0),
         m_ulMcs (0),
         m_maxDlBufSize (0),
         m_maxUlBufSize (0),
@@ -94,15 +66,21 @@ private:
         m_maxUlSymbols (0),
         m_dlSymbols (0),
         m_ulSymbols (0),
-        m_dlSymbolsRetx (0),
-        m_ulSymbolsRetx (0),
         m_dlTbSize (0),
-        m_ulTbSize (0),
-        m_dlAllocDone (false),
-        m_ulAllocDone (false)
+        m_ulTbSize (0)
     {
     }
 
+    /*
+     * RLC buffer status of the LCs of the UE, oldest report first
+     */
+    std::list <MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
+
+    bool            m_bsrValid;          // a BSR has been received
+    uint32_t        m_bsr;               // UL buffer size of the last BSR, decreased by the UL grants
+
+    // allocation in the slot being scheduled
+    bool            m_inSlot;            // the UE is listed in m_slotUes
     uint8_t         m_dlMcs;             // DL MCS
     uint8_t         m_ulMcs;             // UL MCS
     uint32_t        m_maxDlBufSize;             // DL TB size needed to encode the DL buffer (this parameter is also used to temporarily store the DL buffer size)
@@ -111,219 +89,60 @@ private:
     uint8_t         m_maxUlSymbols;             // Number of symbols needed to encode the UL buffer given the UL MCS
     uint8_t         m_dlSymbols;
     uint8_t         m_ulSymbols;
-    uint8_t         m_dlSymbolsRetx;
-    uint8_t         m_ulSymbolsRetx;
     uint32_t        m_dlTbSize;
     uint32_t        m_ulTbSize;
     std::vector <struct RlcPduInfo> m_rlcPduInfo;
-    bool                    m_dlAllocDone;
-    bool                    m_ulAllocDone;
-  };
-
-  unsigned CalcMinTbSizeNumSym (unsigned mcs, unsigned bufSize, unsigned &tbSize);
-
-  uint32_t
-  BsrId2BufferSize (uint8_t val)
-  {
-    NS_ABORT_MSG_UNLESS (val < 64, "val = " << val << " is out of range");
-    return BufferSizeLevelBsrTable[val];
-  }
-
-  uint8_t
-  BufferSize2BsrId (uint32_t val)
-  {
-    int index = 0;
-    if (BufferSizeLevelBsrTable[63] < val)
-      {
-        index = 63;
-      }
-    else
-      {
-        while (BufferSizeLevelBsrTable[index] < val)
-          {
-            NS_ASSERT (index < 64);
-            index++;
-          }
-      }
-
-    return (index);
-  }
-
-  uint8_t UpdateDlHarqProcessId (uint16_t rnti);
-  uint8_t UpdateUlHarqProcessId (uint16_t rnti);
-
-  //
-  // Implementation of the CSCHED API primitives
-  // (See 4.1 for description of the primitives)
-  //
-
-  void DoCschedCellConfigReq (const struct MmWaveMacCschedSapProvider::CschedCellConfigReqParameters& params);
-
-  void DoCschedUeConfigReq (const struct MmWaveMacCschedSapProvider::CschedUeConfigReqParameters& params);
-
-  void DoCschedLcConfigReq (const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
-
-  void DoCschedLcReleaseReq (const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
-
-  void DoCschedUeReleaseReq (const struct MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters& params);
-
-  //
-  // Implementation of the SCHED API primitives
-  // (See 4.2 for description of the primitives)
-  //
 
-  void DoSchedDlRlcBufferReq (const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
-
-  void DoSchedDlCqiInfoReq (const MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters& params);       // Put in UML
-
-  void DoSchedUlCqiInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters& params);
-
-  void DoSchedUlMacCtrlInfoReq (const struct MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters& params);
-
-  void DoSchedTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
-
-  bool DoSchedDlTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
-                            MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
-                            uint32_t frameNum,
-                            unsigned int sfNum,
-                            unsigned int islot);
-
-  bool DoSchedUlTriggerReq (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params,
-                            MmWaveMacSchedSapUser::SchedConfigIndParameters& ret,
-                            uint32_t frameNum,
-                            unsigned int sfNum,
-                            unsigned int islot);
-
-  void DoSchedSetMcs (int mcs);
-
-  /**
-   * \brief Refresh HARQ processes according to the timers
-   *
-   */
-  void RefreshHarqProcesses ();
-
-  Ptr<MmWaveAmc> m_amc;
-
-  /*
-   * Vectors of UE's RLC info
-   */
-  std::list <MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters> m_rlcBufferReq;
-
-  /*
-   * Map of UE's DL CQI WB received
-   */
-  std::map <uint16_t,uint8_t> m_wbCqiRxed;
-  /*
-   * Map of UE's timers on DL CQI WB received
-   */
-  std::map <uint16_t,uint32_t> m_wbCqiTimers;
-
-  uint32_t m_cqiTimersThreshold;       // # of TTIs for which a CQI can be considered valid
-
-  /*
-   * Map of UEs' UL-CQI per RBG
-   */
-  struct UlCqiMapElem
-  {
-    UlCqiMapElem (std::vector<double> ulCqi, uint8_t nSym, uint32_t tbs)
-      : m_ueUlCqi (ulCqi),
-        m_numSym (nSym),
-        m_tbSize (tbs)
+    void
+    ResetSlot ()
     {
+      m_inSlot = false;
+      m_dlMcs = 0;
+      m_ulMcs = 0;
+      m_maxDlBufSize = 0;
+      m_maxUlBufSize = 0;
+      m_maxDlSymbols = 0;
+      m_maxUlSymbols = 0;
+      m_dlSymbols = 0;
+      m_ulSymbols = 0;
+      m_dlTbSize = 0;
+      m_ulTbSize = 0;
+      m_rlcPduInfo.clear ();
     }
-    std::vector <double> m_ueUlCqi;
-    uint8_t         m_numSym;
-    uint32_t        m_tbSize;
   };
 
-  std::map <uint16_t, struct UlCqiMapElem> m_ueUlCqi;
-  /*
-   * Map of UEs' timers on UL-CQI per RBG
-   */
-  std::map <uint16_t, uint32_t> m_ueCqiTimers;
-
-  /*
-   * Map of UE's buffer status reports received
-   */
-  std::map <uint16_t,uint32_t> m_ceBsrRxed;
-
-  uint16_t m_nextRnti;
-  uint64_t m_nextRntiDl;
-  uint64_t m_nextRntiUl;
+  MmWaveFlexTtiRrPolicy ();
 
-  uint8_t m_tbUid;
-  uint32_t m_numChunks;
-  uint32_t m_numDataSymbols;
+  void ConfigureUe (Engine &sched, uint16_t rnti);
+  void ConfigureLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcConfigReqParameters& params);
+  void ReleaseLc (Engine &sched, const struct MmWaveMacCschedSapProvider::CschedLcReleaseReqParameters& params);
+  void ReleaseUe (Engine &sched, uint16_t rnti);
 
-  MmWaveMacSchedSapProvider* m_macSchedSapProvider;
-  MmWaveMacSchedSapUser* m_macSchedSapUser;
-  MmWaveMacCschedSapUser* m_macCschedSapUser;
-  MmWaveMacCschedSapProvider* m_macCschedSapProvider;
+  void UpdateDlRlcBuffer (Engine &sched, const struct MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters& params);
+  void UpdateBsr (Engine &sched, const struct MacCeElement& bsr);
+  void UpdateCqi (Engine &sched, uint16_t rnti);
 
-  MmWaveMacCschedSapProvider::CschedCellConfigReqParameters m_cschedCellConfig;
+  void ScheduleNewData (Engine &sched, MmWaveFlexTtiSlotContext &ctx);
 
-  struct AllocMapElem
-  {
-    AllocMapElem (std::vector<uint16_t> rntiMap, uint8_t nSym, uint32_t tbs)
-      : m_rntiPerChunk (rntiMap),
-        m_numSym (nSym),
-        m_tbSize (tbs)
-    {
-    }
-
-    std::vector <uint16_t> m_rntiPerChunk;
-    uint8_t m_numSym;
-    uint32_t m_tbSize;
-  };
-  /*
-   * Map of previous allocated UE per RBG
-   * (used to retrieve info from UL-CQI)
-   */
-  std::map <uint32_t, struct AllocMapElem> m_ulAllocationMap;
-
-  // HARQ attributes
-  /**
-   * m_harqOn when false inhibit te HARQ mechanisms (by default active)
-   */
-  bool m_harqOn;
-  uint8_t m_numHarqProcess;
-  uint8_t m_harqTimeout;
-
-  std::map <uint16_t, uint8_t> m_dlHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, DlHarqProcessesStatus_t> m_dlHarqProcessesStatus;
-  std::map <uint16_t, DlHarqProcessesTimer_t> m_dlHarqProcessesTimer;
-  std::map <uint16_t, DlHarqProcessesDciInfoList_t> m_dlHarqProcessesDciInfoMap;
-  std::map <uint16_t, DlHarqRlcPduList_t> m_dlHarqProcessesRlcPduMap;
-  std::vector <DlHarqInfo> m_dlHarqInfoList;       // HARQ retx buffered
-  std::vector <UlHarqInfo> m_ulHarqInfoList;       // HARQ retx buffered
-
-  std::map <uint16_t, uint8_t> m_ulHarqCurrentProcessId;
-  //HARQ status
-  // 0: process Id available
-  // x>0: process Id equal to `x` trasmission count
-  std::map <uint16_t, UlHarqProcessesStatus_t>    m_ulHarqProcessesStatus;
-  std::map <uint16_t, UlHarqProcessesTimer_t>     m_ulHarqProcessesTimer;
-  std::map <uint16_t, UlHarqProcessesDciInfoList_t> m_ulHarqProcessesDciInfoMap;
+private:
+  unsigned CalcMinTbSizeNumSym (Engine &sched, unsigned mcs, unsigned bufSize, unsigned &tbSize);
 
+  void UpdateDlRlcBufferInfo (UeInfo &ue, uint16_t rnti, uint8_t lcid, uint16_t size);
+  void UpdateUlRlcBufferInfo (UeInfo &ue, uint16_t rnti, uint16_t size);
 
-  static const unsigned m_macHdrSize;
-  static const unsigned m_subHdrSize;
-  static const unsigned m_rlcHdrSize;
+  std::vector <uint16_t> m_slotUes;    // UEs with new data or a HARQ retx in the current slot, sorted
+  uint16_t m_nextRnti;                 // UE served first in the next slot
+};
 
-  static const double m_berDl;
-  bool            m_fixedMcsDl;
-  bool            m_fixedMcsUl;
-  uint8_t m_mcsDefaultDl;
-  uint8_t m_mcsDefaultUl;
+extern template class MmWaveFlexTtiMacSchedulerEngine<MmWaveFlexTtiRrPolicy>;
 
-  bool m_dlOnly;
-  bool m_ulOnly;       //for testing
+class MmWaveFlexTtiMacScheduler : public MmWaveFlexTtiMacSchedulerEngine<MmWaveFlexTtiRrPolicy>
+{
+public:
+  MmWaveFlexTtiMacScheduler ();
 
-  bool m_fixedTti;                      // one slot per TTI
-  uint8_t m_symPerSlot;       // symbols per slot
+  virtual ~MmWaveFlexTtiMacScheduler ();
+  static TypeId GetTypeId (void);
 };
 
 } // namespace mmwave
@@ -0,0 +1,225 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_INDEXED_HEAP_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_INDEXED_HEAP_H_
+
+
+#include <ns3/assert.h>
+#include <vector>
+#include <functional>
+#include <stdint.h>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief Binary heap of integer ids whose keys can be changed in place
+ *
+ * The ids are small integers (e.g. RNTIs), which index the position of each
+ * element in the heap, so that the key of any element can be updated or the
+ * element removed in O(log N). \p Compare (a, b) is true if the element with
+ * key a must be served before the element with key b: with the default
+ * std::less, Top is the element with the smallest key. To get the same order
+ * on every run, the keys of the elements in the heap should be all different.
+ */
+template <class Key, class Compare = std::less<Key> >
+class MmWaveIndexedHeap
+{
+public:
+  bool IsEmpty (void) const
+  {
+    return m_heap.empty ();
+  }
+
+  uint32_t GetSize (void) const
+  {
+    return m_heap.size ();
+  }
+
+  bool Contains (uint32_t id) const
+  {
+    return id < m_pos.size () && m_pos[id] != NOT_IN_HEAP;
+  }
+
+  /**
+   * \return the id of the element served first
+   */
+  uint32_t Top (void) const
+  {
+    NS_ASSERT (!IsEmpty ());
+    return m_heap.front ().m_id;
+  }
+
+  const Key& GetKey (uint32_t id) const
+  {
+    NS_ASSERT (Contains (id));
+    return m_heap[m_pos[id]].m_key;
+  }
+
+  /**
+   * \brief Insert an element, or change its key if it is already in the heap
+   */
+  void Update (uint32_t id, const Key &key)
+  {
+    if (!Contains (id))
+      {
+        if (id >= m_pos.size ())
+          {
+            m_pos.resize (id + 1, NOT_IN_HEAP);
+          }
+        m_heap.push_back (Entry (key, id));
+        m_pos[id] = m_heap.size () - 1;
+        SiftUp (m_heap.size () - 1);
+      }
+    else
+      {
+        uint32_t pos = m_pos[id];
+        m_heap[pos].m_key = key;
+        SiftUp (pos);
+        SiftDown (m_pos[id]);
+      }
+  }
+
+  /**
+   * \brief Remove an element, if it is in the heap
+   */
+  void Remove (uint32_t id)
+  {
+    if (!Contains (id))
+      {
+        return;
+      }
+    uint32_t pos = m_pos[id];
+    m_pos[id] = NOT_IN_HEAP;
+    Entry last = m_heap.back ();
+    m_heap.pop_back ();
+    if (pos < m_heap.size ())
+      {
+        m_heap[pos] = last;
+        m_pos[last.m_id] = pos;
+        SiftUp (pos);
+        SiftDown (m_pos[last.m_id]);
+      }
+  }
+
+  void Pop (void)
+  {
+    Remove (Top ());
+  }
+
+  void Clear (void)
+  {
+    m_heap.clear ();
+    m_pos.clear ();
+  }
+
+  /**
+   * \brief Change the keys of all the elements, then restore the heap in O(N)
+   * \param update functor called with the id and a reference to the key of
+   *        each element, in no particular order
+   */
+  template <class KeyUpdater>
+  void UpdateAll (KeyUpdater update)
+  {
+    for (Entry &entry : m_heap)
+      {
+        update (entry.m_id, entry.m_key);
+      }
+    for (uint32_t pos = m_heap.size () / 2; pos > 0; pos--)
+      {
+        SiftDown (pos - 1);
+      }
+  }
+
+private:
+  static const uint32_t NOT_IN_HEAP = 0xFFFFFFFF;
+
+  struct Entry
+  {
+    Entry (const Key &key, uint32_t id)
+      : m_key (key),
+        m_id (id)
+    {
+    }
+
+    Key m_key;
+    uint32_t m_id;
+  };
+
+  void SiftUp (uint32_t pos)
+  {
+    Entry entry = m_heap[pos];
+    while (pos > 0)
+      {
+        uint32_t parent = (pos - 1) / 2;
+        if (!m_compare (entry.m_key, m_heap[parent].m_key))
+          {
+            break;
+          }
+        Place (pos, m_heap[parent]);
+        pos = parent;
+      }
+    Place (pos, entry);
+  }
+
+  void SiftDown (uint32_t pos)
+  {
+    Entry entry = m_heap[pos];
+    uint32_t size = m_heap.size ();
+    while (2 * pos + 1 < size)
+      {
+        uint32_t child = 2 * pos + 1;
+        if (child + 1 < size && m_compare (m_heap[child + 1].m_key, m_heap[child].m_key))
+          {
+            child++;
+          }
+        if (!m_compare (m_heap[child].m_key, entry.m_key))
+          {
+            break;
+          }
+        Place (pos, m_heap[child]);
+        pos = child;
+      }
+    Place (pos, entry);
+  }
+
+  void Place (uint32_t pos, const Entry &entry)
+  {
+    m_heap[pos] = entry;
+    m_pos[entry.m_id] = pos;
+  }
+
+  std::vector<Entry> m_heap;           // the elements, in heap order
+  std::vector<uint32_t> m_pos;         // position of each id in m_heap, NOT_IN_HEAP if absent
+  Compare m_compare;
+};
+
+template <class Key, class Compare>
+const uint32_t MmWaveIndexedHeap<Key, Compare>::NOT_IN_HEAP;
+
+} // namespace mmwave
+
+} // namespace ns3
+
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_INDEXED_HEAP_H_ */
@@ -75,6 +75,20 @@ public:
 
   virtual MmWaveMacCschedSapProvider* GetMacCschedSapProvider () = 0;
 
+  /**
+   * \brief Compute the allocation of a slot, without sending it to the MAC
+   *
+   * Together with DeliverSlot, equivalent to SchedTriggerReq. Used by
+   * MmWaveSlotBarrier, which calls PrepareSlot of the schedulers of several
+   * cells concurrently: it must touch only the state of this scheduler.
+   */
+  virtual void PrepareSlot (const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params) = 0;
+
+  /**
+   * \brief Send the allocation computed by the last PrepareSlot to the MAC
+   */
+  virtual void DeliverSlot (void) = 0;
+
 protected:
   Ptr<MmWavePhyMacCommon> m_phyMacConfig;
   uint32_t m_rbgSize;                   // RBs per RB group for res alloc type 0
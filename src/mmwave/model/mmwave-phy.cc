@@ -38,6 +38,7 @@
 #include <ns3/node.h>
 #include <ns3/packet.h>
 #include <ns3/log.h>
+#include <ns3/boolean.h>
 #include "mmwave-phy.h"
 #include "mmwave-phy-sap.h"
 #include "mmwave-mac-pdu-tag.h"
@@ -108,6 +109,13 @@ MmWavePhy::GetTypeId ()
     tid =
     TypeId ("ns3::MmWavePhy")
     .SetParent<Object> ()
+    .AddAttribute ("TxPool",
+                   "If true, the packet bursts and control message lists transmitted by the PHY "
+                   "are reused once received; otherwise, new ones are allocated for each transmission",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&MmWavePhy::SetTxPoolEnabled,
+                                        &MmWavePhy::IsTxPoolEnabled),
+                   MakeBooleanChecker ())
   ;
 
   return tid;
@@ -149,6 +157,8 @@ MmWavePhy::DoDispose ()
 {
   NS_LOG_FUNCTION (this);
   m_controlMessageQueue.clear ();
+  m_packetBurstPool.Clear ();
+  m_controlMessageListPool.Clear ();
 
   Object::DoDispose ();
 }
@@ -219,7 +229,7 @@ MmWavePhy::SetMacPdu (Ptr<Packet> p)
       std::map<uint64_t, Ptr<PacketBurst> >::iterator it = m_packetBurstMap.find (tag.GetSfn ().Encode ());
       if (it == m_packetBurstMap.end ())
         {
-          it = m_packetBurstMap.insert (std::pair<uint64_t, Ptr<PacketBurst> > (tag.GetSfn ().Encode (), CreateObject<PacketBurst> ())).first;
+          it = m_packetBurstMap.insert (std::pair<uint64_t, Ptr<PacketBurst> > (tag.GetSfn ().Encode (), m_packetBurstPool.Get ())).first;
         }
       else
         {
@@ -267,32 +277,21 @@ MmWavePhy::SetControlMessage (Ptr<MmWaveControlMessage> m)
     }
 }
 
-std::list<Ptr<MmWaveControlMessage> >
+Ptr<MmWaveControlMessageList>
 MmWavePhy::GetControlMessages (void)
 {
   NS_LOG_FUNCTION (this);
+  Ptr<MmWaveControlMessageList> ret = m_controlMessageListPool.Get ();
   if (m_controlMessageQueue.empty ())
     {
-      std::list<Ptr<MmWaveControlMessage> > emptylist;
-      return (emptylist);
+      return ret;
     }
 
-  if (m_controlMessageQueue.at (0).size () > 0)
-    {
-      std::list<Ptr<MmWaveControlMessage> > ret = m_controlMessageQueue.front ();
-      m_controlMessageQueue.erase (m_controlMessageQueue.begin ());
-      std::list<Ptr<MmWaveControlMessage> > newlist;
-      m_controlMessageQueue.push_back (newlist);
-      return (ret);
-    }
-  else
-    {
-      m_controlMessageQueue.erase (m_controlMessageQueue.begin ());
-      std::list<Ptr<MmWaveControlMessage> > newlist;
-      m_controlMessageQueue.push_back (newlist);
-      std::list<Ptr<MmWaveControlMessage> > emptylist;
-      return (emptylist);
-    }
+  // move the messages without copying the nodes of the list
+  ret->m_messages.splice (ret->m_messages.end (), m_controlMessageQueue.front ());
+  m_controlMessageQueue.erase (m_controlMessageQueue.begin ());
+  m_controlMessageQueue.push_back (std::list<Ptr<MmWaveControlMessage> > ());
+  return ret;
 }
 
 void
@@ -380,6 +379,31 @@ MmWavePhy::SetComponentCarrierId (uint8_t index)
   m_uplinkSpectrumPhy->SetComponentCarrierId (index);
 }
 
+uint64_t
+MmWavePhy::GetTxPoolRequests (void) const
+{
+  return m_packetBurstPool.GetNRequests () + m_controlMessageListPool.GetNRequests ();
+}
+
+uint64_t
+MmWavePhy::GetTxPoolAllocations (void) const
+{
+  return m_packetBurstPool.GetNAllocations () + m_controlMessageListPool.GetNAllocations ();
+}
+
+void
+MmWavePhy::SetTxPoolEnabled (bool enabled)
+{
+  m_packetBurstPool.SetEnabled (enabled);
+  m_controlMessageListPool.SetEnabled (enabled);
+}
+
+bool
+MmWavePhy::IsTxPoolEnabled (void) const
+{
+  return m_packetBurstPool.IsEnabled ();
+}
+
 uint8_t
 MmWavePhy::GetComponentCarrierId ()
 {
@@ -51,6 +51,7 @@
 #include "mmwave-spectrum-phy.h"
 #include "mmwave-net-device.h"
 #include "mmwave-phy-sap.h"
+#include "mmwave-tx-pool.h"
 #include <string>
 #include <map>
 
@@ -107,7 +108,12 @@ public:
   double GetNoiseFigure (void) const;
 
   void SetControlMessage (Ptr<MmWaveControlMessage> m);
-  std::list<Ptr<MmWaveControlMessage> > GetControlMessages (void);
+
+  /**
+   * \brief Get the control messages to transmit in the current TTI
+   * \return a list drawn from the transmission pool of the PHY
+   */
+  Ptr<MmWaveControlMessageList> GetControlMessages (void);
 
   virtual void SetMacPdu (Ptr<Packet> pb);
 
@@ -156,6 +162,29 @@ public:
   */
   uint8_t GetComponentCarrierId ();
 
+  /**
+   * \brief Get the number of packet bursts and control message lists
+   *        requested from the transmission pools of this PHY
+   */
+  uint64_t GetTxPoolRequests (void) const;
+
+  /**
+   * \brief Get the number of packet bursts and control message lists
+   *        constructed by the transmission pools of this PHY
+   */
+  uint64_t GetTxPoolAllocations (void) const;
+
+  /**
+   * \brief Enable or disable the reuse of the packet bursts and control
+   *        message lists of the transmission pools of this PHY
+   */
+  void SetTxPoolEnabled (bool enabled);
+
+  /**
+   * \brief Whether the transmission pools of this PHY reuse their objects
+   */
+  bool IsTxPoolEnabled (void) const;
+
 protected:
   Ptr<NetDevice> m_netDevice;
 
@@ -172,6 +201,8 @@ protected:
 
   std::map<uint64_t, Ptr<PacketBurst> > m_packetBurstMap;
   std::vector< std::list<Ptr<MmWaveControlMessage> > > m_controlMessageQueue;
+  MmWaveTxPool<PacketBurst> m_packetBurstPool;                     //!< the bursts transmitted by this PHY
+  MmWaveTxPool<MmWaveControlMessageList> m_controlMessageListPool;  //!< the control messages transmitted by this PHY
 
   std::vector <SlotAllocInfo> m_slotAllocInfo;  //!< Maps slot number to its allocation info
 
@@ -0,0 +1,224 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2016, University of Padova, Dep. of Information Engineering, SIGNET lab.
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include "mmwave-sinr-filter-table.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <ns3/assert.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace ns3 {
+
+namespace mmwave {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveSinrFilterTable");
+
+MmWaveSinrFilterTable::MmWaveSinrFilterTable ()
+  : m_capacity (0)
+{
+}
+
+void
+MmWaveSinrFilterTable::SetCapacity (uint32_t capacity)
+{
+  NS_LOG_FUNCTION (this << capacity);
+  m_capacity = capacity;
+  m_samples.clear ();
+  m_windows.clear ();
+}
+
+uint32_t
+MmWaveSinrFilterTable::GetCapacity () const
+{
+  return m_capacity;
+}
+
+uint32_t
+MmWaveSinrFilterTable::GetNumSamples (uint64_t imsi) const
+{
+  std::map<uint64_t, Window>::const_iterator it = m_windows.find (imsi);
+  return it == m_windows.end () ? 0 : it->second.m_size;
+}
+
+double
+MmWaveSinrFilterTable::AddSamples (uint64_t imsi, double realSinr, double noisySinr, bool filter)
+{
+  NS_LOG_FUNCTION (this << imsi << realSinr << noisySinr << filter);
+  NS_ABORT_MSG_IF (m_capacity == 0, "The capacity of the SINR filter table has not been set");
+
+  std::map<uint64_t, Window>::iterator it = m_windows.find (imsi);
+  if (it == m_windows.end ())
+    {
+      Window newWindow;
+      newWindow.m_offset = m_samples.size ();
+      newWindow.m_head = 0;
+      newWindow.m_size = 0;
+      m_samples.resize (m_samples.size () + m_capacity);
+      it = m_windows.insert (std::make_pair (imsi, newWindow)).first;
+    }
+  Window &w = it->second;
+
+  bool hasPrev = w.m_size > 0;
+  Sample prev;
+  if (hasPrev)
+    {
+      prev = At (w, w.m_size - 1);
+    }
+
+  if (filter && w.m_size > 0)
+    {
+      // after the transient, the window slides
+      w.m_head = (w.m_head + 1 == m_capacity) ? 0 : w.m_head + 1;
+      w.m_size--;
+    }
+  NS_ABORT_MSG_IF (w.m_size == m_capacity, "Too many SINR samples collected during the transient for IMSI " << imsi);
+
+  uint32_t pos = w.m_head + w.m_size;
+  if (pos >= m_capacity)
+    {
+      pos -= m_capacity;
+    }
+  Sample &s = m_samples[w.m_offset + pos];
+  s.m_real = realSinr;
+  s.m_noisy = noisySinr;
+  s.m_noisyDb = 10 * std::log10 (noisySinr);
+  s.m_highSinrRun = (s.m_noisyDb > 10) ? (hasPrev ? prev.m_highSinrRun : 0) + 1 : 0;
+  if (hasPrev)
+    {
+      // same operations of MmWaveEnbPhy::MakeAvg and MmWaveEnbPhy::MakeVar on the two samples
+      double mean = 0.0;
+      mean += prev.m_noisyDb;
+      mean += s.m_noisyDb;
+      mean = mean / 2;
+      double var = 0.0;
+      var += std::pow ((prev.m_noisyDb - mean), 2);
+      var += std::pow ((s.m_noisyDb - mean), 2);
+      s.m_var = var / 2;
+      s.m_lowVarRun = (s.m_var < 1) ? prev.m_lowVarRun + 1 : 0;
+    }
+  else
+    {
+      s.m_var = std::numeric_limits<double>::quiet_NaN ();
+      s.m_lowVarRun = 0;
+    }
+  w.m_size++;
+
+  if (!filter)
+    {
+      return noisySinr;
+    }
+
+  std::pair<uint32_t, uint32_t> filterWindow = FindFilterWindow (w);
+  NS_LOG_DEBUG ("IMSI " << imsi << " filter from sample " << filterWindow.first << " to sample " << filterWindow.second);
+  if (filterWindow.first == filterWindow.second)
+    {
+      // no need to apply the filter
+      return noisySinr;
+    }
+  return FilterLastSample (w, filterWindow.first, filterWindow.second);
+}
+
+std::pair<uint32_t, uint32_t>
+MmWaveSinrFilterTable::FindFilterWindow (const Window &w) const
+{
+  // the variance of samples i and i + 1 is stored in sample i + 1
+  uint32_t endFilter = 0;
+  for (uint32_t varIndex = (w.m_size >= 2) ? w.m_size - 2 : 0; varIndex > 0; varIndex--)
+    {
+      uint32_t noisySinrIndex = varIndex + 1;
+      const Sample &s = At (w, noisySinrIndex);
+      bool highVariance = (s.m_var > 5 || std::isnan (s.m_var));
+      bool lowSinr = s.m_noisy < 10;
+      if (highVariance || lowSinr)
+        {
+          endFilter = noisySinrIndex;
+          break;
+        }
+    }
+
+  // the filtering ends when the last 15 variances are below 1, or the last
+  // 16 samples are above 10 dB
+  const uint32_t numberOfVarWindow = 16;
+  uint32_t startFilter = 0;
+  for (uint32_t noisySinrIndex = endFilter; noisySinrIndex > numberOfVarWindow; --noisySinrIndex)
+    {
+      const Sample &s = At (w, noisySinrIndex - 1);
+      if (s.m_lowVarRun >= numberOfVarWindow - 1 || s.m_highSinrRun >= numberOfVarWindow)
+        {
+          startFilter = noisySinrIndex;
+          break;
+        }
+    }
+
+  return std::make_pair (startFilter, endFilter);
+}
+
+double
+MmWaveSinrFilterTable::FilterLastSample (const Window &w, uint32_t start, uint32_t end) const
+{
+  NS_ASSERT (start < end && end < w.m_size);
+
+  // the filtered trace is made of the samples up to start, the filtered
+  // samples from start + 1 to end - 1, and the samples after end
+  if (end + 1 < w.m_size)
+    {
+      return At (w, w.m_size - 1).m_noisy;
+    }
+  if (end - start < 2)
+    {
+      return At (w, start).m_noisy;
+    }
+
+  /* find best alpha parameter for the Kalman estimation */
+  int rep = 0;
+  std::array<double,100> meanError;
+  for (double alpha = 0; alpha < 1; alpha = alpha + 0.01 )
+    {
+      double x = 0;
+      double errorSum = 0.0;
+      for (uint32_t i = start; i < end; i++)
+        {
+          const Sample &s = At (w, i);
+          x = (1 - alpha) * x + alpha * s.m_noisy;
+          errorSum += std::abs (x - s.m_real);
+        }
+      meanError.at (rep) = errorSum / (end - start);
+      rep++;
+    }
+
+  int posMinAlpha = std::distance (meanError.begin (),std::min_element (meanError.begin (),meanError.end ()));
+  double minAlpha = (posMinAlpha + 1) * 0.01;
+  if (minAlpha > 0.5)
+    {
+      minAlpha = 0.2;
+    }
+
+  double x = 0;
+  for (uint32_t i = start; i < end - 1; i++)
+    {
+      x = (1 - minAlpha) * x + minAlpha * At (w, i).m_noisy;
+    }
+  return x;
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,152 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2016, University of Padova, Dep. of Information Engineering, SIGNET lab.
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_SINR_FILTER_TABLE_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_SINR_FILTER_TABLE_H_
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ *
+ * \brief Windows of SINR samples used by MmWaveEnbPhy to filter the
+ * noisy SINR estimates
+ *
+ * Each link (identified by the IMSI of the UE) owns a circular buffer of
+ * fixed capacity in a single flat table, which holds the real and the noisy
+ * SINR samples. The quantities used by MmWaveEnbPhy::ApplyFilter (the
+ * samples in dB, the variance of consecutive samples and the length of the
+ * runs of low-variance and high-SINR samples) are computed once, when a
+ * sample is added, so that finding the filtering window costs O(1) per
+ * sample of the window, without copies.
+ * The sample returned by AddSamples is the last element of the trace
+ * computed by the sequence MmWaveEnbPhy::ApplyFilter, MmWaveEnbPhy::MakeFilter
+ * on the same windows, with the same floating point operations.
+ */
+class MmWaveSinrFilterTable
+{
+public:
+  MmWaveSinrFilterTable ();
+
+  /**
+   * Sets the maximum number of samples kept for each link, i.e., the number
+   * of samples collected during the transient. Drops the existing links.
+   *
+   * \param capacity the number of samples
+   */
+  void SetCapacity (uint32_t capacity);
+
+  /**
+   * \return the maximum number of samples kept for each link
+   */
+  uint32_t GetCapacity () const;
+
+  /**
+   * Adds a new pair of samples to the window of a link and computes the
+   * SINR sample to forward.
+   *
+   * \param imsi the IMSI of the UE
+   * \param realSinr the SINR (linear)
+   * \param noisySinr the SINR (linear), with the measurement error
+   * \param filter if false, the window grows and the noisy sample is
+   * returned. If true, the oldest samples are dropped and the filter is
+   * applied to the window
+   * \return the (possibly filtered) noisy SINR for the current time
+   */
+  double AddSamples (uint64_t imsi, double realSinr, double noisySinr, bool filter);
+
+  /**
+   * \param imsi the IMSI of the UE
+   * \return the number of samples in the window of the link
+   */
+  uint32_t GetNumSamples (uint64_t imsi) const;
+
+private:
+  /**
+   * A SINR sample, with the quantities that depend on it and on the
+   * previous sample of the same link
+   */
+  struct Sample
+  {
+    double m_real;            //!< the SINR
+    double m_noisy;           //!< the noisy SINR
+    double m_noisyDb;         //!< the noisy SINR in dB
+    double m_var;             //!< the variance of the noisy SINR in dB of this and of the previous sample
+    uint32_t m_highSinrRun;   //!< number of consecutive samples with noisy SINR above 10 dB, up to this one
+    uint32_t m_lowVarRun;     //!< number of consecutive samples with variance below 1, up to this one
+  };
+
+  /**
+   * Position of the window of a link in the table
+   */
+  struct Window
+  {
+    uint32_t m_offset;  //!< index of the first sample of the link in m_samples
+    uint32_t m_head;    //!< position of the oldest sample in the window
+    uint32_t m_size;    //!< number of samples in the window
+  };
+
+  /**
+   * \param w the window
+   * \param i the position of the sample in the window, 0 is the oldest
+   * \return the sample
+   */
+  const Sample& At (const Window &w, uint32_t i) const
+  {
+    uint32_t pos = w.m_head + i;
+    if (pos >= m_capacity)
+      {
+        pos -= m_capacity;
+      }
+    return m_samples[w.m_offset + pos];
+  }
+
+  /**
+   * Finds where to apply the filter, as MmWaveEnbPhy::ApplyFilter
+   *
+   * \param w the window
+   * \return the first and the last sample to filter
+   */
+  std::pair<uint32_t, uint32_t> FindFilterWindow (const Window &w) const;
+
+  /**
+   * Computes the last element of the trace returned by MmWaveEnbPhy::MakeFilter
+   *
+   * \param w the window
+   * \param start the first sample to filter
+   * \param end the last sample to filter
+   * \return the last sample of the filtered trace
+   */
+  double FilterLastSample (const Window &w, uint32_t start, uint32_t end) const;
+
+  uint32_t m_capacity;                    //!< maximum number of samples per link
+  std::vector<Sample> m_samples;          //!< samples of all the links, m_capacity per link
+  std::map<uint64_t, Window> m_windows;   //!< window of each link
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_SINR_FILTER_TABLE_H_ */
@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#include "mmwave-slot-barrier.h"
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/uinteger.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveSlotBarrier");
+
+namespace mmwave {
+
+NS_OBJECT_ENSURE_REGISTERED (MmWaveSlotBarrier);
+
+TypeId
+MmWaveSlotBarrier::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MmWaveSlotBarrier")
+    .SetParent<Object> ()
+    .AddConstructor<MmWaveSlotBarrier> ()
+    .AddAttribute ("NumThreads",
+                   "Number of threads used to schedule the slots of the cells "
+                   "that start at the same time",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&MmWaveSlotBarrier::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+  ;
+  return tid;
+}
+
+MmWaveSlotBarrier::MmWaveSlotBarrier ()
+  : m_numThreads (1)
+{
+  NS_LOG_FUNCTION (this);
+}
+
+MmWaveSlotBarrier::~MmWaveSlotBarrier ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MmWaveSlotBarrier::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_batchEvent.Cancel ();
+  m_jobs.clear ();
+  Object::DoDispose ();
+}
+
+void
+MmWaveSlotBarrier::SchedTriggerReq (uint16_t cellId, Ptr<MmWaveMacScheduler> scheduler,
+                                    const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params)
+{
+  NS_LOG_FUNCTION (this << cellId);
+  SlotJob job;
+  job.m_cellId = cellId;
+  job.m_scheduler = scheduler;
+  job.m_params = params;
+  m_jobs.push_back (job);
+  if (!m_batchEvent.IsRunning ())
+    {
+      // the slot indications of the other cells for this time step have
+      // already been scheduled, thus they run before the batch
+      m_batchEvent = Simulator::ScheduleNow (&MmWaveSlotBarrier::RunBatch, this);
+    }
+}
+
+void
+MmWaveSlotBarrier::RunBatch (void)
+{
+  NS_LOG_FUNCTION (this);
+  std::vector<SlotJob> jobs;
+  jobs.swap (m_jobs);
+  std::stable_sort (jobs.begin (), jobs.end (),
+                    [] (const SlotJob &a, const SlotJob &b)
+                    {
+                      return a.m_cellId < b.m_cellId;
+                    });
+  NS_LOG_DEBUG ("schedule " << jobs.size () << " slots at " << Simulator::Now ().GetSeconds ());
+
+  // each job touches only the state of its own scheduler, and the workers
+  // do not copy the Ptrs, whose reference count is not thread safe
+  std::atomic<std::size_t> nextJob {0};
+  auto worker = [&jobs, &nextJob] ()
+    {
+      for (std::size_t i = nextJob++; i < jobs.size (); i = nextJob++)
+        {
+          jobs[i].m_scheduler->PrepareSlot (jobs[i].m_params);
+        }
+    };
+
+  uint32_t numThreads = std::max<uint32_t> (1, std::min<std::size_t> (m_numThreads, jobs.size ()));
+  std::vector<std::thread> threads;
+  for (uint32_t t = 1; t < numThreads; t++)
+    {
+      threads.emplace_back (worker);
+    }
+  worker ();
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  for (SlotJob &job : jobs)
+    {
+      job.m_scheduler->DeliverSlot ();
+    }
+}
+
+} // namespace mmwave
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   Copyright (c) 2015, NYU WIRELESS, Tandon School of Engineering, New York University
+*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_SLOT_BARRIER_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_SLOT_BARRIER_H_
+
+
+#include <ns3/object.h>
+#include <ns3/event-id.h>
+#include "mmwave-mac-scheduler.h"
+#include "mmwave-mac-sched-sap.h"
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief Runs together the schedulers of the cells whose slots start at the same time
+ *
+ * When an MmWaveEnbMac is attached to a barrier, it hands the scheduler
+ * trigger of every slot to the barrier instead of calling SchedTriggerReq.
+ * The barrier collects the triggers of all the cells up to the end of the
+ * current time step, then computes the slots with MmWaveMacScheduler::PrepareSlot
+ * on up to NumThreads threads, and finally delivers the allocations to the
+ * MACs in order of cell ID. The outcome does not depend on the number of
+ * threads.
+ *
+ * The allocation of a slot is delivered to the MAC later than with
+ * SchedTriggerReq, but at the same simulation time, thus the L1-L2 latency
+ * must be at least one slot. Since the schedulers also see the reports
+ * received later in the same time step, the allocations may differ from the
+ * ones obtained without the barrier. Logging from the schedulers is not
+ * serialized when more than one thread is used.
+ */
+class MmWaveSlotBarrier : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MmWaveSlotBarrier ();
+  virtual ~MmWaveSlotBarrier ();
+  virtual void DoDispose (void) override;
+
+  /**
+   * \brief Queue the scheduling of a slot, run at the end of the current time step
+   * \param cellId the cell ID of the MAC, which defines the order of delivery
+   * \param scheduler the scheduler of the cell
+   * \param params the trigger that would be passed to SchedTriggerReq
+   */
+  void SchedTriggerReq (uint16_t cellId, Ptr<MmWaveMacScheduler> scheduler,
+                        const struct MmWaveMacSchedSapProvider::SchedTriggerReqParameters& params);
+
+private:
+  struct SlotJob
+  {
+    uint16_t m_cellId;
+    Ptr<MmWaveMacScheduler> m_scheduler;
+    MmWaveMacSchedSapProvider::SchedTriggerReqParameters m_params;
+  };
+
+  /**
+   * \brief Schedule the queued slots and deliver them to the MACs
+   */
+  void RunBatch (void);
+
+  std::vector<SlotJob> m_jobs;         // slots queued in the current time step
+  EventId m_batchEvent;
+  uint32_t m_numThreads;
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_SLOT_BARRIER_H_ */
@@ -123,7 +123,7 @@ MmWaveSpectrumPhy::GetTypeId (void)
 void
 MmWaveSpectrumPhy::DoDispose ()
 {
-
+  m_errorModel = nullptr;
 }
 
 void
@@ -199,7 +199,14 @@ MmWaveSpectrumPhy::GetRxSpectrumModel () const
 void
 MmWaveSpectrumPhy::SetErrorModelType (TypeId errorModelType)
 {
+  NS_ABORT_MSG_IF (!errorModelType.IsChildOf (MmWaveErrorModel::GetTypeId ()),
+                   "The error model must be a subclass of MmWaveErrorModel!");
   m_errorModelType = errorModelType;
+
+  // the error model is stateless, thus the same instance is used for all the TBs
+  ObjectFactory emFactory;
+  emFactory.SetTypeId (m_errorModelType);
+  m_errorModel = DynamicCast<MmWaveErrorModel> (emFactory.Create ());
 }
 
 Ptr<Object>
@@ -336,7 +343,7 @@ MmWaveSpectrumPhy::StartRx (Ptr<SpectrumSignalParameters> params)
 
   Ptr<MmWaveEnbNetDevice> enbTx = DynamicCast<MmWaveEnbNetDevice> (params->txPhy->GetDevice ());
   Ptr<MmWaveEnbNetDevice> enbRx = DynamicCast<MmWaveEnbNetDevice> (GetDevice ());
-  if (( enbTx &&  enbRx) || ( enbTx &&  enbRx))
+  if (( enbTx &&  enbRx) || (!enbTx && !enbRx))
     {
       NS_LOG_INFO ("BS to BS or UE to UE transmission neglected.");
       return;
@@ -451,7 +458,11 @@ MmWaveSpectrumPhy::StartRxData (Ptr<MmwaveSpectrumSignalParametersDataFrame> par
               m_rxPacketBurstList.push_back (params->packetBurst);
             }
 
-          m_rxControlMessageList.insert (m_rxControlMessageList.end (), params->ctrlMsgList.begin (), params->ctrlMsgList.end ());
+          if (params->ctrlMsgList)
+            {
+              m_rxControlMessageList.insert (m_rxControlMessageList.end (), params->ctrlMsgList->m_messages.begin (),
+                                             params->ctrlMsgList->m_messages.end ());
+            }
 
           NS_LOG_LOGIC (this << " numSimultaneousRxEvents = " << m_rxPacketBurstList.size ());
         }
@@ -492,7 +503,8 @@ MmWaveSpectrumPhy::StartRxCtrl (Ptr<MmWaveSpectrumSignalParametersDlCtrlFrame> d
                 }
               NS_ASSERT ((m_firstRxStart == Simulator::Now ()) && (m_firstRxDuration == dlCtrlRxParams->duration));
 
-              m_rxControlMessageList.insert (m_rxControlMessageList.end (), dlCtrlRxParams->ctrlMsgList.begin (), dlCtrlRxParams->ctrlMsgList.end ());
+              m_rxControlMessageList.insert (m_rxControlMessageList.end (), dlCtrlRxParams->ctrlMsgList->m_messages.begin (),
+                                             dlCtrlRxParams->ctrlMsgList->m_messages.end ());
             }
           else
             {
@@ -518,7 +530,7 @@ MmWaveSpectrumPhy::StartRxCtrl (Ptr<MmWaveSpectrumSignalParametersDlCtrlFrame> d
               NS_LOG_LOGIC (this << " scheduling EndRx with delay " << dlCtrlRxParams->duration);
 
               // store the DCIs
-              m_rxControlMessageList = dlCtrlRxParams->ctrlMsgList;
+              m_rxControlMessageList = dlCtrlRxParams->ctrlMsgList->m_messages;
               m_endRxDlCtrlEvent = Simulator::Schedule (dlCtrlRxParams->duration, &MmWaveSpectrumPhy::EndRxCtrl, this);
               ChangeState (RX_CTRL);
             }
@@ -576,19 +588,12 @@ MmWaveSpectrumPhy::EndRxData ()
           const MmWaveErrorModel::MmWaveErrorModelHistory & harqInfoList = RetrieveHistory (itTb->first, 
                                                                 itTb->second.m_expected.m_harqProcessId);
 
-          // Obtain pointer to the specific error model used
-          NS_ABORT_MSG_IF (!m_errorModelType.IsChildOf (MmWaveErrorModel::GetTypeId ()),
-                           "The error model must be a subclass of MmWaveErrorModel!");
-          ObjectFactory emFactory;
-          emFactory.SetTypeId (m_errorModelType);
-          Ptr<MmWaveErrorModel> em = DynamicCast<MmWaveErrorModel> (emFactory.Create ());
-
           // Check whether the TB is corrupted or not, update TB info accordingly
-          itTb->second.m_outputOfEM = em->GetTbDecodificationStats (m_sinrPerceived, 
-                                                                    itTb->second.m_expected.m_rbBitmap, 
-                                                                    itTb->second.m_expected.m_tbSize, 
-                                                                    itTb->second.m_expected.m_mcs, 
-                                                                    harqInfoList);
+          itTb->second.m_outputOfEM = m_errorModel->GetTbDecodificationStats (m_sinrPerceived, 
+                                                                              itTb->second.m_expected.m_rbBitmap,
+                                                                              itTb->second.m_expected.m_tbSize,
+                                                                              itTb->second.m_expected.m_mcs,
+                                                                              harqInfoList);
           itTb->second.m_isCorrupted = m_random->GetValue () > itTb->second.m_outputOfEM->m_tbler ? false : true;
 
           if (itTb->second.m_isCorrupted)
@@ -627,7 +632,8 @@ MmWaveSpectrumPhy::EndRxData ()
             {
               if (!itTb->second.m_isCorrupted)
                 {
-                  m_phyRxDataEndOkCallback (packet);
+                  // the burst is shared with the other receivers of the signal
+                  m_phyRxDataEndOkCallback (packet->Copy ());
                 }
               else
                 {
@@ -820,7 +826,7 @@ MmWaveSpectrumPhy::EndRxCtrl ()
 }
 
 bool
-MmWaveSpectrumPhy::StartTxDataFrames (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveControlMessage> > ctrlMsgList, Time duration, uint8_t slotInd)
+MmWaveSpectrumPhy::StartTxDataFrames (Ptr<PacketBurst> pb, Ptr<MmWaveControlMessageList> ctrlMsgList, Time duration, uint8_t slotInd)
 {
   switch (m_state)
     {
@@ -864,7 +870,7 @@ MmWaveSpectrumPhy::StartTxDataFrames (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveC
 }
 
 bool
-MmWaveSpectrumPhy::StartTxDlControlFrames (std::list<Ptr<MmWaveControlMessage> > ctrlMsgList, Time duration)
+MmWaveSpectrumPhy::StartTxDlControlFrames (Ptr<MmWaveControlMessageList> ctrlMsgList, Time duration)
 {
   NS_LOG_LOGIC (this << " state: " << m_state);
 
@@ -215,9 +215,9 @@ public:
   void SetComponentCarrierId (uint8_t componentCarrierId);
 
 
-  bool StartTxDataFrames (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveControlMessage> > ctrlMsgList, Time duration, uint8_t slotInd);
+  bool StartTxDataFrames (Ptr<PacketBurst> pb, Ptr<MmWaveControlMessageList> ctrlMsgList, Time duration, uint8_t slotInd);
 
-  bool StartTxDlControlFrames (std::list<Ptr<MmWaveControlMessage> > ctrlMsgList, Time duration);       // control frames from enb to ue
+  bool StartTxDlControlFrames (Ptr<MmWaveControlMessageList> ctrlMsgList, Time duration);       // control frames from enb to ue
   bool StartTxUlControlFrames (void);       // control frames from ue to enb
 
   void SetPhyRxDataEndOkCallback (MmWavePhyRxDataEndOkCallback c);
@@ -306,6 +306,7 @@ private:
   bool m_dataErrorModelEnabled;       // when true (default) the phy error model is enabled
   bool m_ctrlErrorModelEnabled;       // when true (default) the phy error model is enabled for DL ctrl frame
   TypeId m_errorModelType {Object::GetTypeId()}; //!< Error model type by default is MmWaveLteMiErrorModel
+  Ptr<MmWaveErrorModel> m_errorModel; //!< Error model instance of type m_errorModelType, used for all the TBs
 
   Ptr<MmWaveHarqPhy> m_harqPhyModule;
 
@@ -72,10 +72,7 @@ MmwaveSpectrumSignalParametersDataFrame::MmwaveSpectrumSignalParametersDataFrame
 {
   NS_LOG_FUNCTION (this << &p);
   cellId = p.cellId;
-  if (p.packetBurst)
-    {
-      packetBurst = p.packetBurst->Copy ();
-    }
+  packetBurst = p.packetBurst;
   ctrlMsgList = p.ctrlMsgList;
   slotInd = p.slotInd;
 }
@@ -38,7 +38,7 @@ class PacketBurst;
 
 namespace mmwave {
 
-class MmWaveControlMessage;
+class MmWaveControlMessageList;
 
 /**
  * \ingroup mmwave
@@ -83,9 +83,13 @@ struct MmwaveSpectrumSignalParametersDataFrame : public SpectrumSignalParameters
   */
   MmwaveSpectrumSignalParametersDataFrame (const MmwaveSpectrumSignalParametersDataFrame& p);
 
+  /**
+   * The packets and the control messages are shared, not copied, by the
+   * signal parameters of all the receivers, thus they must not be modified
+   */
   Ptr<PacketBurst> packetBurst;
 
-  std::list<Ptr<MmWaveControlMessage> > ctrlMsgList;
+  Ptr<MmWaveControlMessageList> ctrlMsgList;
 
   uint16_t cellId;
 
@@ -110,7 +114,7 @@ struct MmWaveSpectrumSignalParametersDlCtrlFrame : public SpectrumSignalParamete
   MmWaveSpectrumSignalParametersDlCtrlFrame (const MmWaveSpectrumSignalParametersDlCtrlFrame& p);
 
 
-  std::list<Ptr<MmWaveControlMessage> > ctrlMsgList;
+  Ptr<MmWaveControlMessageList> ctrlMsgList;   //!< shared by all the receivers
 
   bool pss;
   uint16_t cellId;
@@ -0,0 +1,146 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+
+
+#ifndef SRC_MMWAVE_MODEL_MMWAVE_TX_POOL_H_
+#define SRC_MMWAVE_MODEL_MMWAVE_TX_POOL_H_
+
+#include <ns3/object.h>
+#include <ns3/ptr.h>
+#include <type_traits>
+#include <vector>
+
+namespace ns3 {
+
+namespace mmwave {
+
+/**
+ * \ingroup mmwave
+ * \brief A pool of the packet bursts or control message lists transmitted by a PHY
+ *
+ * The objects are shared, by reference count, by the PHY and by the signal
+ * parameters of the receivers. An object is reused, after a call to its
+ * Clear method, once the pool holds its only reference, i.e., once the
+ * transmission is received by all the receivers. The pool thus grows to
+ * the largest number of objects in flight, and then allocates no more.
+ * A disabled pool allocates a new object for each request.
+ */
+template <typename T>
+class MmWaveTxPool
+{
+public:
+  MmWaveTxPool ()
+    : m_enabled (true),
+      m_next (0),
+      m_requests (0),
+      m_allocations (0)
+  {
+  }
+
+  /**
+   * \brief Enable or disable the reuse of the objects
+   */
+  void SetEnabled (bool enabled)
+  {
+    m_enabled = enabled;
+    Clear ();
+  }
+
+  /**
+   * \brief Whether the objects are reused
+   */
+  bool IsEnabled (void) const
+  {
+    return m_enabled;
+  }
+
+  /**
+   * \brief Get an empty object, reused if possible
+   */
+  Ptr<T> Get (void)
+  {
+    m_requests++;
+    m_allocations++;
+    if (!m_enabled)
+      {
+        return New (std::is_base_of<Object, T> ());
+      }
+    for (uint32_t i = 0; i < m_objects.size (); i++)
+      {
+        Ptr<T> object = m_objects[m_next];
+        m_next = (m_next + 1) % m_objects.size ();
+        // the reference held by this function, and the one of the pool
+        if (object->GetReferenceCount () == 2)
+          {
+            object->Clear ();
+            m_allocations--;
+            return object;
+          }
+      }
+    Ptr<T> object = New (std::is_base_of<Object, T> ());
+    m_objects.push_back (object);
+    return object;
+  }
+
+  /**
+   * \brief Get the number of objects requested by Get
+   */
+  uint64_t GetNRequests (void) const
+  {
+    return m_requests;
+  }
+
+  /**
+   * \brief Get the number of objects constructed by Get
+   */
+  uint64_t GetNAllocations (void) const
+  {
+    return m_allocations;
+  }
+
+  /**
+   * \brief Release the objects of the pool
+   */
+  void Clear (void)
+  {
+    m_objects.clear ();
+    m_next = 0;
+  }
+
+private:
+  static Ptr<T> New (std::true_type)
+  {
+    return CreateObject<T> ();
+  }
+
+  static Ptr<T> New (std::false_type)
+  {
+    return Create<T> ();
+  }
+
+  bool m_enabled;                   // whether the objects are reused
+  std::vector<Ptr<T> > m_objects;   // all the objects allocated by the pool
+  uint32_t m_next;                  // next object to check in m_objects
+  uint64_t m_requests;
+  uint64_t m_allocations;           // objects constructed by Get
+};
+
+} // namespace mmwave
+
+} // namespace ns3
+
+#endif /* SRC_MMWAVE_MODEL_MMWAVE_TX_POOL_H_ */
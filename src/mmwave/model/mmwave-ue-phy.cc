@@ -569,7 +569,7 @@ MmWaveUePhy::StartTti ()
     {
       SetSubChannelsForTransmission (m_channelChunks);
       currTtiDuration = m_phyMacConfig->GetUlCtrlSymbols () * m_phyMacConfig->GetSymbolPeriod ();
-      std::list<Ptr<MmWaveControlMessage> > ctrlMsg = GetControlMessages ();
+      Ptr<MmWaveControlMessageList> ctrlMsg = GetControlMessages ();
       NS_LOG_DEBUG ("UE" << m_rnti << " imsi" << m_imsi << " TXing UL CTRL frame " << m_frameNum << " subframe " << (unsigned)m_sfNum << " symbols "
                          << (unsigned)currTti.m_dci.m_symStart << "-" << (unsigned)(currTti.m_dci.m_symStart + currTti.m_dci.m_numSym - 1) <<
                     "\t start " << Simulator::Now () << " end " << (Simulator::Now () + currTtiDuration - NanoSeconds (1.0)));
@@ -623,7 +623,7 @@ MmWaveUePhy::StartTti ()
 
       if (pktBurst)
         {
-          std::list<Ptr<MmWaveControlMessage> > ctrlMsg = GetControlMessages ();
+          Ptr<MmWaveControlMessageList> ctrlMsg = GetControlMessages ();
           m_sendDataChannelEvent = Simulator::Schedule (NanoSeconds (1.0), &MmWaveUePhy::SendDataChannels, this, pktBurst, ctrlMsg, currTtiDuration - NanoSeconds (2.0), m_slotNum);
         }
     }
@@ -715,7 +715,7 @@ MmWaveUePhy::DelayPhyDataPacketReceived (Ptr<Packet> p)
 }
 
 void
-MmWaveUePhy::SendDataChannels (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveControlMessage> > ctrlMsg, Time duration, uint8_t slotInd)
+MmWaveUePhy::SendDataChannels (Ptr<PacketBurst> pb, Ptr<MmWaveControlMessageList> ctrlMsg, Time duration, uint8_t slotInd)
 {
 
   //Ptr<PhasedArrayModel> antennaArray = DynamicCast<PhasedArrayModel> (GetDlSpectrumPhy ()->GetRxAntenna());
@@ -739,7 +739,7 @@ MmWaveUePhy::SendDataChannels (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveControlM
 }
 
 void
-MmWaveUePhy::SendCtrlChannels (std::list<Ptr<MmWaveControlMessage> > ctrlMsg, Time prd)
+MmWaveUePhy::SendCtrlChannels (Ptr<MmWaveControlMessageList> ctrlMsg, Time prd)
 {
   m_downlinkSpectrumPhy->StartTxDlControlFrames (ctrlMsg,prd);
 }
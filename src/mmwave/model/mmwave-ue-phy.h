@@ -157,9 +157,9 @@ public:
   void PhyDataPacketReceived (Ptr<Packet> p);
   void DelayPhyDataPacketReceived (Ptr<Packet> p);
 
-  void SendDataChannels (Ptr<PacketBurst> pb, std::list<Ptr<MmWaveControlMessage> > ctrlMsg, Time duration, uint8_t slotInd);
+  void SendDataChannels (Ptr<PacketBurst> pb, Ptr<MmWaveControlMessageList> ctrlMsg, Time duration, uint8_t slotInd);
 
-  void SendCtrlChannels (std::list<Ptr<MmWaveControlMessage> > ctrlMsg, Time prd);
+  void SendCtrlChannels (Ptr<MmWaveControlMessageList> ctrlMsg, Time prd);
 
   uint32_t GetAbsoluteSubframeNo ();       // Used for tracing purposes
 
@@ -0,0 +1,716 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/test.h"
+#include "ns3/boolean.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/mmwave-mac-scheduler.h"
+#include "ns3/mmwave-phy-mac-common.h"
+#include "ns3/mmwave-indexed-heap.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <set>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveFlexTtiSchedulerTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-flex-tti-scheduler-test.cc
+ * \ingroup test
+ *
+ * \brief This test checks the DCIs of the flex-TTI schedulers against golden
+ * digests, the release of their UEs, and the indexed heap used by the PF and
+ * MaxWeight policies.
+ */
+
+/**
+ * \brief Receives the allocations of a scheduler and computes a digest of them
+ */
+class FlexTtiTestSchedSapUser : public MmWaveMacSchedSapUser
+{
+public:
+  FlexTtiTestSchedSapUser ()
+    : m_digest (14695981039346656037ULL),
+      m_numDataTtis (0)
+  {
+  }
+
+  virtual void SchedConfigInd (const struct SchedConfigIndParameters& params)
+  {
+    m_slotAllocInfo = params.m_slotAllocInfo;
+    Add (params.m_slotAllocInfo.m_numSymAlloc);
+    for (const TtiAllocInfo &tti : params.m_slotAllocInfo.m_ttiAllocInfo)
+      {
+        Add (tti.m_tddMode);
+        Add (tti.m_ttiType);
+        Add (tti.m_ttiIdx);
+        Add (tti.m_rnti);
+        Add (tti.m_dci.m_rnti);
+        Add (tti.m_dci.m_format);
+        Add (tti.m_dci.m_symStart);
+        Add (tti.m_dci.m_numSym);
+        Add (tti.m_dci.m_mcs);
+        Add (tti.m_dci.m_tbSize);
+        Add (tti.m_dci.m_ndi);
+        Add (tti.m_dci.m_rv);
+        Add (tti.m_dci.m_harqProcess);
+        for (const RlcPduInfo &rlcPdu : tti.m_rlcPduInfo)
+          {
+            Add (rlcPdu.m_lcid);
+            Add (rlcPdu.m_size);
+          }
+        if (tti.m_ttiType != TtiAllocInfo::CTRL)
+          {
+            m_numDataTtis++;
+          }
+      }
+  }
+
+  SlotAllocInfo m_slotAllocInfo; //!< the allocation of the last slot
+  uint64_t m_digest;             //!< FNV-1a hash of the allocations
+  uint64_t m_numDataTtis;        //!< number of data TTIs allocated
+
+private:
+  /**
+   * Adds a value to the digest
+   * \param value the value
+   */
+  void Add (uint32_t value)
+  {
+    for (int i = 0; i < 4; i++)
+      {
+        m_digest ^= (value >> (8 * i)) & 0xFF;
+        m_digest *= 1099511628211ULL;
+      }
+  }
+};
+
+/**
+ * \brief Ignores the confirmations of a scheduler
+ */
+class FlexTtiTestCschedSapUser : public MmWaveMacCschedSapUser
+{
+public:
+  virtual void CschedCellConfigCnf (const struct CschedCellConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigCnf (const struct CschedUeConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcConfigCnf (const struct CschedLcConfigCnfParameters& params)
+  {
+  }
+  virtual void CschedLcReleaseCnf (const struct CschedLcReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeReleaseCnf (const struct CschedUeReleaseCnfParameters& params)
+  {
+  }
+  virtual void CschedUeConfigUpdateInd (const struct CschedUeConfigUpdateIndParameters& params)
+  {
+  }
+  virtual void CschedCellConfigUpdateInd (const struct CschedCellConfigUpdateIndParameters& params)
+  {
+  }
+};
+
+/**
+ * \brief Drives a flex-TTI scheduler through its SAPs, as MmWaveEnbMac does
+ *
+ * In each slot the UEs report random DL RLC buffers, BSRs and DL CQIs, and
+ * the UL CQIs and the HARQ feedback of the previous allocations are sent
+ * back to the scheduler. The inputs only depend on the number of UEs and on
+ * the allocations, as in the mmwave-scheduler-benchmark example.
+ */
+class FlexTtiSchedulerDriver
+{
+public:
+  /**
+   * Create and configure a scheduler
+   * \param schedType the type of the scheduler
+   * \param harq the value of the HarqEnabled attribute
+   * \param numUes the number of UEs, with RNTIs 1 to numUes
+   */
+  FlexTtiSchedulerDriver (std::string schedType, bool harq, uint16_t numUes);
+  ~FlexTtiSchedulerDriver ();
+
+  /**
+   * Schedule a slot
+   */
+  void ScheduleSlot (void);
+
+  /**
+   * Release a UE
+   * \param rnti the RNTI of the UE
+   */
+  void ReleaseUe (uint16_t rnti);
+
+  /**
+   * \return the digest of the allocations so far
+   */
+  uint64_t GetDigest (void) const;
+
+  /**
+   * \return the allocation of the last slot
+   */
+  const SlotAllocInfo& GetSlotAllocInfo (void) const;
+
+  /**
+   * \return the number of data TTIs allocated so far
+   */
+  uint64_t GetNumDataTtis (void) const;
+
+private:
+  /**
+   * Configures a UE with a signalling and a data logical channel
+   * \param rnti the RNTI of the UE
+   */
+  void ConfigureUe (uint16_t rnti);
+
+  bool m_harq;                                //!< whether HARQ is enabled
+  Ptr<MmWavePhyMacCommon> m_config;           //!< the PHY and MAC parameters
+  Ptr<MmWaveMacScheduler> m_sched;            //!< the scheduler
+  FlexTtiTestSchedSapUser m_schedSapUser;     //!< the SCHED SAP user
+  FlexTtiTestCschedSapUser m_cschedSapUser;   //!< the CSCHED SAP user
+  Ptr<UniformRandomVariable> m_rv;            //!< the source of the inputs
+  std::list<uint16_t> m_ueList;               //!< the RNTIs of the UEs
+  std::vector<MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters> m_ulCqis; //!< UL CQIs of the last slot
+  std::vector<DlHarqInfo> m_dlHarqFeedback;   //!< DL HARQ feedback of the last slot
+  std::vector<UlHarqInfo> m_ulHarqFeedback;   //!< UL HARQ feedback of the last slot
+  SfnSf m_sfn;                                //!< the next slot
+};
+
+FlexTtiSchedulerDriver::FlexTtiSchedulerDriver (std::string schedType, bool harq, uint16_t numUes)
+  : m_harq (harq),
+    m_sfn (1, 0, 0, 0)
+{
+  m_config = CreateObject<MmWavePhyMacCommon> ();
+  ObjectFactory schedFactory;
+  schedFactory.SetTypeId (schedType);
+  schedFactory.Set ("HarqEnabled", BooleanValue (harq));
+  m_sched = DynamicCast<MmWaveMacScheduler> (schedFactory.Create ());
+  m_sched->ConfigureCommonParameters (m_config);
+  m_sched->SetMacSchedSapUser (&m_schedSapUser);
+  m_sched->SetMacCschedSapUser (&m_cschedSapUser);
+
+  MmWaveMacCschedSapProvider::CschedCellConfigReqParameters cellParams;
+  cellParams.m_ulBandwidth = m_config->GetNumRb ();
+  cellParams.m_dlBandwidth = m_config->GetNumRb ();
+  m_sched->GetMacCschedSapProvider ()->CschedCellConfigReq (cellParams);
+  for (uint16_t rnti = 1; rnti <= numUes; rnti++)
+    {
+      ConfigureUe (rnti);
+      m_ueList.push_back (rnti);
+    }
+
+  m_rv = CreateObject<UniformRandomVariable> ();
+  m_rv->SetStream (1);
+}
+
+FlexTtiSchedulerDriver::~FlexTtiSchedulerDriver ()
+{
+  m_sched->Dispose ();
+}
+
+void
+FlexTtiSchedulerDriver::ConfigureUe (uint16_t rnti)
+{
+  MmWaveMacCschedSapProvider *csched = m_sched->GetMacCschedSapProvider ();
+  MmWaveMacCschedSapProvider::CschedUeConfigReqParameters ueParams;
+  ueParams.m_rnti = rnti;
+  ueParams.m_transmissionMode = 0;
+  csched->CschedUeConfigReq (ueParams);
+
+  for (uint8_t lcid : {1, 3})
+    {
+      MmWaveMacCschedSapProvider::CschedLcConfigReqParameters lcParams;
+      lcParams.m_rnti = rnti;
+      lcParams.m_reconfigureFlag = false;
+      LogicalChannelConfigListElement_s lccle;
+      lccle.m_logicalChannelIdentity = lcid;
+      lccle.m_logicalChannelGroup = (lcid == 1) ? 0 : 1;
+      lccle.m_direction = LogicalChannelConfigListElement_s::DIR_BOTH;
+      lccle.m_qosBearerType = LogicalChannelConfigListElement_s::QBT_NON_GBR;
+      lccle.m_qci = 9;
+      lccle.m_eRabMaximulBitrateUl = 0;
+      lccle.m_eRabMaximulBitrateDl = 0;
+      lccle.m_eRabGuaranteedBitrateUl = 0;
+      lccle.m_eRabGuaranteedBitrateDl = 0;
+      lcParams.m_logicalChannelConfigList.push_back (lccle);
+      csched->CschedLcConfigReq (lcParams);
+    }
+}
+
+void
+FlexTtiSchedulerDriver::ReleaseUe (uint16_t rnti)
+{
+  MmWaveMacCschedSapProvider::CschedUeReleaseReqParameters params;
+  params.m_rnti = rnti;
+  m_sched->GetMacCschedSapProvider ()->CschedUeReleaseReq (params);
+  m_ueList.remove (rnti);
+  // the feedback of the UE is not received any more
+  m_dlHarqFeedback.erase (std::remove_if (m_dlHarqFeedback.begin (), m_dlHarqFeedback.end (),
+                                          [rnti] (const DlHarqInfo &info) { return info.m_rnti == rnti; }),
+                          m_dlHarqFeedback.end ());
+  m_ulHarqFeedback.erase (std::remove_if (m_ulHarqFeedback.begin (), m_ulHarqFeedback.end (),
+                                          [rnti] (const UlHarqInfo &info) { return info.m_rnti == rnti; }),
+                          m_ulHarqFeedback.end ());
+}
+
+void
+FlexTtiSchedulerDriver::ScheduleSlot (void)
+{
+  MmWaveMacSchedSapProvider *schedSap = m_sched->GetMacSchedSapProvider ();
+  MmWaveMacSchedSapProvider::SchedDlCqiInfoReqParameters dlCqiParams;
+  dlCqiParams.m_sfnsf = m_sfn;
+  MmWaveMacSchedSapProvider::SchedUlMacCtrlInfoReqParameters bsrParams;
+  bsrParams.m_sfnSf = m_sfn;
+  for (uint16_t rnti : m_ueList)
+    {
+      if (m_rv->GetValue () < 0.3)
+        {
+          MmWaveMacSchedSapProvider::SchedDlRlcBufferReqParameters rlcParams;
+          rlcParams.m_rnti = rnti;
+          rlcParams.m_logicalChannelIdentity = (m_rv->GetValue () < 0.1) ? 1 : 3;
+          rlcParams.m_rlcTransmissionQueueSize = 0;
+          rlcParams.m_rlcTransmissionQueueHolDelay = m_rv->GetInteger (0, 20);
+          rlcParams.m_rlcRetransmissionQueueSize = 0;
+          rlcParams.m_rlcRetransmissionHolDelay = 0;
+          rlcParams.m_rlcStatusPduSize = 0;
+          rlcParams.m_arrivalRate = 0;
+          uint32_t numPackets = m_rv->GetInteger (0, 10);
+          for (uint32_t i = 0; i < numPackets; i++)
+            {
+              uint32_t size = m_rv->GetInteger (40, 1500);
+              rlcParams.m_rlcTransmissionQueueSize += size;
+              rlcParams.m_txPacketSizes.push_back (size);
+              rlcParams.m_txPacketDelays.push_back (m_rv->GetInteger (0, 20000));
+            }
+          schedSap->SchedDlRlcBufferReq (rlcParams);
+        }
+      if (m_rv->GetValue () < 0.2)
+        {
+          DlCqiInfo cqi;
+          cqi.m_rnti = rnti;
+          cqi.m_ri = 1;
+          cqi.m_cqiType = DlCqiInfo::WB;
+          cqi.m_wbCqi = m_rv->GetInteger (0, 15);
+          cqi.m_wbPmi = 0;
+          dlCqiParams.m_cqiList.push_back (cqi);
+        }
+      if (m_rv->GetValue () < 0.2)
+        {
+          MacCeElement bsr;
+          bsr.m_rnti = rnti;
+          bsr.m_macCeType = MacCeElement::BSR;
+          bsr.m_macCeValue.m_phr = 0;
+          bsr.m_macCeValue.m_crnti = 0;
+          bsr.m_macCeValue.m_bufferStatus.resize (4, 0);
+          bsr.m_macCeValue.m_bufferStatus[1] = m_rv->GetInteger (0, 40);
+          bsrParams.m_macCeList.push_back (bsr);
+        }
+    }
+  schedSap->SchedDlCqiInfoReq (dlCqiParams);
+  for (const MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters &ulCqi : m_ulCqis)
+    {
+      schedSap->SchedUlCqiInfoReq (ulCqi);
+    }
+  if (!bsrParams.m_macCeList.empty ())
+    {
+      schedSap->SchedUlMacCtrlInfoReq (bsrParams);
+    }
+
+  MmWaveMacSchedSapProvider::SchedTriggerReqParameters triggerParams;
+  triggerParams.m_snfSf = m_sfn;
+  triggerParams.m_ueList = m_ueList;
+  triggerParams.m_dlHarqInfoList.swap (m_dlHarqFeedback);
+  triggerParams.m_ulHarqInfoList.swap (m_ulHarqFeedback);
+  schedSap->SchedTriggerReq (triggerParams);
+
+  // the UL CQIs and the HARQ feedback of this slot are received in the next one
+  m_ulCqis.clear ();
+  const SlotAllocInfo &alloc = m_schedSapUser.m_slotAllocInfo;
+  for (const TtiAllocInfo &tti : alloc.m_ttiAllocInfo)
+    {
+      if (tti.m_ttiType == TtiAllocInfo::CTRL)
+        {
+          continue;
+        }
+      bool ok = m_rv->GetValue () > 0.1;
+      if (tti.m_tddMode == TtiAllocInfo::DL_slotAllocInfo)
+        {
+          DlHarqInfo info;
+          info.m_rnti = tti.m_dci.m_rnti;
+          info.m_harqProcessId = tti.m_dci.m_harqProcess;
+          info.m_harqStatus = ok ? DlHarqInfo::ACK : DlHarqInfo::NACK;
+          info.m_numRetx = tti.m_dci.m_rv;
+          if (m_harq)
+            {
+              m_dlHarqFeedback.push_back (info);
+            }
+          continue;
+        }
+      UlHarqInfo info;
+      info.m_rnti = tti.m_dci.m_rnti;
+      info.m_harqProcessId = tti.m_dci.m_harqProcess;
+      info.m_receptionStatus = ok ? UlHarqInfo::Ok : UlHarqInfo::NotOk;
+      info.m_numRetx = tti.m_dci.m_rv;
+      if (m_harq)
+        {
+          m_ulHarqFeedback.push_back (info);
+        }
+
+      MmWaveMacSchedSapProvider::SchedUlCqiInfoReqParameters ulCqi;
+      ulCqi.m_ulCqi.m_type = UlCqiInfo::PUSCH;
+      double sinr = std::pow (10, m_rv->GetValue (0, 25) / 10);
+      ulCqi.m_ulCqi.m_sinr.assign (m_config->GetNumRb (), sinr);
+      // the schedulers identify the UL allocations either by the start
+      // symbol or by the slot index replaced by the start symbol
+      ulCqi.m_sfnSf = alloc.m_sfnSf;
+      ulCqi.m_sfnSf.m_symStart = tti.m_dci.m_symStart;
+      m_ulCqis.push_back (ulCqi);
+      SfnSf otherSfn = alloc.m_sfnSf;
+      otherSfn.m_slotNum = tti.m_dci.m_symStart;
+      if (otherSfn.Encode () != ulCqi.m_sfnSf.Encode ())
+        {
+          ulCqi.m_sfnSf = otherSfn;
+          m_ulCqis.push_back (ulCqi);
+        }
+    }
+
+  if (++m_sfn.m_slotNum == m_config->GetSlotsPerSubframe ())
+    {
+      m_sfn.m_slotNum = 0;
+      if (++m_sfn.m_sfNum == m_config->GetSubframesPerFrame ())
+        {
+          m_sfn.m_sfNum = 0;
+          m_sfn.m_frameNum++;
+        }
+    }
+}
+
+uint64_t
+FlexTtiSchedulerDriver::GetDigest (void) const
+{
+  return m_schedSapUser.m_digest;
+}
+
+const SlotAllocInfo&
+FlexTtiSchedulerDriver::GetSlotAllocInfo (void) const
+{
+  return m_schedSapUser.m_slotAllocInfo;
+}
+
+uint64_t
+FlexTtiSchedulerDriver::GetNumDataTtis (void) const
+{
+  return m_schedSapUser.m_numDataTtis;
+}
+
+/**
+ * \brief Checks the digest of the DCIs of a flex-TTI scheduler
+ *
+ * Where they could be, the golden digests were computed with the schedulers
+ * as they were before they shared MmWaveFlexTtiMacSchedulerEngine.
+ */
+class MmWaveFlexTtiSchedulerDigestTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param schedType the type of the scheduler
+   * \param harq the value of the HarqEnabled attribute
+   * \param numUes the number of UEs
+   * \param digest the expected digest of the DCIs
+   */
+  MmWaveFlexTtiSchedulerDigestTestCase (std::string schedType, bool harq, uint16_t numUes, uint64_t digest);
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_schedType; //!< the type of the scheduler
+  bool m_harq;             //!< the value of the HarqEnabled attribute
+  uint16_t m_numUes;       //!< the number of UEs
+  uint64_t m_digest;       //!< the expected digest of the DCIs
+};
+
+MmWaveFlexTtiSchedulerDigestTestCase::MmWaveFlexTtiSchedulerDigestTestCase (std::string schedType, bool harq,
+                                                                            uint16_t numUes, uint64_t digest)
+  : TestCase ("Checks the DCIs of " + schedType + (harq ? " with" : " without") + " HARQ, "
+              + std::to_string (numUes) + " UEs"),
+    m_schedType (schedType),
+    m_harq (harq),
+    m_numUes (numUes),
+    m_digest (digest)
+{
+}
+
+void
+MmWaveFlexTtiSchedulerDigestTestCase::DoRun (void)
+{
+  FlexTtiSchedulerDriver driver (m_schedType, m_harq, m_numUes);
+  for (uint32_t slot = 0; slot < 1000; slot++)
+    {
+      driver.ScheduleSlot ();
+    }
+  NS_TEST_ASSERT_MSG_GT (driver.GetNumDataTtis (), 0, "No data TTI was allocated");
+  std::ostringstream digest;
+  digest << std::hex << std::setw (16) << std::setfill ('0') << driver.GetDigest ();
+  NS_LOG_INFO (GetName () << ": digest " << digest.str ());
+  NS_TEST_ASSERT_MSG_EQ (driver.GetDigest (), m_digest, "Different DCIs, digest " << digest.str ());
+}
+
+/**
+ * \brief Checks that a flex-TTI scheduler stops serving the UEs that are
+ * released, and keeps serving the others
+ *
+ * The released UEs are removed from the PF heap and their flows from the
+ * MaxWeight heap.
+ */
+class MmWaveFlexTtiSchedulerReleaseTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param schedType the type of the scheduler
+   * \param harq the value of the HarqEnabled attribute
+   */
+  MmWaveFlexTtiSchedulerReleaseTestCase (std::string schedType, bool harq);
+
+private:
+  virtual void DoRun (void);
+
+  std::string m_schedType; //!< the type of the scheduler
+  bool m_harq;             //!< the value of the HarqEnabled attribute
+};
+
+MmWaveFlexTtiSchedulerReleaseTestCase::MmWaveFlexTtiSchedulerReleaseTestCase (std::string schedType, bool harq)
+  : TestCase ("Checks that " + schedType + (harq ? " with" : " without") + " HARQ does not serve the released UEs"),
+    m_schedType (schedType),
+    m_harq (harq)
+{
+}
+
+void
+MmWaveFlexTtiSchedulerReleaseTestCase::DoRun (void)
+{
+  FlexTtiSchedulerDriver driver (m_schedType, m_harq, 16);
+  for (uint32_t slot = 0; slot < 200; slot++)
+    {
+      driver.ScheduleSlot ();
+    }
+  std::set<uint16_t> released;
+  for (uint16_t rnti = 2; rnti <= 16; rnti += 3)
+    {
+      driver.ReleaseUe (rnti);
+      released.insert (rnti);
+    }
+  uint64_t numDataTtis = driver.GetNumDataTtis ();
+  for (uint32_t slot = 0; slot < 200; slot++)
+    {
+      driver.ScheduleSlot ();
+      for (const TtiAllocInfo &tti : driver.GetSlotAllocInfo ().m_ttiAllocInfo)
+        {
+          if (tti.m_ttiType != TtiAllocInfo::CTRL)
+            {
+              NS_TEST_ASSERT_MSG_EQ (released.count (tti.m_dci.m_rnti), 0,
+                                     "Released UE " << tti.m_dci.m_rnti << " was allocated");
+            }
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (driver.GetNumDataTtis (), numDataTtis, "The other UEs were not served");
+}
+
+/**
+ * \brief Checks MmWaveIndexedHeap against a std::set of (key, id) pairs,
+ * with random updates, removals and pops
+ */
+class MmWaveIndexedHeapTestCase : public TestCase
+{
+public:
+  MmWaveIndexedHeapTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmWaveIndexedHeapTestCase::MmWaveIndexedHeapTestCase ()
+  : TestCase ("Checks the indexed heap against a std::set")
+{
+}
+
+void
+MmWaveIndexedHeapTestCase::DoRun (void)
+{
+  // the keys are made different by the id, as done by the policies
+  typedef std::pair<uint32_t, uint32_t> Key;
+  MmWaveIndexedHeap<Key> heap;
+  std::set<Key> reference;
+  std::vector<uint32_t> keyOf (64, 0);
+  Ptr<UniformRandomVariable> rv = CreateObject<UniformRandomVariable> ();
+  rv->SetStream (1);
+  for (uint32_t i = 0; i < 20000; i++)
+    {
+      uint32_t id = rv->GetInteger (0, 63);
+      uint32_t op = rv->GetInteger (0, 9);
+      if (op < 5)
+        {
+          // insert, or change the key
+          if (heap.Contains (id))
+            {
+              reference.erase (Key (keyOf[id], id));
+            }
+          keyOf[id] = rv->GetInteger (0, 15);
+          heap.Update (id, Key (keyOf[id], id));
+          reference.insert (Key (keyOf[id], id));
+        }
+      else if (op < 7)
+        {
+          if (heap.Contains (id))
+            {
+              reference.erase (Key (keyOf[id], id));
+            }
+          heap.Remove (id);
+        }
+      else if (op < 9)
+        {
+          if (!heap.IsEmpty ())
+            {
+              NS_TEST_ASSERT_MSG_EQ (heap.Top (), reference.begin ()->second, "Wrong top");
+              reference.erase (reference.begin ());
+              heap.Pop ();
+            }
+        }
+      else
+        {
+          // age all the keys, as done by MaxWeight for the flows
+          heap.UpdateAll ([&keyOf, &reference] (uint32_t id, Key &key)
+            {
+              reference.erase (key);
+              keyOf[id] = (key.first * 7 + 3) % 16;
+              key.first = keyOf[id];
+            });
+          for (uint32_t j = 0; j < keyOf.size (); j++)
+            {
+              if (heap.Contains (j))
+                {
+                  reference.insert (Key (keyOf[j], j));
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (heap.GetSize (), reference.size (), "Wrong size");
+      if (!heap.IsEmpty ())
+        {
+          NS_TEST_ASSERT_MSG_EQ (heap.Top (), reference.begin ()->second, "Wrong top");
+        }
+    }
+}
+
+/**
+ * \brief The flex-TTI schedulers test suite
+ */
+class MmWaveFlexTtiSchedulerTestSuite : public TestSuite
+{
+public:
+  MmWaveFlexTtiSchedulerTestSuite ();
+};
+
+MmWaveFlexTtiSchedulerTestSuite::MmWaveFlexTtiSchedulerTestSuite ()
+  : TestSuite ("mmwave-flex-tti-scheduler-test", UNIT)
+{
+  /**
+   * Golden digest of the DCIs of a scheduler
+   */
+  struct GoldenDigest
+  {
+    std::string m_schedType; //!< the type of the scheduler
+    bool m_harq;             //!< the value of the HarqEnabled attribute
+    uint16_t m_numUes;       //!< the number of UEs
+    uint64_t m_digest;       //!< the digest of the DCIs
+  };
+  // The digests over 1000 slots. Round robin without HARQ, MaxRate, and PF
+  // with 1 UE or with 3 UEs without HARQ match the schedulers before
+  // MmWaveFlexTtiMacSchedulerEngine. Since then, the round robin DL HARQ
+  // retx TTIs carry the RNTI of the UE, and PF sorts only the UEs of the
+  // slot and breaks its ties by RNTI. The previous MaxWeight scheduler
+  // aborted on the PDUs that did not fit in a slot: its digests are those of
+  // the first version that segments these PDUs.
+  const GoldenDigest goldenDigests[] = {
+    {"ns3::MmWaveFlexTtiMacScheduler", true, 1, 0x7bb5127c998564bcULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", true, 3, 0x896bc49eee88bd12ULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", true, 8, 0xeab951f210c00167ULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", true, 20, 0xff920e6b6f89490eULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", true, 64, 0xaf21732a10b468d3ULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", false, 1, 0xe36efc5170ea259fULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", false, 3, 0x319b86f5f06b579eULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", false, 8, 0x5e191f500804eacaULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", false, 20, 0xb5cddf8144772e8eULL},
+    {"ns3::MmWaveFlexTtiMacScheduler", false, 64, 0x0444937ef80072d9ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", true, 1, 0x7bbd5a519d009966ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", true, 3, 0xf62adabc48eecd56ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", true, 8, 0xe0f90aea71a64704ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", true, 20, 0x266bf8e635ed7caaULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", true, 64, 0xfd6e91fdab579015ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", false, 1, 0x810f2559e24bacb4ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", false, 3, 0xe5a78b452d520c44ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", false, 8, 0x5da4bb936fc9950dULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", false, 20, 0x1bc64f87445ab808ULL},
+    {"ns3::MmWaveFlexTtiPfMacScheduler", false, 64, 0x72ef1798d6e0ca28ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", true, 1, 0x6253dd318608e4eaULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", true, 3, 0xbe6ae3ace3e354e4ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", true, 8, 0x0113160746f56bd1ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", true, 20, 0x3fb64eb631067badULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", true, 64, 0xf7033c0aa7f72769ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false, 1, 0x44925707f34c3960ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false, 3, 0x79f0dec04bc6d033ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false, 8, 0x3e4b388890147b2cULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false, 20, 0xef13dc3bb57e50c6ULL},
+    {"ns3::MmWaveFlexTtiMaxRateMacScheduler", false, 64, 0x3d83dbeda247ce3eULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", true, 1, 0x47a9fb16372b0d94ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", true, 3, 0x5b2fc57c501339eaULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", true, 8, 0xbe7d6268e262dba1ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", true, 20, 0xfee905d7f474b601ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", true, 64, 0x78021ee3b6730c18ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false, 1, 0x58990801db5d21b8ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false, 3, 0xe1988faac35ff394ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false, 8, 0xb56d718ead92a592ULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false, 20, 0xcd6569a54ee98e3cULL},
+    {"ns3::MmWaveFlexTtiMaxWeightMacScheduler", false, 64, 0x3627afbf7c2e5183ULL},
+  };
+
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveIndexedHeapTestCase, TestCase::QUICK);
+  for (const GoldenDigest &golden : goldenDigests)
+    {
+      AddTestCase (new MmWaveFlexTtiSchedulerDigestTestCase (golden.m_schedType, golden.m_harq,
+                                                             golden.m_numUes, golden.m_digest),
+                   golden.m_numUes > 8 ? TestCase::EXTENSIVE : TestCase::QUICK);
+    }
+  for (std::string schedType : {"ns3::MmWaveFlexTtiMacScheduler", "ns3::MmWaveFlexTtiPfMacScheduler",
+                                "ns3::MmWaveFlexTtiMaxRateMacScheduler", "ns3::MmWaveFlexTtiMaxWeightMacScheduler"})
+    {
+      AddTestCase (new MmWaveFlexTtiSchedulerReleaseTestCase (schedType, true), TestCase::QUICK);
+      AddTestCase (new MmWaveFlexTtiSchedulerReleaseTestCase (schedType, false), TestCase::QUICK);
+    }
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveFlexTtiSchedulerTestSuite mmwaveTestSuite;
@@ -23,6 +23,9 @@
 #include "ns3/mmwave-eesm-cc-t2.h"
 #include "ns3/mmwave-eesm-ir-t1.h"
 #include "ns3/mmwave-eesm-ir-t2.h"
+#include "ns3/mmwave-lte-mi-error-model.h"
+#include "ns3/spectrum-value.h"
+#include <cmath>
 
 using namespace ns3;
 using namespace mmwave;
@@ -259,12 +262,89 @@ MmWaveL2smEesmTestCase::DoRun ()
   TestEesmIrTable2 ();
 }
 
+/**
+ * \brief Checks that the MI of a TB does not depend on how its RBs are
+ * mapped, i.e., that the vectorized mapping of the RBs, if the CPU supports
+ * it, gives the same MI as the mapping of one RB at a time
+ */
+class MmWaveL2smMiesmTestCase : public TestCase
+{
+public:
+  MmWaveL2smMiesmTestCase () : TestCase ("MI of the RBs mapped at once and one at a time") { }
+
+private:
+  virtual void DoRun (void) override;
+};
+
+void
+MmWaveL2smMiesmTestCase::DoRun ()
+{
+  // 37 RBs, so that the vectorized mapping has a remainder
+  const uint32_t numRbs = 37;
+  std::vector<double> freqs;
+  for (uint32_t rb = 0; rb < numRbs; rb++)
+    {
+      freqs.push_back (28e9 + rb * 1.44e6);
+    }
+  SpectrumValue sinr (Create<SpectrumModel> (freqs));
+  for (uint32_t rb = 0; rb < numRbs; rb++)
+    {
+      // from -20 to 34 dB, below, inside and above the axes of the MI maps
+      sinr[rb] = std::pow (10, (-20.0 + rb * 1.5) / 10);
+    }
+  sinr[3] = 0;
+
+  // the RBs are not in order, and some of them are repeated
+  std::vector<int> map;
+  for (uint32_t i = 0; i < 2 * numRbs; i++)
+    {
+      map.push_back ((i * 7) % numRbs);
+    }
+
+  // an MCS for each modulation
+  for (uint8_t mcs : {0, 9, 10, 16, 17, 28})
+    {
+      for (size_t size : {1, 3, 4, 9, 37, 74})
+        {
+          std::vector<int> tbMap (map.begin (), map.begin () + size);
+          double miSum = 0.0;
+          for (int rb : tbMap)
+            {
+              miSum += MmWaveLteMiMib (sinr, {rb}, mcs);
+            }
+          NS_TEST_ASSERT_MSG_EQ (MmWaveLteMiMib (sinr, tbMap, mcs), miSum / size,
+                                 "Wrong MI for MCS " << +mcs << " and " << size << " RBs");
+        }
+    }
+  NS_TEST_ASSERT_MSG_EQ (MmWaveLteMiMib (sinr, {}, 0), 0, "Wrong MI without RBs");
+
+  // a SINR equal to the last point of the axis of a modulation gets the
+  // last MI of its map, both one RB at a time and four RBs at a time
+  struct AxisEnd
+  {
+    uint8_t m_mcs;
+    double m_sinr;
+    double m_mi;
+  };
+  for (const AxisEnd &axisEnd : {AxisEnd {0, 3.197, 0.862005}, AxisEnd {10, 9.993, 0.764879},
+                                 AxisEnd {17, 157.96, 0.985302}})
+    {
+      SpectrumValue edgeSinr (sinr.GetSpectrumModel ());
+      edgeSinr = axisEnd.m_sinr;
+      NS_TEST_ASSERT_MSG_EQ (MmWaveLteMiMib (edgeSinr, {0}, axisEnd.m_mcs), axisEnd.m_mi,
+                             "Wrong MI at the end of the axis for MCS " << +axisEnd.m_mcs);
+      NS_TEST_ASSERT_MSG_EQ (MmWaveLteMiMib (edgeSinr, {0, 1, 2, 3}, axisEnd.m_mcs), axisEnd.m_mi,
+                             "Wrong MI of four RBs at the end of the axis for MCS " << +axisEnd.m_mcs);
+    }
+}
+
 class MmWaveTestL2smEesm : public TestSuite
 {
 public:
   MmWaveTestL2smEesm () : TestSuite ("mmwave-l2sm-test", UNIT)
     {
       AddTestCase(new MmWaveL2smEesmTestCase ("First test"), QUICK);
+      AddTestCase(new MmWaveL2smMiesmTestCase (), QUICK);
     }
 };
 
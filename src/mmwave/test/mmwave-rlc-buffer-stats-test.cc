@@ -0,0 +1,243 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-rlc-buffer-stats-calculator.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc-sap.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include <fstream>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveRlcBufferStatsTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* A MAC SAP provider that drops the PDUs
+*/
+class MmWaveRlcBufferStatsTestMac : public LteMacSapProvider
+{
+public:
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+  }
+
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+  }
+};
+
+/**
+* This test case samples the buffers of AM entities with
+* MmWaveRlcBufferStatsCalculator and checks the rows of the samples
+*/
+class MmWaveRlcBufferStatsTestCase : public TestCase
+{
+public:
+  MmWaveRlcBufferStatsTestCase ();
+  virtual ~MmWaveRlcBufferStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Give an SDU to an entity
+   */
+  static void TransmitSdu (Ptr<LteRlcAm> rlc, uint32_t size);
+
+  /**
+   * Give a transmission opportunity to an entity
+   */
+  static void NotifyTxOpportunity (Ptr<LteRlcAm> rlc, uint32_t bytes);
+
+  /**
+   * Check if an entity is in the registry of LteRlcAm
+   */
+  static bool IsRegistered (Ptr<LteRlcAm> rlc);
+
+  /**
+   * Read the rows of a text trace, without its header
+   */
+  std::vector<std::vector<std::string> > ReadRows (std::string fileName);
+
+  MmWaveRlcBufferStatsTestMac m_mac;
+};
+
+MmWaveRlcBufferStatsTestCase::MmWaveRlcBufferStatsTestCase ()
+  : TestCase ("Checks the samples of the RLC AM buffers")
+{
+}
+
+MmWaveRlcBufferStatsTestCase::~MmWaveRlcBufferStatsTestCase ()
+{
+}
+
+void
+MmWaveRlcBufferStatsTestCase::TransmitSdu (Ptr<LteRlcAm> rlc, uint32_t size)
+{
+  LteRlcSapProvider::TransmitPdcpPduParameters params;
+  params.pdcpPdu = Create<Packet> (size);
+  params.rnti = rlc->GetRnti ();
+  params.lcid = rlc->GetLcId ();
+  rlc->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+}
+
+void
+MmWaveRlcBufferStatsTestCase::NotifyTxOpportunity (Ptr<LteRlcAm> rlc, uint32_t bytes)
+{
+  LteMacSapUser::TxOpportunityParameters params;
+  params.bytes = bytes;
+  params.layer = 0;
+  params.harqId = 0;
+  params.componentCarrierId = 0;
+  params.rnti = rlc->GetRnti ();
+  params.lcid = rlc->GetLcId ();
+  rlc->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+}
+
+bool
+MmWaveRlcBufferStatsTestCase::IsRegistered (Ptr<LteRlcAm> rlc)
+{
+  for (const std::pair<const uint64_t, LteRlcAm *> &instance : LteRlcAm::GetInstances ())
+    {
+      if (instance.second == PeekPointer (rlc))
+        {
+          return true;
+        }
+    }
+  return false;
+}
+
+std::vector<std::vector<std::string> >
+MmWaveRlcBufferStatsTestCase::ReadRows (std::string fileName)
+{
+  std::vector<std::vector<std::string> > rows;
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  std::getline (file, line);
+  while (std::getline (file, line))
+    {
+      std::vector<std::string> row;
+      std::istringstream columns (line);
+      std::string column;
+      while (std::getline (columns, column, '\t'))
+        {
+          row.push_back (column);
+        }
+      rows.push_back (row);
+    }
+  return rows;
+}
+
+void
+MmWaveRlcBufferStatsTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("RlcBufferStats.txt");
+  Ptr<MmWaveRlcBufferStatsCalculator> stats = CreateObjectWithAttributes<MmWaveRlcBufferStatsCalculator> (
+      "SamplingPeriod", TimeValue (MilliSeconds (10)),
+      "OutputFilename", StringValue (fileName));
+
+  // RNTI 1 is busy, RNTI 2 is idle, and RNTI 3 is disposed before the second sample
+  Ptr<LteRlcAm> rlc[3];
+  for (uint16_t i = 0; i < 3; i++)
+    {
+      rlc[i] = CreateObject<LteRlcAm> ();
+      rlc[i]->SetRnti (i + 1);
+      rlc[i]->SetLcId (3);
+      rlc[i]->SetLteMacSapProvider (&m_mac);
+    }
+  Simulator::Schedule (MilliSeconds (5), &MmWaveRlcBufferStatsTestCase::TransmitSdu, rlc[0], 100);
+  Simulator::Schedule (MilliSeconds (6), &MmWaveRlcBufferStatsTestCase::TransmitSdu, rlc[0], 200);
+  Simulator::Schedule (MilliSeconds (5), &MmWaveRlcBufferStatsTestCase::TransmitSdu, rlc[2], 50);
+  Simulator::Schedule (MilliSeconds (15), &LteRlcAm::Dispose, rlc[2]);
+
+  // the PDU of RNTI 1 is transmitted at 25 ms, and considered for
+  // retransmission when t-PollRetransmit expires, at 45 ms
+  Simulator::Schedule (MilliSeconds (25), &MmWaveRlcBufferStatsTestCase::NotifyTxOpportunity, rlc[0], 1000);
+
+  stats->Start ();
+  Simulator::Stop (MilliSeconds (55));
+  Simulator::Run ();
+  NS_TEST_ASSERT_MSG_EQ (IsRegistered (rlc[0]), true, "RNTI 1 was removed from the registry");
+  NS_TEST_ASSERT_MSG_EQ (IsRegistered (rlc[2]), false, "RNTI 3 is still in the registry");
+  // in another order than the creation
+  rlc[1]->Dispose ();
+  rlc[0]->Dispose ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (IsRegistered (rlc[0]) || IsRegistered (rlc[1]), false, "A disposed entity is in the registry");
+
+  std::vector<std::vector<std::string> > rows = ReadRows (fileName);
+  NS_TEST_ASSERT_MSG_EQ (rows.size (), 6, "Wrong number of rows");
+  NS_TEST_ASSERT_MSG_EQ (stats->GetNRows (), 6, "Wrong number of rows counted");
+  for (const std::vector<std::string> &row : rows)
+    {
+      NS_TEST_ASSERT_MSG_EQ (row.size (), 9, "Wrong number of columns");
+    }
+  if (rows.size () != 6 || rows[0].size () != 9)
+    {
+      return;
+    }
+
+  // 10 ms: the SDUs of RNTI 1 and 3 are in the transmission buffer
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][0]), 0.01, 1e-9, "Wrong time");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][1] + " " + rows[0][2], "1 3", "Wrong RNTI and LCID");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][3], "300", "Wrong transmission buffer size");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][4], "5000", "Wrong HOL delay of the transmission buffer");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][5] + " " + rows[0][6] + " " + rows[0][7] + " " + rows[0][8], "0 0 0 0",
+                         "Wrong retransmission and transmitted buffers");
+  NS_TEST_ASSERT_MSG_EQ (rows[1][1], "3", "Wrong RNTI");
+  NS_TEST_ASSERT_MSG_EQ (rows[1][3], "50", "Wrong transmission buffer size");
+
+  // 20 ms: RNTI 3 was disposed
+  NS_TEST_ASSERT_MSG_EQ (rows[2][1], "1", "Wrong RNTI");
+  NS_TEST_ASSERT_MSG_EQ (rows[2][4], "15000", "Wrong HOL delay of the transmission buffer");
+
+  // 30 and 40 ms: the PDU waits for an ACK
+  uint32_t pduSize = std::stoul (rows[3][8]);
+  NS_TEST_ASSERT_MSG_GT (pduSize, 300, "Wrong transmitted buffer size");
+  NS_TEST_ASSERT_MSG_EQ (rows[3][3] + " " + rows[3][4] + " " + rows[3][5], "0 0 0", "Wrong buffers");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[4][0]), 0.04, 1e-9, "Wrong time");
+
+  // 50 ms: the PDU is considered for retransmission
+  NS_TEST_ASSERT_MSG_EQ (rows[5][5], "1", "Wrong number of PDUs to retransmit");
+  NS_TEST_ASSERT_MSG_EQ (std::stoul (rows[5][6]), pduSize, "Wrong retransmission buffer size");
+  NS_TEST_ASSERT_MSG_EQ (rows[5][7], "25000", "Wrong HOL delay of the retransmission buffer");
+  NS_TEST_ASSERT_MSG_EQ (rows[5][8], "0", "Wrong transmitted buffer size");
+}
+
+/**
+* This suite tests the sampling of the RLC AM buffers
+*/
+class MmWaveRlcBufferStatsTest : public TestSuite
+{
+public:
+  MmWaveRlcBufferStatsTest ();
+};
+
+MmWaveRlcBufferStatsTest::MmWaveRlcBufferStatsTest ()
+  : TestSuite ("mmwave-rlc-buffer-stats-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveRlcBufferStatsTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveRlcBufferStatsTest mmwaveTestSuite;
@@ -0,0 +1,244 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-rx-packet-stats-calculator.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveRxPacketStatsTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case checks that the quantiles estimated by MmWaveQuantileSketch
+* are within half a bin of the exact quantiles
+*/
+class MmWaveQuantileSketchTestCase : public TestCase
+{
+public:
+  MmWaveQuantileSketchTestCase ();
+  virtual ~MmWaveQuantileSketchTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmWaveQuantileSketchTestCase::MmWaveQuantileSketchTestCase ()
+  : TestCase ("Checks the quantiles of the sketch")
+{
+}
+
+MmWaveQuantileSketchTestCase::~MmWaveQuantileSketchTestCase ()
+{
+}
+
+void
+MmWaveQuantileSketchTestCase::DoRun (void)
+{
+  double resolution = 0.5;
+  MmWaveQuantileSketch sketch (resolution);
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetQuantile (0.5), 0, "An empty sketch has no quantile");
+
+  // values in a scrambled order, with negative values to grow the bins downwards
+  std::vector<double> values;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      values.push_back (-30.0 + ((i * 7919) % 1000) * 0.0731);
+    }
+  for (double value : values)
+    {
+      sketch.Add (value);
+    }
+  std::sort (values.begin (), values.end ());
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), values.size (), "Wrong number of values");
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetMin (), values.front (), "Wrong minimum");
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetMax (), values.back (), "Wrong maximum");
+  for (double q : {0.0, 0.05, 0.25, 0.5, 0.75, 0.95, 1.0})
+    {
+      uint32_t rank = std::max<uint32_t> (1, std::ceil (q * values.size ()));
+      NS_TEST_ASSERT_MSG_EQ_TOL (sketch.GetQuantile (q), values[rank - 1], resolution / 2,
+                                 "Wrong quantile " << q);
+    }
+
+  sketch.Reset ();
+  sketch.Add (12.3);
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetCount (), 1, "The sketch was not reset");
+  NS_TEST_ASSERT_MSG_EQ (sketch.GetQuantile (0.05), 12.3, "A quantile is clamped to the values");
+}
+
+/**
+* This test case feeds transport blocks to MmWaveRxPacketStatsCalculator
+* and checks the summaries of the windows
+*/
+class MmWaveRxPacketStatsTestCase : public TestCase
+{
+public:
+  MmWaveRxPacketStatsTestCase ();
+  virtual ~MmWaveRxPacketStatsTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Read the rows of a text trace, without its header
+   */
+  std::vector<std::vector<std::string> > ReadRows (std::string fileName);
+};
+
+MmWaveRxPacketStatsTestCase::MmWaveRxPacketStatsTestCase ()
+  : TestCase ("Checks the window summaries of the RX packet statistics")
+{
+}
+
+MmWaveRxPacketStatsTestCase::~MmWaveRxPacketStatsTestCase ()
+{
+}
+
+std::vector<std::vector<std::string> >
+MmWaveRxPacketStatsTestCase::ReadRows (std::string fileName)
+{
+  std::vector<std::vector<std::string> > rows;
+  std::ifstream file (fileName.c_str ());
+  std::string line;
+  std::getline (file, line);
+  while (std::getline (file, line))
+    {
+      std::vector<std::string> row;
+      std::istringstream columns (line);
+      std::string column;
+      while (std::getline (columns, column, '\t'))
+        {
+          row.push_back (column);
+        }
+      rows.push_back (row);
+    }
+  return rows;
+}
+
+void
+MmWaveRxPacketStatsTestCase::DoRun (void)
+{
+  std::string fileName = CreateTempDirFilename ("RxPacketStats.txt");
+  std::string mcsFileName = CreateTempDirFilename ("RxPacketMcsStats.txt");
+  Ptr<MmWaveRxPacketStatsCalculator> stats = CreateObjectWithAttributes<MmWaveRxPacketStatsCalculator> (
+      "EpochDuration", TimeValue (MilliSeconds (100)),
+      "OutputFilename", StringValue (fileName),
+      "McsOutputFilename", StringValue (mcsFileName));
+
+  RxPacketTraceParams params {};
+  params.m_cellId = 2;
+  params.m_rnti = 1;
+  params.m_tbSize = 1000;
+
+  // window 0: three DL blocks of RNTI 1, one of them corrupted, and an UL block of RNTI 3
+  params.m_mcs = 10;
+  params.m_sinr = 10;
+  Simulator::Schedule (MilliSeconds (10), &MmWaveRxPacketStatsCalculator::AddTransportBlock, stats, 0, params);
+  params.m_mcs = 12;
+  params.m_sinr = 100;
+  params.m_corrupt = true;
+  Simulator::Schedule (MilliSeconds (20), &MmWaveRxPacketStatsCalculator::AddTransportBlock, stats, 0, params);
+  params.m_corrupt = false;
+  params.m_rv = 1;
+  Simulator::Schedule (MilliSeconds (30), &MmWaveRxPacketStatsCalculator::AddTransportBlock, stats, 0, params);
+  params.m_rv = 0;
+  params.m_rnti = 3;
+  Simulator::Schedule (MilliSeconds (40), &MmWaveRxPacketStatsCalculator::AddTransportBlock, stats, 1, params);
+
+  // window 1 is empty, window 2 has a DL block of RNTI 1, written at Simulator::Destroy
+  params.m_rnti = 1;
+  Simulator::Schedule (MilliSeconds (250), &MmWaveRxPacketStatsCalculator::AddTransportBlock, stats, 0, params);
+
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  std::vector<std::vector<std::string> > rows = ReadRows (fileName);
+  NS_TEST_ASSERT_MSG_EQ (rows.size (), 3, "Wrong number of window summaries");
+  for (const std::vector<std::string> &row : rows)
+    {
+      NS_TEST_ASSERT_MSG_EQ (row.size (), 16, "Wrong number of columns");
+    }
+  if (rows.size () != 3 || rows[0].size () != 16)
+    {
+      return;
+    }
+
+  // DL, window 0, cell 2, RNTI 1
+  NS_TEST_ASSERT_MSG_EQ (rows[0][0], "DL", "Wrong direction");
+  NS_TEST_ASSERT_MSG_EQ (std::stod (rows[0][1]), 0, "Wrong window");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][2], "2", "Wrong cell");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][3], "1", "Wrong RNTI");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][4], "3", "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][5], "1", "Wrong number of corrupted blocks");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][6], "1", "Wrong number of retransmissions");
+  NS_TEST_ASSERT_MSG_EQ (rows[0][7], "2000", "Wrong number of received bytes");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][8]), 0.16, 1e-9, "Wrong throughput");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][9]), 1.0 / 3, 1e-3, "Wrong BLER");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][10]), 34.0 / 3, 1e-3, "Wrong mean MCS");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][11]), 50.0 / 3, 1e-3, "Wrong mean SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][12]), 10, 1e-9, "Wrong minimum SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][13]), 10, 0.05, "Wrong 5th percentile of the SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][14]), 20, 0.05, "Wrong median SINR");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[0][15]), 20, 0.05, "Wrong 95th percentile of the SINR");
+
+  // UL, window 0, cell 2, RNTI 3
+  NS_TEST_ASSERT_MSG_EQ (rows[1][0], "UL", "Wrong direction");
+  NS_TEST_ASSERT_MSG_EQ (rows[1][3], "3", "Wrong RNTI");
+  NS_TEST_ASSERT_MSG_EQ (rows[1][4], "1", "Wrong number of blocks");
+
+  // DL, window 2, cell 2, RNTI 1
+  NS_TEST_ASSERT_MSG_EQ (rows[2][0], "DL", "Wrong direction");
+  NS_TEST_ASSERT_MSG_EQ_TOL (std::stod (rows[2][1]), 0.2, 1e-9, "Wrong window");
+  NS_TEST_ASSERT_MSG_EQ (rows[2][4], "1", "Wrong number of blocks");
+  NS_TEST_ASSERT_MSG_EQ (rows[2][5], "0", "The statistics of the window were not reset");
+
+  std::vector<std::vector<std::string> > mcsRows = ReadRows (mcsFileName);
+  NS_TEST_ASSERT_MSG_EQ (mcsRows.size (), 4, "Wrong number of MCS histogram rows");
+  if (mcsRows.size () != 4)
+    {
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (mcsRows[0][4] + " " + mcsRows[0][5], "10 1", "Wrong MCS histogram");
+  NS_TEST_ASSERT_MSG_EQ (mcsRows[1][4] + " " + mcsRows[1][5], "12 2", "Wrong MCS histogram");
+  NS_TEST_ASSERT_MSG_EQ (mcsRows[2][0] + " " + mcsRows[2][4], "UL 12", "Wrong MCS histogram");
+  NS_TEST_ASSERT_MSG_EQ (mcsRows[3][4] + " " + mcsRows[3][5], "12 1", "Wrong MCS histogram");
+}
+
+/**
+* This suite tests the streaming aggregation of RxPacketTraceUe and RxPacketTraceEnb
+*/
+class MmWaveRxPacketStatsTest : public TestSuite
+{
+public:
+  MmWaveRxPacketStatsTest ();
+};
+
+MmWaveRxPacketStatsTest::MmWaveRxPacketStatsTest ()
+  : TestSuite ("mmwave-rx-packet-stats-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveQuantileSketchTestCase, TestCase::QUICK);
+  AddTestCase (new MmWaveRxPacketStatsTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveRxPacketStatsTest mmwaveTestSuite;
@@ -0,0 +1,138 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ *   Copyright (c) 2016, University of Padova, Dep. of Information Engineering, SIGNET lab.
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License version 2 as
+ *   published by the Free Software Foundation;
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/mmwave-enb-phy.h"
+#include "ns3/mmwave-spectrum-phy.h"
+#include "ns3/mmwave-sinr-filter-table.h"
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+ * \file mmwave-sinr-filter-test.cc
+ * \ingroup test
+ *
+ * \brief This test checks that MmWaveSinrFilterTable forwards the same SINR
+ * samples as the sequence MmWaveEnbPhy::ApplyFilter, MmWaveEnbPhy::MakeFilter
+ * applied to the windows of samples stored in vectors.
+ */
+
+/**
+ * \brief MmWaveSinrFilter testcase
+ */
+class MmWaveSinrFilterTestCase : public TestCase
+{
+public:
+  MmWaveSinrFilterTestCase (const std::string &name, uint32_t transientSamples, uint32_t numSamples)
+    : TestCase (name),
+      m_transientSamples (transientSamples),
+      m_numSamples (numSamples)
+  {
+  }
+
+  /**
+   * \brief Destroy the object instance
+   */
+  virtual ~MmWaveSinrFilterTestCase () override {}
+
+private:
+  virtual void DoRun (void) override;
+
+  uint32_t m_transientSamples; //!< number of samples collected before filtering
+  uint32_t m_numSamples;       //!< number of samples of each link
+};
+
+void
+MmWaveSinrFilterTestCase::DoRun ()
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<MmWaveEnbPhy> phy = CreateObject<MmWaveEnbPhy> (CreateObject<MmWaveSpectrumPhy> (),
+                                                      CreateObject<MmWaveSpectrumPhy> ());
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+
+  const uint64_t numLinks = 3;
+  MmWaveSinrFilterTable table;
+  table.SetCapacity (m_transientSamples);
+
+  std::vector<std::vector<double> > realWindows (numLinks);
+  std::vector<std::vector<double> > noisyWindows (numLinks);
+  std::vector<double> realSinr (numLinks, 300);
+  uint32_t filtered = 0;
+
+  for (uint32_t n = 0; n < m_numSamples; n++)
+    {
+      bool applyFilter = n >= m_transientSamples;
+      for (uint64_t imsi = 0; imsi < numLinks; imsi++)
+        {
+          // alternate LOS periods and blockages
+          if (uniform->GetValue () < 0.05)
+            {
+              realSinr[imsi] = (realSinr[imsi] > 10) ? uniform->GetValue (0.1, 2) : uniform->GetValue (30, 1000);
+            }
+          double noisySinr = phy->AddGaussianNoise (realSinr[imsi]);
+
+          std::vector<double> &real = realWindows[imsi];
+          std::vector<double> &noisy = noisyWindows[imsi];
+          if (applyFilter)
+            {
+              real.erase (real.begin ());
+              noisy.erase (noisy.begin ());
+            }
+          real.push_back (realSinr[imsi]);
+          noisy.push_back (noisySinr);
+
+          double expected = noisySinr;
+          if (applyFilter)
+            {
+              std::pair<uint64_t, uint64_t> filterPair = phy->ApplyFilter (noisy);
+              if (filterPair.first != filterPair.second)
+                {
+                  expected = phy->MakeFilter (noisy, real, filterPair).back ();
+                  filtered++;
+                }
+            }
+
+          double sample = table.AddSamples (imsi, realSinr[imsi], noisySinr, applyFilter);
+          NS_TEST_ASSERT_MSG_EQ (sample, expected, "Sample " << n << " of link " << imsi
+                                 << " differs from the one computed with ApplyFilter and MakeFilter");
+          NS_TEST_ASSERT_MSG_EQ (table.GetNumSamples (imsi), noisy.size (), "Wrong number of samples in the window");
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT (filtered, 0, "The filter has never been applied");
+
+  Simulator::Destroy ();
+}
+
+class MmWaveTestSinrFilter : public TestSuite
+{
+public:
+  MmWaveTestSinrFilter () : TestSuite ("mmwave-sinr-filter-test", UNIT)
+    {
+      AddTestCase (new MmWaveSinrFilterTestCase ("Window of 17 samples", 17, 150), QUICK);
+      AddTestCase (new MmWaveSinrFilterTestCase ("Window of 201 samples", 201, 1000), EXTENSIVE);
+    }
+};
+
+static MmWaveTestSinrFilter mmwaveSinrFilterTestSuite; //!< MmWave SINR filter test suite
@@ -0,0 +1,197 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/config.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/test.h"
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveSlotBarrierTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case checks that the schedulers of the cells run through a
+* MmWaveSlotBarrier allocate every slot, and that the allocations do not
+* depend on the number of threads of the barrier
+*/
+class MmWaveSlotBarrierTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  * \param numEnbs number of cells
+  * \param duration simulated time of each run
+  */
+  MmWaveSlotBarrierTestCase (uint32_t numEnbs, Time duration);
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveSlotBarrierTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Run a multi-cell scenario and return a digest of the allocations
+  * \param slotBarrier whether the slot barrier is used
+  * \param numThreads number of threads of the barrier
+  */
+  uint64_t RunScenario (bool slotBarrier, uint32_t numThreads);
+
+  /**
+  * Add a slot allocation to the digest
+  */
+  void SchedulingTrace (std::string context, MmWaveEnbMac::MmWaveSchedTraceInfo info);
+
+  uint32_t m_numEnbs;  //!< number of cells
+  Time m_duration;     //!< simulated time of each run
+  uint64_t m_digest;   //!< hash of the allocations traced so far
+  uint32_t m_numSlots; //!< number of slots traced so far
+};
+
+MmWaveSlotBarrierTestCase::MmWaveSlotBarrierTestCase (uint32_t numEnbs, Time duration)
+  : TestCase ("Checks that the slot barrier gives the same allocations with any number of threads, "
+              + std::to_string (numEnbs) + " cells, " + std::to_string (duration.GetMilliSeconds ()) + " ms"),
+    m_numEnbs (numEnbs),
+    m_duration (duration)
+{
+}
+
+MmWaveSlotBarrierTestCase::~MmWaveSlotBarrierTestCase ()
+{
+}
+
+void
+MmWaveSlotBarrierTestCase::SchedulingTrace (std::string context, MmWaveEnbMac::MmWaveSchedTraceInfo info)
+{
+  std::hash<std::string> hashString;
+  m_digest = m_digest * 1099511628211ULL + hashString (context);
+  m_digest = m_digest * 1099511628211ULL + Simulator::Now ().GetTimeStep ();
+  m_digest = m_digest * 1099511628211ULL + info.m_indParam.m_sfnSf.Encode ();
+  for (const TtiAllocInfo &tti : info.m_indParam.m_slotAllocInfo.m_ttiAllocInfo)
+    {
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_rnti;
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_symStart;
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_numSym;
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_tbSize;
+    }
+  m_numSlots++;
+}
+
+uint64_t
+MmWaveSlotBarrierTestCase::RunScenario (bool slotBarrier, uint32_t numThreads)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  // the runs must draw the same channels to be compared
+  RngSeedManager::ResetNextStreamIndex ();
+  m_digest = 0;
+  m_numSlots = 0;
+
+  Config::SetDefault ("ns3::MmWaveSlotBarrier::NumThreads", UintegerValue (numThreads));
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+  helper->SetAttribute ("SlotBarrier", BooleanValue (slotBarrier));
+  // small arrays, since most of the run time goes into the channel matrices
+  helper->SetEnbPhasedArrayModelAttribute ("NumColumns", UintegerValue (2));
+  helper->SetEnbPhasedArrayModelAttribute ("NumRows", UintegerValue (2));
+
+  uint32_t numEnbs = m_numEnbs;
+  uint32_t uesPerEnb = 1;
+
+  NodeContainer enbNodes;
+  enbNodes.Create (numEnbs);
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < numEnbs; i++)
+    {
+      enbPositionAlloc->Add (Vector (100.0 * i, 0.0, 25.0));
+    }
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.SetPositionAllocator (enbPositionAlloc);
+  enbMobility.Install (enbNodes);
+
+  NodeContainer ueNodes;
+  ueNodes.Create (numEnbs * uesPerEnb);
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < numEnbs * uesPerEnb; i++)
+    {
+      uePositionAlloc->Add (Vector (100.0 * (i / uesPerEnb), 20.0 + 10.0 * (i % uesPerEnb), 1.6));
+    }
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  ueMobility.SetPositionAllocator (uePositionAlloc);
+  ueMobility.Install (ueNodes);
+
+  NetDeviceContainer enbNetDevs = helper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueNetDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (ueNetDevs, enbNetDevs);
+  helper->ActivateDataRadioBearer (ueNetDevs, EpsBearer (EpsBearer::GBR_CONV_VOICE));
+
+  Config::Connect ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/MmWaveEnbMac/SchedulingTraceEnb",
+                   MakeCallback (&MmWaveSlotBarrierTestCase::SchedulingTrace, this));
+
+  Simulator::Stop (m_duration);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  return m_digest;
+}
+
+void
+MmWaveSlotBarrierTestCase::DoRun (void)
+{
+  RunScenario (false, 1);
+  uint32_t numSlots = m_numSlots;
+  NS_TEST_ASSERT_MSG_GT (numSlots, 0, "No slot was scheduled");
+
+  // the slots are scheduled later in the time step than without the
+  // barrier, thus the allocations may differ from the ones above
+  uint64_t digest = RunScenario (true, 1);
+  NS_TEST_ASSERT_MSG_EQ (m_numSlots, numSlots, "Different number of slots with the slot barrier");
+
+  uint64_t parallelDigest = RunScenario (true, 4);
+  NS_TEST_ASSERT_MSG_EQ (m_numSlots, numSlots, "Different number of slots with 4 threads");
+  NS_TEST_ASSERT_MSG_EQ (parallelDigest, digest, "Different allocations with 4 threads");
+  Config::Reset ();
+}
+
+/**
+* This suite tests the slot barrier of the eNB MACs
+*/
+class MmWaveSlotBarrierTest : public TestSuite
+{
+public:
+  MmWaveSlotBarrierTest ();
+};
+
+MmWaveSlotBarrierTest::MmWaveSlotBarrierTest ()
+  : TestSuite ("mmwave-slot-barrier-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveSlotBarrierTestCase (2, MilliSeconds (20)), TestCase::QUICK);
+  AddTestCase (new MmWaveSlotBarrierTestCase (4, MilliSeconds (20)), TestCase::EXTENSIVE);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveSlotBarrierTest mmwaveTestSuite;
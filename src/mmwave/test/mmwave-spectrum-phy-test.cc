@@ -0,0 +1,139 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/config.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/test.h"
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveSpectrumPhyTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case checks that the signals transmitted by a UE are not
+* received by the other UEs of the same cell. Before, a UE that was
+* transmitting when the UL control of another UE reached it aborted the
+* simulation.
+*/
+class MmWaveUeToUeSignalTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  */
+  MmWaveUeToUeSignalTestCase ();
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveUeToUeSignalTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Count the UL transport blocks received by the eNB
+  */
+  void RxPacketTraceEnb (RxPacketTraceParams params);
+
+  std::set<uint16_t> m_ulRntis; //!< RNTIs of the UEs whose UL TBs were received
+};
+
+MmWaveUeToUeSignalTestCase::MmWaveUeToUeSignalTestCase ()
+  : TestCase ("Checks that two UEs of the same cell can transmit in the same slot")
+{
+}
+
+MmWaveUeToUeSignalTestCase::~MmWaveUeToUeSignalTestCase ()
+{
+}
+
+void
+MmWaveUeToUeSignalTestCase::RxPacketTraceEnb (RxPacketTraceParams params)
+{
+  m_ulRntis.insert (params.m_rnti);
+}
+
+void
+MmWaveUeToUeSignalTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  enbPositionAlloc->Add (Vector (0.0, 0.0, 25.0));
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.SetPositionAllocator (enbPositionAlloc);
+  enbMobility.Install (enbNodes);
+
+  // two UEs close to each other, both attached to the same cell
+  NodeContainer ueNodes;
+  ueNodes.Create (2);
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  uePositionAlloc->Add (Vector (20.0, 0.0, 1.6));
+  uePositionAlloc->Add (Vector (20.0, 5.0, 1.6));
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  ueMobility.SetPositionAllocator (uePositionAlloc);
+  ueMobility.Install (ueNodes);
+
+  NetDeviceContainer enbNetDevs = helper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueNetDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (ueNetDevs, enbNetDevs);
+  helper->ActivateDataRadioBearer (ueNetDevs, EpsBearer (EpsBearer::GBR_CONV_VOICE));
+
+  Ptr<MmWaveEnbNetDevice> enbNetDev = DynamicCast<MmWaveEnbNetDevice> (enbNetDevs.Get (0));
+  enbNetDev->GetPhy ()->GetDlSpectrumPhy ()->TraceConnectWithoutContext ("RxPacketTraceEnb",
+                                                                       MakeCallback (&MmWaveUeToUeSignalTestCase::RxPacketTraceEnb, this));
+
+  Simulator::Stop (MilliSeconds (50));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (m_ulRntis.size (), 2, "The UL transmissions of both UEs should reach the eNB");
+}
+
+/**
+* This suite tests the reception of the signals by MmWaveSpectrumPhy
+*/
+class MmWaveSpectrumPhyTest : public TestSuite
+{
+public:
+  MmWaveSpectrumPhyTest ();
+};
+
+MmWaveSpectrumPhyTest::MmWaveSpectrumPhyTest ()
+  : TestSuite ("mmwave-spectrum-phy-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveUeToUeSignalTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveSpectrumPhyTest mmwaveTestSuite;
@@ -0,0 +1,200 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-trace-writer.h"
+#include "ns3/mmwave-trace-io-thread.h"
+#include "ns3/simulator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/uinteger.h"
+#include "ns3/test.h"
+#include <sstream>
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTraceWriterTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case writes the same records in the text format and in a
+* binary format, and checks that the binary trace converted to text is
+* identical to the text trace. With the asynchronous writer, the format
+* can also be the text format, and the test checks that the records are
+* all written at Simulator::Destroy.
+*/
+class MmWaveTraceWriterTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  * \param format the format to test
+  * \param async whether the records are written by MmWaveTraceIoThread
+  */
+  MmWaveTraceWriterTestCase (MmWaveTraceWriter::Format format, bool async);
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveTraceWriterTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Write the records of the test in a file
+  * \param fileName the file name
+  * \param format the format of the file
+  * \param async whether the records are written by MmWaveTraceIoThread
+  */
+  void WriteTrace (std::string fileName, MmWaveTraceWriter::Format format, bool async);
+
+  MmWaveTraceWriter::Format m_format; //!< the format to test
+  bool m_async;                       //!< whether the records are written by MmWaveTraceIoThread
+  MmWaveTraceSchema m_schema;         //!< the schema of the trace
+};
+
+MmWaveTraceWriterTestCase::MmWaveTraceWriterTestCase (MmWaveTraceWriter::Format format, bool async)
+  : TestCase ("Checks that a trace converted to text matches the text trace, format "
+              + std::to_string (format) + (async ? ", asynchronous" : "")),
+    m_format (format),
+    m_async (async),
+    m_schema ("DL/UL\ttime\tframe\tsubF\tcellId\trnti\ttbSize\tSINR(dB)\tcorrupt")
+{
+  m_schema.AddLabelColumn ("DL/UL", {"DL", "UL"})
+  .AddColumn ("time", MmWaveTraceSchema::DOUBLE)
+  .AddColumn ("frame", MmWaveTraceSchema::UINT32)
+  .AddColumn ("subF", MmWaveTraceSchema::UINT8)
+  .AddColumn ("cellId", MmWaveTraceSchema::UINT64)
+  .AddColumn ("rnti", MmWaveTraceSchema::UINT16)
+  .AddColumn ("tbSize", MmWaveTraceSchema::UINT32, " ")
+  .AddColumn ("SINR(dB)", MmWaveTraceSchema::DOUBLE)
+  .SetSuffixByLabel ("DL/UL", {"\t", " \t"})
+  .AddColumn ("corrupt", MmWaveTraceSchema::UINT8, "");
+}
+
+MmWaveTraceWriterTestCase::~MmWaveTraceWriterTestCase ()
+{
+}
+
+void
+MmWaveTraceWriterTestCase::WriteTrace (std::string fileName, MmWaveTraceWriter::Format format, bool async)
+{
+  MmWaveTraceWriter writer (m_schema);
+  writer.Open (fileName, format);
+  // more than two blocks, the last one partial
+  uint32_t numRecords = 2 * MmWaveTraceWriter::BLOCK_RECORDS + 123;
+  for (uint32_t i = 0; i < numRecords; i++)
+    {
+      writer.Write ({i % 2, i * 0.000125, i / 80, (i / 8) % 10, 1ULL << (i % 64),
+                     i % 65536, i * 2654435761U, -20.0 + (i % 700) / 17.0, i % 7 == 0});
+    }
+  if (async)
+    {
+      // the records must be in the file without closing it
+      Simulator::Destroy ();
+      std::ifstream file (fileName.c_str (), std::ios::binary | std::ios::ate);
+      std::streamoff size = file.tellg ();
+      writer.Close ();
+      file.seekg (0, std::ios::end);
+      NS_TEST_ASSERT_MSG_EQ (file.tellg (), size, "The trace was not flushed at Simulator::Destroy");
+    }
+  writer.Close ();
+}
+
+void
+MmWaveTraceWriterTestCase::DoRun (void)
+{
+  std::string textFileName = CreateTempDirFilename ("trace.txt");
+  std::string binaryFileName = CreateTempDirFilename ("trace.bin");
+  WriteTrace (textFileName, MmWaveTraceWriter::TEXT, false);
+  if (m_async)
+    {
+      // a small queue, to exercise the full queue case
+      Config::SetGlobal ("MmWaveAsyncTraces", BooleanValue (true));
+      Config::SetGlobal ("MmWaveAsyncTraceQueueSize", UintegerValue (64));
+      MmWaveTraceIoThread::ResetStats ();
+    }
+  WriteTrace (binaryFileName, m_format, m_async);
+  if (m_async)
+    {
+      Config::SetGlobal ("MmWaveAsyncTraces", BooleanValue (false));
+      Config::SetGlobal ("MmWaveAsyncTraceQueueSize", UintegerValue (16384));
+      MmWaveTraceIoThread::Stats stats = MmWaveTraceIoThread::GetStats ();
+      NS_TEST_ASSERT_MSG_EQ (stats.m_records, 2 * MmWaveTraceWriter::BLOCK_RECORDS + 123, "Wrong number of records queued");
+      NS_TEST_ASSERT_MSG_LT_OR_EQ (stats.m_peakSize, 64, "The queue cannot hold more than 64 records");
+    }
+
+  std::ifstream textFile (textFileName.c_str ());
+  std::stringstream text;
+  text << textFile.rdbuf ();
+
+  std::ifstream binaryFile (binaryFileName.c_str (), std::ios::binary);
+  std::stringstream converted;
+  if (m_format == MmWaveTraceWriter::TEXT)
+    {
+      converted << binaryFile.rdbuf ();
+      NS_TEST_ASSERT_MSG_EQ ((converted.str () == text.str ()), true, "The asynchronous trace is different");
+      return;
+    }
+  NS_TEST_ASSERT_MSG_EQ (MmWaveTraceWriter::ConvertToText (binaryFile, converted), true, "Invalid binary trace");
+  NS_TEST_ASSERT_MSG_EQ (converted.str ().size (), text.str ().size (), "The converted trace has a different size");
+  NS_TEST_ASSERT_MSG_EQ ((converted.str () == text.str ()), true, "The converted trace is different");
+
+  // a truncated trace is reported as invalid
+  binaryFile.clear ();
+  binaryFile.seekg (0, std::ios::end);
+  std::streamoff size = binaryFile.tellg ();
+  binaryFile.seekg (0);
+  std::string truncated (size - 10, '\0');
+  binaryFile.read (&truncated[0], truncated.size ());
+  std::istringstream truncatedStream (truncated);
+  std::ostringstream discarded;
+  NS_TEST_ASSERT_MSG_EQ (MmWaveTraceWriter::ConvertToText (truncatedStream, discarded), false,
+                         "The truncated trace is not reported");
+}
+
+/**
+* This suite tests the binary trace writer
+*/
+class MmWaveTraceWriterTest : public TestSuite
+{
+public:
+  MmWaveTraceWriterTest ();
+};
+
+MmWaveTraceWriterTest::MmWaveTraceWriterTest ()
+  : TestSuite ("mmwave-trace-writer-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveTraceWriterTestCase (MmWaveTraceWriter::BINARY, false), TestCase::QUICK);
+  if (MmWaveTraceWriter::IsFormatSupported (MmWaveTraceWriter::BINARY_ZSTD))
+    {
+      AddTestCase (new MmWaveTraceWriterTestCase (MmWaveTraceWriter::BINARY_ZSTD, false), TestCase::QUICK);
+    }
+  if (MmWaveTraceWriter::IsFormatSupported (MmWaveTraceWriter::BINARY_LZ4))
+    {
+      AddTestCase (new MmWaveTraceWriterTestCase (MmWaveTraceWriter::BINARY_LZ4, false), TestCase::QUICK);
+    }
+  AddTestCase (new MmWaveTraceWriterTestCase (MmWaveTraceWriter::TEXT, true), TestCase::QUICK);
+  AddTestCase (new MmWaveTraceWriterTestCase (MmWaveTraceWriter::BINARY, true), TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveTraceWriterTest mmwaveTestSuite;
@@ -0,0 +1,269 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-helper.h"
+#include "ns3/mmwave-control-messages.h"
+#include "ns3/mmwave-spectrum-signal-parameters.h"
+#include "ns3/mmwave-tx-pool.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/packet-burst.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include "ns3/test.h"
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveTxPoolTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case checks that the signal parameters given to each receiver
+* share the packet burst and the control messages of the transmission
+*/
+class MmWaveSignalParametersCopyTestCase : public TestCase
+{
+public:
+  MmWaveSignalParametersCopyTestCase ();
+  virtual ~MmWaveSignalParametersCopyTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+MmWaveSignalParametersCopyTestCase::MmWaveSignalParametersCopyTestCase ()
+  : TestCase ("Checks that the copies of the signal parameters share the burst and the control messages")
+{
+}
+
+MmWaveSignalParametersCopyTestCase::~MmWaveSignalParametersCopyTestCase ()
+{
+}
+
+void
+MmWaveSignalParametersCopyTestCase::DoRun (void)
+{
+  MmWaveTxPool<PacketBurst> burstPool;
+  MmWaveTxPool<MmWaveControlMessageList> listPool;
+
+  std::vector<double> freqs = {28e9, 28.1e9};
+  Ptr<MmwaveSpectrumSignalParametersDataFrame> txParams = Create<MmwaveSpectrumSignalParametersDataFrame> ();
+  txParams->psd = Create<SpectrumValue> (Create<SpectrumModel> (freqs));
+  txParams->packetBurst = burstPool.Get ();
+  txParams->packetBurst->AddPacket (Create<Packet> (100));
+  txParams->ctrlMsgList = listPool.Get ();
+  txParams->ctrlMsgList->m_messages.push_back (Create<MmWaveTdmaDciMessage> ());
+
+  // as done by the spectrum channel for each receiver
+  std::vector<Ptr<SpectrumSignalParameters> > rxParams;
+  for (uint32_t i = 0; i < 8; i++)
+    {
+      rxParams.push_back (txParams->Copy ());
+      Ptr<MmwaveSpectrumSignalParametersDataFrame> copy = DynamicCast<MmwaveSpectrumSignalParametersDataFrame> (rxParams.back ());
+      NS_TEST_ASSERT_MSG_EQ (copy->packetBurst, txParams->packetBurst, "The burst was copied");
+      NS_TEST_ASSERT_MSG_EQ (copy->ctrlMsgList, txParams->ctrlMsgList, "The control messages were copied");
+    }
+
+  // the objects are not reused while a receiver holds them
+  Ptr<PacketBurst> burst = txParams->packetBurst;
+  txParams = 0;
+  burst = 0;
+  NS_TEST_ASSERT_MSG_NE (burstPool.Get (), DynamicCast<MmwaveSpectrumSignalParametersDataFrame> (rxParams[0])->packetBurst,
+                         "A burst held by a receiver was reused");
+  NS_TEST_ASSERT_MSG_EQ (burstPool.GetNAllocations (), 2, "Wrong number of bursts allocated");
+
+  // and they are reused, empty, once all the receivers are done
+  rxParams.clear ();
+  NS_TEST_ASSERT_MSG_EQ (burstPool.Get ()->GetNPackets (), 0, "A reused burst is not empty");
+  NS_TEST_ASSERT_MSG_EQ (listPool.Get ()->m_messages.size (), 0, "A reused list is not empty");
+  NS_TEST_ASSERT_MSG_EQ (burstPool.GetNAllocations (), 2, "A burst was allocated instead of being reused");
+  NS_TEST_ASSERT_MSG_EQ (listPool.GetNAllocations (), 1, "A list was allocated instead of being reused");
+  NS_TEST_ASSERT_MSG_EQ (burstPool.GetNRequests (), 3, "Wrong number of bursts requested");
+}
+
+/**
+* This test case runs a full-buffer scenario, with the pools of the PHYs
+* disabled and then enabled, and counts the packet bursts and the control
+* message lists constructed by the PHYs per transmitted TTI
+*/
+class MmWaveTxPoolAllocationTestCase : public TestCase
+{
+public:
+  MmWaveTxPoolAllocationTestCase ();
+  virtual ~MmWaveTxPoolAllocationTestCase ();
+
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the scenario and measure the constructions after a warm up
+   * \param pool whether the pools reuse the objects
+   * \param [out] requestsPerTti number of objects requested per transmitted TTI
+   * \return the number of objects constructed per transmitted TTI
+   */
+  double RunScenario (bool pool, double &requestsPerTti);
+
+  /**
+   * Count a transmitted TTI
+   */
+  void PhyTransmissionTrace (PhyTransmissionTraceParams params);
+
+  /**
+   * Sum the requests and the constructions of the pools of all the PHYs
+   */
+  void GetPoolCounters (uint64_t &requests, uint64_t &allocations);
+
+  NetDeviceContainer m_enbDevs;   //!< the eNB devices
+  NetDeviceContainer m_ueDevs;    //!< the UE devices
+  uint64_t m_numTtis;             //!< number of transmitted TTIs
+};
+
+MmWaveTxPoolAllocationTestCase::MmWaveTxPoolAllocationTestCase ()
+  : TestCase ("Counts the bursts and the control message lists constructed per TTI"),
+    m_numTtis (0)
+{
+}
+
+MmWaveTxPoolAllocationTestCase::~MmWaveTxPoolAllocationTestCase ()
+{
+}
+
+void
+MmWaveTxPoolAllocationTestCase::PhyTransmissionTrace (PhyTransmissionTraceParams params)
+{
+  m_numTtis++;
+}
+
+void
+MmWaveTxPoolAllocationTestCase::GetPoolCounters (uint64_t &requests, uint64_t &allocations)
+{
+  requests = 0;
+  allocations = 0;
+  for (uint32_t i = 0; i < m_enbDevs.GetN (); i++)
+    {
+      Ptr<MmWaveEnbPhy> phy = DynamicCast<MmWaveEnbNetDevice> (m_enbDevs.Get (i))->GetPhy ();
+      requests += phy->GetTxPoolRequests ();
+      allocations += phy->GetTxPoolAllocations ();
+    }
+  for (uint32_t i = 0; i < m_ueDevs.GetN (); i++)
+    {
+      Ptr<MmWaveUePhy> phy = DynamicCast<MmWaveUeNetDevice> (m_ueDevs.Get (i))->GetPhy ();
+      requests += phy->GetTxPoolRequests ();
+      allocations += phy->GetTxPoolAllocations ();
+    }
+}
+
+double
+MmWaveTxPoolAllocationTestCase::RunScenario (bool pool, double &requestsPerTti)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  RngSeedManager::ResetNextStreamIndex ();
+  m_numTtis = 0;
+  Config::SetDefault ("ns3::MmWavePhy::TxPool", BooleanValue (pool));
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  NodeContainer ueNodes;
+  ueNodes.Create (3);
+  Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator> ();
+  positionAlloc->Add (Vector (0.0, 0.0, 25.0));
+  for (uint32_t i = 0; i < ueNodes.GetN (); i++)
+    {
+      positionAlloc->Add (Vector (20.0 + 10.0 * i, 0.0, 1.6));
+    }
+  MobilityHelper mobility;
+  mobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  mobility.SetPositionAllocator (positionAlloc);
+  mobility.Install (enbNodes);
+  mobility.Install (ueNodes);
+
+  // without EPC, the bearers use the saturation mode of the RLC, i.e., a full buffer
+  m_enbDevs = helper->InstallEnbDevice (enbNodes);
+  m_ueDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (m_ueDevs, m_enbDevs);
+  helper->ActivateDataRadioBearer (m_ueDevs, EpsBearer (EpsBearer::NGBR_VIDEO_TCP_DEFAULT));
+
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/MmWaveEnbPhy/ReportDlPhyTransmission",
+                                 MakeCallback (&MmWaveTxPoolAllocationTestCase::PhyTransmissionTrace, this));
+  Config::ConnectWithoutContext ("/NodeList/*/DeviceList/*/ComponentCarrierMap/*/MmWaveUePhy/ReportUlPhyTransmission",
+                                 MakeCallback (&MmWaveTxPoolAllocationTestCase::PhyTransmissionTrace, this));
+
+  // warm up, until the pools hold all the objects in flight
+  Simulator::Stop (MilliSeconds (20));
+  Simulator::Run ();
+  uint64_t warmupTtis = m_numTtis;
+  uint64_t warmupRequests;
+  uint64_t warmupAllocations;
+  GetPoolCounters (warmupRequests, warmupAllocations);
+
+  Simulator::Stop (MilliSeconds (20));
+  Simulator::Run ();
+  uint64_t requests;
+  uint64_t allocations;
+  GetPoolCounters (requests, allocations);
+  double numTtis = m_numTtis - warmupTtis;
+  Simulator::Destroy ();
+  Config::Reset ();
+
+  NS_TEST_EXPECT_MSG_GT (numTtis, 0, "No TTI was transmitted");
+  requestsPerTti = (requests - warmupRequests) / numTtis;
+  double allocationsPerTti = (allocations - warmupAllocations) / numTtis;
+  NS_LOG_INFO ((pool ? "with" : "without") << " the pools: " << numTtis << " TTIs, "
+               << requestsPerTti << " requests per TTI, " << allocationsPerTti << " constructions per TTI");
+  return allocationsPerTti;
+}
+
+void
+MmWaveTxPoolAllocationTestCase::DoRun (void)
+{
+  // without the pools, each request constructs a burst or a list
+  double requestsPerTti;
+  double allocationsPerTtiBefore = RunScenario (false, requestsPerTti);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (requestsPerTti, 1, "Fewer than one burst or list requested per transmitted TTI");
+  NS_TEST_ASSERT_MSG_EQ_TOL (allocationsPerTtiBefore, requestsPerTti, 1e-9,
+                             "Without the pools, the bursts and the lists must be constructed for each request");
+
+  double allocationsPerTtiAfter = RunScenario (true, requestsPerTti);
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (requestsPerTti, 1, "Fewer than one burst or list requested per transmitted TTI");
+  NS_TEST_ASSERT_MSG_EQ (allocationsPerTtiAfter, 0, "The pools still construct after the warm up, "
+                         << allocationsPerTtiAfter << " constructions per TTI for " << requestsPerTti
+                         << " requests per TTI");
+}
+
+/**
+* This suite tests the pools of the packet bursts and control messages transmitted by the PHYs
+*/
+class MmWaveTxPoolTest : public TestSuite
+{
+public:
+  MmWaveTxPoolTest ();
+};
+
+MmWaveTxPoolTest::MmWaveTxPoolTest ()
+  : TestSuite ("mmwave-tx-pool-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveSignalParametersCopyTestCase, TestCase::QUICK);
+  AddTestCase (new MmWaveTxPoolAllocationTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveTxPoolTest mmwaveTestSuite;
@@ -0,0 +1,208 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+*   This program is free software; you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License version 2 as
+*   published by the Free Software Foundation;
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program; if not, write to the Free Software
+*   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*
+*/
+
+#include "ns3/mmwave-helper.h"
+#include "ns3/node-container.h"
+#include "ns3/mobility-helper.h"
+#include "ns3/config.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/test.h"
+
+NS_LOG_COMPONENT_DEFINE ("MmWaveUeChannelsTest");
+
+using namespace ns3;
+using namespace mmwave;
+
+/**
+* This test case checks that the eNB PHY generates the channels of its UEs
+* in one batch when the ThreeGppChannelModel has more than one thread, and
+* that the allocations and the SINRs then do not depend on the number of
+* threads
+*/
+class MmWaveUeChannelsTestCase : public TestCase
+{
+public:
+  /**
+  * Constructor
+  */
+  MmWaveUeChannelsTestCase ();
+
+  /**
+  * Destructor
+  */
+  virtual ~MmWaveUeChannelsTestCase ();
+
+private:
+  /**
+  * Run the test
+  */
+  virtual void DoRun (void);
+
+  /**
+  * Run a single-cell scenario and return a digest of the allocations and
+  * of the SINRs of the received TBs
+  * \param numThreads number of threads of the channel model
+  * \param [out] batchChannels number of channels generated in one batch
+  */
+  uint64_t RunScenario (uint32_t numThreads, uint64_t &batchChannels);
+
+  /**
+  * Add a slot allocation to the digest
+  */
+  void SchedulingTrace (MmWaveEnbMac::MmWaveSchedTraceInfo info);
+
+  /**
+  * Add the SINR of a received TB to the digest
+  */
+  void RxPacketTrace (RxPacketTraceParams params);
+
+  uint64_t m_digest;   //!< hash of the allocations and SINRs traced so far
+  uint32_t m_numTbs;   //!< number of TBs traced so far
+};
+
+MmWaveUeChannelsTestCase::MmWaveUeChannelsTestCase ()
+  : TestCase ("Checks the channels of the UEs generated in one batch by the eNB PHY")
+{
+}
+
+MmWaveUeChannelsTestCase::~MmWaveUeChannelsTestCase ()
+{
+}
+
+void
+MmWaveUeChannelsTestCase::SchedulingTrace (MmWaveEnbMac::MmWaveSchedTraceInfo info)
+{
+  for (const TtiAllocInfo &tti : info.m_indParam.m_slotAllocInfo.m_ttiAllocInfo)
+    {
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_rnti;
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_mcs;
+      m_digest = m_digest * 1099511628211ULL + tti.m_dci.m_tbSize;
+    }
+}
+
+void
+MmWaveUeChannelsTestCase::RxPacketTrace (RxPacketTraceParams params)
+{
+  std::hash<double> hashDouble;
+  m_digest = m_digest * 1099511628211ULL + params.m_rnti;
+  m_digest = m_digest * 1099511628211ULL + hashDouble (params.m_sinr);
+  m_numTbs++;
+}
+
+uint64_t
+MmWaveUeChannelsTestCase::RunScenario (uint32_t numThreads, uint64_t &batchChannels)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  RngSeedManager::ResetNextStreamIndex ();
+  m_digest = 0;
+  m_numTbs = 0;
+
+  Config::SetDefault ("ns3::ThreeGppChannelModel::NumThreads", UintegerValue (numThreads));
+  Config::SetDefault ("ns3::ThreeGppChannelModel::PerLinkRandomStreams", BooleanValue (true));
+  Config::SetDefault ("ns3::ThreeGppChannelConditionModel::PerLinkRandomStreams", BooleanValue (true));
+  // the channels of the static UEs are generated again only when they expire
+  Config::SetDefault ("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue (MilliSeconds (4)));
+  Ptr<MmWaveHelper> helper = CreateObject<MmWaveHelper> ();
+
+  NodeContainer enbNodes;
+  enbNodes.Create (1);
+  Ptr<ListPositionAllocator> enbPositionAlloc = CreateObject<ListPositionAllocator> ();
+  enbPositionAlloc->Add (Vector (0.0, 0.0, 25.0));
+  MobilityHelper enbMobility;
+  enbMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  enbMobility.SetPositionAllocator (enbPositionAlloc);
+  enbMobility.Install (enbNodes);
+
+  uint32_t numUes = 2;
+  NodeContainer ueNodes;
+  ueNodes.Create (numUes);
+  Ptr<ListPositionAllocator> uePositionAlloc = CreateObject<ListPositionAllocator> ();
+  for (uint32_t i = 0; i < numUes; i++)
+    {
+      uePositionAlloc->Add (Vector (20.0 + 15.0 * i, 10.0 * i, 1.6));
+    }
+  MobilityHelper ueMobility;
+  ueMobility.SetMobilityModel ("ns3::ConstantPositionMobilityModel");
+  ueMobility.SetPositionAllocator (uePositionAlloc);
+  ueMobility.Install (ueNodes);
+
+  NetDeviceContainer enbNetDevs = helper->InstallEnbDevice (enbNodes);
+  NetDeviceContainer ueNetDevs = helper->InstallUeDevice (ueNodes);
+  helper->AttachToClosestEnb (ueNetDevs, enbNetDevs);
+  helper->ActivateDataRadioBearer (ueNetDevs, EpsBearer (EpsBearer::GBR_CONV_VOICE));
+
+  Ptr<MmWaveEnbNetDevice> enbNetDev = DynamicCast<MmWaveEnbNetDevice> (enbNetDevs.Get (0));
+  enbNetDev->GetMac ()->TraceConnectWithoutContext ("SchedulingTraceEnb",
+                                                   MakeCallback (&MmWaveUeChannelsTestCase::SchedulingTrace, this));
+  enbNetDev->GetPhy ()->GetDlSpectrumPhy ()->TraceConnectWithoutContext ("RxPacketTraceEnb",
+                                                                       MakeCallback (&MmWaveUeChannelsTestCase::RxPacketTrace, this));
+  for (uint32_t i = 0; i < numUes; i++)
+    {
+      Ptr<MmWaveUeNetDevice> ueNetDev = DynamicCast<MmWaveUeNetDevice> (ueNetDevs.Get (i));
+      ueNetDev->GetPhy ()->GetDlSpectrumPhy ()->TraceConnectWithoutContext ("RxPacketTraceUe",
+                                                                          MakeCallback (&MmWaveUeChannelsTestCase::RxPacketTrace, this));
+    }
+
+  Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm = DynamicCast<ThreeGppSpectrumPropagationLossModel> (
+    enbNetDev->GetPhy ()->GetDlSpectrumPhy ()->GetSpectrumChannel ()->GetPhasedArraySpectrumPropagationLossModel ());
+  NS_ASSERT_MSG (threeGppSplm, "The channel should use a ThreeGppSpectrumPropagationLossModel");
+  Ptr<ThreeGppChannelModel> channelModel = DynamicCast<ThreeGppChannelModel> (threeGppSplm->GetChannelModel ());
+
+  Simulator::Stop (MilliSeconds (12));
+  Simulator::Run ();
+  batchChannels = channelModel->GetNumBatchChannels ();
+  Simulator::Destroy ();
+  Config::Reset ();
+  return m_digest;
+}
+
+void
+MmWaveUeChannelsTestCase::DoRun (void)
+{
+  uint64_t batchChannels = 0;
+  RunScenario (1, batchChannels);
+  NS_TEST_ASSERT_MSG_GT (m_numTbs, 0, "No TB was received");
+  NS_TEST_ASSERT_MSG_EQ (batchChannels, 0, "The channels were generated in one batch with a single thread");
+
+  uint64_t batchDigest = RunScenario (2, batchChannels);
+  NS_TEST_ASSERT_MSG_GT (batchChannels, 0, "The channels were not generated in one batch");
+
+  uint64_t otherBatchDigest = RunScenario (4, batchChannels);
+  NS_TEST_ASSERT_MSG_EQ (otherBatchDigest, batchDigest, "The allocations or SINRs depend on the number of threads");
+}
+
+/**
+* This suite tests the generation of the channels of the UEs by the eNB PHY
+*/
+class MmWaveUeChannelsTest : public TestSuite
+{
+public:
+  MmWaveUeChannelsTest ();
+};
+
+MmWaveUeChannelsTest::MmWaveUeChannelsTest ()
+  : TestSuite ("mmwave-ue-channels-test", UNIT)
+{
+  // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
+  AddTestCase (new MmWaveUeChannelsTestCase, TestCase::QUICK);
+}
+
+// Do not forget to allocate an instance of this TestSuite
+static MmWaveUeChannelsTest mmwaveTestSuite;
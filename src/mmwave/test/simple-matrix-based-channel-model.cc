@@ -218,17 +218,7 @@ SimpleMatrixBasedChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
 
   // Initialize the channel matrix: consider a the tx, b the rx
   // The size of the channel matrix will be (bSize) x (aSize) x (numClusters)
-  Complex3DVector H;  //channel coffecient H[b][a][n];
-
-  H.resize (bSize);
-  for (uint64_t bIndex = 0; bIndex < bSize; bIndex++)
-    {
-      H[bIndex].resize (aSize);
-      for (uint64_t aIndex = 0; aIndex < aSize; aIndex++)
-        {
-          H[bIndex][aIndex].resize (numClusters);
-        }
-    }
+  Complex3DVector H (bSize, aSize, numClusters);  //channel coffecient H (b, a, n);
 
   // Create the channel matrix
   for (uint64_t n = 0; n < numClusters; n++)
@@ -262,7 +252,7 @@ SimpleMatrixBasedChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
               double aGain = std::get<1> (aAntenna->GetElementFieldPattern (aod));
               double bGain = std::get<1> (bAntenna->GetElementFieldPattern (aoa));
 
-              H[bIndex][aIndex][n] = (p * aGain * bGain) * totalShift;
+              H (bIndex, aIndex, n) = (p * aGain * bGain) * totalShift;
             }
         }
     }
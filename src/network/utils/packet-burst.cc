@@ -88,6 +88,13 @@ PacketBurst::AddPacket (Ptr<Packet> packet)
     }
 }
 
+void
+PacketBurst::Clear (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_packets.clear ();
+}
+
 std::list<Ptr<Packet> >
 PacketBurst::GetPackets (void) const
 {
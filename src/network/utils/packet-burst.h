@@ -51,6 +51,10 @@ public:
    * \param packet the packet to add
    */
   void AddPacket (Ptr<Packet> packet);
+  /**
+   * \brief remove all the packets of the burst
+   */
+  void Clear (void);
   /**
    * \return the list of packet of this burst
    */
@@ -25,6 +25,8 @@
 #include "ns3/node.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
+#include "ns3/boolean.h"
+#include "ns3/rng-seed-manager.h"
 
 namespace ns3 {
 
@@ -282,6 +284,14 @@ ThreeGppChannelConditionModel::GetTypeId (void)
                    TimeValue (MilliSeconds (0)),
                    MakeTimeAccessor (&ThreeGppChannelConditionModel::m_updatePeriod),
                    MakeTimeChecker ())
+    .AddAttribute ("PerLinkRandomStreams",
+                   "If true, the condition of each link is drawn from a value keyed "
+                   "by the seed, the run, the stream assigned to the model, the pair "
+                   "of nodes and the number of updates of the link, so that it does "
+                   "not depend on the order in which the links are queried",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelConditionModel::m_perLinkRandomStreams),
+                   MakeBooleanChecker ())
   ;
   return tid;
 }
@@ -316,11 +326,13 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
   bool update = false; // indicates if the channel condition has to be updated
 
   // look for the channel condition in m_channelConditionMap
+  uint32_t updateIndex = 0;
   auto mapItem = m_channelConditionMap.find (key);
   if (mapItem != m_channelConditionMap.end ())
     {
       NS_LOG_DEBUG ("found the channel condition in the map");
       cond = mapItem->second.m_condition;
+      updateIndex = mapItem->second.m_updateIndex + 1;
 
       // check if it has to be updated
       if (!m_updatePeriod.IsZero () && Simulator::Now () - mapItem->second.m_generatedTime > m_updatePeriod)
@@ -339,12 +351,13 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
   // generate a new channel condition
   if (notFound || update)
     {
-      cond = ComputeChannelCondition (a, b);
+      cond = ComputeChannelCondition (a, b, updateIndex);
       // store the channel condition in m_channelConditionMap, used as cache.
       // For this reason you see a const_cast.
       Item mapItem;
       mapItem.m_condition = cond;
       mapItem.m_generatedTime = Simulator::Now ();
+      mapItem.m_updateIndex = updateIndex;
       const_cast<ThreeGppChannelConditionModel*> (this)->m_channelConditionMap [key] = mapItem;
     }
 
@@ -353,9 +366,10 @@ ThreeGppChannelConditionModel::GetChannelCondition (Ptr<const MobilityModel> a,
 
 Ptr<ChannelCondition>
 ThreeGppChannelConditionModel::ComputeChannelCondition (Ptr<const MobilityModel> a,
-                                                        Ptr<const MobilityModel> b) const
+                                                        Ptr<const MobilityModel> b,
+                                                        uint32_t updateIndex) const
 {
-  NS_LOG_FUNCTION (this << a << b);
+  NS_LOG_FUNCTION (this << a << b << updateIndex);
   Ptr<ChannelCondition> cond = CreateObject<ChannelCondition> ();
 
   // compute the LOS probability
@@ -363,7 +377,7 @@ ThreeGppChannelConditionModel::ComputeChannelCondition (Ptr<const MobilityModel>
   double pNlos = ComputePnlos (a, b);
 
   // draw a random value
-  double pRef = m_uniformVar->GetValue ();
+  double pRef = m_perLinkRandomStreams ? GetPerLinkUniform (GetKey (a, b), updateIndex) : m_uniformVar->GetValue ();
 
   NS_LOG_DEBUG ("pRef " << pRef << " pLos " << pLos << " pNlos " << pNlos);
 
@@ -396,6 +410,26 @@ ThreeGppChannelConditionModel::ComputePnlos (Ptr<const MobilityModel> a,
   return (1 - ComputePlos (a, b));
 }
 
+double
+ThreeGppChannelConditionModel::GetPerLinkUniform (uint32_t key, uint32_t updateIndex) const
+{
+  // the SplitMix64 finalizer
+  auto mix = [] (uint64_t x)
+    {
+      x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+      return x ^ (x >> 31);
+    };
+  uint64_t hash = RngSeedManager::GetSeed ();
+  for (uint64_t value : {RngSeedManager::GetRun (), static_cast<uint64_t> (m_uniformVar->GetStream ()),
+                         static_cast<uint64_t> (key), static_cast<uint64_t> (updateIndex)})
+    {
+      hash = mix (mix (hash + 0x9e3779b97f4a7c15ULL) ^ value);
+    }
+  // 53 random bits, centered in the interval to exclude 0 and 1
+  return ((hash >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
 int64_t
 ThreeGppChannelConditionModel::AssignStreams (int64_t stream)
 {
@@ -474,9 +474,23 @@ private:
   *
   * \param a tx mobility model
   * \param b rx mobility model
+  * \param updateIndex the number of previous updates of the condition of the link
   * \return the channel condition
   */
-  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+  Ptr<ChannelCondition> ComputeChannelCondition (Ptr<const MobilityModel> a, Ptr<const MobilityModel> b,
+                                                 uint32_t updateIndex) const;
+
+  /**
+   * Draws the uniform value of a link when the attribute PerLinkRandomStreams
+   * is true. The value is a hash of the seed, the run, the stream of
+   * m_uniformVar, the key of the link and the number of updates of its
+   * condition, thus it does not depend on the order of the links.
+   *
+   * \param key the key of the link
+   * \param updateIndex the number of previous updates of the condition of the link
+   * \return a value uniformly distributed in (0, 1)
+   */
+  double GetPerLinkUniform (uint32_t key, uint32_t updateIndex) const;
 
   /**
    * Compute the LOS probability.
@@ -511,10 +525,12 @@ private:
   {
     Ptr<ChannelCondition> m_condition; //!< the channel condition
     Time m_generatedTime; //!< the time when the condition was generated
+    uint32_t m_updateIndex; //!< the number of previous updates of the condition
   };
 
   std::unordered_map<uint32_t, Item> m_channelConditionMap; //!< map to store the channel conditions
   Time m_updatePeriod; //!< the update period for the channel condition
+  bool m_perLinkRandomStreams; //!< if true, the conditions are drawn with GetPerLinkUniform
 };
 
 /**
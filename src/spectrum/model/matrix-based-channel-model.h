@@ -52,14 +52,119 @@ public:
   typedef std::vector<DoubleVector> Double2DVector; //!< type definition for matrices of doubles
   typedef std::vector<Double2DVector> Double3DVector; //!< type definition for 3D matrices of doubles
   typedef std::vector<PhasedArrayModel::ComplexVector> Complex2DVector; //!< type definition for complex matrices
-  typedef std::vector<Complex2DVector> Complex3DVector; //!< type definition for complex 3D matrices
+
+  /**
+   * Complex 3D matrix, stored in a single contiguous block of memory.
+   *
+   * The element (row, col, page) is stored at position
+   * (page * numCols + col) * numRows + row, i.e., the rows of a column of
+   * a page are contiguous. For the channel matrix H[u][s][n], the rows are
+   * the u antenna elements, the columns are the s antenna elements and the
+   * pages are the clusters.
+   */
+  class Complex3DVector
+  {
+  public:
+    /**
+     * Create an empty matrix
+     */
+    Complex3DVector () = default;
+
+    /**
+     * Create a matrix with all the elements equal to zero
+     * \param numRows the number of rows
+     * \param numCols the number of columns
+     * \param numPages the number of pages
+     */
+    Complex3DVector (size_t numRows, size_t numCols, size_t numPages)
+      : m_numRows (numRows),
+        m_numCols (numCols),
+        m_numPages (numPages),
+        m_values (numRows * numCols * numPages)
+    {
+    }
+
+    /**
+     * \return the number of rows
+     */
+    size_t GetNumRows () const
+    {
+      return m_numRows;
+    }
+
+    /**
+     * \return the number of columns
+     */
+    size_t GetNumCols () const
+    {
+      return m_numCols;
+    }
+
+    /**
+     * \return the number of pages
+     */
+    size_t GetNumPages () const
+    {
+      return m_numPages;
+    }
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a reference to the element (row, col, page)
+     */
+    std::complex<double>& operator() (size_t row, size_t col, size_t page)
+    {
+      NS_ASSERT_MSG (row < m_numRows && col < m_numCols && page < m_numPages, "Index out of range");
+      return m_values[(page * m_numCols + col) * m_numRows + row];
+    }
+
+    /**
+     * \param row the row index
+     * \param col the column index
+     * \param page the page index
+     * \return a const reference to the element (row, col, page)
+     */
+    const std::complex<double>& operator() (size_t row, size_t col, size_t page) const
+    {
+      NS_ASSERT_MSG (row < m_numRows && col < m_numCols && page < m_numPages, "Index out of range");
+      return m_values[(page * m_numCols + col) * m_numRows + row];
+    }
+
+    /**
+     * \param col the column index
+     * \param page the page index
+     * \return a pointer to the GetNumRows () contiguous elements of the
+     * column col of the page
+     */
+    const std::complex<double>* GetColumnPtr (size_t col, size_t page) const
+    {
+      NS_ASSERT_MSG (col < m_numCols && page < m_numPages, "Index out of range");
+      return &m_values[(page * m_numCols + col) * m_numRows];
+    }
+
+    /**
+     * \return the elements of the matrix, in the storage order
+     */
+    const PhasedArrayModel::ComplexVector& GetValues () const
+    {
+      return m_values;
+    }
+
+  private:
+    size_t m_numRows {0}; //!< number of rows
+    size_t m_numCols {0}; //!< number of columns
+    size_t m_numPages {0}; //!< number of pages
+    PhasedArrayModel::ComplexVector m_values; //!< the elements of the matrix
+  };
 
   /**
    * Data structure that stores a channel realization
    */
   struct ChannelMatrix : public SimpleRefCount<ChannelMatrix>
   {
-    Complex3DVector    m_channel; //!< channel matrix H[u][s][n].
+    Complex3DVector    m_channel; //!< channel matrix H[u][s][n], accessed as m_channel (u, s, n)
     Time               m_generatedTime; //!< generation time
     std::pair<uint32_t, uint32_t> m_antennaPair; //!< the first element is the ID of the antenna of the s-node (the antenna of the transmitter when the channel was generated), the second element is ID of the antenna of the u-node antenna (the antenna of the receiver when the channel was generated)
     std::pair<uint32_t, uint32_t> m_nodeIds; //!< the first element is the s-node ID (the transmitter when the channel was generated), the second element is the u-node ID (the receiver when the channel was generated)
@@ -79,7 +79,9 @@ RxSpectrumModelInfo::RxSpectrumModelInfo (Ptr<const SpectrumModel> rxSpectrumMod
 }
 
 MultiModelSpectrumChannel::MultiModelSpectrumChannel ()
-  : m_numDevices {0}
+  : m_numDevices {0},
+    m_numRxCulledByRange {0},
+    m_numRxCulledByLoss {0}
 {
   NS_LOG_FUNCTION (this);
 }
@@ -100,7 +102,20 @@ MultiModelSpectrumChannel::GetTypeId (void)
     .SetParent<SpectrumChannel> ()
     .SetGroupName ("Spectrum")
     .AddConstructor<MultiModelSpectrumChannel> ()
-
+    .AddAttribute ("MaxRange",
+                   "The maximum distance in meters between the transmitter "
+                   "and a receiver for which transmissions will be passed "
+                   "to the receiving PHY. Receivers farther than this value "
+                   "are skipped before the signal parameters are copied and "
+                   "before any propagation and spectrum loss is computed for "
+                   "them, thus they are not reported by the Gain and PathLoss "
+                   "traces. This parameter is to be used to reduce the "
+                   "computational load in dense deployments. Note that "
+                   "the default value, NO_MAX_RANGE, corresponds to considering "
+                   "all signals for reception. Tune this value with care.",
+                   DoubleValue (NO_MAX_RANGE),
+                   MakeDoubleAccessor (&MultiModelSpectrumChannel::m_maxRange),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
@@ -290,23 +305,30 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
-              NS_LOG_LOGIC ("copying signal parameters " << txParams);
-              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
-              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
               Time delay = MicroSeconds (0);
+              double pathGainLinear = 1.0;
 
               Ptr<MobilityModel> receiverMobility = (*rxPhyIterator)->GetMobility ();
 
               if (txMobility && receiverMobility)
                 {
+                  if (m_maxRange != NO_MAX_RANGE
+                      && CalculateDistance (txMobility->GetPosition (), receiverMobility->GetPosition ()) > m_maxRange)
+                    {
+                      // beyond range, skip the receiver before any copy
+                      NS_LOG_LOGIC ("receiver " << *rxPhyIterator << " beyond MaxRange");
+                      m_numRxCulledByRange++;
+                      continue;
+                    }
+
                   double txAntennaGain = 0;
                   double rxAntennaGain = 0;
                   double propagationGainDb = 0;
                   double pathLossDb = 0;
-                  if (rxParams->txAntenna)
+                  if (txParams->txAntenna)
                     {
                       Angles txAngles (receiverMobility->GetPosition (), txMobility->GetPosition ());
-                      txAntennaGain = rxParams->txAntenna->GetGainDb (txAngles);
+                      txAntennaGain = txParams->txAntenna->GetGainDb (txAngles);
                       NS_LOG_LOGIC ("txAntennaGain = " << txAntennaGain << " dB");
                       pathLossDb -= txAntennaGain;
                     }
@@ -332,10 +354,10 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                   if (pathLossDb > m_maxLossDb)
                     {
                       // beyond range
+                      m_numRxCulledByLoss++;
                       continue;
                     }
-                  double pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
-                  *(rxParams->psd) *= pathGainLinear;
+                  pathGainLinear = std::pow (10.0, (-pathLossDb) / 10.0);
 
                   if (m_propagationDelay)
                     {
@@ -343,6 +365,15 @@ MultiModelSpectrumChannel::StartTx (Ptr<SpectrumSignalParameters> txParams)
                     }
                 }
 
+              // copy the signal parameters only for the receivers in range
+              NS_LOG_LOGIC ("copying signal parameters " << txParams);
+              Ptr<SpectrumSignalParameters> rxParams = txParams->Copy ();
+              rxParams->psd = Copy<SpectrumValue> (convertedTxPowerSpectrum);
+              if (txMobility && receiverMobility)
+                {
+                  *(rxParams->psd) *= pathGainLinear;
+                }
+
               if (rxNetDevice)
                 {
                   // the receiver has a NetDevice, so we expect that it is attached to a Node
@@ -383,6 +414,18 @@ MultiModelSpectrumChannel::StartRx (Ptr<SpectrumSignalParameters> params, Ptr<Sp
   receiver->StartRx (params);
 }
 
+uint64_t
+MultiModelSpectrumChannel::GetNumRxCulledByRange (void) const
+{
+  return m_numRxCulledByRange;
+}
+
+uint64_t
+MultiModelSpectrumChannel::GetNumRxCulledByLoss (void) const
+{
+  return m_numRxCulledByLoss;
+}
+
 std::size_t
 MultiModelSpectrumChannel::GetNDevices (void) const
 {
@@ -125,6 +125,23 @@ public:
   virtual std::size_t GetNDevices (void) const;
   virtual Ptr<NetDevice> GetDevice (std::size_t i) const;
 
+  /**
+   * The value of MaxRange for which no receiver is skipped
+   */
+  static constexpr double NO_MAX_RANGE = 0.0;
+
+  /**
+   * \return the number of receivers skipped by StartTx because they were
+   * farther than MaxRange from the transmitter
+   */
+  uint64_t GetNumRxCulledByRange (void) const;
+
+  /**
+   * \return the number of receivers skipped by StartTx because the loss
+   * was above MaxLossDb
+   */
+  uint64_t GetNumRxCulledByLoss (void) const;
+
 
 protected:
   void DoDispose ();
@@ -170,6 +187,15 @@ private:
    */
   std::size_t m_numDevices;
 
+  /**
+   * Maximum distance [m] between the transmitter and a receiver for which
+   * the signal is propagated, or NO_MAX_RANGE.
+   */
+  double m_maxRange;
+
+  uint64_t m_numRxCulledByRange; //!< number of receivers skipped because beyond m_maxRange
+  uint64_t m_numRxCulledByLoss;  //!< number of receivers skipped because of a loss above m_maxLossDb
+
 };
 
 
@@ -0,0 +1,287 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2020 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "three-gpp-channel-cache.h"
+#include <ns3/log.h>
+#include <ns3/abort.h>
+#include <cstring>
+#ifdef HAVE_MMAP_FLOCK
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ThreeGppChannelCache");
+
+/// magic string at the beginning of the file
+static const char CACHE_MAGIC[8] = {'N', 'S', '3', 'T', 'G', 'P', 'P', 'C'};
+
+/// size of the file header: magic string and version
+static const size_t CACHE_HEADER_SIZE = sizeof (CACHE_MAGIC) + sizeof (uint32_t);
+
+/// size of the record header: type, key and payload size
+static const size_t RECORD_HEADER_SIZE = sizeof (uint32_t) + sizeof (uint64_t) + sizeof (uint64_t);
+
+/**
+ * \param data the first bytes of the file
+ * \param size the number of bytes
+ * \return true if the bytes start with a valid header
+ */
+static bool
+IsValidHeader (const uint8_t *data, size_t size)
+{
+  if (size < CACHE_HEADER_SIZE || std::memcmp (data, CACHE_MAGIC, sizeof (CACHE_MAGIC)) != 0)
+    {
+      return false;
+    }
+  uint32_t version;
+  std::memcpy (&version, data + sizeof (CACHE_MAGIC), sizeof (version));
+  return version == ThreeGppChannelCache::VERSION;
+}
+
+ThreeGppChannelCache::ThreeGppChannelCache (const std::string &fileName)
+  : m_fileName (fileName),
+    m_mapped (nullptr),
+    m_mappedSize (0)
+{
+  NS_LOG_FUNCTION (this << fileName);
+  Open ();
+}
+
+ThreeGppChannelCache::~ThreeGppChannelCache ()
+{
+  NS_LOG_FUNCTION (this);
+  Flush ();
+#ifdef HAVE_MMAP_FLOCK
+  if (m_mapped)
+    {
+      munmap (const_cast<uint8_t *> (m_mapped), m_mappedSize);
+    }
+#endif
+}
+
+void
+ThreeGppChannelCache::Open ()
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_MMAP_FLOCK
+  int fd = open (m_fileName.c_str (), O_RDONLY);
+  if (fd < 0)
+    {
+      NS_LOG_INFO ("Cache file " << m_fileName << " not found, it will be created");
+      return;
+    }
+  flock (fd, LOCK_SH);
+  struct stat st;
+  if (fstat (fd, &st) == 0 && st.st_size > 0)
+    {
+      void *mapped = mmap (nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped != MAP_FAILED)
+        {
+          m_mapped = static_cast<const uint8_t *> (mapped);
+          m_mappedSize = st.st_size;
+        }
+    }
+  flock (fd, LOCK_UN);
+  close (fd);
+#else
+  std::ifstream file (m_fileName.c_str (), std::ios::binary);
+  if (!file)
+    {
+      NS_LOG_INFO ("Cache file " << m_fileName << " not found, it will be created");
+      return;
+    }
+  m_contents.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+  if (!m_contents.empty ())
+    {
+      m_mapped = m_contents.data ();
+      m_mappedSize = m_contents.size ();
+    }
+#endif
+  if (!m_mapped)
+    {
+      return;
+    }
+
+  if (!IsValidHeader (m_mapped, m_mappedSize))
+    {
+      NS_LOG_WARN ("Cache file " << m_fileName << " has a different format, its records are ignored");
+      return;
+    }
+
+  size_t offset = CACHE_HEADER_SIZE;
+  while (offset + RECORD_HEADER_SIZE <= m_mappedSize)
+    {
+      uint32_t type;
+      uint64_t key;
+      uint64_t size;
+      std::memcpy (&type, m_mapped + offset, sizeof (type));
+      std::memcpy (&key, m_mapped + offset + sizeof (type), sizeof (key));
+      std::memcpy (&size, m_mapped + offset + sizeof (type) + sizeof (key), sizeof (size));
+      offset += RECORD_HEADER_SIZE;
+      if (size > m_mappedSize - offset)
+        {
+          NS_LOG_WARN ("Truncated record in cache file " << m_fileName);
+          break;
+        }
+      // the last record with a key replaces the previous ones
+      m_index[GetIndexKey (type, key)] = {m_mapped + offset, size};
+      offset += size;
+    }
+  NS_LOG_INFO ("Loaded " << m_index.size () << " records from cache file " << m_fileName);
+}
+
+uint64_t
+ThreeGppChannelCache::GetIndexKey (uint32_t type, uint64_t key)
+{
+  // the types are a handful of small values, thus they are mixed in the
+  // most significant bits of the key
+  return key ^ (static_cast<uint64_t> (type) * 0x9e3779b97f4a7c15ULL);
+}
+
+bool
+ThreeGppChannelCache::Find (uint32_t type, uint64_t key, Payload &payload) const
+{
+  std::unordered_map<uint64_t, Payload>::const_iterator it = m_index.find (GetIndexKey (type, key));
+  if (it == m_index.end ())
+    {
+      return false;
+    }
+  payload = it->second;
+  return true;
+}
+
+void
+ThreeGppChannelCache::Add (uint32_t type, uint64_t key, std::vector<uint8_t> payload)
+{
+  NS_LOG_FUNCTION (this << type << key << payload.size ());
+  uint64_t size = payload.size ();
+  std::vector<uint8_t> record (RECORD_HEADER_SIZE + size);
+  std::memcpy (&record[0], &type, sizeof (type));
+  std::memcpy (&record[sizeof (type)], &key, sizeof (key));
+  std::memcpy (&record[sizeof (type) + sizeof (key)], &size, sizeof (size));
+  if (size > 0)
+    {
+      std::memcpy (&record[RECORD_HEADER_SIZE], payload.data (), size);
+    }
+  m_newRecords.push_back (std::move (record));
+  // the data of a vector does not move when the vector is moved
+  m_index[GetIndexKey (type, key)] = {m_newRecords.back ().data () + RECORD_HEADER_SIZE, size};
+}
+
+void
+ThreeGppChannelCache::Flush ()
+{
+  NS_LOG_FUNCTION (this);
+  if (m_newRecords.empty ())
+    {
+      return;
+    }
+
+#ifdef HAVE_MMAP_FLOCK
+  int fd = open (m_fileName.c_str (), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd < 0)
+    {
+      NS_LOG_WARN ("Cannot open cache file " << m_fileName << ", " << m_newRecords.size () << " records are lost");
+      return;
+    }
+  flock (fd, LOCK_EX);
+  struct stat st;
+  NS_ABORT_MSG_IF (fstat (fd, &st) != 0, "Cannot stat cache file " << m_fileName);
+  bool isEmpty = st.st_size == 0;
+  uint8_t header[CACHE_HEADER_SIZE];
+  bool isValid = !isEmpty && pread (fd, header, sizeof (header), 0) == sizeof (header)
+    && IsValidHeader (header, sizeof (header));
+#else
+  std::ifstream existing (m_fileName.c_str (), std::ios::binary);
+  uint8_t header[CACHE_HEADER_SIZE];
+  existing.read (reinterpret_cast<char *> (header), sizeof (header));
+  bool isEmpty = existing.gcount () == 0;
+  bool isValid = existing.gcount () == sizeof (header) && IsValidHeader (header, sizeof (header));
+  existing.close ();
+#endif
+  std::vector<uint8_t> buffer;
+  if (!isEmpty)
+    {
+      if (!isValid)
+        {
+          NS_LOG_WARN ("Cache file " << m_fileName << " has a different format, " << m_newRecords.size () << " records are lost");
+#ifdef HAVE_MMAP_FLOCK
+          flock (fd, LOCK_UN);
+          close (fd);
+#endif
+          return;
+        }
+    }
+  else
+    {
+      buffer.insert (buffer.end (), CACHE_MAGIC, CACHE_MAGIC + sizeof (CACHE_MAGIC));
+      uint32_t version = VERSION;
+      const uint8_t *versionBytes = reinterpret_cast<const uint8_t *> (&version);
+      buffer.insert (buffer.end (), versionBytes, versionBytes + sizeof (version));
+    }
+  for (const std::vector<uint8_t> &record : m_newRecords)
+    {
+      buffer.insert (buffer.end (), record.begin (), record.end ());
+    }
+#ifdef HAVE_MMAP_FLOCK
+  ssize_t written = write (fd, buffer.data (), buffer.size ());
+  NS_ABORT_MSG_IF (written != static_cast<ssize_t> (buffer.size ()), "Error while writing cache file " << m_fileName);
+  flock (fd, LOCK_UN);
+  close (fd);
+#else
+  std::ofstream file (m_fileName.c_str (), std::ios::binary | std::ios::app);
+  if (!file)
+    {
+      NS_LOG_WARN ("Cannot open cache file " << m_fileName << ", " << m_newRecords.size () << " records are lost");
+      return;
+    }
+  file.write (reinterpret_cast<const char *> (buffer.data ()), buffer.size ());
+  NS_ABORT_MSG_IF (!file, "Error while writing cache file " << m_fileName);
+#endif
+  NS_LOG_INFO ("Appended " << m_newRecords.size () << " records to cache file " << m_fileName);
+
+  // the index keeps pointing to the new records, which are kept in memory
+  // but not written again
+  m_flushedRecords.insert (m_flushedRecords.end (),
+                           std::make_move_iterator (m_newRecords.begin ()),
+                           std::make_move_iterator (m_newRecords.end ()));
+  m_newRecords.clear ();
+}
+
+const std::string&
+ThreeGppChannelCache::GetFileName () const
+{
+  return m_fileName;
+}
+
+size_t
+ThreeGppChannelCache::GetNumRecords () const
+{
+  return m_index.size ();
+}
+
+} // namespace ns3
@@ -0,0 +1,137 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2020 SIGNET Lab, Department of Information Engineering,
+ * University of Padova
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef THREE_GPP_CHANNEL_CACHE_H
+#define THREE_GPP_CHANNEL_CACHE_H
+
+#include <ns3/simple-ref-count.h>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup spectrum
+ * \brief Persistent cache of the channel realizations of ThreeGppChannelModel
+ *
+ * The cache is a binary file made of a header, with a magic string and the
+ * version of the format, followed by records. Each record has a type, a
+ * 64-bit key and an opaque payload, which is serialized and validated by
+ * the user of the cache. When the cache is opened, the file is mapped in
+ * memory and indexed, so that the payloads are read in place. The records
+ * added during the run are appended to the file by Flush, under an
+ * exclusive lock, so that several runs can share the same file.
+ *
+ * On the platforms without mmap and flock, the file is read in memory
+ * instead, and it is not locked, thus it must not be shared by concurrent
+ * runs.
+ *
+ * If the file does not exist, it is created by Flush. If the file has a
+ * different magic string or version, or a truncated record, the records
+ * which cannot be read are ignored.
+ */
+class ThreeGppChannelCache : public SimpleRefCount<ThreeGppChannelCache>
+{
+public:
+  /**
+   * Opens the cache
+   * \param fileName the name of the file
+   */
+  ThreeGppChannelCache (const std::string &fileName);
+
+  /**
+   * Appends the new records to the file and unmaps it
+   */
+  ~ThreeGppChannelCache ();
+
+  // delete copy constructor and assignment operator
+  ThreeGppChannelCache (const ThreeGppChannelCache&) = delete;
+  ThreeGppChannelCache& operator= (const ThreeGppChannelCache&) = delete;
+
+  /**
+   * A payload of the cache
+   */
+  struct Payload
+  {
+    const uint8_t *m_data; //!< the first byte
+    size_t m_size; //!< the number of bytes
+  };
+
+  /**
+   * Looks for a record
+   * \param type the type of the record
+   * \param key the key of the record
+   * \param [out] payload the payload of the record, if found
+   * \return true if the record has been found
+   */
+  bool Find (uint32_t type, uint64_t key, Payload &payload) const;
+
+  /**
+   * Adds a record, which is written to the file by Flush. If a record with
+   * the same type and key exists, it is replaced.
+   * \param type the type of the record
+   * \param key the key of the record
+   * \param payload the payload of the record
+   */
+  void Add (uint32_t type, uint64_t key, std::vector<uint8_t> payload);
+
+  /**
+   * Appends the records added since the last call to the file
+   */
+  void Flush ();
+
+  /**
+   * \return the name of the file
+   */
+  const std::string& GetFileName () const;
+
+  /**
+   * \return the number of records in the cache
+   */
+  size_t GetNumRecords () const;
+
+  static const uint32_t VERSION = 1; //!< version of the file format
+
+private:
+  /**
+   * Maps the file in memory and indexes its records
+   */
+  void Open ();
+
+  /**
+   * \param type the type of the record
+   * \param key the key of the record
+   * \return the key of m_index
+   */
+  static uint64_t GetIndexKey (uint32_t type, uint64_t key);
+
+  std::string m_fileName; //!< the name of the file
+  const uint8_t *m_mapped; //!< the file mapped in memory, or nullptr
+  std::vector<uint8_t> m_contents; //!< the file read in memory, when it cannot be mapped
+  size_t m_mappedSize; //!< the size of the mapped file
+  std::unordered_map<uint64_t, Payload> m_index; //!< the payloads of the records, in m_mapped or in m_newRecords
+  std::vector<std::vector<uint8_t> > m_newRecords; //!< the records added since the last flush, with their header
+  std::vector<std::vector<uint8_t> > m_flushedRecords; //!< the records added and already written to the file
+};
+
+} // namespace ns3
+
+#endif // THREE_GPP_CHANNEL_CACHE_H
@@ -27,8 +27,14 @@
 #include "ns3/double.h"
 #include "ns3/string.h"
 #include "ns3/integer.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <random>
+#include <set>
+#include <thread>
 #include "ns3/log.h"
 #include <ns3/simulator.h>
 #include "ns3/mobility-model.h"
@@ -40,6 +46,152 @@ NS_LOG_COMPONENT_DEFINE ("ThreeGppChannelModel");
 
 NS_OBJECT_ENSURE_REGISTERED (ThreeGppChannelModel);
 
+/// types of the records of the channel cache
+enum ChannelCacheRecordType : uint32_t
+{
+  CHANNEL_PARAMS_RECORD = 1, //!< ThreeGppChannelParams
+  CHANNEL_MATRIX_RECORD = 2, //!< ChannelMatrix
+};
+
+/**
+ * Serializes the channel params and matrices in the payload of a record of
+ * the channel cache
+ */
+class ChannelCacheWriter
+{
+public:
+  /**
+   * Writes a value
+   * \param value the value
+   */
+  template <typename T>
+  void Write (const T &value)
+  {
+    static_assert (std::is_trivially_copyable<T>::value, "Only trivially copyable types can be written");
+    const uint8_t *bytes = reinterpret_cast<const uint8_t *> (&value);
+    m_buffer.insert (m_buffer.end (), bytes, bytes + sizeof (T));
+  }
+
+  /**
+   * Writes a pair
+   * \param value the pair
+   */
+  template <typename T1, typename T2>
+  void Write (const std::pair<T1, T2> &value)
+  {
+    Write (value.first);
+    Write (value.second);
+  }
+
+  /**
+   * Writes a vector, preceded by its size
+   * \param values the vector
+   */
+  template <typename T>
+  void Write (const std::vector<T> &values)
+  {
+    Write<uint64_t> (values.size ());
+    for (const T &value : values)
+      {
+        Write (value);
+      }
+  }
+
+  /**
+   * \return the payload
+   */
+  std::vector<uint8_t> GetBuffer ()
+  {
+    return std::move (m_buffer);
+  }
+
+private:
+  std::vector<uint8_t> m_buffer; //!< the payload
+};
+
+/**
+ * Deserializes the payload of a record of the channel cache. After a read
+ * beyond the end of the payload, all the following reads fail.
+ */
+class ChannelCacheReader
+{
+public:
+  /**
+   * Constructor
+   * \param payload the payload
+   */
+  ChannelCacheReader (const ThreeGppChannelCache::Payload &payload)
+    : m_data (payload.m_data),
+      m_size (payload.m_size),
+      m_offset (0),
+      m_ok (true)
+  {
+  }
+
+  /**
+   * Reads a value
+   * \param [out] value the value
+   * \return false if the payload is too short
+   */
+  template <typename T>
+  bool Read (T &value)
+  {
+    static_assert (std::is_trivially_copyable<T>::value, "Only trivially copyable types can be read");
+    m_ok = m_ok && (m_size - m_offset >= sizeof (T));
+    if (m_ok)
+      {
+        std::memcpy (&value, m_data + m_offset, sizeof (T));
+        m_offset += sizeof (T);
+      }
+    return m_ok;
+  }
+
+  /**
+   * Reads a pair
+   * \param [out] value the pair
+   * \return false if the payload is too short
+   */
+  template <typename T1, typename T2>
+  bool Read (std::pair<T1, T2> &value)
+  {
+    Read (value.first);
+    return Read (value.second);
+  }
+
+  /**
+   * Reads a vector, preceded by its size
+   * \param [out] values the vector
+   * \return false if the payload is too short
+   */
+  template <typename T>
+  bool Read (std::vector<T> &values)
+  {
+    uint64_t size = 0;
+    // each element takes at least one byte, this bounds the allocation
+    m_ok = Read (size) && size <= m_size - m_offset;
+    values.resize (m_ok ? size : 0);
+    for (T &value : values)
+      {
+        Read (value);
+      }
+    return m_ok;
+  }
+
+  /**
+   * \return true if all the reads succeeded and the whole payload has been read
+   */
+  bool IsComplete () const
+  {
+    return m_ok && m_offset == m_size;
+  }
+
+private:
+  const uint8_t *m_data; //!< the payload
+  size_t m_size; //!< the size of the payload
+  size_t m_offset; //!< the number of bytes already read
+  bool m_ok; //!< false if a read failed
+};
+
 /// The ray offset angles within a cluster, given for rms angle spread normalized to 1. (Table 7.5-3)
 static const double offSetAlpha[20] = {
   0.0447, -0.0447, 0.1413, -0.1413, 0.2492, -0.2492, 0.3715, -0.3715, 0.5129, -0.5129,
@@ -251,6 +403,11 @@ ThreeGppChannelModel::ThreeGppChannelModel ()
   m_normalRv = CreateObject<NormalRandomVariable> ();
   m_normalRv->SetAttribute ("Mean", DoubleValue (0.0));
   m_normalRv->SetAttribute ("Variance", DoubleValue (1.0));
+  m_batchChannels = 0;
+  m_conditionModelChecked = false;
+  m_cacheConfigKey = 0;
+  m_cacheHits = 0;
+  m_cacheMisses = 0;
 }
 
 ThreeGppChannelModel::~ThreeGppChannelModel ()
@@ -269,6 +426,14 @@ ThreeGppChannelModel::DoDispose ()
   m_channelMatrixMap.clear ();
   m_channelParamsMap.clear ();
   m_channelConditionModel = nullptr;
+  if (m_cache)
+    {
+      uint64_t lookups = m_cacheHits + m_cacheMisses;
+      NS_LOG_INFO ("cache " << m_cache->GetFileName () << ": "
+                   << m_cacheHits << " hits, " << m_cacheMisses << " misses, hit rate "
+                   << (lookups > 0 ? 100.0 * m_cacheHits / lookups : 0.0) << "%");
+      m_cache = nullptr;
+    }
 }
 
 TypeId
@@ -329,6 +494,30 @@ ThreeGppChannelModel::GetTypeId (void)
                    DoubleValue (0.0),
                    MakeDoubleAccessor (&ThreeGppChannelModel::m_vScatt),
                    MakeDoubleChecker<double> (0.0))
+    .AddAttribute ("NumThreads",
+                   "Number of threads used by GenerateChannels to compute the "
+                   "channel matrices",
+                   UintegerValue (1),
+                   MakeUintegerAccessor (&ThreeGppChannelModel::m_numThreads),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("PerLinkRandomStreams",
+                   "If true, the channel params of each link are generated with "
+                   "counter-based random streams keyed by the seed, the run, the "
+                   "streams assigned to the model, the pair of nodes and the "
+                   "number of updates of the link, so that they do not depend "
+                   "on the order in which the links are generated. A "
+                   "ThreeGppChannelConditionModel must then have its attribute "
+                   "PerLinkRandomStreams set as well",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&ThreeGppChannelModel::m_perLinkRandomStreams),
+                   MakeBooleanChecker ())
+    .AddAttribute ("CacheFile",
+                   "Name of the file where the channel params and matrices are "
+                   "cached across runs. If empty, the cache is disabled. The "
+                   "cache requires PerLinkRandomStreams",
+                   StringValue (""),
+                   MakeStringAccessor (&ThreeGppChannelModel::m_cacheFile),
+                   MakeStringChecker ())
 
   ;
   return tid;
@@ -339,6 +528,7 @@ ThreeGppChannelModel::SetChannelConditionModel (Ptr<ChannelConditionModel> model
 {
   NS_LOG_FUNCTION (this);
   m_channelConditionModel = model;
+  m_conditionModelChecked = false;
 }
 
 Ptr<ChannelConditionModel>
@@ -1040,7 +1230,8 @@ ThreeGppChannelModel::GetThreeGppTable (Ptr<const ChannelCondition> channelCondi
 
 bool
 ThreeGppChannelModel::ChannelParamsNeedsUpdate (Ptr<const ThreeGppChannelParams> channelParams,
-                                                Ptr<const ChannelCondition> channelCondition) const
+                                                Ptr<const ChannelCondition> channelCondition,
+                                                Time horizon) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -1054,7 +1245,7 @@ ThreeGppChannelModel::ChannelParamsNeedsUpdate (Ptr<const ThreeGppChannelParams>
     }
 
   // if the coherence time is over the channel has to be updated
-  if (!m_updatePeriod.IsZero () && Simulator::Now () - channelParams->m_generatedTime > m_updatePeriod)
+  if (!m_updatePeriod.IsZero () && Simulator::Now () + horizon - channelParams->m_generatedTime > m_updatePeriod)
     {
       NS_LOG_DEBUG ("Generation time " << channelParams->m_generatedTime.As (Time::NS) << " now " << Now ().As (Time::NS));
       update = true;
@@ -1086,12 +1277,49 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
 {
   NS_LOG_FUNCTION (this);
 
+  Ptr<const ThreeGppChannelParams> channelParams;
+  Ptr<const ParamsTable> table3gpp;
+  Ptr<ChannelMatrix> channelMatrix = LookupChannel (aMob, bMob, aAntenna, bAntenna, channelParams, table3gpp);
+
+  // If the channel is not present in the map or if it has to be updated
+  // generate a new realization
+  if (!channelMatrix)
+    {
+      // channel matrix not found or has to be updated, load it from the
+      // cache or generate a new one
+      channelMatrix = LoadChannel (channelParams, aMob, bMob, aAntenna, bAntenna);
+      if (!channelMatrix)
+        {
+          channelMatrix = GetNewChannel (channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
+          StoreChannel (channelMatrix, aAntenna, bAntenna);
+          SaveChannel (channelMatrix, channelParams, aMob->GetPosition (), bMob->GetPosition (), aAntenna, bAntenna);
+        }
+    }
+
+  return channelMatrix;
+}
+
+Ptr<MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::LookupChannel (Ptr<const MobilityModel> aMob,
+                                     Ptr<const MobilityModel> bMob,
+                                     Ptr<const PhasedArrayModel> aAntenna,
+                                     Ptr<const PhasedArrayModel> bAntenna,
+                                     Ptr<const ThreeGppChannelParams> &params,
+                                     Ptr<const ParamsTable> &table,
+                                     Time horizon)
+{
+  NS_LOG_FUNCTION (this);
+
   // Compute the channel params key. The key is reciprocal, i.e., key (a, b) = key (b, a)
   uint64_t channelParamsKey = GetKey (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
   // Compute the channel matrix key. The key is reciprocal, i.e., key (a, b) = key (b, a)
   uint64_t channelMatrixKey = GetKey (aAntenna->GetId (), bAntenna->GetId ());
 
   // retrieve the channel condition
+  if (m_perLinkRandomStreams && !m_conditionModelChecked)
+    {
+      CheckChannelConditionModel ();
+    }
   Ptr<const ChannelCondition> condition = m_channelConditionModel->GetChannelCondition (aMob, bMob);
 
   // Check if the channel is present in the map and return it, otherwise
@@ -1108,7 +1336,7 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
     {
       channelParams = m_channelParamsMap[channelParamsKey];
       // check if it has to be updated
-      updateParams = ChannelParamsNeedsUpdate (channelParams, condition);
+      updateParams = ChannelParamsNeedsUpdate (channelParams, condition, horizon);
     }
   else
     {
@@ -1138,7 +1366,13 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       //shuffle all the arrays to perform random coupling
       //Step 9: Generate the cross polarization power ratios
       //Step 10: Draw initial phases
-      channelParams = GenerateChannelParameters (condition, table3gpp, aMob, bMob);
+      uint32_t updateIndex = notFoundParams ? 0 : channelParams->m_updateIndex + 1;
+      channelParams = LoadChannelParams (condition, aMob, bMob, updateIndex);
+      if (!channelParams)
+        {
+          channelParams = GenerateChannelParameters (condition, table3gpp, aMob, bMob, updateIndex);
+          SaveChannelParams (channelParams, aMob->GetPosition (), bMob->GetPosition ());
+        }
       // store or replace the channel parameters
       m_channelParamsMap[channelParamsKey] = channelParams;
     }
@@ -1156,21 +1390,452 @@ ThreeGppChannelModel::GetChannel (Ptr<const MobilityModel> aMob,
       notFoundMatrix = true;
     }
 
-  // If the channel is not present in the map or if it has to be updated
-  // generate a new realization
+  params = channelParams;
+  table = table3gpp;
   if (notFoundMatrix || updateMatrix)
     {
-      // channel matrix not found or has to be updated, generate a new one
-      channelMatrix = GetNewChannel (channelParams, table3gpp, aMob, bMob, aAntenna, bAntenna);
-      channelMatrix->m_antennaPair = std::make_pair (aAntenna->GetId (), bAntenna->GetId ()); // save antenna pair, with the exact order of s and u antennas at the moment of the channel generation
+      return nullptr;
+    }
+  return channelMatrix;
+}
+
+void
+ThreeGppChannelModel::CheckChannelConditionModel ()
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<ThreeGppChannelConditionModel> threeGppCcm = DynamicCast<ThreeGppChannelConditionModel> (m_channelConditionModel);
+  if (threeGppCcm)
+    {
+      BooleanValue perLink;
+      threeGppCcm->GetAttribute ("PerLinkRandomStreams", perLink);
+      NS_ABORT_MSG_IF (!perLink.Get (), "PerLinkRandomStreams requires the attribute PerLinkRandomStreams of the "
+                       "ThreeGppChannelConditionModel, otherwise the channel conditions depend on the order of the links");
+    }
+  m_conditionModelChecked = true;
+}
+
+void
+ThreeGppChannelModel::StoreChannel (Ptr<ChannelMatrix> channelMatrix,
+                                    Ptr<const PhasedArrayModel> aAntenna,
+                                    Ptr<const PhasedArrayModel> bAntenna)
+{
+  NS_LOG_FUNCTION (this);
+  channelMatrix->m_antennaPair = std::make_pair (aAntenna->GetId (), bAntenna->GetId ()); // save antenna pair, with the exact order of s and u antennas at the moment of the channel generation
+
+  // store or replace the channel matrix in the channel map
+  m_channelMatrixMap[GetKey (aAntenna->GetId (), bAntenna->GetId ())] = channelMatrix;
+}
+
+void
+ThreeGppChannelModel::GenerateChannels (const std::vector<ChannelLink> &links, Time horizon)
+{
+  NS_LOG_FUNCTION (this << links.size () << horizon);
+
+  // the channel params of the links to update are generated in the calling
+  // thread, in the order of the links, since they use the random variables
+  std::vector<ChannelJob> jobs;
+  std::set<uint64_t> channelMatrixKeys;
+  for (const ChannelLink &link : links)
+    {
+      uint64_t channelMatrixKey = GetKey (link.m_aAntenna->GetId (), link.m_bAntenna->GetId ());
+      if (!channelMatrixKeys.insert (channelMatrixKey).second)
+        {
+          // already in this batch
+          continue;
+        }
+
+      ChannelJob job;
+      job.m_link = &link;
+      if (LookupChannel (link.m_aMob, link.m_bMob, link.m_aAntenna, link.m_bAntenna, job.m_params, job.m_table, horizon))
+        {
+          // the channel matrix is valid
+          continue;
+        }
+      if (LoadChannel (job.m_params, link.m_aMob, link.m_bMob, link.m_aAntenna, link.m_bAntenna))
+        {
+          continue;
+        }
+      job.m_sPosition = link.m_aMob->GetPosition ();
+      job.m_uPosition = link.m_bMob->GetPosition ();
+      job.m_nodeIds = std::make_pair (link.m_aMob->GetObject<Node> ()->GetId (), link.m_bMob->GetObject<Node> ()->GetId ());
+      jobs.push_back (job);
+    }
+  NS_LOG_DEBUG ("generate " << jobs.size () << " channel matrices for " << links.size () << " links");
+  m_batchChannels += jobs.size ();
+
+  // the channel coefficients do not use the random variables, thus they
+  // are computed by the workers. The workers use only the data in the jobs
+  // and do not copy the Ptrs, whose reference count is not thread safe.
+  Time now = Simulator::Now ();
+  std::atomic<std::size_t> nextJob {0};
+  auto worker = [this, &jobs, &nextJob, now] ()
+    {
+      for (std::size_t i = nextJob++; i < jobs.size (); i = nextJob++)
+        {
+          ChannelJob &job = jobs[i];
+          job.m_channel = ComputeChannelMatrix (*job.m_params, *job.m_table, job.m_nodeIds,
+                                                job.m_sPosition, job.m_uPosition,
+                                                *job.m_link->m_aAntenna, *job.m_link->m_bAntenna, now);
+        }
+    };
+
+  uint32_t numThreads = std::max<uint32_t> (1, std::min<std::size_t> (m_numThreads, jobs.size ()));
+  std::vector<std::thread> threads;
+  for (uint32_t t = 1; t < numThreads; t++)
+    {
+      threads.emplace_back (worker);
+    }
+  worker ();
+  for (std::thread &thread : threads)
+    {
+      thread.join ();
+    }
+
+  for (ChannelJob &job : jobs)
+    {
+      StoreChannel (job.m_channel, job.m_link->m_aAntenna, job.m_link->m_bAntenna);
+      SaveChannel (job.m_channel, job.m_params, job.m_sPosition, job.m_uPosition, job.m_link->m_aAntenna, job.m_link->m_bAntenna);
+    }
+}
+
+uint64_t
+ThreeGppChannelModel::GetNumBatchChannels () const
+{
+  return m_batchChannels;
+}
+
+uint64_t
+ThreeGppChannelModel::GetNumCacheHits () const
+{
+  return m_cacheHits;
+}
+
+uint64_t
+ThreeGppChannelModel::GetNumCacheMisses () const
+{
+  return m_cacheMisses;
+}
+
+Ptr<ThreeGppChannelCache>
+ThreeGppChannelModel::GetCache ()
+{
+  if (m_cacheFile.empty ())
+    {
+      return nullptr;
+    }
+  if (!m_cache)
+    {
+      NS_ABORT_MSG_IF (!m_perLinkRandomStreams, "The channel cache requires PerLinkRandomStreams, "
+                       "otherwise the channels depend on the order of the links");
+      m_cache = Create<ThreeGppChannelCache> (m_cacheFile);
+
+      // the key of the configuration of the model
+      m_cacheConfigKey = CounterRandomStream::CombineKey (RngSeedManager::GetSeed (), RngSeedManager::GetRun ());
+      m_cacheConfigKey = CounterRandomStream::CombineKey (m_cacheConfigKey, GetStreamKey ());
+      m_cacheConfigKey = CounterRandomStream::CombineKey (m_cacheConfigKey, GetConfigKey ());
+    }
+  return m_cache;
+}
+
+uint64_t
+ThreeGppChannelModel::GetAntennaKey (const PhasedArrayModel &antenna)
+{
+  uint64_t key = CounterRandomStream::CombineKey (0, antenna.GetNumberOfElements ());
+  std::vector<double> values;
+  for (uint64_t i = 0; i < antenna.GetNumberOfElements (); i++)
+    {
+      Vector loc = antenna.GetElementLocation (i);
+      values.insert (values.end (), {loc.x, loc.y, loc.z});
+    }
+  // the field pattern in a few directions accounts for the type and the
+  // orientation of the elements
+  for (double azimuth : {0.0, 1.0, 2.5, -2.0})
+    {
+      for (double inclination : {0.3, 1.5, 2.8})
+        {
+          std::pair<double, double> field = antenna.GetElementFieldPattern (Angles (azimuth, inclination));
+          values.insert (values.end (), {field.first, field.second});
+        }
+    }
+  for (double value : values)
+    {
+      uint64_t bits;
+      std::memcpy (&bits, &value, sizeof (bits));
+      key = CounterRandomStream::CombineKey (key, bits);
+    }
+  return key;
+}
+
+Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
+ThreeGppChannelModel::LoadChannelParams (Ptr<const ChannelCondition> condition,
+                                         Ptr<const MobilityModel> aMob,
+                                         Ptr<const MobilityModel> bMob,
+                                         uint32_t updateIndex)
+{
+  NS_LOG_FUNCTION (this << updateIndex);
+  Ptr<ThreeGppChannelCache> cache = GetCache ();
+  if (!cache)
+    {
+      return nullptr;
+    }
+
+  uint32_t aId = aMob->GetObject<Node> ()->GetId ();
+  uint32_t bId = bMob->GetObject<Node> ()->GetId ();
+  uint64_t key = CounterRandomStream::CombineKey (m_cacheConfigKey, GetKey (aId, bId));
+  key = CounterRandomStream::CombineKey (key, updateIndex);
+
+  ThreeGppChannelCache::Payload payload;
+  if (!cache->Find (CHANNEL_PARAMS_RECORD, key, payload))
+    {
+      m_cacheMisses++;
+      return nullptr;
+    }
+
+  // validate the record: the nodes, their positions, the channel condition
+  // and the generation time must be the same
+  ChannelCacheReader reader (payload);
+  Ptr<ThreeGppChannelParams> params = Create<ThreeGppChannelParams> ();
+  Vector firstPos, secondPos;
+  int64_t generatedTime = 0;
+  reader.Read (params->m_nodeIds);
+  reader.Read (firstPos);
+  reader.Read (secondPos);
+  reader.Read (generatedTime);
+  reader.Read (params->m_updateIndex);
+  reader.Read (params->m_losCondition);
+  reader.Read (params->m_o2iCondition);
+  bool sameDirection = params->m_nodeIds == std::make_pair (aId, bId);
+  bool valid = (sameDirection || params->m_nodeIds == std::make_pair (bId, aId))
+    && firstPos == (sameDirection ? aMob : bMob)->GetPosition ()
+    && secondPos == (sameDirection ? bMob : aMob)->GetPosition ()
+    && generatedTime == Simulator::Now ().GetTimeStep ()
+    && params->m_updateIndex == updateIndex
+    && params->m_losCondition == condition->GetLosCondition ()
+    && params->m_o2iCondition == condition->GetO2iCondition ();
+
+  reader.Read (params->m_delay);
+  reader.Read (params->m_angle);
+  reader.Read (params->m_alpha);
+  reader.Read (params->m_D);
+  reader.Read (params->m_nonSelfBlocking);
+  reader.Read (params->m_preLocUT);
+  reader.Read (params->m_locUT);
+  reader.Read (params->m_norRvAngles);
+  reader.Read (params->m_DS);
+  reader.Read (params->m_K_factor);
+  reader.Read (params->m_reducedClusterNumber);
+  reader.Read (params->m_rayAodRadian);
+  reader.Read (params->m_rayAoaRadian);
+  reader.Read (params->m_rayZodRadian);
+  reader.Read (params->m_rayZoaRadian);
+  reader.Read (params->m_clusterPhase);
+  reader.Read (params->m_crossPolarizationPowerRatios);
+  reader.Read (params->m_speed);
+  reader.Read (params->m_dis2D);
+  reader.Read (params->m_dis3D);
+  reader.Read (params->m_clusterPower);
+  reader.Read (params->m_attenuation_dB);
+  reader.Read (params->m_cluster1st);
+  reader.Read (params->m_cluster2nd);
+  if (!valid || !reader.IsComplete ())
+    {
+      NS_LOG_DEBUG ("invalid channel params in the cache");
+      m_cacheMisses++;
+      return nullptr;
+    }
+  params->m_generatedTime = Simulator::Now ();
+
+  m_cacheHits++;
+  return params;
+}
 
-      // store or replace the channel matrix in the channel map
-      m_channelMatrixMap[channelMatrixKey] = channelMatrix;
+void
+ThreeGppChannelModel::SaveChannelParams (Ptr<const ThreeGppChannelParams> params,
+                                         const Vector &aPosition,
+                                         const Vector &bPosition)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<ThreeGppChannelCache> cache = GetCache ();
+  if (!cache)
+    {
+      return;
+    }
+
+  uint64_t key = CounterRandomStream::CombineKey (m_cacheConfigKey, GetKey (params->m_nodeIds.first, params->m_nodeIds.second));
+  key = CounterRandomStream::CombineKey (key, params->m_updateIndex);
+
+  ChannelCacheWriter writer;
+  writer.Write (params->m_nodeIds);
+  writer.Write (aPosition);
+  writer.Write (bPosition);
+  writer.Write (params->m_generatedTime.GetTimeStep ());
+  writer.Write (params->m_updateIndex);
+  writer.Write (params->m_losCondition);
+  writer.Write (params->m_o2iCondition);
+  writer.Write (params->m_delay);
+  writer.Write (params->m_angle);
+  writer.Write (params->m_alpha);
+  writer.Write (params->m_D);
+  writer.Write (params->m_nonSelfBlocking);
+  writer.Write (params->m_preLocUT);
+  writer.Write (params->m_locUT);
+  writer.Write (params->m_norRvAngles);
+  writer.Write (params->m_DS);
+  writer.Write (params->m_K_factor);
+  writer.Write (params->m_reducedClusterNumber);
+  writer.Write (params->m_rayAodRadian);
+  writer.Write (params->m_rayAoaRadian);
+  writer.Write (params->m_rayZodRadian);
+  writer.Write (params->m_rayZoaRadian);
+  writer.Write (params->m_clusterPhase);
+  writer.Write (params->m_crossPolarizationPowerRatios);
+  writer.Write (params->m_speed);
+  writer.Write (params->m_dis2D);
+  writer.Write (params->m_dis3D);
+  writer.Write (params->m_clusterPower);
+  writer.Write (params->m_attenuation_dB);
+  writer.Write (params->m_cluster1st);
+  writer.Write (params->m_cluster2nd);
+  cache->Add (CHANNEL_PARAMS_RECORD, key, writer.GetBuffer ());
+}
+
+uint64_t
+ThreeGppChannelModel::GetCacheChannelKey (Ptr<const ThreeGppChannelParams> channelParams,
+                                          uint64_t aAntennaKey,
+                                          uint64_t bAntennaKey) const
+{
+  // the channel matrix depends on the configuration of the antennas, and
+  // not on their IDs, which depend on the order in which they are created
+  uint64_t key = CounterRandomStream::CombineKey (m_cacheConfigKey, GetKey (channelParams->m_nodeIds.first, channelParams->m_nodeIds.second));
+  key = CounterRandomStream::CombineKey (key, channelParams->m_updateIndex);
+  key = CounterRandomStream::CombineKey (key, std::min (aAntennaKey, bAntennaKey));
+  return CounterRandomStream::CombineKey (key, std::max (aAntennaKey, bAntennaKey));
+}
+
+Ptr<MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::LoadChannel (Ptr<const ThreeGppChannelParams> channelParams,
+                                   Ptr<const MobilityModel> aMob,
+                                   Ptr<const MobilityModel> bMob,
+                                   Ptr<const PhasedArrayModel> aAntenna,
+                                   Ptr<const PhasedArrayModel> bAntenna)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<ThreeGppChannelCache> cache = GetCache ();
+  if (!cache)
+    {
+      return nullptr;
+    }
+
+  uint64_t aAntennaKey = GetAntennaKey (*aAntenna);
+  uint64_t bAntennaKey = GetAntennaKey (*bAntenna);
+  ThreeGppChannelCache::Payload payload;
+  if (!cache->Find (CHANNEL_MATRIX_RECORD, GetCacheChannelKey (channelParams, aAntennaKey, bAntennaKey), payload))
+    {
+      m_cacheMisses++;
+      return nullptr;
     }
 
+  // validate the record: the nodes, their positions, the antennas, the
+  // channel params and the generation time must be the same
+  ChannelCacheReader reader (payload);
+  Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix> ();
+  Vector sPos, uPos;
+  int64_t generatedTime = 0;
+  uint32_t paramsUpdateIndex = 0;
+  uint64_t sAntennaKey = 0;
+  uint64_t uAntennaKey = 0;
+  uint64_t numRows = 0;
+  uint64_t numCols = 0;
+  uint64_t numPages = 0;
+  reader.Read (channelMatrix->m_nodeIds);
+  reader.Read (sPos);
+  reader.Read (uPos);
+  reader.Read (generatedTime);
+  reader.Read (paramsUpdateIndex);
+  reader.Read (sAntennaKey);
+  reader.Read (uAntennaKey);
+  reader.Read (numRows);
+  reader.Read (numCols);
+  reader.Read (numPages);
+
+  uint32_t aId = aMob->GetObject<Node> ()->GetId ();
+  uint32_t bId = bMob->GetObject<Node> ()->GetId ();
+  bool sameDirection = channelMatrix->m_nodeIds == std::make_pair (aId, bId);
+  Ptr<const MobilityModel> sMob = sameDirection ? aMob : bMob;
+  Ptr<const MobilityModel> uMob = sameDirection ? bMob : aMob;
+  Ptr<const PhasedArrayModel> sAntenna = sameDirection ? aAntenna : bAntenna;
+  Ptr<const PhasedArrayModel> uAntenna = sameDirection ? bAntenna : aAntenna;
+  bool valid = (sameDirection || channelMatrix->m_nodeIds == std::make_pair (bId, aId))
+    && sPos == sMob->GetPosition ()
+    && uPos == uMob->GetPosition ()
+    && generatedTime == Simulator::Now ().GetTimeStep ()
+    && paramsUpdateIndex == channelParams->m_updateIndex
+    && sAntennaKey == (sameDirection ? aAntennaKey : bAntennaKey)
+    && uAntennaKey == (sameDirection ? bAntennaKey : aAntennaKey)
+    && numRows == uAntenna->GetNumberOfElements ()
+    && numCols == sAntenna->GetNumberOfElements ();
+
+  PhasedArrayModel::ComplexVector values;
+  reader.Read (values);
+  if (!valid || !reader.IsComplete () || values.size () != numRows * numCols * numPages)
+    {
+      NS_LOG_DEBUG ("invalid channel matrix in the cache");
+      m_cacheMisses++;
+      return nullptr;
+    }
+  channelMatrix->m_channel = Complex3DVector (numRows, numCols, numPages);
+  for (uint64_t n = 0; n < numPages; n++)
+    {
+      for (uint64_t s = 0; s < numCols; s++)
+        {
+          for (uint64_t u = 0; u < numRows; u++)
+            {
+              channelMatrix->m_channel (u, s, n) = values[(n * numCols + s) * numRows + u];
+            }
+        }
+    }
+  channelMatrix->m_generatedTime = Simulator::Now ();
+
+  // store the channel matrix in the channel map, with the direction of the record
+  StoreChannel (channelMatrix, sAntenna, uAntenna);
+  m_cacheHits++;
   return channelMatrix;
 }
 
+void
+ThreeGppChannelModel::SaveChannel (Ptr<const ChannelMatrix> channelMatrix,
+                                   Ptr<const ThreeGppChannelParams> channelParams,
+                                   const Vector &sPosition,
+                                   const Vector &uPosition,
+                                   Ptr<const PhasedArrayModel> sAntenna,
+                                   Ptr<const PhasedArrayModel> uAntenna)
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<ThreeGppChannelCache> cache = GetCache ();
+  if (!cache)
+    {
+      return;
+    }
+
+  uint64_t sAntennaKey = GetAntennaKey (*sAntenna);
+  uint64_t uAntennaKey = GetAntennaKey (*uAntenna);
+
+  const Complex3DVector &hUsn = channelMatrix->m_channel;
+  ChannelCacheWriter writer;
+  writer.Write (channelMatrix->m_nodeIds);
+  writer.Write (sPosition);
+  writer.Write (uPosition);
+  writer.Write (channelMatrix->m_generatedTime.GetTimeStep ());
+  writer.Write (channelParams->m_updateIndex);
+  writer.Write (sAntennaKey);
+  writer.Write (uAntennaKey);
+  writer.Write<uint64_t> (hUsn.GetNumRows ());
+  writer.Write<uint64_t> (hUsn.GetNumCols ());
+  writer.Write<uint64_t> (hUsn.GetNumPages ());
+  writer.Write (hUsn.GetValues ());
+  cache->Add (CHANNEL_MATRIX_RECORD, GetCacheChannelKey (channelParams, sAntennaKey, uAntennaKey), writer.GetBuffer ());
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelParams>
 ThreeGppChannelModel::GetParams (Ptr<const MobilityModel> aMob,
                                  Ptr<const MobilityModel> bMob) const
@@ -1196,14 +1861,18 @@ Ptr<ThreeGppChannelModel::ThreeGppChannelParams>
 ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelCondition> channelCondition,
                                                  const Ptr<const ParamsTable> table3gpp,
                                                  const Ptr<const MobilityModel> aMob,
-                                                 const Ptr<const MobilityModel> bMob) const
+                                                 const Ptr<const MobilityModel> bMob,
+                                                 uint32_t updateIndex) const
 {
 
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << updateIndex);
   // create a channel matrix instance
   Ptr<ThreeGppChannelParams> channelParams = Create<ThreeGppChannelParams> ();
   channelParams->m_generatedTime = Simulator::Now ();
   channelParams->m_nodeIds = std::make_pair (aMob->GetObject<Node> ()->GetId (), bMob->GetObject<Node> ()->GetId ());
+  channelParams->m_updateIndex = updateIndex;
+  ParamsRandomVariables rv = m_perLinkRandomStreams ? ParamsRandomVariables (this, channelParams->m_nodeIds, updateIndex)
+                                                    : ParamsRandomVariables (this);
   channelParams->m_losCondition = channelCondition->GetLosCondition ();
   channelParams->m_o2iCondition = channelCondition->GetO2iCondition ();
 
@@ -1218,7 +1887,7 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
   //Generate paramNum independent LSPs.
   for (uint8_t iter = 0; iter < paramNum; iter++)
     {
-      LSPsIndep.push_back (m_normalRv->GetValue ());
+      LSPsIndep.push_back (rv.GetNormal ());
     }
   for (uint8_t row = 0; row < paramNum; row++)
     {
@@ -1267,7 +1936,7 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
   double minTau = 100.0;
   for (uint8_t cIndex = 0; cIndex < table3gpp->m_numOfCluster; cIndex++)
     {
-      double tau = -1 * table3gpp->m_rTau * DS * log (m_uniformRv->GetValue (0, 1)); //(7.5-1)
+      double tau = -1 * table3gpp->m_rTau * DS * log (rv.GetUniform (0, 1)); //(7.5-1)
       if (minTau > tau)
         {
           minTau = tau;
@@ -1290,7 +1959,7 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
   for (uint8_t cIndex = 0; cIndex < table3gpp->m_numOfCluster; cIndex++)
     {
       double power = exp (-1 * clusterDelay[cIndex] * (table3gpp->m_rTau - 1) / table3gpp->m_rTau / DS) *
-        pow (10, -1 * m_normalRv->GetValue () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
+        pow (10, -1 * rv.GetNormal () * table3gpp->m_perClusterShadowingStd / 10);                       //(7.5-5)
       powerSum += power;
       clusterPower.push_back (power);
     }
@@ -1464,21 +2133,21 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
   for (uint8_t cIndex = 0; cIndex < channelParams->m_reducedClusterNumber; cIndex++)
     {
       int Xn = 1;
-      if (m_uniformRv->GetValue (0, 1) < 0.5)
+      if (rv.GetUniform (0, 1) < 0.5)
         {
           Xn = -1;
         }
-      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (m_normalRv->GetValue () * ASA / 7) + RadiansToDegrees (uAngle.GetAzimuth ());        //(7.5-11)
-      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (m_normalRv->GetValue () * ASD / 7) + RadiansToDegrees (sAngle.GetAzimuth ());
+      clusterAoa[cIndex] = clusterAoa[cIndex] * Xn + (rv.GetNormal () * ASA / 7) + RadiansToDegrees (uAngle.GetAzimuth ());        //(7.5-11)
+      clusterAod[cIndex] = clusterAod[cIndex] * Xn + (rv.GetNormal () * ASD / 7) + RadiansToDegrees (sAngle.GetAzimuth ());
       if (channelCondition->IsO2i ())
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + 90;            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.GetNormal () * ZSA / 7) + 90;            //(7.5-16)
         }
       else
         {
-          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (m_normalRv->GetValue () * ZSA / 7) + RadiansToDegrees (uAngle.GetInclination ());            //(7.5-16)
+          clusterZoa[cIndex] = clusterZoa[cIndex] * Xn + (rv.GetNormal () * ZSA / 7) + RadiansToDegrees (uAngle.GetInclination ());            //(7.5-16)
         }
-      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (m_normalRv->GetValue () * ZSD / 7) + RadiansToDegrees (sAngle.GetInclination ()) + table3gpp->m_offsetZOD;        //(7.5-19)
+      clusterZod[cIndex] = clusterZod[cIndex] * Xn + (rv.GetNormal () * ZSD / 7) + RadiansToDegrees (sAngle.GetInclination ()) + table3gpp->m_offsetZOD;        //(7.5-19)
     }
 
   if (channelParams->m_losCondition == ChannelCondition::LOS)
@@ -1562,7 +2231,7 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
   DoubleVector attenuationDb;
   if (m_blockage)
     {
-      attenuationDb = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa);
+      attenuationDb = CalcAttenuationOfBlockage (channelParams, clusterAoa, clusterZoa, rv);
       for (uint8_t cInd = 0; cInd < channelParams->m_reducedClusterNumber; cInd++)
         {
           channelParams->m_clusterPower[cInd] = channelParams->m_clusterPower[cInd] / pow (10,attenuationDb[cInd] / 10);
@@ -1599,10 +2268,10 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
 
   for (uint8_t cIndex = 0; cIndex < channelParams->m_reducedClusterNumber; cIndex++)
     {
-      Shuffle (&rayAodRadian[cIndex][0], &rayAodRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayAoaRadian[cIndex][0], &rayAoaRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayZodRadian[cIndex][0], &rayZodRadian[cIndex][table3gpp->m_raysPerCluster]);
-      Shuffle (&rayZoaRadian[cIndex][0], &rayZoaRadian[cIndex][table3gpp->m_raysPerCluster]);
+      Shuffle (&rayAodRadian[cIndex][0], &rayAodRadian[cIndex][table3gpp->m_raysPerCluster], rv);
+      Shuffle (&rayAoaRadian[cIndex][0], &rayAoaRadian[cIndex][table3gpp->m_raysPerCluster], rv);
+      Shuffle (&rayZodRadian[cIndex][0], &rayZodRadian[cIndex][table3gpp->m_raysPerCluster], rv);
+      Shuffle (&rayZoaRadian[cIndex][0], &rayZoaRadian[cIndex][table3gpp->m_raysPerCluster], rv);
     }
 
   // store values
@@ -1624,11 +2293,11 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
           double uXprLinear = pow (10, table3gpp->m_uXpr / 10); // convert to linear
           double sigXprLinear = pow (10, table3gpp->m_sigXpr / 10); // convert to linear
 
-          temp.push_back (std::pow (10, (m_normalRv->GetValue () * sigXprLinear + uXprLinear) / 10));
+          temp.push_back (std::pow (10, (rv.GetNormal () * sigXprLinear + uXprLinear) / 10));
           DoubleVector temp3; // used to store the PHI valuse
           for (uint8_t pInd = 0; pInd < 4; pInd++)
             {
-              temp3.push_back (m_uniformRv->GetValue (-1 * M_PI, M_PI));
+              temp3.push_back (rv.GetUniform (-1 * M_PI, M_PI));
             }
           temp2.push_back (temp3);
         }
@@ -1752,8 +2421,8 @@ ThreeGppChannelModel::GenerateChannelParameters (const Ptr<const ChannelConditio
       double D = 0;
       if (cIndex != 0)
       {
-        alpha = m_uniformRvDoppler->GetValue (-1, 1);
-        D = m_uniformRvDoppler->GetValue (-m_vScatt, m_vScatt);
+        alpha = rv.GetDopplerUniform (-1, 1);
+        D = rv.GetDopplerUniform (-m_vScatt, m_vScatt);
       }
       dopplerTermAlpha.push_back (alpha);
       dopplerTermD.push_back (D);
@@ -1775,15 +2444,31 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
 {
   NS_LOG_FUNCTION (this);
 
+  return ComputeChannelMatrix (*channelParams, *table3gpp,
+                               std::make_pair (sMob->GetObject<Node> ()->GetId (), uMob->GetObject<Node> ()->GetId ()),
+                               sMob->GetPosition (), uMob->GetPosition (),
+                               *sAntenna, *uAntenna, Simulator::Now ());
+}
+
+Ptr<MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModel::ComputeChannelMatrix (const ThreeGppChannelParams &channelParams,
+                                            const ParamsTable &table3gpp,
+                                            std::pair<uint32_t, uint32_t> nodeIds,
+                                            const Vector &sPosition,
+                                            const Vector &uPosition,
+                                            const PhasedArrayModel &sAntenna,
+                                            const PhasedArrayModel &uAntenna,
+                                            Time now) const
+{
   NS_ASSERT_MSG (m_frequency > 0.0, "Set the operating frequency first!");
 
   // create a channel matrix instance
   Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix> ();
-  channelMatrix->m_generatedTime = Simulator::Now ();
+  channelMatrix->m_generatedTime = now;
   // save in which order is generated this matrix
-  channelMatrix->m_nodeIds = std::make_pair (sMob->GetObject<Node> ()->GetId (), uMob->GetObject<Node> ()->GetId ());
+  channelMatrix->m_nodeIds = nodeIds;
   // check if channelParams structure is generated in direction s-to-u or u-to-s
-  bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
+  bool isSameDirection = (channelParams.m_nodeIds == channelMatrix->m_nodeIds);
 
   MatrixBasedChannelModel::Double2DVector rayAodRadian;
   MatrixBasedChannelModel::Double2DVector rayAoaRadian;
@@ -1796,87 +2481,83 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
   // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
   if (isSameDirection)
     {
-      rayAodRadian = channelParams->m_rayAodRadian;
-      rayAoaRadian = channelParams->m_rayAoaRadian;
-      rayZodRadian = channelParams->m_rayZodRadian;
-      rayZoaRadian = channelParams->m_rayZoaRadian;
+      rayAodRadian = channelParams.m_rayAodRadian;
+      rayAoaRadian = channelParams.m_rayAoaRadian;
+      rayZodRadian = channelParams.m_rayZodRadian;
+      rayZoaRadian = channelParams.m_rayZoaRadian;
     }
   else
     {
-      rayAodRadian = channelParams->m_rayAoaRadian;
-      rayAoaRadian = channelParams->m_rayAodRadian;
-      rayZodRadian = channelParams->m_rayZoaRadian;
-      rayZoaRadian = channelParams->m_rayZodRadian;
+      rayAodRadian = channelParams.m_rayAoaRadian;
+      rayAoaRadian = channelParams.m_rayAodRadian;
+      rayZodRadian = channelParams.m_rayZoaRadian;
+      rayZoaRadian = channelParams.m_rayZodRadian;
     }
 
   //Step 11: Generate channel coefficients for each cluster n and each receiver
   // and transmitter element pair u,s.
-  Complex3DVector hUsn;  //channel coffecient hUsn[u][s][n];
-  // where u and s are receive and transmit antenna element, n is cluster index.
+  // channel coffecient hUsn (u, s, n), where u and s are receive and transmit
+  // antenna element, n is cluster index.
   // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
-  // the total cluster will be numReducedCLuster + 4.
-  uint64_t uSize = uAntenna->GetNumberOfElements ();
-  uint64_t sSize = sAntenna->GetNumberOfElements ();
-
-  hUsn.resize (uSize);
-  for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
-    {
-      hUsn[uIndex].resize (sSize);
-      for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
-        {
-          hUsn[uIndex][sIndex].resize (channelParams->m_reducedClusterNumber);
-        }
-    }
-
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= channelParams->m_crossPolarizationPowerRatios.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayZodRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAoaRadian.size ());
-  NS_ASSERT (channelParams->m_reducedClusterNumber <= rayAodRadian.size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_clusterPhase[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= channelParams->m_crossPolarizationPowerRatios[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayZodRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAoaRadian[0].size ());
-  NS_ASSERT (table3gpp->m_raysPerCluster <= rayAodRadian[0].size ());
-
-
-  double x = sMob->GetPosition ().x - uMob->GetPosition ().x;
-  double y = sMob->GetPosition ().y - uMob->GetPosition ().y;
+  // the total cluster will be numReducedCLuster + 4 (+ 2 if there is only one
+  // cluster). The 2 additional sub-clusters of each of the strongest
+  // clusters are stored after the numReducedCLuster clusters, in the order
+  // of the cluster index.
+  uint64_t uSize = uAntenna.GetNumberOfElements ();
+  uint64_t sSize = sAntenna.GetNumberOfElements ();
+  uint8_t numStrongClusters = (channelParams.m_cluster1st == channelParams.m_cluster2nd) ? 1 : 2;
+  Complex3DVector hUsn (uSize, sSize, channelParams.m_reducedClusterNumber + 2 * numStrongClusters);
+
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_clusterPhase.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_clusterPower.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= channelParams.m_crossPolarizationPowerRatios.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayZoaRadian.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayZodRadian.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayAoaRadian.size ());
+  NS_ASSERT (channelParams.m_reducedClusterNumber <= rayAodRadian.size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= channelParams.m_clusterPhase[0].size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= channelParams.m_crossPolarizationPowerRatios[0].size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayZoaRadian[0].size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayZodRadian[0].size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayAoaRadian[0].size ());
+  NS_ASSERT (table3gpp.m_raysPerCluster <= rayAodRadian[0].size ());
+
+
+  double x = sPosition.x - uPosition.x;
+  double y = sPosition.y - uPosition.y;
   double distance2D = sqrt (x * x + y * y);
   // NOTE we assume hUT = min (height(a), height(b)) and
   // hBS = max (height (a), height (b))
-  double hUt = std::min (sMob->GetPosition ().z, uMob->GetPosition ().z);
-  double hBs = std::max (sMob->GetPosition ().z, uMob->GetPosition ().z);
+  double hUt = std::min (sPosition.z, uPosition.z);
+  double hBs = std::max (sPosition.z, uPosition.z);
   // compute the 3D distance using eq. 7.4-1
   double distance3D = std::sqrt (distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
 
-  Angles sAngle (uMob->GetPosition (), sMob->GetPosition ());
-  Angles uAngle (sMob->GetPosition (), uMob->GetPosition ());
+  Angles sAngle (uPosition, sPosition);
+  Angles uAngle (sPosition, uPosition);
 
 
   // The following for loops computes the channel coefficients
   for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-      Vector uLoc = uAntenna->GetElementLocation (uIndex);
+      Vector uLoc = uAntenna.GetElementLocation (uIndex);
 
       for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-          Vector sLoc = sAntenna->GetElementLocation (sIndex);
+          Vector sLoc = sAntenna.GetElementLocation (sIndex);
+          uint64_t subClusterIndex = channelParams.m_reducedClusterNumber; // index of the next sub-cluster
 
-          for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+          for (uint8_t nIndex = 0; nIndex < channelParams.m_reducedClusterNumber; nIndex++)
             {
               //Compute the N-2 weakest cluster, assuming 0 slant angle and a
               //polarization slant angle configured in the array (7.5-22)
-              if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+              if (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd)
                 {
                   std::complex<double> rays (0,0);
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < table3gpp.m_raysPerCluster; mIndex++)
                     {
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+                      DoubleVector initialPhase = channelParams.m_clusterPhase[nIndex][mIndex];
+                      double k = channelParams.m_crossPolarizationPowerRatios[nIndex][mIndex];
                       //lambda_0 is accounted in the antenna spacing uLoc and sLoc.
                       double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
                                                        + sin (rayZoaRadian[nIndex][mIndex]) * sin (rayAoaRadian[nIndex][mIndex]) * uLoc.y
@@ -1888,8 +2569,8 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                       // NOTE Doppler is computed in the CalcBeamformingGain function and is simplified to only account for the center angle of each cluster.
 
                       double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAoaRadian[nIndex][mIndex], channelParams->m_rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (channelParams->m_rayAodRadian[nIndex][mIndex], channelParams->m_rayZodRadian[nIndex][mIndex]));
+                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAoaRadian[nIndex][mIndex], channelParams.m_rayZoaRadian[nIndex][mIndex]));
+                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (channelParams.m_rayAodRadian[nIndex][mIndex], channelParams.m_rayZodRadian[nIndex][mIndex]));
                       NS_ASSERT (4 <= initialPhase.size ());
                       rays += (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
                                std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * std::sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
@@ -1898,8 +2579,8 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                         * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
                         * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
                     }
-                  rays *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = rays;
+                  rays *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = rays;
                 }
               else  //(7.5-28)
                 {
@@ -1907,12 +2588,12 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                   std::complex<double> raysSub2 (0, 0);
                   std::complex<double> raysSub3 (0, 0);
 
-                  for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                  for (uint8_t mIndex = 0; mIndex < table3gpp.m_raysPerCluster; mIndex++)
                     {
-                      double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+                      double k = channelParams.m_crossPolarizationPowerRatios[nIndex][mIndex];
 
                       //ZML:Just remind me that the angle offsets for the 3 subclusters were not generated correctly.
-                      DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+                      DoubleVector initialPhase = channelParams.m_clusterPhase[nIndex][mIndex];
                       NS_ASSERT (4 <= initialPhase.size ());
 
                       double rxPhaseDiff = 2 * M_PI * (sin (rayZoaRadian[nIndex][mIndex]) * cos (rayAoaRadian[nIndex][mIndex]) * uLoc.x
@@ -1923,8 +2604,8 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                                                        + cos (rayZodRadian[nIndex][mIndex]) * sLoc.z);
 
                       double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+                      std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
+                      std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
 
                       std::complex<double> raySub = (std::complex<double> (cos (initialPhase[0]), sin (initialPhase[0])) * rxFieldPatternTheta * txFieldPatternTheta +
                                                      std::complex<double> (cos (initialPhase[1]), sin (initialPhase[1])) * sqrt (1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
@@ -1954,16 +2635,16 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                             break;
                         }
                     }
-                  raysSub1 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub2 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  raysSub3 *= sqrt (channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                  hUsn[uIndex][sIndex][nIndex] = raysSub1;
-                  hUsn[uIndex][sIndex].push_back (raysSub2);
-                  hUsn[uIndex][sIndex].push_back (raysSub3);
+                  raysSub1 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub2 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  raysSub3 *= sqrt (channelParams.m_clusterPower[nIndex] / table3gpp.m_raysPerCluster);
+                  hUsn (uIndex, sIndex, nIndex) = raysSub1;
+                  hUsn (uIndex, sIndex, subClusterIndex++) = raysSub2;
+                  hUsn (uIndex, sIndex, subClusterIndex++) = raysSub3;
                 }
             }
 
-          if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+          if (channelParams.m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
             {
               std::complex<double> ray (0, 0);
               double rxPhaseDiff = 2 * M_PI * (sin (uAngle.GetInclination ()) * cos (uAngle.GetAzimuth ()) * uLoc.x
@@ -1974,8 +2655,8 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                                                + cos (sAngle.GetInclination ()) * sLoc.z);
 
               double rxFieldPatternPhi, rxFieldPatternTheta, txFieldPatternPhi, txFieldPatternTheta;
-              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
-              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
+              std::tie (rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna.GetElementFieldPattern (Angles (uAngle.GetAzimuth (), uAngle.GetInclination ()));
+              std::tie (txFieldPatternPhi, txFieldPatternTheta) = sAntenna.GetElementFieldPattern (Angles (sAngle.GetAzimuth (), sAngle.GetInclination ()));
 
               double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
 
@@ -1984,31 +2665,31 @@ ThreeGppChannelModel::GetNewChannel (Ptr<const ThreeGppChannelParams> channelPar
                 * std::complex<double> (cos (rxPhaseDiff), sin (rxPhaseDiff))
                 * std::complex<double> (cos (txPhaseDiff), sin (txPhaseDiff));
 
-              double kLinear = pow (10, channelParams->m_K_factor / 10);
+              double kLinear = pow (10, channelParams.m_K_factor / 10);
               // the LOS path should be attenuated if blockage is enabled.
-              hUsn[uIndex][sIndex][0] = sqrt (1 / (kLinear + 1)) * hUsn[uIndex][sIndex][0] + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams->m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
-              double tempSize = hUsn[uIndex][sIndex].size ();
+              hUsn (uIndex, sIndex, 0) = sqrt (1 / (kLinear + 1)) * hUsn (uIndex, sIndex, 0) + sqrt (kLinear / (1 + kLinear)) * ray / pow (10, channelParams.m_attenuation_dB[0] / 10);           //(7.5-30) for tau = tau1
+              double tempSize = hUsn.GetNumPages ();
               for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
                 {
-                  hUsn[uIndex][sIndex][nIndex] *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
+                  hUsn (uIndex, sIndex, nIndex) *= sqrt (1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
                 }
             }
         }
     }
 
-  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna->GetId () << ", " << uAntenna->GetId ());
-  for (auto& i:hUsn)
+  NS_LOG_DEBUG ("Husn (sAntenna, uAntenna):" << sAntenna.GetId () << ", " << uAntenna.GetId ());
+  for (uint64_t uIndex = 0; uIndex < hUsn.GetNumRows (); uIndex++)
     {
-      for (auto& j:i)
+      for (uint64_t sIndex = 0; sIndex < hUsn.GetNumCols (); sIndex++)
         {
-          for (auto& k:j)
+          for (uint64_t nIndex = 0; nIndex < hUsn.GetNumPages (); nIndex++)
             {
-              NS_LOG_DEBUG (" " << k << ",");
+              NS_LOG_DEBUG (" " << hUsn (uIndex, sIndex, nIndex) << ",");
             }
         }
     }
-  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.size () << "][" << hUsn[0].size () << "][" << hUsn[0][0].size () << "]");
-  channelMatrix->m_channel = hUsn;
+  NS_LOG_INFO ("size of coefficient matrix =[" << hUsn.GetNumRows () << "][" << hUsn.GetNumCols () << "][" << hUsn.GetNumPages () << "]");
+  channelMatrix->m_channel = std::move (hUsn);
   return channelMatrix;
 }
 
@@ -2036,7 +2717,8 @@ ThreeGppChannelModel::WrapAngles (double azimuthRad, double inclinationRad)
 MatrixBasedChannelModel::DoubleVector
 ThreeGppChannelModel::CalcAttenuationOfBlockage (const Ptr<ThreeGppChannelModel::ThreeGppChannelParams> channelParams,
                                                  const DoubleVector &clusterAOA,
-                                                 const DoubleVector &clusterZOA) const
+                                                 const DoubleVector &clusterZOA,
+                                                 ParamsRandomVariables &rv) const
 {
   NS_LOG_FUNCTION (this);
 
@@ -2071,17 +2753,17 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (const Ptr<ThreeGppChannelModel:
         {
           //draw value from table 7.6.4.1-2 Blocking region parameters
           DoubleVector table;
-          table.push_back (m_normalRv->GetValue ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
+          table.push_back (rv.GetNormal ()); //phi_k: store the normal RV that will be mapped to uniform (0,360) later.
           if (m_scenario == "InH-OfficeMixed" || m_scenario == "InH-OfficeOpen")
             {
-              table.push_back (m_uniformRv->GetValue (15, 45)); //x_k
+              table.push_back (rv.GetUniform (15, 45)); //x_k
               table.push_back (90);  //Theta_k
-              table.push_back (m_uniformRv->GetValue (5, 15)); //y_k
+              table.push_back (rv.GetUniform (5, 15)); //y_k
               table.push_back (2);  //r
             }
           else
             {
-              table.push_back (m_uniformRv->GetValue (5, 15)); //x_k
+              table.push_back (rv.GetUniform (5, 15)); //x_k
               table.push_back (90);  //Theta_k
               table.push_back (5);  //y_k
               table.push_back (10);  //r
@@ -2144,7 +2826,7 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (const Ptr<ThreeGppChannelModel:
 
               //Generate a new correlated normal RV with the following formula
               channelParams->m_nonSelfBlocking[blockInd][PHI_INDEX] =
-                R * channelParams->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * m_normalRv->GetValue ();
+                R * channelParams->m_nonSelfBlocking[blockInd][PHI_INDEX] + sqrt (1 - R * R) * rv.GetNormal ();
             }
         }
 
@@ -2253,11 +2935,11 @@ ThreeGppChannelModel::CalcAttenuationOfBlockage (const Ptr<ThreeGppChannelModel:
 }
 
 void
-ThreeGppChannelModel::Shuffle (double * first, double * last) const
+ThreeGppChannelModel::Shuffle (double * first, double * last, ParamsRandomVariables &rv) const
 {
   for (auto i = (last - first) - 1; i > 0; --i)
     {
-      std::swap (first[i], first[m_uniformRvShuffle->GetInteger (0, i)]);
+      std::swap (first[i], first[rv.GetShuffleInteger (0, i)]);
     }
 }
 
@@ -2272,4 +2954,136 @@ ThreeGppChannelModel::AssignStreams (int64_t stream)
   return 4;
 }
 
+uint64_t
+ThreeGppChannelModel::GetStreamKey () const
+{
+  int64_t stream = m_normalRv->GetStream ();
+  if (stream != -1)
+    {
+      return stream;
+    }
+  // without AssignStreams, the streams of all the models are -1. The key is
+  // then the configuration of the model, which, unlike a number drawn from
+  // an automatic stream, does not depend on the random variables created
+  // before the model
+  return GetConfigKey ();
+}
+
+uint64_t
+ThreeGppChannelModel::GetConfigKey () const
+{
+  uint64_t key = 0;
+  for (char c : m_scenario)
+    {
+      key = CounterRandomStream::CombineKey (key, c);
+    }
+  for (double value : {m_frequency, m_vScatt, m_blockerSpeed})
+    {
+      uint64_t bits;
+      std::memcpy (&bits, &value, sizeof (bits));
+      key = CounterRandomStream::CombineKey (key, bits);
+    }
+  key = CounterRandomStream::CombineKey (key, m_blockage);
+  key = CounterRandomStream::CombineKey (key, m_numNonSelfBlocking);
+  return CounterRandomStream::CombineKey (key, m_portraitMode);
+}
+
+ThreeGppChannelModel::CounterRandomStream::CounterRandomStream (uint64_t key)
+  : m_key (key),
+    m_counter (0),
+    m_hasNormal (false),
+    m_normal (0.0)
+{
+}
+
+uint64_t
+ThreeGppChannelModel::CounterRandomStream::Mix (uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+uint64_t
+ThreeGppChannelModel::CounterRandomStream::CombineKey (uint64_t key, uint64_t value)
+{
+  return Mix (Mix (key + 0x9e3779b97f4a7c15ULL) ^ value);
+}
+
+double
+ThreeGppChannelModel::CounterRandomStream::GetValue ()
+{
+  // the counter is spaced by the golden ratio, as in SplitMix64
+  uint64_t word = Mix (m_key + (++m_counter) * 0x9e3779b97f4a7c15ULL);
+  // 53 random bits, centered in the interval to exclude 0 and 1
+  return ((word >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+double
+ThreeGppChannelModel::CounterRandomStream::GetNormal ()
+{
+  if (m_hasNormal)
+    {
+      m_hasNormal = false;
+      return m_normal;
+    }
+  // Box-Muller transform
+  double radius = std::sqrt (-2.0 * std::log (GetValue ()));
+  double angle = 2 * M_PI * GetValue ();
+  m_normal = radius * std::sin (angle);
+  m_hasNormal = true;
+  return radius * std::cos (angle);
+}
+
+ThreeGppChannelModel::ParamsRandomVariables::ParamsRandomVariables (const ThreeGppChannelModel *model)
+  : m_model (model),
+    m_perLink (false)
+{
+}
+
+ThreeGppChannelModel::ParamsRandomVariables::ParamsRandomVariables (const ThreeGppChannelModel *model,
+                                                                    std::pair<uint32_t, uint32_t> nodeIds,
+                                                                    uint32_t updateIndex)
+  : m_model (model),
+    m_perLink (true)
+{
+  // the key is reciprocal, as the key of m_channelParamsMap
+  uint64_t key = CounterRandomStream::CombineKey (RngSeedManager::GetSeed (), RngSeedManager::GetRun ());
+  key = CounterRandomStream::CombineKey (key, model->GetStreamKey ());
+  key = CounterRandomStream::CombineKey (key, GetKey (nodeIds.first, nodeIds.second));
+  key = CounterRandomStream::CombineKey (key, updateIndex);
+  m_normal = CounterRandomStream (CounterRandomStream::CombineKey (key, 0));
+  m_uniform = CounterRandomStream (CounterRandomStream::CombineKey (key, 1));
+  m_shuffle = CounterRandomStream (CounterRandomStream::CombineKey (key, 2));
+  m_doppler = CounterRandomStream (CounterRandomStream::CombineKey (key, 3));
+}
+
+double
+ThreeGppChannelModel::ParamsRandomVariables::GetNormal ()
+{
+  return m_perLink ? m_normal.GetNormal () : m_model->m_normalRv->GetValue ();
+}
+
+double
+ThreeGppChannelModel::ParamsRandomVariables::GetUniform (double min, double max)
+{
+  return m_perLink ? min + m_uniform.GetValue () * (max - min) : m_model->m_uniformRv->GetValue (min, max);
+}
+
+uint32_t
+ThreeGppChannelModel::ParamsRandomVariables::GetShuffleInteger (uint32_t min, uint32_t max)
+{
+  if (!m_perLink)
+    {
+      return m_model->m_uniformRvShuffle->GetInteger (min, max);
+    }
+  return min + static_cast<uint32_t> (m_shuffle.GetValue () * (max - min + 1));
+}
+
+double
+ThreeGppChannelModel::ParamsRandomVariables::GetDopplerUniform (double min, double max)
+{
+  return m_perLink ? min + m_doppler.GetValue () * (max - min) : m_model->m_uniformRvDoppler->GetValue (min, max);
+}
+
 }  // namespace ns3
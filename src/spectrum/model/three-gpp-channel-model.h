@@ -31,6 +31,7 @@
 #include <unordered_map>
 #include <ns3/channel-condition-model.h>
 #include <ns3/matrix-based-channel-model.h>
+#include <ns3/three-gpp-channel-cache.h>
 
 namespace ns3 {
 
@@ -130,6 +131,59 @@ public:
    */
   Ptr<const ChannelParams> GetParams (Ptr<const MobilityModel> aMob,
                                       Ptr<const MobilityModel> bMob) const override;
+
+  /**
+   * A link between the a and the b devices, as passed to GetChannel
+   */
+  struct ChannelLink
+  {
+    Ptr<const MobilityModel> m_aMob; //!< mobility model of the a device
+    Ptr<const MobilityModel> m_bMob; //!< mobility model of the b device
+    Ptr<const PhasedArrayModel> m_aAntenna; //!< antenna of the a device
+    Ptr<const PhasedArrayModel> m_bAntenna; //!< antenna of the b device
+  };
+
+  /**
+   * Generates the channel matrices of the links which are not in
+   * m_channelMatrixMap or have to be updated, so that the following calls
+   * to GetChannel for these links return the stored matrices.
+   *
+   * The channel params are looked up and generated in the calling thread,
+   * in the order of the links. The channel coefficients are then computed
+   * in parallel by the number of threads set by the attribute NumThreads,
+   * thus the result does not depend on the number of threads. If the
+   * attribute PerLinkRandomStreams is true, it does not depend on the order
+   * of the links either, and it is the same as calling GetChannel for each link.
+   * If both (a, b) and (b, a) are in the vector, only the first one is
+   * considered.
+   *
+   * The channels which expire before Now () + horizon are generated again
+   * as well, so that a caller which runs once per slot can update them
+   * before the transmissions of the slot look them up one at a time. With
+   * a positive horizon, they are updated up to horizon earlier than
+   * GetChannel would.
+   *
+   * \param links the links
+   * \param horizon the time ahead of now at which the expired channels are
+   *        generated again
+   */
+  void GenerateChannels (const std::vector<ChannelLink> &links, Time horizon = Seconds (0));
+
+  /**
+   * \return the number of channel matrices computed by GenerateChannels
+   */
+  uint64_t GetNumBatchChannels () const;
+
+  /**
+   * \return the number of channel params and matrices found in the cache
+   */
+  uint64_t GetNumCacheHits () const;
+
+  /**
+   * \return the number of channel params and matrices not found in the
+   * cache, or found with a different key
+   */
+  uint64_t GetNumCacheMisses () const;
   /**
    * \brief Assign a fixed random variable stream number to the random variables
    * used by this model.
@@ -155,12 +209,122 @@ protected:
    */
   static std::pair<double, double> WrapAngles (double azimuthRad, double inclinationRad);
 
+  /**
+   * Counter-based generator of random numbers. The n-th number of the
+   * sequence is a hash of the key and of n, thus the sequence depends only
+   * on the key, and not on the numbers drawn by other generators.
+   */
+  class CounterRandomStream
+  {
+  public:
+    /**
+     * Constructor
+     * \param key the key of the sequence
+     */
+    explicit CounterRandomStream (uint64_t key = 0);
+
+    /**
+     * \return a uniform random number in (0, 1)
+     */
+    double GetValue ();
+
+    /**
+     * \return a standard normal random number
+     */
+    double GetNormal ();
+
+    /**
+     * Combines a key with a value, to derive the key of a new sequence
+     * \param key the key
+     * \param value the value
+     * \return the combined key
+     */
+    static uint64_t CombineKey (uint64_t key, uint64_t value);
+
+  private:
+    /**
+     * The finalizer of SplitMix64, which maps a 64-bit word to a
+     * uniformly distributed 64-bit word
+     * \param x the word
+     * \return the mixed word
+     */
+    static uint64_t Mix (uint64_t x);
+
+    uint64_t m_key; //!< the key of the sequence
+    uint64_t m_counter; //!< the number of words drawn
+    bool m_hasNormal; //!< true if m_normal has not been returned yet
+    double m_normal; //!< second normal number generated by the Box-Muller transform
+  };
+
+  /**
+   * The random variables used to generate the channel params of a link.
+   * They are either the random variables of the model, shared by all the
+   * links, or counter-based streams keyed by the seed, the run, the stream
+   * assigned to the model, the pair of nodes and the number of times the
+   * channel params of the link have been updated.
+   */
+  class ParamsRandomVariables
+  {
+  public:
+    /**
+     * Uses the random variables of the model
+     * \param model the channel model
+     */
+    explicit ParamsRandomVariables (const ThreeGppChannelModel *model);
+
+    /**
+     * Uses the counter-based streams of a link
+     * \param model the channel model
+     * \param nodeIds the IDs of the nodes of the link, in any order
+     * \param updateIndex the number of previous updates of the channel params of the link
+     */
+    ParamsRandomVariables (const ThreeGppChannelModel *model,
+                           std::pair<uint32_t, uint32_t> nodeIds,
+                           uint32_t updateIndex);
+
+    /**
+     * \return a standard normal random number
+     */
+    double GetNormal ();
+
+    /**
+     * \param min the minimum value
+     * \param max the maximum value
+     * \return a uniform random number in [min, max)
+     */
+    double GetUniform (double min, double max);
+
+    /**
+     * \param min the minimum value
+     * \param max the maximum value
+     * \return a uniform random integer in [min, max], used to shuffle the rays
+     */
+    uint32_t GetShuffleInteger (uint32_t min, uint32_t max);
+
+    /**
+     * \param min the minimum value
+     * \param max the maximum value
+     * \return a uniform random number in [min, max), used for the additional
+     * Doppler contribution
+     */
+    double GetDopplerUniform (double min, double max);
+
+  private:
+    const ThreeGppChannelModel *m_model; //!< the channel model
+    bool m_perLink; //!< true if the counter-based streams are used
+    CounterRandomStream m_normal; //!< stream replacing m_normalRv
+    CounterRandomStream m_uniform; //!< stream replacing m_uniformRv
+    CounterRandomStream m_shuffle; //!< stream replacing m_uniformRvShuffle
+    CounterRandomStream m_doppler; //!< stream replacing m_uniformRvDoppler
+  };
+
   /**
    * \brief Shuffle the elements of a simple sequence container of type double
    * \param first Pointer to the first element among the elements to be shuffled
    * \param last Pointer to the last element among the elements to be shuffled
+   * \param rv the random variables of the link
    */
-  void Shuffle (double * first, double * last) const;
+  void Shuffle (double * first, double * last, ParamsRandomVariables &rv) const;
 
   /**
    * Extends the struct ChannelParams by including information that is used
@@ -193,6 +357,7 @@ protected:
     DoubleVector m_attenuation_dB; //!< vector that stores the attenuation of the blockage
     uint8_t m_cluster1st; //!< index of the first strongest cluster
     uint8_t m_cluster2nd; //!< index of the second strongest cluster
+    uint32_t m_updateIndex {0}; //!< number of previous updates of the channel params of this pair of nodes
 
   };
 
@@ -257,12 +422,14 @@ protected:
    * \param table3gpp the 3gpp parameters from the table
    * \param aMob the a node mobility model
    * \param bMob the b node mobility model
+   * \param updateIndex the number of previous updates of the channel params of the pair of nodes
    * \return ThreeGppChannelParams structure with all the channel parameters generated according 38.901 steps from 4 to 10.
    */
   Ptr<ThreeGppChannelParams> GenerateChannelParameters (const Ptr<const ChannelCondition> channelCondition,
                                                         const Ptr<const ParamsTable> table3gpp,
                                                         const Ptr<const MobilityModel> aMob,
-                                                        const Ptr<const MobilityModel> bMob) const;
+                                                        const Ptr<const MobilityModel> bMob,
+                                                        uint32_t updateIndex) const;
 
   /**
    * Compute the channel matrix between two nodes a and b, and their
@@ -288,20 +455,24 @@ protected:
    * \param channelParams the channel parameters structure
    * \param clusterAOA vector containing the azimuth angle of arrival for each cluster
    * \param clusterZOA vector containing the zenith angle of arrival for each cluster
+   * \param rv the random variables of the link
    * \return vector containing the power attenuation for each cluster
    */
   DoubleVector CalcAttenuationOfBlockage (const Ptr<ThreeGppChannelModel::ThreeGppChannelParams> channelParams,
                                           const DoubleVector &clusterAOA,
-                                          const DoubleVector &clusterZOA) const;
+                                          const DoubleVector &clusterZOA,
+                                          ParamsRandomVariables &rv) const;
 
   /**
    * Check if the channel params has to be updated
    * \param channelParams channel params
    * \param channelCondition the channel condition
+   * \param horizon the time ahead of now at which the coherence time is checked
    * \return true if the channel params has to be updated, false otherwise
    */
   bool ChannelParamsNeedsUpdate (Ptr<const ThreeGppChannelParams> channelParams,
-                                 Ptr<const ChannelCondition> channelCondition) const;
+                                 Ptr<const ChannelCondition> channelCondition,
+                                 Time horizon = Seconds (0)) const;
 
   /**
    * Check if the channel matrix has to be updated (it needs update when the channel params generation
@@ -312,6 +483,181 @@ protected:
    */
   bool ChannelMatrixNeedsUpdate (Ptr<const ThreeGppChannelParams> channelParams, Ptr<const ChannelMatrix> channelMatrix);
 
+  /**
+   * Looks for the channel matrix associated to the aMob and bMob pair in
+   * m_channelMatrixMap, as GetChannel, generating or updating the channel
+   * params if needed.
+   *
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \param [out] params the channel params of the pair of nodes
+   * \param [out] table the 3gpp parameters table of the link
+   * \param horizon the time ahead of now at which the coherence time is checked
+   * \return the channel matrix, or nullptr if a new channel matrix has to
+   * be generated
+   */
+  Ptr<ChannelMatrix> LookupChannel (Ptr<const MobilityModel> aMob,
+                                    Ptr<const MobilityModel> bMob,
+                                    Ptr<const PhasedArrayModel> aAntenna,
+                                    Ptr<const PhasedArrayModel> bAntenna,
+                                    Ptr<const ThreeGppChannelParams> &params,
+                                    Ptr<const ParamsTable> &table,
+                                    Time horizon = Seconds (0));
+
+  /**
+   * Aborts if PerLinkRandomStreams is true and the conditions of the
+   * channel condition model depend on the order of the links, i.e., if it
+   * is a ThreeGppChannelConditionModel whose attribute PerLinkRandomStreams
+   * is false. The other channel condition models do not draw the
+   * conditions from random variables.
+   */
+  void CheckChannelConditionModel ();
+
+  /**
+   * Stores a new channel matrix in m_channelMatrixMap
+   * \param channelMatrix the channel matrix
+   * \param sAntenna the antenna array of node s
+   * \param uAntenna the antenna array of node u
+   */
+  void StoreChannel (Ptr<ChannelMatrix> channelMatrix,
+                     Ptr<const PhasedArrayModel> sAntenna,
+                     Ptr<const PhasedArrayModel> uAntenna);
+
+  /**
+   * Computes the channel coefficients, as described in 3GPP TR 38.901.
+   * It does not use the random variables nor modify the model, and it
+   * does not copy the Ptrs passed by reference, thus it can be called by
+   * several threads at the same time.
+   *
+   * \param channelParams the channel parameters previously generated for the pair of nodes a and b
+   * \param table3gpp the 3gpp parameters table
+   * \param nodeIds the IDs of node s and of node u
+   * \param sPosition the position of node s
+   * \param uPosition the position of node u
+   * \param sAntenna the antenna array of node s
+   * \param uAntenna the antenna array of node u
+   * \param now the generation time of the channel matrix
+   * \return the channel realization
+   */
+  Ptr<ChannelMatrix> ComputeChannelMatrix (const ThreeGppChannelParams &channelParams,
+                                           const ParamsTable &table3gpp,
+                                           std::pair<uint32_t, uint32_t> nodeIds,
+                                           const Vector &sPosition,
+                                           const Vector &uPosition,
+                                           const PhasedArrayModel &sAntenna,
+                                           const PhasedArrayModel &uAntenna,
+                                           Time now) const;
+
+  /**
+   * \return the cache of the channel params and matrices, or nullptr if
+   * the cache is disabled
+   */
+  Ptr<ThreeGppChannelCache> GetCache ();
+
+  /**
+   * \param antenna the antenna array
+   * \return a hash of the configuration of the antenna array
+   */
+  static uint64_t GetAntennaKey (const PhasedArrayModel &antenna);
+
+  /**
+   * Get the part of the keys of the per-link streams and of the cache that
+   * distinguishes this model from the others. It is the stream assigned with
+   * AssignStreams or, if no stream was assigned, the key returned by
+   * GetConfigKey. Thus the models with the same configuration and without
+   * assigned streams draw the same channel params for the same pair of nodes.
+   *
+   * \return the key of the streams of the model
+   */
+  uint64_t GetStreamKey () const;
+
+  /**
+   * \return a hash of the attributes of the model that the channel params
+   * depend on
+   */
+  uint64_t GetConfigKey () const;
+
+  /**
+   * Looks for the channel params of the pair of nodes in the cache
+   * \param condition the channel condition
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param updateIndex the number of previous updates of the channel params of the pair of nodes
+   * \return the channel params, or nullptr if they are not in the cache
+   */
+  Ptr<ThreeGppChannelParams> LoadChannelParams (Ptr<const ChannelCondition> condition,
+                                                Ptr<const MobilityModel> aMob,
+                                                Ptr<const MobilityModel> bMob,
+                                                uint32_t updateIndex);
+
+  /**
+   * Adds the channel params of a pair of nodes to the cache
+   * \param params the channel params
+   * \param aPosition the position of the first node of params->m_nodeIds
+   * \param bPosition the position of the second node of params->m_nodeIds
+   */
+  void SaveChannelParams (Ptr<const ThreeGppChannelParams> params,
+                          const Vector &aPosition,
+                          const Vector &bPosition);
+
+  /**
+   * \param channelParams the channel params of the pair of nodes
+   * \param aAntennaKey the hash of the configuration of the antenna of the a device
+   * \param bAntennaKey the hash of the configuration of the antenna of the b device
+   * \return the key of the channel matrix in the cache
+   */
+  uint64_t GetCacheChannelKey (Ptr<const ThreeGppChannelParams> channelParams,
+                               uint64_t aAntennaKey,
+                               uint64_t bAntennaKey) const;
+
+  /**
+   * Looks for the channel matrix of the pair of antennas in the cache and,
+   * if found, stores it in m_channelMatrixMap
+   * \param channelParams the channel params of the pair of nodes
+   * \param aMob mobility model of the a device
+   * \param bMob mobility model of the b device
+   * \param aAntenna antenna of the a device
+   * \param bAntenna antenna of the b device
+   * \return the channel matrix, or nullptr if it is not in the cache
+   */
+  Ptr<ChannelMatrix> LoadChannel (Ptr<const ThreeGppChannelParams> channelParams,
+                                  Ptr<const MobilityModel> aMob,
+                                  Ptr<const MobilityModel> bMob,
+                                  Ptr<const PhasedArrayModel> aAntenna,
+                                  Ptr<const PhasedArrayModel> bAntenna);
+
+  /**
+   * Adds a channel matrix to the cache
+   * \param channelMatrix the channel matrix
+   * \param channelParams the channel params used to generate the matrix
+   * \param sPosition the position of node s
+   * \param uPosition the position of node u
+   * \param sAntenna the antenna array of node s
+   * \param uAntenna the antenna array of node u
+   */
+  void SaveChannel (Ptr<const ChannelMatrix> channelMatrix,
+                    Ptr<const ThreeGppChannelParams> channelParams,
+                    const Vector &sPosition,
+                    const Vector &uPosition,
+                    Ptr<const PhasedArrayModel> sAntenna,
+                    Ptr<const PhasedArrayModel> uAntenna);
+
+  /**
+   * A channel matrix to compute in GenerateChannels
+   */
+  struct ChannelJob
+  {
+    const ChannelLink *m_link; //!< the link
+    Ptr<const ThreeGppChannelParams> m_params; //!< the channel params of the link
+    Ptr<const ParamsTable> m_table; //!< the 3gpp parameters table of the link
+    std::pair<uint32_t, uint32_t> m_nodeIds; //!< the IDs of node s and of node u
+    Vector m_sPosition; //!< the position of node s
+    Vector m_uPosition; //!< the position of node u
+    Ptr<ChannelMatrix> m_channel; //!< the computed channel matrix
+  };
+
   std::unordered_map<uint64_t, Ptr<ChannelMatrix> > m_channelMatrixMap; //!< map containing the channel realizations per pair of PhasedAntennaArray instances, the key of this map is reciprocal uniquely identifies a pair of PhasedAntennaArrays
   std::unordered_map<uint64_t, Ptr<ThreeGppChannelParams> > m_channelParamsMap; //!< map containing the common channel parameters per pair of nodes, the key of this map is reciprocal and uniquely identifies a pair of nodes
   Time m_updatePeriod; //!< the channel update period
@@ -321,6 +667,15 @@ protected:
   Ptr<UniformRandomVariable> m_uniformRv; //!< uniform random variable
   Ptr<NormalRandomVariable> m_normalRv; //!< normal random variable
   Ptr<UniformRandomVariable> m_uniformRvShuffle; //!< uniform random variable used to shuffle array in GetNewChannel
+  uint32_t m_numThreads; //!< number of threads used by GenerateChannels
+  uint64_t m_batchChannels; //!< number of channel matrices computed by GenerateChannels
+  bool m_perLinkRandomStreams; //!< if true, the channel params of each link are generated with its own counter-based streams
+  bool m_conditionModelChecked; //!< true if the channel condition model was checked for PerLinkRandomStreams
+  std::string m_cacheFile; //!< the name of the cache file, empty if the cache is disabled
+  Ptr<ThreeGppChannelCache> m_cache; //!< the cache of the channel params and matrices
+  uint64_t m_cacheConfigKey; //!< hash of the configuration of the model, part of the keys of the cache
+  uint64_t m_cacheHits; //!< number of channel params and matrices found in the cache
+  uint64_t m_cacheMisses; //!< number of channel params and matrices not found in the cache
 
   // Variable used to compute the additional Doppler contribution for the delayed
   // (reflected) paths, as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3.
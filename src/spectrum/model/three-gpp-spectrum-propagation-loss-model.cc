@@ -52,6 +52,7 @@ void
 ThreeGppSpectrumPropagationLossModel::DoDispose ()
 {
   m_longTermMap.clear ();
+  m_clusterTermsMap.clear ();
   m_channelModel->Dispose ();
   m_channelModel = nullptr;
 }
@@ -115,27 +116,26 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm (Ptr<const MatrixBasedChannel
   uint16_t sAntenna = static_cast<uint16_t> (sW.size ());
   uint16_t uAntenna = static_cast<uint16_t> (uW.size ());
 
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  NS_ASSERT (uAntenna == params->m_channel.GetNumRows ());
+  NS_ASSERT (sAntenna == params->m_channel.GetNumCols ());
 
   NS_LOG_DEBUG ("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
   //store the long term part to reduce computation load
   //only the small scale fading needs to be updated if the large scale parameters and antenna weights remain unchanged.
   PhasedArrayModel::ComplexVector longTerm;
-  uint8_t numCluster = static_cast<uint8_t> (params->m_channel[0][0].size ());
-
-  NS_ASSERT (uAntenna == params->m_channel.size ());
-  NS_ASSERT (sAntenna == params->m_channel.at (0).size());
+  uint8_t numCluster = static_cast<uint8_t> (params->m_channel.GetNumPages ());
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
       std::complex<double> txSum (0, 0);
       for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
+          // the coefficients of the u antenna elements are contiguous
+          const std::complex<double> *hU = params->m_channel.GetColumnPtr (sIndex, cIndex);
           std::complex<double> rxSum (0, 0);
           for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
-              rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
+              rxSum = rxSum + uW[uIndex] * hU[uIndex];
             }
           txSum = txSum + sW[sIndex] * rxSum;
         }
@@ -156,14 +156,14 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue> (txPsd);
 
   //channel[rx][tx][cluster]
-  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel[0][0].size ());
+  uint8_t numCluster = static_cast<uint8_t> (channelMatrix->m_channel.GetNumPages ());
 
   // compute the doppler term
   // NOTE the update of Doppler is simplified by only taking the center angle of
   // each cluster in to consideration.
   double slotTime = Simulator::Now ().GetSeconds ();
   double factor = 2 * M_PI * slotTime * GetFrequency () / 3e8;
-  PhasedArrayModel::ComplexVector doppler;
+  PhasedArrayModel::ComplexVector longTermDoppler; // long term component of each cluster with the doppler term
 
   // The following asserts might seem paranoic, but it is important to
   // make sure that all the structures that are passed to this function
@@ -181,29 +181,16 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
   // check if channelParams structure is generated in direction s-to-u or u-to-s
   bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-  MatrixBasedChannelModel::DoubleVector zoa;
-  MatrixBasedChannelModel::DoubleVector zod;
-  MatrixBasedChannelModel::DoubleVector aoa;
-  MatrixBasedChannelModel::DoubleVector aod;
+  // retrieve the direction cosines of the clusters and the delay phases,
+  // which do not change until the channel params are updated
+  Ptr<const ClusterTerms> clusterTerms = GetClusterTerms (channelParams, tempPsd->GetSpectrumModel ());
+  NS_ASSERT (numCluster <= clusterTerms->m_arrivalDirection.size ());
 
   // if channel params is generated in the same direction in which we
   // generate the channel matrix, angles and zenit od departure and arrival are ok,
-  // just set them to corresponding variable that will be used for the generation
-  // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-  if (isSameDirection)
-    {
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-  else
-    {
-      zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-      zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-      aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-      aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
+  // otherwise we need to flip angles and zenits of departure and arrival
+  const std::vector<Vector> &uDirection = isSameDirection ? clusterTerms->m_arrivalDirection : clusterTerms->m_departureDirection;
+  const std::vector<Vector> &sDirection = isSameDirection ? clusterTerms->m_departureDirection : clusterTerms->m_arrivalDirection;
 
   for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
@@ -222,40 +209,99 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain (Ptr<SpectrumValue> tx
       double D = channelParams->m_D [cIndex];
 
       //cluster angle angle[direction][n], where direction = 0(aoa), 1(zoa).
-      double tempDoppler = factor * ((sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180) * uSpeed.x
-                                       + sin (zoa [cIndex] * M_PI / 180) * sin (aoa [cIndex] * M_PI / 180) * uSpeed.y
-                                       + cos (zoa [cIndex] * M_PI / 180) * uSpeed.z)
-                                       + (sin (zod [cIndex] * M_PI / 180) * cos (aod [cIndex] * M_PI / 180) * sSpeed.x
-                                       + sin (zod [cIndex] * M_PI / 180) * sin (aod [cIndex] * M_PI / 180) * sSpeed.y
-                                       + cos (zod [cIndex] * M_PI / 180) * sSpeed.z) + 2 * alpha * D);
-      doppler.push_back (std::complex<double> (cos (tempDoppler), sin (tempDoppler)));
+      double tempDoppler = factor * ((uDirection [cIndex].x * uSpeed.x
+                                       + uDirection [cIndex].y * uSpeed.y
+                                       + uDirection [cIndex].z * uSpeed.z)
+                                       + (sDirection [cIndex].x * sSpeed.x
+                                       + sDirection [cIndex].y * sSpeed.y
+                                       + sDirection [cIndex].z * sSpeed.z) + 2 * alpha * D);
+      longTermDoppler.push_back (longTerm[cIndex] * std::complex<double> (cos (tempDoppler), sin (tempDoppler)));
     }
 
-  NS_ASSERT (numCluster <= doppler.size());
+  NS_ASSERT (numCluster <= longTermDoppler.size());
 
-  // apply the doppler term and the propagation delay to the long term component
-  // to obtain the beamforming gain
-  auto vit = tempPsd->ValuesBegin (); // psd iterator
-  auto sbit = tempPsd->ConstBandsBegin (); // band iterator
-  while (vit != tempPsd->ValuesEnd ())
+  // apply the propagation delay to the long term component with the doppler
+  // term to obtain the beamforming gain
+  const PhasedArrayModel::ComplexVector &delayPhase = clusterTerms->m_delayPhase.find (tempPsd->GetSpectrumModelUid ())->second;
+  const size_t numDelays = delayPhase.size () / tempPsd->GetValuesN ();
+  NS_ASSERT (numCluster <= numDelays);
+  const std::complex<double> *bandPhase = delayPhase.data ();
+  for (auto vit = tempPsd->ValuesBegin (); vit != tempPsd->ValuesEnd (); vit++, bandPhase += numDelays)
     {
       if ((*vit) != 0.00)
         {
           std::complex<double> subsbandGain (0.0, 0.0);
-          double fsb = (*sbit).fc; // center frequency of the sub-band
           for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
-              double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-              subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] * std::complex<double> (cos (delay), sin (delay));
+              subsbandGain = subsbandGain + longTermDoppler[cIndex] * bandPhase[cIndex];
             }
           *vit = (*vit) * (norm (subsbandGain));
         }
-      vit++;
-      sbit++;
     }
   return tempPsd;
 }
 
+Ptr<const ThreeGppSpectrumPropagationLossModel::ClusterTerms>
+ThreeGppSpectrumPropagationLossModel::GetClusterTerms (Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                                       Ptr<const SpectrumModel> spectrumModel) const
+{
+  NS_LOG_FUNCTION (this);
+
+  // the key is unique for each node pair, as the one of the channel params
+  uint64_t clusterTermsId = MatrixBasedChannelModel::GetKey (channelParams->m_nodeIds.first, channelParams->m_nodeIds.second);
+
+  Ptr<ClusterTerms> clusterTerms;
+  auto it = m_clusterTermsMap.find (clusterTermsId);
+  if (it != m_clusterTermsMap.end ()
+      && it->second->m_params == channelParams
+      && it->second->m_generatedTime == channelParams->m_generatedTime)
+    {
+      clusterTerms = it->second;
+    }
+  else
+    {
+      NS_LOG_DEBUG ("compute the direction cosines of the clusters");
+      clusterTerms = Create<ClusterTerms> ();
+      clusterTerms->m_params = channelParams;
+      clusterTerms->m_generatedTime = channelParams->m_generatedTime;
+
+      const MatrixBasedChannelModel::DoubleVector &zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
+      const MatrixBasedChannelModel::DoubleVector &zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
+      const MatrixBasedChannelModel::DoubleVector &aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
+      const MatrixBasedChannelModel::DoubleVector &aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
+      size_t numCluster = std::min ({zoa.size (), zod.size (), aoa.size (), aod.size ()});
+      for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+          clusterTerms->m_arrivalDirection.push_back (Vector (sin (zoa [cIndex] * M_PI / 180) * cos (aoa [cIndex] * M_PI / 180),
+                                                              sin (zoa [cIndex] * M_PI / 180) * sin (aoa [cIndex] * M_PI / 180),
+                                                              cos (zoa [cIndex] * M_PI / 180)));
+          clusterTerms->m_departureDirection.push_back (Vector (sin (zod [cIndex] * M_PI / 180) * cos (aod [cIndex] * M_PI / 180),
+                                                                sin (zod [cIndex] * M_PI / 180) * sin (aod [cIndex] * M_PI / 180),
+                                                                cos (zod [cIndex] * M_PI / 180)));
+        }
+      m_clusterTermsMap[clusterTermsId] = clusterTerms;
+    }
+
+  if (clusterTerms->m_delayPhase.find (spectrumModel->GetUid ()) == clusterTerms->m_delayPhase.end ())
+    {
+      NS_LOG_DEBUG ("compute the delay phases for spectrum model " << spectrumModel->GetUid ());
+      const MatrixBasedChannelModel::DoubleVector &clusterDelay = channelParams->m_delay;
+      PhasedArrayModel::ComplexVector &delayPhase = clusterTerms->m_delayPhase[spectrumModel->GetUid ()];
+      delayPhase.reserve (spectrumModel->GetNumBands () * clusterDelay.size ());
+      for (auto sbit = spectrumModel->Begin (); sbit != spectrumModel->End (); sbit++)
+        {
+          double fsb = (*sbit).fc; // center frequency of the sub-band
+          for (size_t cIndex = 0; cIndex < clusterDelay.size (); cIndex++)
+            {
+              double delay = -2 * M_PI * fsb * (clusterDelay[cIndex]);
+              delayPhase.push_back (std::complex<double> (cos (delay), sin (delay)));
+            }
+        }
+    }
+
+  return clusterTerms;
+}
+
 PhasedArrayModel::ComplexVector
 ThreeGppSpectrumPropagationLossModel::GetLongTerm (Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
                                                    Ptr<const PhasedArrayModel> aPhasedArrayModel,
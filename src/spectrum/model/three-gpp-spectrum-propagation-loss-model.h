@@ -135,6 +135,21 @@ private:
     PhasedArrayModel::ComplexVector m_uW; //!< the beamforming vector for the node u used to compute the long term
   };
 
+  /**
+   * Data structure that stores, for a tx-rx pair, the terms of the beamforming
+   * gain that depend only on the channel parameters, i.e., the direction
+   * cosines of the cluster angles and the phase rotation due to the delay of
+   * each cluster in each sub-band
+   */
+  struct ClusterTerms : public SimpleRefCount<ClusterTerms>
+  {
+    Ptr<const MatrixBasedChannelModel::ChannelParams> m_params; //!< pointer to the channel params used to compute the terms
+    Time m_generatedTime; //!< generation time of the channel params used to compute the terms
+    std::vector<Vector> m_arrivalDirection; //!< direction cosines of the ZOA and AOA of each cluster
+    std::vector<Vector> m_departureDirection; //!< direction cosines of the ZOD and AOD of each cluster
+    std::map<SpectrumModelUid_t, PhasedArrayModel::ComplexVector> m_delayPhase; //!< for each spectrum model, the delay phase of each sub-band and cluster, with index band * numClusters + cluster
+  };
+
   /**
    * Get the operating frequency
    * \return the operating frequency in Hz
@@ -164,6 +179,18 @@ private:
                                                 const PhasedArrayModel::ComplexVector &sW,
                                                 const PhasedArrayModel::ComplexVector &uW) const;
 
+  /**
+   * Looks for the cluster terms of the channel params in m_clusterTermsMap.
+   * If not found or if the channel params have been updated, computes the
+   * direction cosines of the clusters. If the delay phases for the spectrum
+   * model of the PSD have not been computed yet, computes them.
+   * \param channelParams the channel params structure
+   * \param spectrumModel the spectrum model of the PSD
+   * \return the cluster terms
+   */
+  Ptr<const ClusterTerms> GetClusterTerms (Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
+                                           Ptr<const SpectrumModel> spectrumModel) const;
+
   /**
    * Computes the beamforming gain and applies it to the tx PSD
    * \param txPsd the tx PSD
@@ -181,6 +208,7 @@ private:
                                           const Vector &sSpeed, const Vector &uSpeed) const;
 
   mutable std::unordered_map < uint64_t, Ptr<const LongTerm> > m_longTermMap; //!< map containing the long term components
+  mutable std::unordered_map < uint64_t, Ptr<ClusterTerms> > m_clusterTermsMap; //!< map containing the cluster terms of each node pair
   Ptr<MatrixBasedChannelModel> m_channelModel; //!< the model to generate the channel matrix
 };
 } // namespace ns3
@@ -0,0 +1,222 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <ns3/test.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+#include <ns3/double.h>
+#include <ns3/net-device.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/spectrum-signal-parameters.h>
+#include <ns3/multi-model-spectrum-channel.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/propagation-loss-model.h>
+
+
+NS_LOG_COMPONENT_DEFINE ("MultiModelSpectrumChannelTest");
+
+using namespace ns3;
+
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief A SpectrumPhy that counts the signals it receives
+ */
+class CountingSpectrumPhy : public SpectrumPhy
+{
+public:
+  /**
+   * Constructor
+   * \param model the spectrum model of the receiver
+   * \param mobility the mobility model of the receiver
+   */
+  CountingSpectrumPhy (Ptr<const SpectrumModel> model, Ptr<MobilityModel> mobility)
+    : m_model (model),
+      m_mobility (mobility),
+      m_numRx (0)
+  {
+  }
+
+  // inherited from SpectrumPhy
+  virtual void SetDevice (Ptr<NetDevice> d)
+  {
+  }
+  virtual Ptr<NetDevice> GetDevice () const
+  {
+    return nullptr;
+  }
+  virtual void SetMobility (Ptr<MobilityModel> m)
+  {
+    m_mobility = m;
+  }
+  virtual Ptr<MobilityModel> GetMobility () const
+  {
+    return m_mobility;
+  }
+  virtual void SetChannel (Ptr<SpectrumChannel> c)
+  {
+  }
+  virtual Ptr<const SpectrumModel> GetRxSpectrumModel () const
+  {
+    return m_model;
+  }
+  virtual Ptr<Object> GetAntenna () const
+  {
+    return nullptr;
+  }
+  virtual void StartRx (Ptr<SpectrumSignalParameters> params)
+  {
+    m_numRx++;
+  }
+
+  /**
+   * \return the number of signals received
+   */
+  uint32_t GetNumRx (void) const
+  {
+    return m_numRx;
+  }
+
+private:
+  Ptr<const SpectrumModel> m_model; //!< the spectrum model
+  Ptr<MobilityModel> m_mobility;    //!< the mobility model
+  uint32_t m_numRx;                 //!< the number of signals received
+};
+
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Checks the receivers skipped by MultiModelSpectrumChannel because
+ * of the MaxRange and MaxLossDb attributes
+ *
+ * The receivers are at 10, 100 and 1000 m from the transmitter, with a
+ * Friis loss of about 67, 87 and 107 dB.
+ */
+class MultiModelSpectrumChannelCullingTestCase : public TestCase
+{
+public:
+  /**
+   * Constructor
+   * \param maxRange the MaxRange attribute
+   * \param maxLossDb the MaxLossDb attribute
+   * \param numRx the number of receivers reached by each transmission
+   * \param numCulledByRange the number of receivers skipped by range at each transmission
+   * \param numCulledByLoss the number of receivers skipped by loss at each transmission
+   */
+  MultiModelSpectrumChannelCullingTestCase (double maxRange, double maxLossDb, uint32_t numRx,
+                                            uint32_t numCulledByRange, uint32_t numCulledByLoss);
+
+private:
+  virtual void DoRun (void);
+
+  double m_maxRange;           //!< the MaxRange attribute
+  double m_maxLossDb;          //!< the MaxLossDb attribute
+  uint32_t m_numRx;            //!< the expected receivers reached by each transmission
+  uint32_t m_numCulledByRange; //!< the expected receivers skipped by range at each transmission
+  uint32_t m_numCulledByLoss;  //!< the expected receivers skipped by loss at each transmission
+};
+
+MultiModelSpectrumChannelCullingTestCase::MultiModelSpectrumChannelCullingTestCase (double maxRange, double maxLossDb,
+                                                                                  uint32_t numRx,
+                                                                                  uint32_t numCulledByRange,
+                                                                                  uint32_t numCulledByLoss)
+  : TestCase ("MaxRange " + std::to_string (maxRange) + " m, MaxLossDb " + std::to_string (maxLossDb) + " dB"),
+    m_maxRange (maxRange),
+    m_maxLossDb (maxLossDb),
+    m_numRx (numRx),
+    m_numCulledByRange (numCulledByRange),
+    m_numCulledByLoss (numCulledByLoss)
+{
+}
+
+void
+MultiModelSpectrumChannelCullingTestCase::DoRun (void)
+{
+  Ptr<SpectrumModel> model = Create<SpectrumModel> (std::vector<double> {5.15e9, 5.16e9});
+
+  Ptr<MultiModelSpectrumChannel> channel = CreateObject<MultiModelSpectrumChannel> ();
+  channel->SetAttribute ("MaxRange", DoubleValue (m_maxRange));
+  channel->SetAttribute ("MaxLossDb", DoubleValue (m_maxLossDb));
+  channel->AddPropagationLossModel (CreateObject<FriisPropagationLossModel> ());
+
+  Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<CountingSpectrumPhy> txPhy = Create<CountingSpectrumPhy> (model, txMobility);
+  std::vector<Ptr<CountingSpectrumPhy> > rxPhys;
+  for (double distance : {10.0, 100.0, 1000.0})
+    {
+      Ptr<MobilityModel> rxMobility = CreateObject<ConstantPositionMobilityModel> ();
+      rxMobility->SetPosition (Vector (distance, 0, 0));
+      rxPhys.push_back (Create<CountingSpectrumPhy> (model, rxMobility));
+      channel->AddRx (rxPhys.back ());
+    }
+
+  // the counters add up over the transmissions
+  for (uint32_t tx = 0; tx < 2; tx++)
+    {
+      Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters> ();
+      params->duration = MilliSeconds (1);
+      params->psd = Create<SpectrumValue> (model);
+      (*params->psd) = 1e-3;
+      params->txPhy = txPhy;
+      Simulator::Schedule (MilliSeconds (tx), &MultiModelSpectrumChannel::StartTx, channel, params);
+    }
+  Simulator::Run ();
+
+  uint32_t numRx = 0;
+  for (Ptr<CountingSpectrumPhy> rxPhy : rxPhys)
+    {
+      numRx += rxPhy->GetNumRx ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (numRx, 2 * m_numRx, "Wrong number of signals received");
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNumRxCulledByRange (), 2 * m_numCulledByRange, "Wrong number of receivers skipped by range");
+  NS_TEST_ASSERT_MSG_EQ (channel->GetNumRxCulledByLoss (), 2 * m_numCulledByLoss, "Wrong number of receivers skipped by loss");
+  // the receivers that are reached are the closest ones
+  for (uint32_t rx = 0; rx < rxPhys.size (); rx++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (rxPhys[rx]->GetNumRx (), (rx < m_numRx ? 2 : 0), "Wrong signals received by receiver " << rx);
+    }
+
+  Simulator::Destroy ();
+}
+
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief MultiModelSpectrumChannel test suite
+ */
+class MultiModelSpectrumChannelTestSuite : public TestSuite
+{
+public:
+  MultiModelSpectrumChannelTestSuite ();
+};
+
+MultiModelSpectrumChannelTestSuite::MultiModelSpectrumChannelTestSuite ()
+  : TestSuite ("multi-model-spectrum-channel", UNIT)
+{
+  const double noMaxRange = MultiModelSpectrumChannel::NO_MAX_RANGE;
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (noMaxRange, 1.0e9, 3, 0, 0), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (1.0e9, 1.0e9, 3, 0, 0), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (150, 1.0e9, 2, 1, 0), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (5, 1.0e9, 0, 3, 0), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (noMaxRange, 80, 1, 0, 2), TestCase::QUICK);
+  AddTestCase (new MultiModelSpectrumChannelCullingTestCase (150, 80, 1, 1, 1), TestCase::QUICK);
+}
+
+static MultiModelSpectrumChannelTestSuite g_multiModelSpectrumChannelTestSuite; //!< the test suite
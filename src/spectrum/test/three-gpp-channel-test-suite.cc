@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include "ns3/config.h"
 #include "ns3/double.h"
+#include "ns3/boolean.h"
 #include "ns3/uinteger.h"
 #include "ns3/string.h"
 #include "ns3/angles.h"
@@ -36,6 +37,8 @@
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 #include "ns3/wifi-spectrum-value-helper.h"
 #include "ns3/spectrum-signal-parameters.h"
+#include <algorithm>
+#include <cstdio>
 
 using namespace ns3;
 
@@ -98,7 +101,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   double channelNorm = 0;
-  uint8_t numTotClusters = channelMatrix->m_channel.at (0).at (0).size ();
+  uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages ();
   for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
   {
     double clusterNorm = 0;
@@ -106,7 +109,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm (Ptr<ThreeGppChannelModel> c
     {
       for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
       {
-        clusterNorm += std::pow (std::abs (channelMatrix->m_channel.at (uIndex).at (sIndex).at (cIndex)), 2);
+        clusterNorm += std::pow (std::abs (channelMatrix->m_channel (uIndex, sIndex, cIndex)), 2);
       }
     }
     channelNorm += clusterNorm;
@@ -168,8 +171,8 @@ ThreeGppChannelMatrixComputationTest::DoRun (void)
   Ptr<const ThreeGppChannelModel::ChannelMatrix> channelMatrix = channelModel->GetChannel (txMob, rxMob, txAntenna, rxAntenna);
 
   // check the channel matrix dimensions
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.at (0).size (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
-  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.size (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumCols (), txAntennaElements [0] * txAntennaElements [1], "The second dimension of H should be equal to the number of tx antenna elements");
+  NS_TEST_ASSERT_MSG_EQ (channelMatrix->m_channel.GetNumRows (), rxAntennaElements [0] * rxAntennaElements [1], "The first dimension of H should be equal to the number of rx antenna elements");
 
   // test if the channel matrix is correctly generated
   uint16_t numIt = 1000;
@@ -367,6 +370,405 @@ struct CheckLongTermUpdateParams
   Ptr<PhasedArrayModel> rxAntenna; //!< the antenna array of the rx device
 };
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for ThreeGppChannelModel::GenerateChannels. It checks that the
+ * channel matrices generated by a single thread and by several threads are
+ * the same, and that GetChannel returns the generated matrices.
+ */
+class ThreeGppGenerateChannelsTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppGenerateChannelsTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppGenerateChannelsTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Generates the channel matrices of the links between a base station and
+   * several UEs
+   * \param numThreads the number of threads used to compute the channel matrices
+   * \return the channel matrices of the links
+   */
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > GenerateChannels (uint32_t numThreads);
+};
+
+ThreeGppGenerateChannelsTest::ThreeGppGenerateChannelsTest ()
+  : TestCase ("Check the channel matrices generated in parallel by GenerateChannels")
+{
+}
+
+ThreeGppGenerateChannelsTest::~ThreeGppGenerateChannelsTest ()
+{
+}
+
+std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> >
+ThreeGppGenerateChannelsTest::GenerateChannels (uint32_t numThreads)
+{
+  const uint32_t numUes = 8;
+
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMa"));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  channelModel->SetAttribute ("NumThreads", UintegerValue (numThreads));
+  channelModel->AssignStreams (1);
+
+  NodeContainer nodes;
+  nodes.Create (numUes + 1);
+  std::vector<Ptr<MobilityModel> > mobs;
+  std::vector<Ptr<PhasedArrayModel> > antennas;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (i == 0 ? Vector (0.0, 0.0, 10.0) : Vector (20.0 * i, 10.0 * i, 1.6));
+      nodes.Get (i)->AggregateObject (mob);
+      mobs.push_back (mob);
+      antennas.push_back (CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (i == 0 ? 4 : 2),
+                                                                          "NumRows", UintegerValue (2),
+                                                                          "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ())));
+    }
+
+  std::vector<ThreeGppChannelModel::ChannelLink> links;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      links.push_back ({mobs[0], mobs[i], antennas[0], antennas[i]});
+    }
+  // the reverse of an existing link is not generated again
+  links.push_back ({mobs[1], mobs[0], antennas[1], antennas[0]});
+  channelModel->GenerateChannels (links);
+
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      Ptr<const ThreeGppChannelModel::ChannelMatrix> channel = channelModel->GetChannel (mobs[0], mobs[i], antennas[0], antennas[i]);
+      NS_TEST_EXPECT_MSG_EQ (channel->IsReverse (antennas[0]->GetId (), antennas[i]->GetId ()), false, "The link was generated in the wrong direction");
+      NS_TEST_EXPECT_MSG_EQ (channel->m_channel.GetNumRows (), antennas[i]->GetNumberOfElements (), "Wrong number of rows");
+      NS_TEST_EXPECT_MSG_EQ (channel->m_channel.GetNumCols (), antennas[0]->GetNumberOfElements (), "Wrong number of columns");
+      channels.push_back (channel);
+    }
+
+  // the channel matrices are still valid, thus they are not generated again
+  channelModel->GenerateChannels (links);
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (channelModel->GetChannel (mobs[i], mobs[0], antennas[i], antennas[0]), channels[i - 1], "The channel matrix has been generated again");
+    }
+
+  return channels;
+}
+
+void
+ThreeGppGenerateChannelsTest::DoRun (void)
+{
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > serial = GenerateChannels (1);
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > parallel = GenerateChannels (4);
+
+  NS_TEST_ASSERT_MSG_EQ (serial.size (), parallel.size (), "Different number of channel matrices");
+  for (size_t i = 0; i < serial.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (serial[i]->m_channel.GetNumPages (), parallel[i]->m_channel.GetNumPages (), "Different number of clusters");
+      NS_TEST_ASSERT_MSG_EQ ((serial[i]->m_channel.GetValues () == parallel[i]->m_channel.GetValues ()), true,
+                             "The channel matrices generated by one and by several threads differ");
+    }
+
+  Simulator::Destroy ();
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the attribute PerLinkRandomStreams of ThreeGppChannelModel.
+ * It checks that the channel of a link, including its LOS condition drawn by
+ * a ThreeGppUmiStreetCanyonChannelConditionModel, does not depend on the
+ * order in which the links are generated.
+ */
+class ThreeGppPerLinkRandomStreamsTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppPerLinkRandomStreamsTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppPerLinkRandomStreamsTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Generates the channel matrices of the links between a base station and
+   * several UEs, in the given order
+   * \param perLink the value of the attribute PerLinkRandomStreams
+   * \param order the order of the UEs
+   * \param stream the stream assigned to the channel model, or -1 to not assign streams
+   * \return the channel matrices of the links, indexed by UE
+   */
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > GetChannels (bool perLink, const std::vector<uint32_t> &order,
+                                                                            int64_t stream = 1);
+
+  std::vector<bool> m_los; //!< whether each link of the last GetChannels call is in LOS, indexed by UE
+};
+
+ThreeGppPerLinkRandomStreamsTest::ThreeGppPerLinkRandomStreamsTest ()
+  : TestCase ("Check that the per link random streams do not depend on the order of the links")
+{
+}
+
+ThreeGppPerLinkRandomStreamsTest::~ThreeGppPerLinkRandomStreamsTest ()
+{
+}
+
+std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> >
+ThreeGppPerLinkRandomStreamsTest::GetChannels (bool perLink, const std::vector<uint32_t> &order, int64_t stream)
+{
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMi-StreetCanyon"));
+  Ptr<ChannelConditionModel> conditionModel = CreateObjectWithAttributes<ThreeGppUmiStreetCanyonChannelConditionModel> (
+    "PerLinkRandomStreams", BooleanValue (perLink));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (conditionModel));
+  channelModel->SetAttribute ("PerLinkRandomStreams", BooleanValue (perLink));
+  if (stream != -1)
+    {
+      channelModel->AssignStreams (stream);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (order.size () + 1);
+  std::vector<Ptr<MobilityModel> > mobs;
+  std::vector<Ptr<PhasedArrayModel> > antennas;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (i == 0 ? Vector (0.0, 0.0, 10.0) : Vector (15.0 * i, -5.0 * i, 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+      mobs.push_back (mob);
+      antennas.push_back (CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (2),
+                                                                          "NumRows", UintegerValue (2),
+                                                                          "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ())));
+    }
+
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels (order.size ());
+  m_los.assign (order.size (), false);
+  for (uint32_t ue : order)
+    {
+      channels[ue] = channelModel->GetChannel (mobs[0], mobs[ue + 1], antennas[0], antennas[ue + 1]);
+      m_los[ue] = conditionModel->GetChannelCondition (mobs[0], mobs[ue + 1])->IsLos ();
+    }
+
+  // the streams are keyed by the node ids, so clear the node list before the
+  // next scenario is built
+  Simulator::Destroy ();
+  return channels;
+}
+
+void
+ThreeGppPerLinkRandomStreamsTest::DoRun (void)
+{
+  std::vector<uint32_t> order {0, 1, 2, 3, 4, 5};
+  std::vector<uint32_t> reverseOrder (order.rbegin (), order.rend ());
+  std::vector<uint32_t> shuffledOrder {3, 0, 5, 1, 4, 2};
+
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels = GetChannels (true, order);
+  std::vector<bool> los = m_los;
+  NS_TEST_ASSERT_MSG_EQ ((std::count (los.begin (), los.end (), true) > 0 && std::count (los.begin (), los.end (), false) > 0), true,
+                         "The scenario should have both LOS and NLOS links");
+  for (const std::vector<uint32_t> &otherOrder : {reverseOrder, shuffledOrder})
+    {
+      std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > otherChannels = GetChannels (true, otherOrder);
+      for (size_t i = 0; i < order.size (); i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (m_los[i], los[i], "The condition of link " << i << " depends on the order of the links");
+          NS_TEST_ASSERT_MSG_EQ ((channels[i]->m_channel.GetValues () == otherChannels[i]->m_channel.GetValues ()), true,
+                                 "The channel of link " << i << " depends on the order of the links");
+        }
+    }
+
+  // the shared streams give another realization to the first link generated
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > sharedChannels = GetChannels (false, order);
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > sharedReverseChannels = GetChannels (false, reverseOrder);
+  NS_TEST_ASSERT_MSG_EQ ((sharedChannels[0]->m_channel.GetValues () == sharedReverseChannels[0]->m_channel.GetValues ()), false,
+                         "The shared random streams should depend on the order of the links");
+
+  // the per link streams of two models with different streams differ
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > otherStreamChannels = GetChannels (true, order, 2);
+  NS_TEST_ASSERT_MSG_EQ ((channels[0]->m_channel.GetValues () == otherStreamChannels[0]->m_channel.GetValues ()), false,
+                         "Two models with different streams share the per link streams");
+
+  // without assigned streams, the per link streams are keyed by the
+  // configuration of the model, and not by the random variables created
+  // before the model
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > unassignedChannels = GetChannels (true, order, -1);
+  NS_TEST_ASSERT_MSG_EQ ((channels[0]->m_channel.GetValues () == unassignedChannels[0]->m_channel.GetValues ()), false,
+                         "A model without assigned streams shares the per link streams of stream 1");
+  Ptr<UniformRandomVariable> extraRv = CreateObject<UniformRandomVariable> ();
+  extraRv->GetValue ();
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > otherUnassignedChannels = GetChannels (true, order, -1);
+  for (size_t i = 0; i < order.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((unassignedChannels[i]->m_channel.GetValues () == otherUnassignedChannels[i]->m_channel.GetValues ()), true,
+                             "The per link streams without assigned streams depend on the random variables created before");
+    }
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the channel cache of ThreeGppChannelModel. It checks that
+ * a second run with the same configuration loads all the channel params and
+ * matrices from the cache, and that they are the same as in the first run,
+ * also without assigned streams and with other random variables created
+ * between the two runs.
+ */
+class ThreeGppChannelCacheTest : public TestCase
+{
+public:
+  /**
+   * Constructor
+   */
+  ThreeGppChannelCacheTest ();
+
+  /**
+   * Destructor
+   */
+  virtual ~ThreeGppChannelCacheTest ();
+
+private:
+  /**
+   * Build the test scenario
+   */
+  virtual void DoRun (void);
+
+  /**
+   * Generates the channel matrices of the links between a base station and
+   * several UEs, using the cache
+   * \param cacheFile the name of the cache file
+   * \param [out] hits the number of cache hits
+   * \param [out] misses the number of cache misses
+   * \param assignStreams whether streams are assigned to the channel model
+   * \return the channel matrices of the links
+   */
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > GetChannels (const std::string &cacheFile, uint64_t &hits, uint64_t &misses,
+                                                                            bool assignStreams = true);
+
+  /**
+   * Checks that the second of two runs finds all its channels in the cache
+   * \param cacheFile the name of the cache file, initially empty
+   * \param assignStreams whether streams are assigned to the channel model
+   */
+  void CheckCache (const std::string &cacheFile, bool assignStreams);
+};
+
+ThreeGppChannelCacheTest::ThreeGppChannelCacheTest ()
+  : TestCase ("Check the channel cache of ThreeGppChannelModel")
+{
+}
+
+ThreeGppChannelCacheTest::~ThreeGppChannelCacheTest ()
+{
+}
+
+std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> >
+ThreeGppChannelCacheTest::GetChannels (const std::string &cacheFile, uint64_t &hits, uint64_t &misses, bool assignStreams)
+{
+  const uint32_t numUes = 4;
+
+  Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel> ();
+  channelModel->SetAttribute ("Frequency", DoubleValue (28.0e9));
+  channelModel->SetAttribute ("Scenario", StringValue ("UMa"));
+  channelModel->SetAttribute ("ChannelConditionModel", PointerValue (CreateObject<AlwaysLosChannelConditionModel> ()));
+  channelModel->SetAttribute ("PerLinkRandomStreams", BooleanValue (true));
+  channelModel->SetAttribute ("CacheFile", StringValue (cacheFile));
+  if (assignStreams)
+    {
+      channelModel->AssignStreams (1);
+    }
+
+  NodeContainer nodes;
+  nodes.Create (numUes + 1);
+  std::vector<Ptr<MobilityModel> > mobs;
+  std::vector<Ptr<PhasedArrayModel> > antennas;
+  for (uint32_t i = 0; i < nodes.GetN (); i++)
+    {
+      Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel> ();
+      mob->SetPosition (i == 0 ? Vector (0.0, 0.0, 25.0) : Vector (30.0 * i, 20.0, 1.5));
+      nodes.Get (i)->AggregateObject (mob);
+      mobs.push_back (mob);
+      antennas.push_back (CreateObjectWithAttributes<UniformPlanarArray> ("NumColumns", UintegerValue (i == 0 ? 4 : 2),
+                                                                          "NumRows", UintegerValue (2),
+                                                                          "AntennaElement", PointerValue (CreateObject<IsotropicAntennaModel> ())));
+    }
+
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > channels;
+  for (uint32_t i = 1; i < nodes.GetN (); i++)
+    {
+      channels.push_back (channelModel->GetChannel (mobs[0], mobs[i], antennas[0], antennas[i]));
+    }
+  hits = channelModel->GetNumCacheHits ();
+  misses = channelModel->GetNumCacheMisses ();
+
+  // the new records are written to the file when the model is disposed
+  channelModel->Dispose ();
+  Simulator::Destroy ();
+  return channels;
+}
+
+void
+ThreeGppChannelCacheTest::CheckCache (const std::string &cacheFile, bool assignStreams)
+{
+  std::remove (cacheFile.c_str ());
+
+  uint64_t hits;
+  uint64_t misses;
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > generated = GetChannels (cacheFile, hits, misses, assignStreams);
+  NS_TEST_ASSERT_MSG_EQ (hits, 0, "The cache should be empty");
+  NS_TEST_ASSERT_MSG_EQ (misses, 2 * generated.size (), "The params and the matrix of each link should miss the cache");
+
+  // as in a parameter sweep, other objects may create random variables
+  // between the two runs
+  Ptr<UniformRandomVariable> extraRv = CreateObject<UniformRandomVariable> ();
+  extraRv->GetValue ();
+
+  std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix> > loaded = GetChannels (cacheFile, hits, misses, assignStreams);
+  NS_TEST_ASSERT_MSG_EQ (hits, 2 * loaded.size (), "The params and the matrix of each link should be in the cache");
+  NS_TEST_ASSERT_MSG_EQ (misses, 0, "No lookup should miss the cache");
+  for (size_t i = 0; i < generated.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ ((generated[i]->m_channel.GetValues () == loaded[i]->m_channel.GetValues ()), true,
+                             "The channel matrix loaded from the cache differs from the generated one");
+      NS_TEST_ASSERT_MSG_EQ ((generated[i]->m_nodeIds == loaded[i]->m_nodeIds), true, "Wrong direction of the loaded channel matrix");
+    }
+
+  std::remove (cacheFile.c_str ());
+}
+
+void
+ThreeGppChannelCacheTest::DoRun (void)
+{
+  std::string cacheFile = CreateTempDirFilename ("three-gpp-channel-cache.bin");
+  CheckCache (cacheFile, true);
+  CheckCache (cacheFile, false);
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -577,6 +979,9 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite ()
 {
   AddTestCase (new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
   AddTestCase (new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppGenerateChannelsTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppPerLinkRandomStreamsTest, TestCase::QUICK);
+  AddTestCase (new ThreeGppChannelCacheTest, TestCase::QUICK);
   AddTestCase (new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
 }
 
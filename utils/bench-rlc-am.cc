@@ -0,0 +1,241 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the transmitting side of LteRlcAm
+// for various occupancies of its transmission buffer. A transmitting and a
+// receiving RLC AM entity are connected back to back by an ideal MAC, which
+// gives a transmission opportunity to the transmitting entity every TTI, and
+// to the receiving entity whenever it has a STATUS PDU to send. The
+// transmission buffer is refilled after every TTI, to keep its occupancy
+// constant, and the transmission opportunities are smaller than the SDUs,
+// so that every PDU segments an SDU and gives the rest back to the buffer.
+// Sample usage:  ./ns3 run 'bench-rlc-am --ttis=100000 --occupancies=1000,10000,50000'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/nstime.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-sap.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// Ideal MAC delivering the PDUs of an RLC entity to its peer
+class BenchRlcAmMac : public LteMacSapProvider
+{
+public:
+  BenchRlcAmMac ()
+    : m_peer (0),
+      m_statusPduSize (0),
+      m_nPdus (0)
+  {
+  }
+
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    m_nPdus++;
+    LteMacSapUser::ReceivePduParameters rxParams;
+    rxParams.p = params.pdu;
+    rxParams.rnti = params.rnti;
+    rxParams.lcid = params.lcid;
+    Simulator::Schedule (MicroSeconds (1), &LteMacSapUser::ReceivePdu, m_peer, rxParams);
+  }
+
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+    m_statusPduSize = params.statusPduSize;
+  }
+
+  LteMacSapUser *m_peer;      ///< MAC SAP of the peer entity
+  uint16_t m_statusPduSize;   ///< size of the pending STATUS PDU
+  uint64_t m_nPdus;           ///< number of PDUs transmitted
+};
+
+/// PDCP counting the received SDUs
+class BenchRlcAmPdcp : public LteRlcSapUser
+{
+public:
+  BenchRlcAmPdcp ()
+    : m_nSdus (0)
+  {
+  }
+
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_nSdus++;
+  }
+
+  uint64_t m_nSdus;   ///< number of SDUs received
+};
+
+/// A transmitting and a receiving RLC AM entity, connected back to back
+class BenchRlcAm
+{
+public:
+  /**
+   * \param occupancy the number of SDUs kept in the transmission buffer
+   * \param sduSize the size of the SDUs
+   * \param pduSize the size of the transmission opportunities
+   */
+  BenchRlcAm (uint32_t occupancy, uint32_t sduSize, uint32_t pduSize)
+    : m_occupancy (occupancy),
+      m_sduSize (sduSize),
+      m_pduSize (pduSize)
+  {
+    m_tx = CreateObject<LteRlcAm> ();
+    m_rx = CreateObject<LteRlcAm> ();
+    Ptr<LteRlcAm> entities[2] = { m_tx, m_rx };
+    for (uint32_t i = 0; i < 2; i++)
+      {
+        entities[i]->SetRnti (1);
+        entities[i]->SetLcId (3);
+        entities[i]->SetLteRlcSapUser (&m_pdcp[i]);
+        entities[i]->SetLteMacSapProvider (&m_mac[i]);
+        m_mac[i].m_peer = entities[1 - i]->GetLteMacSapUser ();
+      }
+    Refill ();
+  }
+
+  ~BenchRlcAm ()
+  {
+    m_tx->Dispose ();
+    m_rx->Dispose ();
+  }
+
+  /**
+   * Run a TTI every microsecond, for the given number of TTIs
+   */
+  void Run (uint32_t ttis)
+  {
+    for (uint32_t i = 0; i < ttis; i++)
+      {
+        Simulator::Schedule (MicroSeconds (i), &BenchRlcAm::Tti, this);
+      }
+    Simulator::Stop (MicroSeconds (ttis));
+    Simulator::Run ();
+  }
+
+  uint64_t GetNPdus (void) const
+  {
+    return m_mac[0].m_nPdus;
+  }
+
+  uint64_t GetNSdus (void) const
+  {
+    return m_pdcp[1].m_nSdus;
+  }
+
+private:
+  void Tti (void)
+  {
+    LteMacSapUser::TxOpportunityParameters params;
+    params.bytes = m_pduSize;
+    params.layer = 0;
+    params.harqId = 0;
+    params.componentCarrierId = 0;
+    params.rnti = 1;
+    params.lcid = 3;
+    m_tx->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+    if (m_mac[1].m_statusPduSize > 0)
+      {
+        params.bytes = m_mac[1].m_statusPduSize;
+        m_mac[1].m_statusPduSize = 0;
+        m_rx->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+      }
+    Refill ();
+  }
+
+  void Refill (void)
+  {
+    while (m_tx->GetTxBufferSize () + m_sduSize <= uint64_t (m_occupancy) * m_sduSize)
+      {
+        LteRlcSapProvider::TransmitPdcpPduParameters params;
+        params.pdcpPdu = Create<Packet> (m_sduSize);
+        params.rnti = 1;
+        params.lcid = 3;
+        m_tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+      }
+  }
+
+  uint32_t m_occupancy;
+  uint32_t m_sduSize;
+  uint32_t m_pduSize;
+  Ptr<LteRlcAm> m_tx;
+  Ptr<LteRlcAm> m_rx;
+  BenchRlcAmMac m_mac[2];
+  BenchRlcAmPdcp m_pdcp[2];
+};
+
+int main (int argc, char *argv[])
+{
+  uint32_t ttis = 100000;
+  std::string occupancies = "100,1000,10000,50000";
+  uint32_t sduSize = 1500;
+  uint32_t pduSize = 1000;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the transmission buffer of LteRlcAm");
+  cmd.AddValue ("ttis", "number of TTIs per occupancy", ttis);
+  cmd.AddValue ("occupancies", "comma separated list of transmission buffer occupancies, in SDUs", occupancies);
+  cmd.AddValue ("sdu-size", "size of the SDUs, in bytes", sduSize);
+  cmd.AddValue ("pdu-size", "size of the transmission opportunities, in bytes", pduSize);
+  cmd.Parse (argc, argv);
+
+  // a STATUS PDU every TTI, so that the transmission window never stalls
+  Config::SetDefault ("ns3::LteRlcAm::StatusProhibitTimer", TimeValue (Seconds (0)));
+  Config::SetDefault ("ns3::LteRlcAm::MaxTxBufferSize", UintegerValue (0xffffffff));
+
+  std::cout << "Running bench-rlc-am with ttis=" << ttis << ", sdu-size=" << sduSize
+            << ", pdu-size=" << pduSize << std::endl;
+  std::cout << std::setw (10) << "occupancy" << std::setw (12) << "PDUs"
+            << std::setw (12) << "SDUs" << std::setw (10) << "ms"
+            << std::setw (14) << "PDUs/s" << std::endl;
+
+  std::istringstream list (occupancies);
+  std::string item;
+  while (std::getline (list, item, ','))
+    {
+      uint32_t occupancy = std::stoul (item);
+      uint64_t nPdus;
+      uint64_t nSdus;
+      uint64_t deltaMs;
+      {
+        BenchRlcAm bench (occupancy, sduSize, pduSize);
+        SystemWallClockMs time;
+        time.Start ();
+        bench.Run (ttis);
+        deltaMs = time.End ();
+        nPdus = bench.GetNPdus ();
+        nSdus = bench.GetNSdus ();
+      }
+      Simulator::Destroy ();
+      double ps = nPdus * 1000.0 / std::max<uint64_t> (deltaMs, 1);
+      std::cout << std::setw (10) << occupancy << std::setw (12) << nPdus
+                << std::setw (12) << nSdus << std::setw (10) << deltaMs
+                << std::setw (14) << ps << std::endl;
+    }
+
+  return 0;
+}
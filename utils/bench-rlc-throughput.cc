@@ -0,0 +1,299 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the segmentation and the reassembly
+// of the RLC entities used by the mmWave module, for a single bearer at a
+// high data rate. A transmitting and a receiving RLC entity (AM or low
+// latency UM) are connected back to back by an ideal MAC. Every TTI, the
+// PDCP offers the SDUs arrived at the given rate, and the MAC gives to the
+// transmitting entity a single transmission opportunity large enough to
+// carry them, so that every PDU concatenates many SDUs. The SDUs carry
+// actual bytes, as the IP packets given by the upper layers do. Besides the
+// end-to-end wall time, the program reports the time spent by the
+// transmitting entity in the transmission opportunities, i.e., building the
+// PDUs by segmentation and concatenation.
+// Sample usage:  ./ns3 run 'bench-rlc-throughput --rlc=am --rate=5Gbps --duration=100ms'
+
+#include "ns3/command-line.h"
+#include "ns3/config.h"
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/uinteger.h"
+#include "ns3/lte-mac-sap.h"
+#include "ns3/lte-rlc.h"
+#include "ns3/lte-rlc-am.h"
+#include "ns3/lte-rlc-um-lowlat.h"
+#include "ns3/lte-rlc-sap.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/// Ideal MAC delivering the PDUs of an RLC entity to its peer
+class BenchRlcThroughputMac : public LteMacSapProvider
+{
+public:
+  BenchRlcThroughputMac ()
+    : m_peer (0),
+      m_statusPduSize (0)
+  {
+  }
+
+  virtual void TransmitPdu (TransmitPduParameters params)
+  {
+    LteMacSapUser::ReceivePduParameters rxParams;
+    rxParams.p = params.pdu;
+    rxParams.rnti = params.rnti;
+    rxParams.lcid = params.lcid;
+    Simulator::Schedule (MicroSeconds (1), &LteMacSapUser::ReceivePdu, m_peer, rxParams);
+  }
+
+  virtual void ReportBufferStatus (ReportBufferStatusParameters params)
+  {
+    m_statusPduSize = params.statusPduSize;
+  }
+
+  LteMacSapUser *m_peer;      ///< MAC SAP of the peer entity
+  uint16_t m_statusPduSize;   ///< size of the pending STATUS PDU
+};
+
+/// PDCP counting the received SDUs and bytes
+class BenchRlcThroughputPdcp : public LteRlcSapUser
+{
+public:
+  BenchRlcThroughputPdcp ()
+    : m_nSdus (0),
+      m_nBytes (0)
+  {
+  }
+
+  virtual void ReceivePdcpPdu (Ptr<Packet> p)
+  {
+    m_nSdus++;
+    m_nBytes += p->GetSize ();
+  }
+
+  uint64_t m_nSdus;    ///< number of SDUs received
+  uint64_t m_nBytes;   ///< number of bytes received
+};
+
+/// A transmitting and a receiving RLC entity, connected back to back
+class BenchRlcThroughput
+{
+public:
+  /**
+   * \param rlcType the TypeId name of the RLC entities
+   * \param rate the rate at which the PDCP offers the SDUs
+   * \param tti the duration of a TTI
+   * \param sduSize the size of the SDUs
+   */
+  BenchRlcThroughput (std::string rlcType, DataRate rate, Time tti, uint32_t sduSize)
+    : m_tti (tti),
+      m_sduSize (sduSize),
+      m_credit (0),
+      m_nTxSdus (0),
+      m_txOpportunityTime (0),
+      m_payload (sduSize)
+  {
+    ObjectFactory factory;
+    factory.SetTypeId (rlcType);
+    m_tx = factory.Create<LteRlc> ();
+    m_rx = factory.Create<LteRlc> ();
+    Ptr<LteRlc> entities[2] = { m_tx, m_rx };
+    for (uint32_t i = 0; i < 2; i++)
+      {
+        entities[i]->SetRnti (1);
+        entities[i]->SetLcId (3);
+        entities[i]->SetLteRlcSapUser (&m_pdcp[i]);
+        entities[i]->SetLteMacSapProvider (&m_mac[i]);
+        m_mac[i].m_peer = entities[1 - i]->GetLteMacSapUser ();
+      }
+    for (uint32_t i = 0; i < sduSize; i++)
+      {
+        m_payload[i] = i;
+      }
+    m_bytesPerTti = rate.GetBitRate () * tti.GetSeconds () / 8;
+    // room for the RLC headers, i.e., about two bytes per SDU
+    m_grant = m_bytesPerTti + 2 * (m_bytesPerTti / sduSize + 2) + 16;
+  }
+
+  ~BenchRlcThroughput ()
+  {
+    m_tx->Dispose ();
+    m_rx->Dispose ();
+  }
+
+  /**
+   * Run TTIs for the given simulated duration
+   */
+  void Run (Time duration)
+  {
+    uint64_t ttis = duration.GetInteger () / m_tti.GetInteger ();
+    for (uint64_t i = 0; i < ttis; i++)
+      {
+        Simulator::Schedule (m_tti * i, &BenchRlcThroughput::Tti, this);
+      }
+    Simulator::Stop (m_tti * ttis);
+    Simulator::Run ();
+  }
+
+  uint64_t GetNTxSdus (void) const
+  {
+    return m_nTxSdus;
+  }
+
+  /**
+   * \returns the wall time spent in the transmission opportunities of the
+   * transmitting entity
+   */
+  std::chrono::steady_clock::duration GetTxOpportunityTime (void) const
+  {
+    return m_txOpportunityTime;
+  }
+
+  uint64_t GetNRxSdus (void) const
+  {
+    return m_pdcp[1].m_nSdus;
+  }
+
+  uint64_t GetNRxBytes (void) const
+  {
+    return m_pdcp[1].m_nBytes;
+  }
+
+private:
+  void Tti (void)
+  {
+    m_credit += m_bytesPerTti;
+    while (m_credit >= m_sduSize)
+      {
+        LteRlcSapProvider::TransmitPdcpPduParameters params;
+        params.pdcpPdu = Create<Packet> (m_payload.data (), m_sduSize);
+        params.rnti = 1;
+        params.lcid = 3;
+        m_tx->GetLteRlcSapProvider ()->TransmitPdcpPdu (params);
+        m_credit -= m_sduSize;
+        m_nTxSdus++;
+      }
+
+    LteMacSapUser::TxOpportunityParameters params;
+    params.bytes = m_grant;
+    params.layer = 0;
+    params.harqId = 0;
+    params.componentCarrierId = 0;
+    params.rnti = 1;
+    params.lcid = 3;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+    m_tx->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+    m_txOpportunityTime += std::chrono::steady_clock::now () - start;
+    if (m_mac[1].m_statusPduSize > 0)
+      {
+        params.bytes = m_mac[1].m_statusPduSize;
+        m_mac[1].m_statusPduSize = 0;
+        m_rx->GetLteMacSapUser ()->NotifyTxOpportunity (params);
+      }
+  }
+
+  Time m_tti;
+  uint32_t m_sduSize;
+  uint64_t m_bytesPerTti;
+  uint32_t m_grant;
+  uint64_t m_credit;
+  uint64_t m_nTxSdus;
+  std::chrono::steady_clock::duration m_txOpportunityTime;
+  std::vector<uint8_t> m_payload;
+  Ptr<LteRlc> m_tx;
+  Ptr<LteRlc> m_rx;
+  BenchRlcThroughputMac m_mac[2];
+  BenchRlcThroughputPdcp m_pdcp[2];
+};
+
+int main (int argc, char *argv[])
+{
+  std::string rlc = "am";
+  DataRate rate ("5Gbps");
+  Time tti = MicroSeconds (125);
+  Time duration = MilliSeconds (100);
+  uint32_t sduSize = 1400;
+
+  CommandLine cmd (__FILE__);
+  cmd.Usage ("Benchmark the throughput of a single RLC bearer");
+  cmd.AddValue ("rlc", "RLC entities, am or um-lowlat", rlc);
+  cmd.AddValue ("rate", "rate of the bearer", rate);
+  cmd.AddValue ("tti", "duration of a TTI", tti);
+  cmd.AddValue ("duration", "simulated duration", duration);
+  cmd.AddValue ("sdu-size", "size of the SDUs, in bytes", sduSize);
+  cmd.Parse (argc, argv);
+
+  std::string rlcType;
+  if (rlc == "am")
+    {
+      rlcType = "ns3::LteRlcAm";
+      // a STATUS PDU every TTI, so that the transmission window never stalls
+      Config::SetDefault ("ns3::LteRlcAm::StatusProhibitTimer", TimeValue (Seconds (0)));
+      Config::SetDefault ("ns3::LteRlcAm::MaxTxBufferSize", UintegerValue (0xffffffff));
+    }
+  else if (rlc == "um-lowlat")
+    {
+      rlcType = "ns3::LteRlcUmLowLat";
+      Config::SetDefault ("ns3::LteRlcUmLowLat::MaxTxBufferSize", UintegerValue (0xffffffff));
+    }
+  else
+    {
+      std::cerr << "Unknown RLC " << rlc << ", use am or um-lowlat" << std::endl;
+      return 1;
+    }
+
+  uint64_t nTxSdus;
+  uint64_t nRxSdus;
+  uint64_t nRxBytes;
+  uint64_t deltaMs;
+  double txOpportunityMs;
+  {
+    BenchRlcThroughput bench (rlcType, rate, tti, sduSize);
+    SystemWallClockMs time;
+    time.Start ();
+    bench.Run (duration);
+    deltaMs = time.End ();
+    nTxSdus = bench.GetNTxSdus ();
+    nRxSdus = bench.GetNRxSdus ();
+    nRxBytes = bench.GetNRxBytes ();
+    txOpportunityMs = std::chrono::duration<double, std::milli> (bench.GetTxOpportunityTime ()).count ();
+  }
+  Simulator::Destroy ();
+
+  double goodput = nRxBytes * 8 / duration.GetSeconds () / 1e9;
+  double speed = duration.GetSeconds () * 1000 / std::max<uint64_t> (deltaMs, 1);
+  std::cout << "Running bench-rlc-throughput with rlc=" << rlc << ", rate=" << rate
+            << ", tti=" << tti.As (Time::US) << ", duration=" << duration.As (Time::MS)
+            << ", sdu-size=" << sduSize << std::endl;
+  std::cout << std::setw (12) << "SDUs sent" << std::setw (14) << "SDUs received"
+            << std::setw (14) << "goodput Gb/s" << std::setw (10) << "ms"
+            << std::setw (16) << "sim s / wall s" << std::setw (12) << "tx opp. ms" << std::endl;
+  std::cout << std::setw (12) << nTxSdus << std::setw (14) << nRxSdus
+            << std::setw (14) << goodput << std::setw (10) << deltaMs
+            << std::setw (16) << speed << std::setw (12) << std::fixed << std::setprecision (1)
+            << txOpportunityMs << std::endl;
+
+  return 0;
+}
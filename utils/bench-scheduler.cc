@@ -19,8 +19,10 @@
  */
 
 #include <iomanip>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <vector>
 #include <string.h>
 
@@ -311,12 +313,133 @@ Run (ObjectFactory & factory, uint32_t pop, uint32_t total, uint32_t runs,
 }
 
 
+/** A scheduling operation recorded in a DES Metrics trace. */
+struct TraceRecord
+{
+  uint64_t now;   /**< Time step at which the event was scheduled. */
+  uint64_t ts;    /**< Time step of the event. */
+};
+
+/**
+ * Read the events of a trace written by DesMetrics.
+ *
+ * Each event is on a line of the form
+ * `["<send context>","<now>","<receive context>","<time stamp>"]`,
+ * in the order in which the events were scheduled.
+ *
+ * \param [in] filename The trace file name.
+ * \returns The records of the trace.
+ */
+std::vector<TraceRecord>
+ReadTrace (std::string filename)
+{
+  LOG ("  Event times:                  replayed from " << filename);
+  std::ifstream input (filename.c_str ());
+  if (!input)
+    {
+      NS_FATAL_ERROR ("Cannot open trace " << filename);
+    }
+  std::vector<TraceRecord> records;
+  std::string line;
+  while (std::getline (input, line))
+    {
+      std::size_t begin = line.find ("[\"");
+      if (begin == std::string::npos)
+        {
+          continue;
+        }
+      std::replace_if (line.begin (), line.end (),
+                       [] (char c) { return c == '[' || c == ']' || c == '"' || c == ','; },
+                       ' ');
+      std::istringstream fields (line);
+      int64_t sendCtx, recvCtx;
+      TraceRecord record;
+      if (fields >> sendCtx >> record.now >> recvCtx >> record.ts)
+        {
+          records.push_back (record);
+        }
+    }
+  LOG ("    Found " << records.size () << " events");
+  return records;
+}
+
+/**
+ * Replay a trace on a single scheduler type.
+ *
+ * The events are inserted in the order of the trace; before inserting an
+ * event, the events earlier than the time at which it was scheduled are
+ * removed, as the simulator would have done. The scheduler is used
+ * directly, without the simulator, so that only Insert() and RemoveNext()
+ * are timed.
+ *
+ * \param [in] factory Factory pre-configured to create the desired Scheduler.
+ * \param [in] records The trace.
+ * \param [in] runs The number of replications.
+ */
+void
+Replay (ObjectFactory & factory, const std::vector<TraceRecord> & records, uint32_t runs)
+{
+  std::string schedType = factory.GetTypeId ().GetName ();
+  LOG ("");
+  LOG (schedType);
+  LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (op/s)" <<
+       std::left                         << "Per (s/op)"
+       );
+
+  // prime, then replicate
+  for (uint32_t i = 0; i <= runs; i++)
+    {
+      Ptr<Scheduler> scheduler = factory.Create<Scheduler> ();
+      SystemWallClockMs time;
+      uint64_t ops = 0;
+      uint32_t uid = 0;
+      time.Start ();
+      for (const TraceRecord &record : records)
+        {
+          while (!scheduler->IsEmpty () && scheduler->PeekNext ().key.m_ts < record.now)
+            {
+              scheduler->RemoveNext ();
+              ++ops;
+            }
+          Scheduler::Event ev;
+          ev.impl = 0;
+          ev.key.m_ts = record.ts;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          ++ops;
+        }
+      while (!scheduler->IsEmpty ())
+        {
+          scheduler->RemoveNext ();
+          ++ops;
+        }
+      double simu = time.End () / 1000.0;
+      if (i == 0)
+        {
+          std::cout << std::left << std::setw (g_fwidth) << "(prime)";
+        }
+      else
+        {
+          std::cout << std::left << std::setw (g_fwidth) << i - 1;
+        }
+      LOG (std::setw (g_fwidth) << simu <<
+           std::setw (g_fwidth) << (ops / simu)
+                                << (simu / ops)
+           );
+    }
+}
+
+
 int main (int argc, char *argv[])
 {
 
   bool allSched  = false;
   bool schedCal  = false;
   bool schedHeap = false;
+  bool schedLadder = false;
   bool schedList = false;
   bool schedMap  = false;   // default scheduler
   bool schedPQ   = false;
@@ -325,6 +448,7 @@ int main (int argc, char *argv[])
   uint32_t total = 1000000;
   uint32_t runs  =       1;
   std::string filename = "";
+  std::string tracename = "";
   bool calRev = false;
 
   CommandLine cmd (__FILE__);
@@ -335,11 +459,16 @@ int main (int argc, char *argv[])
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
              "In the case of either --file form, the input is expected\n"
-             "to be ascii, giving the relative event times in ns.");
+             "to be ascii, giving the relative event times in ns.\n"
+             "\n"
+             "With --trace=\"<filename>\", the insertions and removals of\n"
+             "a simulation are replayed from a trace written by a build\n"
+             "configured with NS3_DES_METRICS, instead.");
   cmd.AddValue ("all",   "use all schedulers",            allSched);
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("calrev", "reverse ordering in the CalendarScheduler", calRev);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
   cmd.AddValue ("pri",   "use PriorityQueue",             schedPQ);
@@ -348,6 +477,7 @@ int main (int argc, char *argv[])
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("trace", "DES Metrics trace to replay",   tracename);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
 
@@ -363,14 +493,50 @@ int main (int argc, char *argv[])
 
   if (allSched)
     {
-      schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+      schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
   // Set the default case if nothing else is set
-  if (! (schedCal || schedHeap || schedList || schedMap || schedPQ))
+  if (! (schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
       schedMap = true;
     }
 
+  if (tracename != "")
+    {
+      std::vector<TraceRecord> records = ReadTrace (tracename);
+      std::vector<std::string> types;
+      if (schedCal)
+        {
+          types.push_back ("ns3::CalendarScheduler");
+        }
+      if (schedHeap)
+        {
+          types.push_back ("ns3::HeapScheduler");
+        }
+      if (schedLadder)
+        {
+          types.push_back ("ns3::LadderScheduler");
+        }
+      if (schedList)
+        {
+          types.push_back ("ns3::ListScheduler");
+        }
+      if (schedMap)
+        {
+          types.push_back ("ns3::MapScheduler");
+        }
+      if (schedPQ)
+        {
+          types.push_back ("ns3::PriorityQueueScheduler");
+        }
+      for (const std::string &type : types)
+        {
+          ObjectFactory factory (type);
+          Replay (factory, records, runs);
+        }
+      return 0;
+    }
+
   Ptr<RandomVariableStream> eventStream = GetRandomStream (filename);
 
 
@@ -391,6 +557,11 @@ int main (int argc, char *argv[])
       factory.SetTypeId ("ns3::HeapScheduler");
       Run (factory, pop, total, runs, eventStream, calRev);
     }
+  if (schedLadder)
+    {
+      factory.SetTypeId ("ns3::LadderScheduler");
+      Run (factory, pop, total, runs, eventStream, calRev);
+    }
   if (schedList)
     {
       factory.SetTypeId ("ns3::ListScheduler");